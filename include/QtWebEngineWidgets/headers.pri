@@ -1,4 +1,4 @@
-SYNCQT.HEADER_FILES = api/qtwebenginewidgetsglobal.h api/qwebenginehistory.h api/qwebenginepage.h api/qwebengineview.h ../../include/QtWebEngineWidgets/qtwebenginewidgetsversion.h ../../include/QtWebEngineWidgets/QtWebEngineWidgets 
-SYNCQT.HEADER_CLASSES = ../../include/QtWebEngineWidgets/QWebEngineWidgets ../../include/QtWebEngineWidgets/QWebEngineHistoryItem ../../include/QtWebEngineWidgets/QWebEngineHistory ../../include/QtWebEngineWidgets/QWebEngineCallback ../../include/QtWebEngineWidgets/QWebEnginePage ../../include/QtWebEngineWidgets/QWebEngineView ../../include/QtWebEngineWidgets/QtWebEngineWidgetsVersion 
-SYNCQT.PRIVATE_HEADER_FILES = api/qwebenginehistory_p.h api/qwebenginepage_p.h api/qwebengineview_p.h 
+SYNCQT.HEADER_FILES = api/qtwebenginewidgetsglobal.h api/qwebenginehistory.h api/qwebenginepage.h api/qwebengineprofile.h api/qwebengineview.h ../../include/QtWebEngineWidgets/qtwebenginewidgetsversion.h ../../include/QtWebEngineWidgets/QtWebEngineWidgets 
+SYNCQT.HEADER_CLASSES = ../../include/QtWebEngineWidgets/QWebEngineWidgets ../../include/QtWebEngineWidgets/QWebEngineHistoryItem ../../include/QtWebEngineWidgets/QWebEngineHistory ../../include/QtWebEngineWidgets/QWebEngineCallback ../../include/QtWebEngineWidgets/QWebEnginePage ../../include/QtWebEngineWidgets/QWebEngineProfile ../../include/QtWebEngineWidgets/QWebEngineView ../../include/QtWebEngineWidgets/QtWebEngineWidgetsVersion 
+SYNCQT.PRIVATE_HEADER_FILES = api/qwebenginehistory_p.h api/qwebenginepage_p.h api/qwebengineprofile_p.h api/qwebengineview_p.h 
 SYNCQT.QPA_HEADER_FILES = 
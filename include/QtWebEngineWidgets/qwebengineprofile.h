@@ -0,0 +1 @@
+#include "../../src/webenginewidgets/api/qwebengineprofile.h"
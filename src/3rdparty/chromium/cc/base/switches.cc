@@ -147,6 +147,10 @@ const char kCCRebaselinePixeltests[] = "cc-rebaseline-pixeltests";
 // Disable textures using RGBA_4444 layout.
 const char kDisable4444Textures[] = "disable-4444-textures";
 
+// Raster opaque low priority tiles into low bit depth textures while the
+// memory policy is restrictive.
+const char kEnableLowBitDepthTiles[] = "enable-low-bit-depth-tiles";
+
 // Disable touch hit testing in the compositor.
 const char kDisableCompositorTouchHitTesting[] =
     "disable-compositor-touch-hit-testing";
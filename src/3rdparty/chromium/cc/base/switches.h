@@ -41,6 +41,7 @@ CC_EXPORT extern const char kStrictLayerPropertyChangeChecking[];
 CC_EXPORT extern const char kEnableMapImage[];
 CC_EXPORT extern const char kDisableMapImage[];
 CC_EXPORT extern const char kDisable4444Textures[];
+CC_EXPORT extern const char kEnableLowBitDepthTiles[];
 CC_EXPORT extern const char kDisableCompositorTouchHitTesting[];
 
 // Switches for both the renderer and ui compositors.
@@ -11,6 +11,14 @@
 
 namespace cc {
 
+// State that LayerTreeHostCommon keeps on a layer between calculations so that
+// an unchanged subtree does not have to be recalculated. Its contents are
+// private to LayerTreeHostCommon.
+class SubtreeDrawPropertiesCache {
+ public:
+  virtual ~SubtreeDrawPropertiesCache() {}
+};
+
 // Container for properties that layers need to compute before they can be
 // drawn.
 template <typename LayerType>
@@ -34,7 +42,8 @@ struct CC_EXPORT DrawProperties {
         index_of_first_descendants_addition(0),
         num_descendants_added(0),
         index_of_first_render_surface_layer_list_addition(0),
-        num_render_surfaces_added(0) {}
+        num_render_surfaces_added(0),
+        subtree_property_changed(true) {}
 
   // Transforms objects from content space to target surface space, where
   // this layer would be drawn.
@@ -118,6 +127,15 @@ struct CC_EXPORT DrawProperties {
   size_t num_descendants_added;
   size_t index_of_first_render_surface_layer_list_addition;
   size_t num_render_surfaces_added;
+
+  // True if a property that affects the draw properties of this layer or of
+  // any of its descendants has changed since the layer's draw properties were
+  // last calculated. Only LayerImpl keeps this up to date.
+  bool subtree_property_changed;
+
+  // What LayerTreeHostCommon needs to reuse the draw properties of this
+  // layer's subtree when none of its inputs have changed.
+  scoped_ptr<SubtreeDrawPropertiesCache> subtree_cache;
 };
 
 }  // namespace cc
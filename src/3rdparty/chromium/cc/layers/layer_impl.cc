@@ -110,8 +110,9 @@ LayerImpl::~LayerImpl() {
 void LayerImpl::AddChild(scoped_ptr<LayerImpl> child) {
   child->set_parent(this);
   DCHECK_EQ(layer_tree_impl(), child->layer_tree_impl());
+  child->draw_properties_.subtree_property_changed = true;
   children_.push_back(child.Pass());
-  layer_tree_impl()->set_needs_update_draw_properties();
+  NoteDrawPropertiesChanged();
 }
 
 scoped_ptr<LayerImpl> LayerImpl::RemoveChild(LayerImpl* child) {
@@ -121,7 +122,7 @@ scoped_ptr<LayerImpl> LayerImpl::RemoveChild(LayerImpl* child) {
     if (*it == child) {
       scoped_ptr<LayerImpl> ret = children_.take(it);
       children_.erase(it);
-      layer_tree_impl()->set_needs_update_draw_properties();
+      NoteDrawPropertiesChanged();
       return ret.Pass();
     }
   }
@@ -133,7 +134,7 @@ void LayerImpl::ClearChildList() {
     return;
 
   children_.clear();
-  layer_tree_impl()->set_needs_update_draw_properties();
+  NoteDrawPropertiesChanged();
 }
 
 bool LayerImpl::HasAncestor(const LayerImpl* ancestor) const {
@@ -641,7 +642,7 @@ void LayerImpl::SetStackingOrderChanged(bool stacking_order_changed) {
 
 void LayerImpl::NoteLayerPropertyChanged() {
   layer_property_changed_ = true;
-  layer_tree_impl()->set_needs_update_draw_properties();
+  NoteDrawPropertiesChanged();
 }
 
 void LayerImpl::NoteLayerPropertyChangedForSubtree() {
@@ -650,11 +651,19 @@ void LayerImpl::NoteLayerPropertyChangedForSubtree() {
 }
 
 void LayerImpl::NoteLayerPropertyChangedForDescendants() {
-  layer_tree_impl()->set_needs_update_draw_properties();
+  NoteDrawPropertiesChanged();
   for (size_t i = 0; i < children_.size(); ++i)
     children_[i]->NoteLayerPropertyChangedForSubtree();
 }
 
+void LayerImpl::NoteDrawPropertiesChanged() {
+  // Every ancestor's subtree contains this layer, so none of them can reuse
+  // the draw properties of its subtree either.
+  for (LayerImpl* layer = this; layer; layer = layer->parent())
+    layer->draw_properties_.subtree_property_changed = true;
+  layer_tree_impl()->set_needs_update_draw_properties();
+}
+
 const char* LayerImpl::LayerTypeAsString() const {
   return "cc::LayerImpl";
 }
@@ -793,6 +802,14 @@ void LayerImpl::SetHideLayerAndSubtree(bool hide) {
   NoteLayerPropertyChangedForSubtree();
 }
 
+void LayerImpl::SetForceRenderSurface(bool force) {
+  if (force_render_surface_ == force)
+    return;
+
+  force_render_surface_ = force;
+  NoteDrawPropertiesChanged();
+}
+
 void LayerImpl::SetAnchorPoint(gfx::PointF anchor_point) {
   if (anchor_point_ == anchor_point)
     return;
@@ -928,6 +945,23 @@ void LayerImpl::SetPreserves3d(bool preserves3_d) {
   NoteLayerPropertyChangedForSubtree();
 }
 
+void LayerImpl::SetPositionConstraint(
+    const LayerPositionConstraint& constraint) {
+  if (position_constraint_ == constraint)
+    return;
+
+  position_constraint_ = constraint;
+  NoteDrawPropertiesChanged();
+}
+
+void LayerImpl::SetUseParentBackfaceVisibility(bool use) {
+  if (use_parent_backface_visibility_ == use)
+    return;
+
+  use_parent_backface_visibility_ = use;
+  NoteDrawPropertiesChanged();
+}
+
 void LayerImpl::SetSublayerTransform(const gfx::Transform& sublayer_transform) {
   if (sublayer_transform_ == sublayer_transform)
     return;
@@ -1117,6 +1151,30 @@ void LayerImpl::SetDoubleSided(bool double_sided) {
   NoteLayerPropertyChangedForSubtree();
 }
 
+void LayerImpl::SetScrollable(bool scrollable) {
+  if (scrollable_ == scrollable)
+    return;
+
+  scrollable_ = scrollable;
+  NoteDrawPropertiesChanged();
+}
+
+void LayerImpl::SetHaveWheelEventHandlers(bool have_wheel_event_handlers) {
+  if (have_wheel_event_handlers_ == have_wheel_event_handlers)
+    return;
+
+  have_wheel_event_handlers_ = have_wheel_event_handlers;
+  NoteDrawPropertiesChanged();
+}
+
+void LayerImpl::SetTouchEventHandlerRegion(const Region& region) {
+  if (touch_event_handler_region_ == region)
+    return;
+
+  touch_event_handler_region_ = region;
+  NoteDrawPropertiesChanged();
+}
+
 Region LayerImpl::VisibleContentOpaqueRegion() const {
   if (contents_opaque())
     return visible_content_rect();
@@ -1135,7 +1193,7 @@ void LayerImpl::SetMaxScrollOffset(gfx::Vector2d max_scroll_offset) {
   if (scroll_offset_delegate_)
     scroll_offset_delegate_->SetMaxScrollOffset(max_scroll_offset_);
 
-  layer_tree_impl()->set_needs_update_draw_properties();
+  NoteDrawPropertiesChanged();
   UpdateScrollbarPositions();
 }
 
@@ -187,7 +187,7 @@ class CC_EXPORT LayerImpl : public LayerAnimationValueObserver,
   bool hide_layer_and_subtree() const { return hide_layer_and_subtree_; }
 
   bool force_render_surface() const { return force_render_surface_; }
-  void SetForceRenderSurface(bool force) { force_render_surface_ = force; }
+  void SetForceRenderSurface(bool force);
 
   void SetAnchorPoint(gfx::PointF anchor_point);
   gfx::PointF anchor_point() const { return anchor_point_; }
@@ -251,9 +251,7 @@ class CC_EXPORT LayerImpl : public LayerAnimationValueObserver,
     return fixed_container_size_delta_;
   }
 
-  void SetPositionConstraint(const LayerPositionConstraint& constraint) {
-    position_constraint_ = constraint;
-  }
+  void SetPositionConstraint(const LayerPositionConstraint& constraint);
   const LayerPositionConstraint& position_constraint() const {
     return position_constraint_;
   }
@@ -261,9 +259,7 @@ class CC_EXPORT LayerImpl : public LayerAnimationValueObserver,
   void SetPreserves3d(bool preserves_3d);
   bool preserves_3d() const { return preserves_3d_; }
 
-  void SetUseParentBackfaceVisibility(bool use) {
-    use_parent_backface_visibility_ = use;
-  }
+  void SetUseParentBackfaceVisibility(bool use);
   bool use_parent_backface_visibility() const {
     return use_parent_backface_visibility_;
   }
@@ -399,7 +395,7 @@ class CC_EXPORT LayerImpl : public LayerAnimationValueObserver,
   // initial scroll
   gfx::Vector2dF ScrollBy(gfx::Vector2dF scroll);
 
-  void SetScrollable(bool scrollable) { scrollable_ = scrollable; }
+  void SetScrollable(bool scrollable);
   bool scrollable() const { return scrollable_; }
 
   void set_user_scrollable_horizontal(bool scrollable) {
@@ -419,9 +415,7 @@ class CC_EXPORT LayerImpl : public LayerAnimationValueObserver,
     return should_scroll_on_main_thread_;
   }
 
-  void SetHaveWheelEventHandlers(bool have_wheel_event_handlers) {
-    have_wheel_event_handlers_ = have_wheel_event_handlers;
-  }
+  void SetHaveWheelEventHandlers(bool have_wheel_event_handlers);
   bool have_wheel_event_handlers() const { return have_wheel_event_handlers_; }
 
   void SetNonFastScrollableRegion(const Region& region) {
@@ -431,9 +425,7 @@ class CC_EXPORT LayerImpl : public LayerAnimationValueObserver,
     return non_fast_scrollable_region_;
   }
 
-  void SetTouchEventHandlerRegion(const Region& region) {
-    touch_event_handler_region_ = region;
-  }
+  void SetTouchEventHandlerRegion(const Region& region);
   const Region& touch_event_handler_region() const {
     return touch_event_handler_region_;
   }
@@ -549,6 +541,10 @@ class CC_EXPORT LayerImpl : public LayerAnimationValueObserver,
  private:
   void UpdateScrollbarPositions();
 
+  // Marks the draw properties of this layer and of its ancestors as needing
+  // to be recalculated.
+  void NoteDrawPropertiesChanged();
+
   virtual const char* LayerTypeAsString() const;
 
   // Properties internal to LayerImpl
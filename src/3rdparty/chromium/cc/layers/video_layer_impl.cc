@@ -184,6 +184,12 @@ void VideoLayerImpl::AppendQuads(QuadSink* quad_sink,
                              frame_resources_[2],
                              frame_resources_.size() > 3 ?
                                  frame_resources_[3] : 0);
+      // VideoFrame doesn't carry its color space, JPEG frames are tagged
+      // through their format and anything HD is assumed to be Rec. 709.
+      if (frame_->format() == media::VideoFrame::YV12J)
+        yuv_video_quad->color_space = YUVVideoDrawQuad::REC_601_JPEG;
+      else if (visible_rect.height() >= 720)
+        yuv_video_quad->color_space = YUVVideoDrawQuad::REC_709;
       quad_sink->Append(yuv_video_quad.PassAs<DrawQuad>(), append_quads_data);
       break;
     }
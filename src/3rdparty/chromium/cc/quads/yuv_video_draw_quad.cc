@@ -14,7 +14,8 @@ YUVVideoDrawQuad::YUVVideoDrawQuad()
     : y_plane_resource_id(0),
       u_plane_resource_id(0),
       v_plane_resource_id(0),
-      a_plane_resource_id(0) {}
+      a_plane_resource_id(0),
+      color_space(REC_601) {}
 YUVVideoDrawQuad::~YUVVideoDrawQuad() {}
 
 scoped_ptr<YUVVideoDrawQuad> YUVVideoDrawQuad::Create() {
@@ -63,7 +64,9 @@ void YUVVideoDrawQuad::IterateResources(
     const ResourceIteratorCallback& callback) {
   y_plane_resource_id = callback.Run(y_plane_resource_id);
   u_plane_resource_id = callback.Run(u_plane_resource_id);
-  v_plane_resource_id = callback.Run(v_plane_resource_id);
+  // Two-plane frames carry their interleaved chroma in the U plane.
+  if (v_plane_resource_id)
+    v_plane_resource_id = callback.Run(v_plane_resource_id);
   if (a_plane_resource_id)
     a_plane_resource_id = callback.Run(a_plane_resource_id);
 }
@@ -80,6 +83,7 @@ void YUVVideoDrawQuad::ExtendValue(base::DictionaryValue* value) const {
   value->SetInteger("u_plane_resource_id", u_plane_resource_id);
   value->SetInteger("v_plane_resource_id", v_plane_resource_id);
   value->SetInteger("a_plane_resource_id", a_plane_resource_id);
+  value->SetInteger("color_space", color_space);
 }
 
 }  // namespace cc
@@ -113,6 +113,7 @@ void ImageRasterWorkerPool::ScheduleTasks(RasterTask::Queue* queue) {
           image_task,
           task->dependencies(),
           priority++,
+          GetRasterTaskLane(task),
           IsRasterTaskRequiredForActivation(task),
           raster_required_for_activation_finished_node,
           raster_finished_node,
@@ -140,6 +141,7 @@ void ImageRasterWorkerPool::ScheduleTasks(RasterTask::Queue* queue) {
         new_image_task.get(),
         task->dependencies(),
         priority++,
+        GetRasterTaskLane(task),
         IsRasterTaskRequiredForActivation(task),
         raster_required_for_activation_finished_node,
         raster_finished_node,
@@ -214,6 +216,7 @@ void ImageRasterWorkerPool::CreateGraphNodeForImageTask(
     internal::WorkerPoolTask* image_task,
     const TaskVector& decode_tasks,
     unsigned priority,
+    TaskLane lane,
     bool is_required_for_activation,
     internal::GraphNode* raster_required_for_activation_finished_node,
     internal::GraphNode* raster_finished_node,
@@ -221,6 +224,7 @@ void ImageRasterWorkerPool::CreateGraphNodeForImageTask(
   internal::GraphNode* image_node = CreateGraphNodeForRasterTask(image_task,
                                                                  decode_tasks,
                                                                  priority,
+                                                                 lane,
                                                                  graph);
 
   if (is_required_for_activation) {
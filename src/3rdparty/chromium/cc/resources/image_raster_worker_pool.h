@@ -44,6 +44,7 @@ class CC_EXPORT ImageRasterWorkerPool : public RasterWorkerPool {
       internal::WorkerPoolTask* image_task,
       const TaskVector& decode_tasks,
       unsigned priority,
+      TaskLane lane,
       bool is_required_for_activation,
       internal::GraphNode* raster_required_for_activation_finished_node,
       internal::GraphNode* raster_finished_node,
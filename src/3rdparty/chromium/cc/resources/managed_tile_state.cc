@@ -47,6 +47,7 @@ scoped_ptr<base::Value> ManagedTileBinAsValue(ManagedTileBin bin) {
 
 ManagedTileState::ManagedTileState()
     : raster_mode(LOW_QUALITY_RASTER_MODE),
+      resource_format(RGBA_8888),
       bin(NEVER_BIN),
       resolution(NON_IDEAL_RESOLUTION),
       required_for_activation(false),
@@ -125,6 +125,9 @@ class CC_EXPORT ManagedTileState {
   TileVersion tile_versions[NUM_RASTER_MODES];
   RasterMode raster_mode;
 
+  // Format of the resource that the next raster task for this tile uses.
+  ResourceFormat resource_format;
+
   ManagedTileBin bin;
 
   TileResolution resolution;
@@ -87,6 +87,7 @@ scoped_refptr<Picture> Picture::Create(gfx::Rect layer_rect) {
 
 Picture::Picture(gfx::Rect layer_rect)
   : layer_rect_(layer_rect),
+    shared_for_drawing_(false),
     cell_size_(layer_rect.size()) {
   // Instead of recording a trace event for object creation here, we wait for
   // the picture to be recorded in Picture::Record.
@@ -157,6 +158,7 @@ Picture::Picture(SkPicture* picture,
     layer_rect_(layer_rect),
     opaque_rect_(opaque_rect),
     picture_(skia::AdoptRef(picture)),
+    shared_for_drawing_(false),
     cell_size_(layer_rect.size()) {
 }
 
@@ -167,6 +169,7 @@ Picture::Picture(const skia::RefPtr<SkPicture>& picture,
     layer_rect_(layer_rect),
     opaque_rect_(opaque_rect),
     picture_(picture),
+    shared_for_drawing_(false),
     pixel_refs_(pixel_refs),
     cell_size_(layer_rect.size()) {
 }
@@ -178,6 +181,9 @@ Picture::~Picture() {
 
 scoped_refptr<Picture> Picture::GetCloneForDrawingOnThread(
     unsigned thread_index) const {
+  if (shared_for_drawing_)
+    return make_scoped_refptr(const_cast<Picture*>(this));
+
   // SkPicture is not thread-safe to rasterize with, this returns a clone
   // to rasterize with on a specific thread.
   CHECK_GT(clones_.size(), thread_index);
@@ -188,10 +194,17 @@ void Picture::CloneForDrawing(int num_threads) {
   TRACE_EVENT1("cc", "Picture::CloneForDrawing", "num_threads", num_threads);
 
   DCHECK(picture_);
+  clones_.clear();
+
+  // Drawing such a picture doesn't modify it, the recording can be used on
+  // every raster thread at once instead of costing one copy per thread.
+  shared_for_drawing_ = picture_->isThreadSafeForPlayback();
+  if (shared_for_drawing_)
+    return;
+
   scoped_ptr<SkPicture[]> clones(new SkPicture[num_threads]);
   picture_->clone(&clones[0], num_threads);
 
-  clones_.clear();
   for (int i = 0; i < num_threads; i++) {
     scoped_refptr<Picture> clone = make_scoped_refptr(
         new Picture(skia::AdoptRef(new SkPicture(clones[i])),
@@ -54,9 +54,13 @@ class CC_EXPORT Picture
   scoped_refptr<Picture> GetCloneForDrawingOnThread(
       unsigned thread_index) const;
 
-  // Make thread-safe clones for rasterizing with.
+  // Make thread-safe clones for rasterizing with. A picture that Skia can
+  // play back concurrently isn't cloned, all threads share it instead.
   void CloneForDrawing(int num_threads);
 
+  // True if GetCloneForDrawingOnThread() returns this picture itself.
+  bool IsSharedForDrawing() const { return shared_for_drawing_; }
+
   // Record a paint operation. To be able to safely use this SkPicture for
   // playback on a different thread this can only be called once.
   void Record(ContentLayerClient* client,
@@ -139,6 +143,7 @@ class CC_EXPORT Picture
 
   typedef std::vector<scoped_refptr<Picture> > PictureVector;
   PictureVector clones_;
+  bool shared_for_drawing_;
 
   PixelRefMap pixel_refs_;
   gfx::Point min_pixel_cell_;
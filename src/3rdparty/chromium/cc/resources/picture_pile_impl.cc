@@ -19,7 +19,11 @@
 namespace cc {
 
 PicturePileImpl::ClonesForDrawing::ClonesForDrawing(
-    const PicturePileImpl* pile, int num_threads) {
+    const PicturePileImpl* pile, int num_threads)
+    : shared_(num_threads > 0 && pile->IsSharedForDrawing()) {
+  // A clone would only copy the picture map, with the same pictures in it.
+  if (shared_)
+    return;
   for (int i = 0; i < num_threads; i++) {
     scoped_refptr<PicturePileImpl> clone =
         PicturePileImpl::CreateCloneForDrawing(pile, i);
@@ -64,10 +68,23 @@ PicturePileImpl::~PicturePileImpl() {
 
 PicturePileImpl* PicturePileImpl::GetCloneForDrawingOnThread(
     unsigned thread_index) const {
+  if (clones_for_drawing_.shared_)
+    return const_cast<PicturePileImpl*>(this);
   CHECK_GT(clones_for_drawing_.clones_.size(), thread_index);
   return clones_for_drawing_.clones_[thread_index].get();
 }
 
+bool PicturePileImpl::IsSharedForDrawing() const {
+  for (PictureMap::const_iterator it = picture_map_.begin();
+       it != picture_map_.end();
+       ++it) {
+    const Picture* picture = it->second.GetPicture();
+    if (picture && !picture->IsSharedForDrawing())
+      return false;
+  }
+  return true;
+}
+
 void PicturePileImpl::RasterDirect(
     SkCanvas* canvas,
     gfx::Rect canvas_rect,
@@ -29,6 +29,10 @@ class CC_EXPORT PicturePileImpl : public PicturePileBase {
   // Get paint-safe version of this picture for a specific thread.
   PicturePileImpl* GetCloneForDrawingOnThread(unsigned thread_index) const;
 
+  // True if all of the pictures are shared for drawing, in which case this
+  // pile is its own paint-safe version on every thread.
+  bool IsSharedForDrawing() const;
+
   // Raster a subrect of this PicturePileImpl into the given canvas.
   // It's only safe to call paint on a cloned version.  It is assumed
   // that contents_scale has already been applied to this canvas.
@@ -120,6 +124,7 @@ class CC_EXPORT PicturePileImpl : public PicturePileBase {
 
     typedef std::vector<scoped_refptr<PicturePileImpl> > PicturePileVector;
     PicturePileVector clones_;
+    bool shared_;
   };
 
   static scoped_refptr<PicturePileImpl> CreateCloneForDrawing(
@@ -0,0 +1,154 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "cc/resources/picture_pile_impl.h"
+
+#include <set>
+
+#include "base/memory/scoped_ptr.h"
+#include "base/process/process_handle.h"
+#include "base/process/process_metrics.h"
+#include "base/strings/stringprintf.h"
+#include "cc/debug/rendering_stats_instrumentation.h"
+#include "cc/layers/content_layer_client.h"
+#include "cc/resources/picture_pile.h"
+#include "skia/ext/refptr.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+#include "third_party/skia/include/core/SkCanvas.h"
+#include "third_party/skia/include/effects/SkGradientShader.h"
+
+namespace cc {
+
+namespace {
+
+static const int kLayerWidth = 2048;
+static const int kLayerHeight = 8192;
+static const int kCellSize = 16;
+static const int kNumPiles = 8;
+
+// Paints a grid of small boxes, roughly what the borders and backgrounds of a
+// long page record into. Gradients make Skia clone their paints per thread.
+class BoxesContentLayerClient : public ContentLayerClient {
+ public:
+  explicit BoxesContentLayerClient(bool use_gradients)
+      : use_gradients_(use_gradients) {}
+
+  virtual void PaintContents(SkCanvas* canvas,
+                             gfx::Rect clip,
+                             gfx::RectF* opaque) OVERRIDE {
+    SkPaint paint;
+    skia::RefPtr<SkShader> shader;
+    if (use_gradients_) {
+      SkPoint points[2] = { SkPoint::Make(0, 0),
+                            SkPoint::Make(kCellSize, kCellSize) };
+      SkColor colors[2] = { SK_ColorWHITE, SK_ColorBLUE };
+      shader = skia::AdoptRef(SkGradientShader::CreateLinear(
+          points, colors, NULL, 2, SkShader::kClamp_TileMode));
+      paint.setShader(shader.get());
+    }
+
+    for (int y = clip.y() - clip.y() % kCellSize; y < clip.bottom();
+         y += kCellSize) {
+      for (int x = clip.x() - clip.x() % kCellSize; x < clip.right();
+           x += kCellSize) {
+        paint.setColor(SkColorSetRGB(x % 256, y % 256, 128));
+        canvas->drawRect(
+            SkRect::MakeXYWH(x, y, kCellSize - 2, kCellSize - 2), paint);
+      }
+    }
+  }
+
+  virtual void DidChangeLayerCanUseLCDText() OVERRIDE {}
+
+ private:
+  bool use_gradients_;
+};
+
+size_t GetWorkingSetSize() {
+#if defined(OS_MACOSX) && !defined(OS_IOS)
+  scoped_ptr<base::ProcessMetrics> metrics(
+      base::ProcessMetrics::CreateProcessMetrics(
+          base::GetCurrentProcessHandle(), NULL));
+#else
+  scoped_ptr<base::ProcessMetrics> metrics(
+      base::ProcessMetrics::CreateProcessMetrics(
+          base::GetCurrentProcessHandle()));
+#endif
+  return metrics->GetWorkingSetSize();
+}
+
+class PicturePileImplPerfTest : public testing::Test {
+ public:
+  PicturePileImplPerfTest()
+      : stats_instrumentation_(RenderingStatsInstrumentation::Create()) {}
+
+  // Records kNumPiles layers and makes them ready to be rasterized on
+  // |num_threads| threads. Reports the memory this took and how many copies
+  // of each pile the raster threads end up drawing with.
+  void RunDrawingCopiesTest(const std::string& test_name,
+                            bool use_gradients,
+                            int num_threads) {
+    BoxesContentLayerClient client(use_gradients);
+    gfx::Rect layer_rect(kLayerWidth, kLayerHeight);
+
+    size_t working_set_before = GetWorkingSetSize();
+
+    std::vector<scoped_refptr<PicturePileImpl> > impl_piles;
+    std::set<const PicturePileImpl*> drawing_copies;
+    for (int i = 0; i < kNumPiles; ++i) {
+      scoped_refptr<PicturePile> pile = new PicturePile;
+      pile->Resize(layer_rect.size());
+      pile->SetTileGridSize(gfx::Size(256, 256));
+      pile->set_num_raster_threads(num_threads);
+      pile->Update(&client,
+                   SK_ColorWHITE,
+                   false,
+                   layer_rect,
+                   layer_rect,
+                   1,
+                   stats_instrumentation_.get());
+
+      scoped_refptr<PicturePileImpl> impl_pile =
+          PicturePileImpl::CreateFromOther(pile.get());
+      for (int thread = 0; thread < num_threads; ++thread)
+        drawing_copies.insert(impl_pile->GetCloneForDrawingOnThread(thread));
+      impl_piles.push_back(impl_pile);
+    }
+
+    size_t working_set_after = GetWorkingSetSize();
+    size_t growth = working_set_after > working_set_before
+                        ? working_set_after - working_set_before
+                        : 0;
+
+    std::string trace = base::StringPrintf(
+        "%s_%d_threads", test_name.c_str(), num_threads);
+    perf_test::PrintResult("picture_pile_memory", "", trace,
+                           growth / 1024 / kNumPiles, "kb/layer", true);
+    perf_test::PrintResult("picture_pile_drawing_copies", "", trace,
+                           drawing_copies.size() / kNumPiles, "copies/layer",
+                           true);
+  }
+
+ private:
+  scoped_ptr<RenderingStatsInstrumentation> stats_instrumentation_;
+};
+
+// These pictures can be played back by all threads at once and are shared.
+TEST_F(PicturePileImplPerfTest, SharedPlayback) {
+  RunDrawingCopiesTest("shared", false, 1);
+  RunDrawingCopiesTest("shared", false, 4);
+  RunDrawingCopiesTest("shared", false, 16);
+}
+
+// The gradient shaders force one clone of every picture per raster thread.
+TEST_F(PicturePileImplPerfTest, ClonedPlayback) {
+  RunDrawingCopiesTest("cloned", true, 1);
+  RunDrawingCopiesTest("cloned", true, 4);
+  RunDrawingCopiesTest("cloned", true, 16);
+}
+
+}  // namespace
+
+}  // namespace cc
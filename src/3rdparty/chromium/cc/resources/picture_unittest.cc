@@ -421,5 +421,52 @@ TEST(PictureTest, CreateFromSkpValue) {
   EXPECT_EQ(100, one_rect_picture_check->OpaqueRect().width());
   EXPECT_EQ(200, one_rect_picture_check->OpaqueRect().height());
 }
+
+TEST(PictureTest, CloneForDrawing) {
+  SkGraphics::Init();
+
+  gfx::Rect layer_rect(100, 100);
+
+  SkTileGridPicture::TileGridInfo tile_grid_info;
+  tile_grid_info.fTileInterval = SkISize::Make(100, 100);
+  tile_grid_info.fMargin.setEmpty();
+  tile_grid_info.fOffset.setZero();
+
+  // Plain colors leave the recording untouched when played back, all threads
+  // draw with the same picture.
+  FakeContentLayerClient solid_content_layer_client;
+  SkPaint red_paint;
+  red_paint.setColor(SkColorSetARGB(255, 255, 0, 0));
+  solid_content_layer_client.add_draw_rect(layer_rect, red_paint);
+  scoped_refptr<Picture> solid_picture = Picture::Create(layer_rect);
+  solid_picture->Record(&solid_content_layer_client, tile_grid_info);
+  solid_picture->CloneForDrawing(4);
+
+  EXPECT_TRUE(solid_picture->IsSharedForDrawing());
+  for (unsigned i = 0; i < 4; ++i)
+    EXPECT_EQ(solid_picture.get(),
+              solid_picture->GetCloneForDrawingOnThread(i).get());
+
+  // Bitmaps get locked during playback, each thread needs its own clone.
+  FakeContentLayerClient bitmap_content_layer_client;
+  SkBitmap bitmap;
+  CreateBitmap(gfx::Size(50, 50), "lazy", &bitmap);
+  SkPaint paint;
+  bitmap_content_layer_client.add_draw_bitmap(
+      bitmap, gfx::Point(25, 25), paint);
+  scoped_refptr<Picture> bitmap_picture = Picture::Create(layer_rect);
+  bitmap_picture->Record(&bitmap_content_layer_client, tile_grid_info);
+  bitmap_picture->CloneForDrawing(4);
+
+  EXPECT_FALSE(bitmap_picture->IsSharedForDrawing());
+  for (unsigned i = 0; i < 4; ++i) {
+    scoped_refptr<Picture> clone =
+        bitmap_picture->GetCloneForDrawingOnThread(i);
+    EXPECT_NE(bitmap_picture.get(), clone.get());
+    for (unsigned j = 0; j < i; ++j)
+      EXPECT_NE(bitmap_picture->GetCloneForDrawingOnThread(j).get(),
+                clone.get());
+  }
+}
 }  // namespace
 }  // namespace cc
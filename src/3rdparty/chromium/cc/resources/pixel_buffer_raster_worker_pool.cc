@@ -225,6 +225,20 @@ ResourceFormat PixelBufferRasterWorkerPool::GetResourceFormat() const {
   return resource_provider()->memory_efficient_texture_format();
 }
 
+ResourceFormat PixelBufferRasterWorkerPool::GetLowBitDepthResourceFormat()
+    const {
+  // Software resources can only hold RGBA_8888 pixels.
+  if (resource_provider()->default_resource_type() !=
+      ResourceProvider::GLTexture)
+    return GetResourceFormat();
+
+  // Tiles are already rastered into 16 bit textures.
+  if (BitsPerPixel(GetResourceFormat()) <= BitsPerPixel(RGB_565))
+    return GetResourceFormat();
+
+  return RGB_565;
+}
+
 void PixelBufferRasterWorkerPool::CheckForCompletedTasks() {
   TRACE_EVENT0("cc", "PixelBufferRasterWorkerPool::CheckForCompletedTasks");
 
@@ -491,6 +505,7 @@ void PixelBufferRasterWorkerPool::ScheduleMoreTasks() {
           CreateGraphNodeForRasterTask(pixel_buffer_task,
                                        task->dependencies(),
                                        priority++,
+                                       GetRasterTaskLane(task),
                                        &graph));
       continue;
     }
@@ -516,6 +531,7 @@ void PixelBufferRasterWorkerPool::ScheduleMoreTasks() {
         CreateGraphNodeForRasterTask(new_pixel_buffer_task.get(),
                                      task->dependencies(),
                                      priority++,
+                                     GetRasterTaskLane(task),
                                      &graph));
   }
 
@@ -42,7 +42,8 @@ class PlatformColor {
   static bool SameComponentOrder(ResourceFormat format) {
     switch (Format()) {
       case SOURCE_FORMAT_RGBA8:
-        return format == RGBA_8888 || format == RGBA_4444;
+        return format == RGBA_8888 || format == RGBA_4444 ||
+               format == RGB_565;
       case SOURCE_FORMAT_BGRA8:
         return format == BGRA_8888;
     }
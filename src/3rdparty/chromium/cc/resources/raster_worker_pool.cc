@@ -4,6 +4,8 @@
 
 #include "cc/resources/raster_worker_pool.h"
 
+#include <algorithm>
+
 #include "base/json/json_writer.h"
 #include "base/metrics/histogram.h"
 #include "base/values.h"
@@ -124,8 +126,9 @@ class RasterWorkerPoolTaskImpl : public internal::RasterWorkerPoolTask {
     SkBitmap bitmap;
     switch (resource()->format()) {
       case RGBA_4444:
+      case RGB_565:
         // Use the default stride if we will eventually convert this
-        // bitmap to 4444.
+        // bitmap to 4444 or 565.
         bitmap.setConfig(SkBitmap::kARGB_8888_Config,
                          size.width(),
                          size.height());
@@ -140,7 +143,6 @@ class RasterWorkerPoolTaskImpl : public internal::RasterWorkerPoolTask {
         bitmap.setPixels(buffer);
         break;
       case LUMINANCE_8:
-      case RGB_565:
       case ETC1:
         NOTREACHED();
         break;
@@ -398,11 +400,12 @@ RasterWorkerPool::RasterTask::Queue::~Queue() {
 }
 
 void RasterWorkerPool::RasterTask::Queue::Append(
-    const RasterTask& task, bool required_for_activation) {
+    const RasterTask& task, bool required_for_activation, TaskLane lane) {
   DCHECK(!task.is_null());
   tasks_.push_back(task.internal_);
   if (required_for_activation)
     tasks_required_for_activation_.insert(task.internal_.get());
+  task_lanes_[task.internal_.get()] = lane;
 }
 
 RasterWorkerPool::RasterTask::RasterTask() {
@@ -476,6 +479,10 @@ void RasterWorkerPool::SetClient(RasterWorkerPoolClient* client) {
   client_ = client;
 }
 
+ResourceFormat RasterWorkerPool::GetLowBitDepthResourceFormat() const {
+  return GetResourceFormat();
+}
+
 void RasterWorkerPool::Shutdown() {
   raster_tasks_.clear();
   TaskGraph empty;
@@ -488,6 +495,7 @@ void RasterWorkerPool::SetRasterTasks(RasterTask::Queue* queue) {
   raster_tasks_.swap(queue->tasks_);
   raster_tasks_required_for_activation_.swap(
       queue->tasks_required_for_activation_);
+  raster_task_lanes_.swap(queue->task_lanes_);
 }
 
 bool RasterWorkerPool::IsRasterTaskRequiredForActivation(
@@ -497,6 +505,14 @@ bool RasterWorkerPool::IsRasterTaskRequiredForActivation(
       raster_tasks_required_for_activation_.end();
 }
 
+TaskLane RasterWorkerPool::GetRasterTaskLane(
+    internal::RasterWorkerPoolTask* task) const {
+  RasterTask::Queue::TaskLaneMap::const_iterator it =
+      raster_task_lanes_.find(task);
+  DCHECK(it != raster_task_lanes_.end());
+  return it->second;
+}
+
 scoped_refptr<internal::WorkerPoolTask>
     RasterWorkerPool::CreateRasterFinishedTask() {
   return make_scoped_refptr(
@@ -560,11 +576,13 @@ internal::GraphNode* RasterWorkerPool::CreateGraphNodeForRasterTask(
     internal::WorkerPoolTask* raster_task,
     const TaskVector& decode_tasks,
     unsigned priority,
+    TaskLane lane,
     TaskGraph* graph) {
   DCHECK(!raster_task->HasCompleted());
 
   internal::GraphNode* raster_node = CreateGraphNodeForTask(
       raster_task, priority, graph);
+  raster_node->set_lane(lane);
 
   // Insert image decode tasks.
   for (TaskVector::const_iterator it = decode_tasks.begin();
@@ -581,12 +599,14 @@ internal::GraphNode* RasterWorkerPool::CreateGraphNodeForRasterTask(
     GraphNodeMap::iterator decode_it = graph->find(decode_task);
     if (decode_it != graph->end()) {
       internal::GraphNode* decode_node = decode_it->second;
+      decode_node->set_lane(std::min(decode_node->lane(), lane));
       decode_node->add_dependent(raster_node);
       continue;
     }
 
     internal::GraphNode* decode_node = CreateGraphNodeForTask(
         decode_task, priority, graph);
+    decode_node->set_lane(lane);
     decode_node->add_dependent(raster_node);
   }
 
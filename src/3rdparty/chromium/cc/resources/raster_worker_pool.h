@@ -137,7 +137,11 @@ class CC_EXPORT RasterWorkerPool : public WorkerPool {
       Queue();
       ~Queue();
 
-      void Append(const RasterTask& task, bool required_for_activation);
+      // Tasks in |lane| run before ready tasks in higher lanes, no matter
+      // the order they were appended in.
+      void Append(const RasterTask& task,
+                  bool required_for_activation,
+                  TaskLane lane);
 
      private:
       friend class RasterWorkerPool;
@@ -147,6 +151,9 @@ class CC_EXPORT RasterWorkerPool : public WorkerPool {
       TaskVector tasks_;
       typedef base::hash_set<internal::RasterWorkerPoolTask*> TaskSet;
       TaskSet tasks_required_for_activation_;
+      typedef base::hash_map<internal::RasterWorkerPoolTask*, TaskLane>
+          TaskLaneMap;
+      TaskLaneMap task_lanes_;
     };
 
     RasterTask();
@@ -188,6 +195,11 @@ class CC_EXPORT RasterWorkerPool : public WorkerPool {
   // Returns the format that needs to be used for raster task resources.
   virtual ResourceFormat GetResourceFormat() const = 0;
 
+  // Returns a cheaper format that can be used for resources of opaque tiles
+  // when memory is constrained. The default implementation returns
+  // GetResourceFormat(), which disables low bit depth tiles.
+  virtual ResourceFormat GetLowBitDepthResourceFormat() const;
+
   // TODO(vmpstr): Figure out an elegant way to not pass this many parameters.
   static RasterTask CreateRasterTask(
       const Resource* resource,
@@ -226,6 +238,7 @@ class CC_EXPORT RasterWorkerPool : public WorkerPool {
   void SetRasterTasks(RasterTask::Queue* queue);
   bool IsRasterTaskRequiredForActivation(
       internal::RasterWorkerPoolTask* task) const;
+  TaskLane GetRasterTaskLane(internal::RasterWorkerPoolTask* task) const;
 
   RasterWorkerPoolClient* client() const { return client_; }
   ResourceProvider* resource_provider() const { return resource_provider_; }
@@ -255,10 +268,13 @@ class CC_EXPORT RasterWorkerPool : public WorkerPool {
       unsigned priority,
       TaskGraph* graph);
 
+  // Image decode tasks are moved to |lane| if they are needed by a raster
+  // task in a lower lane than the one they were created for.
   static internal::GraphNode* CreateGraphNodeForRasterTask(
       internal::WorkerPoolTask* raster_task,
       const TaskVector& decode_tasks,
       unsigned priority,
+      TaskLane lane,
       TaskGraph* graph);
 
  private:
@@ -270,6 +286,7 @@ class CC_EXPORT RasterWorkerPool : public WorkerPool {
   ResourceProvider* resource_provider_;
   RasterTask::Queue::TaskVector raster_tasks_;
   RasterTask::Queue::TaskSet raster_tasks_required_for_activation_;
+  RasterTask::Queue::TaskLaneMap raster_task_lanes_;
 
   scoped_refptr<internal::WorkerPoolTask> raster_finished_task_;
   scoped_refptr<internal::WorkerPoolTask>
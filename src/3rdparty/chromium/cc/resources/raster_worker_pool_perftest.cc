@@ -4,6 +4,7 @@
 
 #include "cc/resources/raster_worker_pool.h"
 
+#include "base/threading/platform_thread.h"
 #include "base/time/time.h"
 #include "cc/test/lap_timer.h"
 #include "testing/gtest/include/gtest/gtest.h"
@@ -16,6 +17,9 @@ namespace {
 static const int kTimeLimitMillis = 2000;
 static const int kWarmupRuns = 5;
 static const int kTimeCheckInterval = 10;
+static const unsigned kScrollFrames = 20;
+static const int kTaskDurationMicros = 500;
+static const size_t kNumRasterThreads = 2;
 
 class PerfWorkerPoolTaskImpl : public internal::WorkerPoolTask {
  public:
@@ -27,13 +31,38 @@ class PerfWorkerPoolTaskImpl : public internal::WorkerPoolTask {
   virtual ~PerfWorkerPoolTaskImpl() {}
 };
 
+// Keeps a worker busy for |duration| to simulate rasterization of a tile.
+class TimedPerfWorkerPoolTaskImpl : public internal::WorkerPoolTask {
+ public:
+  explicit TimedPerfWorkerPoolTaskImpl(base::TimeDelta duration)
+      : duration_(duration) {}
+
+  // Overridden from internal::WorkerPoolTask:
+  virtual void RunOnWorkerThread(unsigned thread_index) OVERRIDE {
+    base::TimeTicks end = base::TimeTicks::HighResNow() + duration_;
+    while (base::TimeTicks::HighResNow() < end) {}
+  }
+  virtual void CompleteOnOriginThread() OVERRIDE {}
+
+ private:
+  virtual ~TimedPerfWorkerPoolTaskImpl() {}
+
+  const base::TimeDelta duration_;
+
+  DISALLOW_COPY_AND_ASSIGN(TimedPerfWorkerPoolTaskImpl);
+};
+
+typedef std::vector<scoped_refptr<TimedPerfWorkerPoolTaskImpl> >
+    TimedTaskVector;
+
 class PerfRasterWorkerPool : public RasterWorkerPool {
  public:
-  PerfRasterWorkerPool() : RasterWorkerPool(NULL, 1) {}
+  explicit PerfRasterWorkerPool(size_t num_threads)
+      : RasterWorkerPool(NULL, num_threads) {}
   virtual ~PerfRasterWorkerPool() {}
 
-  static scoped_ptr<PerfRasterWorkerPool> Create() {
-    return make_scoped_ptr(new PerfRasterWorkerPool);
+  static scoped_ptr<PerfRasterWorkerPool> Create(size_t num_threads) {
+    return make_scoped_ptr(new PerfRasterWorkerPool(num_threads));
   }
 
   // Overridden from RasterWorkerPool:
@@ -104,6 +133,7 @@ class PerfRasterWorkerPool : public RasterWorkerPool {
             CreateGraphNodeForRasterTask(perf_task,
                                          task->dependencies(),
                                          priority++,
+                                         GetRasterTaskLane(task),
                                          &graph);
 
         if (IsRasterTaskRequiredForActivation(task)) {
@@ -118,6 +148,49 @@ class PerfRasterWorkerPool : public RasterWorkerPool {
     }
   }
 
+  // Schedules tasks the way TileManager does: priorities follow the order
+  // of the tiles, visible tiles first, and visible tiles go in the NOW lane
+  // when |use_lanes| is true. Completed tasks are skipped.
+  void ScheduleTimedTasks(const TimedTaskVector& visible_tasks,
+                          const TimedTaskVector& prepaint_tasks,
+                          bool use_lanes) {
+    unsigned priority = 0;
+    TaskGraph graph;
+
+    for (TimedTaskVector::const_iterator it = visible_tasks.begin();
+         it != visible_tasks.end(); ++it) {
+      if ((*it)->HasCompleted())
+        continue;
+
+      CreateGraphNodeForRasterTask(
+          it->get(),
+          TaskVector(),
+          priority++,
+          use_lanes ? NOW_TASK_LANE : EVENTUALLY_TASK_LANE,
+          &graph);
+    }
+    for (TimedTaskVector::const_iterator it = prepaint_tasks.begin();
+         it != prepaint_tasks.end(); ++it) {
+      if ((*it)->HasCompleted())
+        continue;
+
+      CreateGraphNodeForRasterTask(
+          it->get(), TaskVector(), priority++, EVENTUALLY_TASK_LANE, &graph);
+    }
+
+    SetTaskGraph(&graph);
+  }
+
+  void WaitForTimedTasksToComplete(const TimedTaskVector& tasks) {
+    for (TimedTaskVector::const_iterator it = tasks.begin();
+         it != tasks.end(); ++it) {
+      while (!(*it)->HasCompleted()) {
+        CheckForCompletedTasks();
+        base::PlatformThread::YieldCurrentThread();
+      }
+    }
+  }
+
  private:
   TaskMap perf_tasks_;
 
@@ -133,7 +206,7 @@ class RasterWorkerPoolPerfTest : public testing::Test {
 
   // Overridden from testing::Test:
   virtual void SetUp() OVERRIDE {
-    raster_worker_pool_ = PerfRasterWorkerPool::Create();
+    raster_worker_pool_ = PerfRasterWorkerPool::Create(1);
   }
   virtual void TearDown() OVERRIDE {
     raster_worker_pool_->Shutdown();
@@ -175,7 +248,8 @@ class RasterWorkerPoolPerfTest : public testing::Test {
               NULL,
               base::Bind(&RasterWorkerPoolPerfTest::OnRasterTaskCompleted),
               &decode_tasks),
-          false);
+          false,
+          NOW_TASK_LANE);
     }
   }
 
@@ -195,6 +269,66 @@ class RasterWorkerPoolPerfTest : public testing::Test {
                            timer_.LapsPerSecond(), "runs/s", true);
   }
 
+  // Simulates scrolling through a strip of tiles, |scroll_step| tiles per
+  // frame. Each frame schedules the visible tiles followed by the prepaint
+  // tiles with the priorities TileManager assigns, so tiles that were
+  // prepaint in the previous frame are still queued when they become
+  // visible. Reports the time to schedule a frame and the time until all
+  // visible tiles of the frame have been rasterized. With |use_lanes|
+  // false all tasks share one lane and priorities alone order them.
+  void RunScrollTest(const std::string& test_name,
+                     unsigned num_visible_tasks,
+                     unsigned num_prepaint_tasks,
+                     unsigned scroll_step,
+                     bool use_lanes) {
+    scoped_ptr<PerfRasterWorkerPool> raster_worker_pool =
+        PerfRasterWorkerPool::Create(kNumRasterThreads);
+    base::TimeDelta task_duration =
+        base::TimeDelta::FromMicroseconds(kTaskDurationMicros);
+
+    TimedTaskVector tiles;
+    unsigned num_tiles = (kScrollFrames - 1) * scroll_step +
+        num_visible_tasks + num_prepaint_tasks;
+    for (unsigned i = 0; i < num_tiles; ++i) {
+      tiles.push_back(
+          make_scoped_refptr(new TimedPerfWorkerPoolTaskImpl(task_duration)));
+    }
+
+    base::TimeDelta schedule_time;
+    base::TimeDelta visible_time;
+    for (unsigned frame = 0; frame < kScrollFrames; ++frame) {
+      TimedTaskVector::const_iterator visible_begin =
+          tiles.begin() + frame * scroll_step;
+      TimedTaskVector::const_iterator prepaint_begin =
+          visible_begin + num_visible_tasks;
+      TimedTaskVector visible_tasks(visible_begin, prepaint_begin);
+      TimedTaskVector prepaint_tasks(prepaint_begin,
+                                     prepaint_begin + num_prepaint_tasks);
+
+      base::TimeTicks start_time = base::TimeTicks::HighResNow();
+      raster_worker_pool->ScheduleTimedTasks(
+          visible_tasks, prepaint_tasks, use_lanes);
+      schedule_time += base::TimeTicks::HighResNow() - start_time;
+      raster_worker_pool->WaitForTimedTasksToComplete(visible_tasks);
+      visible_time += base::TimeTicks::HighResNow() - start_time;
+    }
+
+    // Cancel remaining prepaint tasks.
+    raster_worker_pool->ScheduleTimedTasks(
+        TimedTaskVector(), TimedTaskVector(), use_lanes);
+    raster_worker_pool->WaitForTimedTasksToComplete(tiles);
+    raster_worker_pool->Shutdown();
+    raster_worker_pool->CheckForCompletedTasks();
+
+    perf_test::PrintResult("scroll_schedule_tasks", "", test_name,
+                           static_cast<double>(schedule_time.InMicroseconds()) /
+                               kScrollFrames,
+                           "us", true);
+    perf_test::PrintResult("scroll_time_to_visible_tiles", "", test_name,
+                           visible_time.InMillisecondsF() / kScrollFrames,
+                           "ms", true);
+  }
+
  protected:
   static void OnRasterTaskCompleted(const PicturePileImpl::Analysis& analysis,
                                     bool was_canceled) {}
@@ -219,6 +353,13 @@ TEST_F(RasterWorkerPoolPerfTest, BuildTaskGraph) {
   RunBuildTaskGraphTest("1000_16", 1000, 16);
 }
 
+TEST_F(RasterWorkerPoolPerfTest, Scroll) {
+  RunScrollTest("single_lane_8_32_4", 8, 32, 4, false);
+  RunScrollTest("lanes_8_32_4", 8, 32, 4, true);
+  RunScrollTest("single_lane_8_128_4", 8, 128, 4, false);
+  RunScrollTest("lanes_8_128_4", 8, 128, 4, true);
+}
+
 }  // namespace
 
 }  // namespace cc
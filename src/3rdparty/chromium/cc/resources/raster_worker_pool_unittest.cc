@@ -150,7 +150,7 @@ class RasterWorkerPoolTest : public testing::Test,
     for (std::vector<RasterWorkerPool::RasterTask>::iterator it =
              tasks_.begin();
          it != tasks_.end(); ++it)
-      tasks.Append(*it, false);
+      tasks.Append(*it, false, NOW_TASK_LANE);
 
     worker_pool()->ScheduleTasks(&tasks);
   }
@@ -13,9 +13,10 @@ SkBitmap::Config SkBitmapConfig(ResourceFormat format) {
     case RGBA_8888:
     case BGRA_8888:
       return SkBitmap::kARGB_8888_Config;
+    case RGB_565:
+      return SkBitmap::kRGB_565_Config;
     case ETC1:
     case LUMINANCE_8:
-    case RGB_565:
       NOTREACHED();
       break;
   }
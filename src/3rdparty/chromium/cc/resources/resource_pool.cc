@@ -14,7 +14,7 @@ ResourcePool::ResourcePool(ResourceProvider* resource_provider,
                            ResourceFormat format)
     : resource_provider_(resource_provider),
       target_(target),
-      format_(format),
+      default_format_(format),
       max_memory_usage_bytes_(0),
       max_unused_memory_usage_bytes_(0),
       max_resource_count_(0),
@@ -36,7 +36,8 @@ ResourcePool::~ResourcePool() {
   DCHECK_EQ(0u, resource_count_);
 }
 
-scoped_ptr<ScopedResource> ResourcePool::AcquireResource(gfx::Size size) {
+scoped_ptr<ScopedResource> ResourcePool::AcquireResource(
+    gfx::Size size, ResourceFormat format) {
   for (ResourceList::iterator it = unused_resources_.begin();
        it != unused_resources_.end(); ++it) {
     ScopedResource* resource = *it;
@@ -44,6 +45,8 @@ scoped_ptr<ScopedResource> ResourcePool::AcquireResource(gfx::Size size) {
 
     if (resource->size() != size)
       continue;
+    if (resource->format() != format)
+      continue;
 
     unused_resources_.erase(it);
     unused_memory_usage_bytes_ -= resource->bytes();
@@ -53,7 +56,7 @@ scoped_ptr<ScopedResource> ResourcePool::AcquireResource(gfx::Size size) {
   // Create new resource.
   scoped_ptr<ScopedResource> resource =
       ScopedResource::Create(resource_provider_);
-  resource->AllocateManaged(size, target_, format_);
+  resource->AllocateManaged(size, target_, format);
 
   // Extend all read locks on all resources until the resource is
   // finished being used, such that we know when resources are
@@ -28,7 +28,13 @@ class CC_EXPORT ResourcePool {
 
   virtual ~ResourcePool();
 
-  scoped_ptr<ScopedResource> AcquireResource(gfx::Size size);
+  // Returns a resource of |size| and |format|. The second version
+  // uses the default format of the pool.
+  scoped_ptr<ScopedResource> AcquireResource(gfx::Size size,
+                                             ResourceFormat format);
+  scoped_ptr<ScopedResource> AcquireResource(gfx::Size size) {
+    return AcquireResource(size, default_format_);
+  }
   void ReleaseResource(scoped_ptr<ScopedResource>);
 
   void SetResourceUsageLimits(size_t max_memory_usage_bytes,
@@ -38,6 +44,8 @@ class CC_EXPORT ResourcePool {
   void ReduceResourceUsage();
   void CheckBusyResources();
 
+  ResourceFormat default_format() const { return default_format_; }
+
   size_t total_memory_usage_bytes() const {
     return memory_usage_bytes_;
   }
@@ -60,7 +68,7 @@ class CC_EXPORT ResourcePool {
 
   ResourceProvider* resource_provider_;
   const GLenum target_;
-  const ResourceFormat format_;
+  const ResourceFormat default_format_;
   size_t max_memory_usage_bytes_;
   size_t max_unused_memory_usage_bytes_;
   size_t max_resource_count_;
@@ -110,6 +110,23 @@ const ManagedTileBin kBinIsActiveMap[2][NUM_BINS] = {
   }
 };
 
+// Raster tasks for tiles that are needed now, or that block activation,
+// run before any prepaint work that happens to be ready at the same time.
+inline TaskLane TaskLaneFromManagedTileState(const ManagedTileState& mts) {
+  if (mts.required_for_activation)
+    return NOW_TASK_LANE;
+
+  switch (mts.bin) {
+    case NOW_AND_READY_TO_DRAW_BIN:
+    case NOW_BIN:
+      return NOW_TASK_LANE;
+    case SOON_BIN:
+      return SOON_TASK_LANE;
+    default:
+      return EVENTUALLY_TASK_LANE;
+  }
+}
+
 // Determine bin based on three categories of tiles: things we need now,
 // things we need soon, and eventually.
 inline ManagedTileBin BinFromTilePriority(const TilePriority& prio) {
@@ -172,7 +189,8 @@ scoped_ptr<TileManager> TileManager::Create(
     bool use_map_image,
     size_t max_transfer_buffer_usage_bytes,
     size_t max_raster_usage_bytes,
-    GLenum map_image_texture_target) {
+    GLenum map_image_texture_target,
+    bool use_low_bit_depth_tiles) {
   return make_scoped_ptr(
       new TileManager(client,
                       resource_provider,
@@ -187,7 +205,8 @@ scoped_ptr<TileManager> TileManager::Create(
                           max_transfer_buffer_usage_bytes),
                       num_raster_threads,
                       max_raster_usage_bytes,
-                      rendering_stats_instrumentation));
+                      rendering_stats_instrumentation,
+                      use_low_bit_depth_tiles));
 }
 
 TileManager::TileManager(
@@ -196,7 +215,8 @@ TileManager::TileManager(
     scoped_ptr<RasterWorkerPool> raster_worker_pool,
     size_t num_raster_threads,
     size_t max_raster_usage_bytes,
-    RenderingStatsInstrumentation* rendering_stats_instrumentation)
+    RenderingStatsInstrumentation* rendering_stats_instrumentation,
+    bool use_low_bit_depth_tiles)
     : client_(client),
       resource_pool_(ResourcePool::Create(
                          resource_provider,
@@ -211,6 +231,10 @@ TileManager::TileManager(
       bytes_releasable_(0),
       resources_releasable_(0),
       max_raster_usage_bytes_(max_raster_usage_bytes),
+      use_low_bit_depth_tiles_(use_low_bit_depth_tiles),
+      memory_constrained_(false),
+      low_bit_depth_bytes_saved_(0),
+      low_bit_depth_resource_count_(0),
       ever_exceeded_memory_budget_(false),
       rendering_stats_instrumentation_(rendering_stats_instrumentation),
       did_initialize_visible_tile_(false),
@@ -236,6 +260,8 @@ TileManager::~TileManager() {
 
   DCHECK_EQ(0u, bytes_releasable_);
   DCHECK_EQ(0u, resources_releasable_);
+  DCHECK_EQ(0u, low_bit_depth_bytes_saved_);
+  DCHECK_EQ(0u, low_bit_depth_resource_count_);
 }
 
 void TileManager::Release(Tile* tile) {
@@ -517,6 +543,9 @@ void TileManager::ManageTiles(const GlobalStateThatImpactsTilePriority& state) {
   TRACE_COUNTER_ID1("cc", "unused_memory_bytes", this,
                     resource_pool_->total_memory_usage_bytes() -
                     resource_pool_->acquired_memory_usage_bytes());
+  TRACE_COUNTER_ID2("cc", "low_bit_depth_tiles", this,
+                    "bytes_saved", low_bit_depth_bytes_saved_,
+                    "resource_count", low_bit_depth_resource_count_);
 }
 
 bool TileManager::UpdateVisibleTiles() {
@@ -551,6 +580,7 @@ void TileManager::GetMemoryStats(
 scoped_ptr<base::Value> TileManager::BasicStateAsValue() const {
   scoped_ptr<base::DictionaryValue> state(new base::DictionaryValue());
   state->SetInteger("tile_count", tiles_.size());
+  state->SetBoolean("memory_constrained", memory_constrained_);
   state->Set("global_state", global_state_.AsValue().release());
   state->Set("memory_requirements", GetMemoryRequirementsAsValue().release());
   return state.PassAs<base::Value>();
@@ -583,6 +613,8 @@ scoped_ptr<base::Value> TileManager::GetMemoryRequirementsAsValue() const {
                            memory_nice_to_have_bytes);
   requirements->SetInteger("memory_allocated_bytes", memory_allocated_bytes);
   requirements->SetInteger("memory_used_bytes", memory_used_bytes);
+  requirements->SetInteger("low_bit_depth_bytes_saved",
+                           low_bit_depth_bytes_saved_);
   return requirements.PassAs<base::Value>();
 }
 
@@ -605,6 +637,40 @@ RasterMode TileManager::DetermineRasterMode(const Tile* tile) const {
   return std::min(raster_mode, current_mode);
 }
 
+ResourceFormat TileManager::DetermineResourceFormat(const Tile* tile) const {
+  DCHECK(tile);
+
+  ResourceFormat format = resource_pool_->default_format();
+  if (!memory_constrained_)
+    return format;
+
+  // Tiles that are needed now keep the best quality.
+  const ManagedTileState& mts = tile->managed_state();
+  if (mts.required_for_activation || mts.bin <= NOW_BIN)
+    return format;
+
+  // Low bit depth formats have no alpha channel to spare.
+  if (!tile->opaque_rect().Contains(tile->content_rect()))
+    return format;
+
+  ResourceFormat low_bit_depth_format =
+      raster_worker_pool_->GetLowBitDepthResourceFormat();
+
+  // Rows of converted bitmaps must be 4 byte aligned to be uploaded.
+  if ((BitsPerPixel(low_bit_depth_format) * tile->size().width()) % 32)
+    return format;
+
+  return low_bit_depth_format;
+}
+
+bool TileManager::NeedsFormatUpgrade(
+    const ManagedTileState::TileVersion& tile_version,
+    ResourceFormat format) const {
+  return format == resource_pool_->default_format() &&
+         tile_version.resource_ &&
+         tile_version.resource_->format() != format;
+}
+
 void TileManager::AssignGpuMemoryToTiles(
     PrioritizedTileSet* tiles,
     TileVector* tiles_that_need_to_be_rasterized) {
@@ -640,6 +706,7 @@ void TileManager::AssignGpuMemoryToTiles(
   size_t bytes_left = bytes_allocatable;
   size_t resources_left = resources_allocatable;
   bool oomed = false;
+  bool oomed_tiles_needed_now = false;
 
   // Memory we assign to raster tasks now will be deducted from our memory
   // in future iterations if priorities change. By assigning at most half
@@ -673,7 +740,17 @@ void TileManager::AssignGpuMemoryToTiles(
       continue;
     }
 
-    size_t bytes_if_allocated = BytesConsumedIfAllocated(tile);
+    mts.resource_format = DetermineResourceFormat(tile);
+
+    // Tiles rastered into a low bit depth format are rastered again as
+    // soon as they should use the default format, either because memory
+    // is no longer constrained or because they moved into the NOW bin.
+    // The old resource is kept until the new one is ready.
+    bool needs_format_upgrade =
+        NeedsFormatUpgrade(tile_version, mts.resource_format);
+
+    size_t bytes_if_allocated =
+        BytesConsumedIfAllocated(tile, mts.resource_format);
     size_t raster_bytes_if_rastered = raster_bytes + bytes_if_allocated;
 
     size_t tile_bytes = 0;
@@ -682,7 +759,7 @@ void TileManager::AssignGpuMemoryToTiles(
     // It costs to maintain a resource.
     for (int mode = 0; mode < NUM_RASTER_MODES; ++mode) {
       if (mts.tile_versions[mode].resource_) {
-        tile_bytes += bytes_if_allocated;
+        tile_bytes += mts.tile_versions[mode].resource_->bytes();
         tile_resources++;
       }
     }
@@ -693,7 +770,8 @@ void TileManager::AssignGpuMemoryToTiles(
     if (raster_bytes_if_rastered <= max_raster_bytes) {
       // If we don't have the required version, and it's not in flight
       // then we'll have to pay to create a new task.
-      if (!tile_version.resource_ && tile_version.raster_task_.is_null()) {
+      if ((!tile_version.resource_ || needs_format_upgrade) &&
+          tile_version.raster_task_.is_null()) {
         tile_bytes += bytes_if_allocated;
         tile_resources++;
       }
@@ -710,16 +788,19 @@ void TileManager::AssignGpuMemoryToTiles(
         tile_version.set_rasterize_on_demand();
 
       oomed = true;
+      if (mts.bin <= NOW_BIN || tile->required_for_activation())
+        oomed_tiles_needed_now = true;
       bytes_that_exceeded_memory_budget += tile_bytes;
+      needs_format_upgrade = false;
     } else {
       bytes_left -= tile_bytes;
       resources_left -= tile_resources;
 
-      if (tile_version.resource_)
+      if (tile_version.resource_ && !needs_format_upgrade)
         continue;
     }
 
-    DCHECK(!tile_version.resource_);
+    DCHECK(!tile_version.resource_ || needs_format_upgrade);
 
     // Tile shouldn't be rasterized if |tiles_that_need_to_be_rasterized|
     // has reached it's limit or we've failed to assign gpu memory to this
@@ -730,6 +811,10 @@ void TileManager::AssignGpuMemoryToTiles(
     // 2. Tiles with existing raster task could otherwise incorrectly
     //    be added as they are not affected by |bytes_allocatable|.
     if (oomed || raster_bytes_if_rastered > max_raster_bytes) {
+      // The tile can still be drawn from its low bit depth resource.
+      if (needs_format_upgrade)
+        continue;
+
       all_tiles_that_need_to_be_rasterized_have_memory_ = false;
       if (tile->required_for_activation())
         all_tiles_required_for_activation_have_memory_ = false;
@@ -755,19 +840,52 @@ void TileManager::AssignGpuMemoryToTiles(
       bytes_allocatable - bytes_releasable_;
   memory_stats_from_last_assign_.bytes_over =
       bytes_that_exceeded_memory_budget;
+
+  // Use low bit depth formats while the memory policy derived from the
+  // ManagedMemoryPolicy is restrictive or tiles needed now did not fit into
+  // the budget. Prepaint tiles running out of memory is expected and does
+  // not count. Go back to the default format only once all low bit depth
+  // resources could be upgraded within the budget to avoid alternating
+  // between the two.
+  memory_constrained_ =
+      use_low_bit_depth_tiles_ &&
+      (global_state_.memory_limit_policy != ALLOW_ANYTHING ||
+       oomed_tiles_needed_now ||
+       (memory_constrained_ && bytes_left < low_bit_depth_bytes_saved_));
 }
 
 void TileManager::FreeResourceForTile(Tile* tile, RasterMode mode) {
   ManagedTileState& mts = tile->managed_state();
   if (mts.tile_versions[mode].resource_) {
+    DidReleaseTileResource(mts.tile_versions[mode].resource_.get());
     resource_pool_->ReleaseResource(
         mts.tile_versions[mode].resource_.Pass());
+  }
+}
 
-    DCHECK_GE(bytes_releasable_, BytesConsumedIfAllocated(tile));
-    DCHECK_GE(resources_releasable_, 1u);
+void TileManager::DidAcquireTileResource(const ScopedResource* resource) {
+  bytes_releasable_ += resource->bytes();
+  ++resources_releasable_;
 
-    bytes_releasable_ -= BytesConsumedIfAllocated(tile);
-    --resources_releasable_;
+  if (resource->format() != resource_pool_->default_format()) {
+    low_bit_depth_bytes_saved_ += BytesSavedByFormat(resource);
+    ++low_bit_depth_resource_count_;
+  }
+}
+
+void TileManager::DidReleaseTileResource(const ScopedResource* resource) {
+  DCHECK_GE(bytes_releasable_, resource->bytes());
+  DCHECK_GE(resources_releasable_, 1u);
+
+  bytes_releasable_ -= resource->bytes();
+  --resources_releasable_;
+
+  if (resource->format() != resource_pool_->default_format()) {
+    DCHECK_GE(low_bit_depth_bytes_saved_, BytesSavedByFormat(resource));
+    DCHECK_GE(low_bit_depth_resource_count_, 1u);
+
+    low_bit_depth_bytes_saved_ -= BytesSavedByFormat(resource);
+    --low_bit_depth_resource_count_;
   }
 }
 
@@ -813,12 +931,15 @@ void TileManager::ScheduleTasks(
         mts.tile_versions[mts.raster_mode];
 
     DCHECK(tile_version.requires_resource());
-    DCHECK(!tile_version.resource_);
+    DCHECK(!tile_version.resource_ ||
+           tile_version.resource_->format() != mts.resource_format);
 
     if (tile_version.raster_task_.is_null())
       tile_version.raster_task_ = CreateRasterTask(tile);
 
-    tasks.Append(tile_version.raster_task_, tile->required_for_activation());
+    tasks.Append(tile_version.raster_task_,
+                 tile->required_for_activation(),
+                 TaskLaneFromManagedTileState(mts));
   }
 
   // We must reduce the amount of unused resoruces before calling
@@ -849,7 +970,8 @@ RasterWorkerPool::RasterTask TileManager::CreateRasterTask(Tile* tile) {
   ManagedTileState& mts = tile->managed_state();
 
   scoped_ptr<ScopedResource> resource =
-      resource_pool_->AcquireResource(tile->tile_size_.size());
+      resource_pool_->AcquireResource(tile->tile_size_.size(),
+                                      mts.resource_format);
   const ScopedResource* const_resource = resource.get();
 
   // Create and queue all image decode tasks that this tile depends on.
@@ -946,6 +1068,10 @@ void TileManager::OnRasterTaskCompleted(
 
   ++update_visible_tiles_stats_.completed_count;
 
+  // Release the resource that this version was drawn from so far, if any.
+  // This is the case when the tile was rastered again to upgrade its format.
+  FreeResourceForTile(tile, raster_mode);
+
   tile_version.set_has_text(analysis.has_text);
   if (analysis.is_solid_color) {
     tile_version.set_solid_color(analysis.solid_color);
@@ -954,8 +1080,7 @@ void TileManager::OnRasterTaskCompleted(
     tile_version.set_use_resource();
     tile_version.resource_ = resource.Pass();
 
-    bytes_releasable_ += BytesConsumedIfAllocated(tile);
-    ++resources_releasable_;
+    DidAcquireTileResource(tile_version.resource_.get());
   }
 
   FreeUnusedResourcesForTile(tile);
@@ -57,7 +57,8 @@ class CC_EXPORT TileManager : public RasterWorkerPoolClient,
       bool use_map_image,
       size_t max_transfer_buffer_usage_bytes,
       size_t max_raster_usage_bytes,
-      GLenum map_image_texture_target);
+      GLenum map_image_texture_target,
+      bool use_low_bit_depth_tiles);
   virtual ~TileManager();
 
   void ManageTiles(const GlobalStateThatImpactsTilePriority& state);
@@ -85,21 +86,37 @@ class CC_EXPORT TileManager : public RasterWorkerPoolClient,
     return memory_stats_from_last_assign_;
   }
 
+  // Bytes saved by tiles that are currently rastered into a low bit depth
+  // format because memory was constrained.
+  size_t low_bit_depth_bytes_saved() const {
+    return low_bit_depth_bytes_saved_;
+  }
+  bool memory_constrained() const { return memory_constrained_; }
+
   void InitializeTilesWithResourcesForTesting(
       const std::vector<Tile*>& tiles,
       ResourceProvider* resource_provider) {
+    InitializeTilesWithResourcesForTesting(
+        tiles, resource_provider, resource_pool_->default_format());
+  }
+  void InitializeTilesWithResourcesForTesting(
+      const std::vector<Tile*>& tiles,
+      ResourceProvider* resource_provider,
+      ResourceFormat format) {
     for (size_t i = 0; i < tiles.size(); ++i) {
       ManagedTileState& mts = tiles[i]->managed_state();
       ManagedTileState::TileVersion& tile_version =
           mts.tile_versions[HIGH_QUALITY_NO_LCD_RASTER_MODE];
 
       tile_version.resource_ = resource_pool_->AcquireResource(
-          gfx::Size(1, 1));
+          gfx::Size(1, 1), format);
 
-      bytes_releasable_ += BytesConsumedIfAllocated(tiles[i]);
-      ++resources_releasable_;
+      DidAcquireTileResource(tile_version.resource_.get());
     }
   }
+  void SetUseLowBitDepthTilesForTesting(bool use_low_bit_depth_tiles) {
+    use_low_bit_depth_tiles_ = use_low_bit_depth_tiles;
+  }
   RasterWorkerPool* RasterWorkerPoolForTesting() {
     return raster_worker_pool_.get();
   }
@@ -122,7 +139,8 @@ class CC_EXPORT TileManager : public RasterWorkerPoolClient,
               scoped_ptr<RasterWorkerPool> raster_worker_pool,
               size_t num_raster_threads,
               size_t max_raster_usage_bytes,
-              RenderingStatsInstrumentation* rendering_stats_instrumentation);
+              RenderingStatsInstrumentation* rendering_stats_instrumentation,
+              bool use_low_bit_depth_tiles);
 
   // Methods called by Tile
   friend class Tile;
@@ -162,12 +180,25 @@ class CC_EXPORT TileManager : public RasterWorkerPoolClient,
                              const PicturePileImpl::Analysis& analysis,
                              bool was_canceled);
 
+  inline size_t BytesConsumedIfAllocated(const Tile* tile,
+                                         ResourceFormat format) const {
+    return Resource::MemorySizeBytes(tile->size(), format);
+  }
   inline size_t BytesConsumedIfAllocated(const Tile* tile) const {
-    return Resource::MemorySizeBytes(tile->size(),
-                                     raster_worker_pool_->GetResourceFormat());
+    return BytesConsumedIfAllocated(tile, resource_pool_->default_format());
+  }
+  inline size_t BytesSavedByFormat(const Resource* resource) const {
+    return Resource::MemorySizeBytes(resource->size(),
+                                     resource_pool_->default_format()) -
+           resource->bytes();
   }
 
   RasterMode DetermineRasterMode(const Tile* tile) const;
+  ResourceFormat DetermineResourceFormat(const Tile* tile) const;
+  bool NeedsFormatUpgrade(const ManagedTileState::TileVersion& tile_version,
+                          ResourceFormat format) const;
+  void DidAcquireTileResource(const ScopedResource* resource);
+  void DidReleaseTileResource(const ScopedResource* resource);
   void FreeResourceForTile(Tile* tile, RasterMode mode);
   void FreeResourcesForTile(Tile* tile);
   void FreeUnusedResourcesForTile(Tile* tile);
@@ -198,6 +229,14 @@ class CC_EXPORT TileManager : public RasterWorkerPoolClient,
   size_t resources_releasable_;
   size_t max_raster_usage_bytes_;
 
+  // True while tiles of low priority are rastered into low bit depth
+  // formats to reduce memory usage. Never set unless
+  // |use_low_bit_depth_tiles_|.
+  bool use_low_bit_depth_tiles_;
+  bool memory_constrained_;
+  size_t low_bit_depth_bytes_saved_;
+  size_t low_bit_depth_resource_count_;
+
   bool ever_exceeded_memory_budget_;
   MemoryHistory::Entry memory_stats_from_last_assign_;
 
@@ -2,6 +2,8 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <algorithm>
+
 #include "cc/resources/tile.h"
 #include "cc/resources/tile_priority.h"
 #include "cc/test/fake_output_surface.h"
@@ -103,10 +105,42 @@ class TileManagerTest : public testing::TestWithParam<bool> {
                                settings_.default_tile_size);
   }
 
+  // Creates tiles that cover the full tile with |opaque_rect| and don't use
+  // LCD text, so that they are rastered in HIGH_QUALITY_NO_LCD_RASTER_MODE.
+  TileVector CreateTilesWithOpaqueRect(int count,
+                                       TilePriority active_priority,
+                                       TilePriority pending_priority,
+                                       gfx::Rect opaque_rect) {
+    TileVector tiles;
+    for (int i = 0; i < count; ++i) {
+      scoped_refptr<Tile> tile =
+          tile_manager_->CreateTile(picture_pile_.get(),
+                                    settings_.default_tile_size,
+                                    TileRect(),
+                                    opaque_rect,
+                                    1.0,
+                                    0,
+                                    0,
+                                    0);
+      tile->SetPriority(ACTIVE_TREE, active_priority);
+      tile->SetPriority(PENDING_TREE, pending_priority);
+      tiles.push_back(tile);
+    }
+    return tiles;
+  }
+
+  gfx::Rect TileRect() const {
+    return gfx::Rect(settings_.default_tile_size);
+  }
+
   FakeTileManager* tile_manager() {
     return tile_manager_.get();
   }
 
+  ResourceProvider* resource_provider() {
+    return resource_provider_.get();
+  }
+
   int AssignedMemoryCount(const TileVector& tiles) {
     int has_memory_count = 0;
     for (TileVector::const_iterator it = tiles.begin();
@@ -118,6 +152,31 @@ class TileManagerTest : public testing::TestWithParam<bool> {
     return has_memory_count;
   }
 
+  int TilesWithResourceFormatCount(const TileVector& tiles,
+                                   ResourceFormat format) {
+    int format_count = 0;
+    for (TileVector::const_iterator it = tiles.begin();
+         it != tiles.end();
+         ++it) {
+      if ((*it)->managed_state().resource_format == format)
+        ++format_count;
+    }
+    return format_count;
+  }
+
+  int TilesForRasterCount(const TileVector& tiles) {
+    int raster_count = 0;
+    for (TileVector::const_iterator it = tiles.begin();
+         it != tiles.end();
+         ++it) {
+      if (std::find(tile_manager_->tiles_for_raster.begin(),
+                    tile_manager_->tiles_for_raster.end(),
+                    it->get()) != tile_manager_->tiles_for_raster.end())
+        ++raster_count;
+    }
+    return raster_count;
+  }
+
   int TilesWithLCDCount(const TileVector& tiles) {
     int has_lcd_count = 0;
     for (TileVector::const_iterator it = tiles.begin();
@@ -520,6 +579,114 @@ TEST_P(TileManagerTest, RespectMemoryLimit) {
   EXPECT_LE(memory_allocated_bytes, global_state_.memory_limit_in_bytes);
 }
 
+TEST_P(TileManagerTest, LowBitDepthTilesDisabledByDefault) {
+  // Without the setting, a restrictive memory policy doesn't change the
+  // resource format of any tile.
+
+  Initialize(10, ALLOW_PREPAINT_ONLY, SMOOTHNESS_TAKES_PRIORITY);
+  TileVector active_soon = CreateTilesWithOpaqueRect(
+      3, TilePriorityForSoonBin(), TilePriority(), TileRect());
+
+  tile_manager()->AssignMemoryToTiles(global_state_);
+  tile_manager()->AssignMemoryToTiles(global_state_);
+
+  ResourceFormat default_format =
+      tile_manager()->RasterWorkerPoolForTesting()->GetResourceFormat();
+  EXPECT_FALSE(tile_manager()->memory_constrained());
+  EXPECT_EQ(3, TilesWithResourceFormatCount(active_soon, default_format));
+}
+
+TEST_P(TileManagerTest, LowBitDepthFormatForOpaqueTilesNotNeededNow) {
+  // A restrictive memory policy makes opaque tiles outside the NOW bin use
+  // the low bit depth format. Tiles needed now and tiles that are not
+  // opaque keep the default format.
+
+  Initialize(20, ALLOW_PREPAINT_ONLY, SMOOTHNESS_TAKES_PRIORITY);
+  tile_manager()->SetUseLowBitDepthTilesForTesting(true);
+  TileVector active_now = CreateTilesWithOpaqueRect(
+      3, TilePriorityForNowBin(), TilePriority(), TileRect());
+  TileVector active_soon = CreateTilesWithOpaqueRect(
+      3, TilePriorityForSoonBin(), TilePriority(), TileRect());
+  TileVector active_soon_translucent = CreateTilesWithOpaqueRect(
+      3, TilePriorityForSoonBin(), TilePriority(), gfx::Rect());
+
+  // The first pass picks up the memory policy, the second one uses it.
+  tile_manager()->AssignMemoryToTiles(global_state_);
+  EXPECT_TRUE(tile_manager()->memory_constrained());
+  tile_manager()->AssignMemoryToTiles(global_state_);
+  EXPECT_TRUE(tile_manager()->memory_constrained());
+
+  ResourceFormat default_format =
+      tile_manager()->RasterWorkerPoolForTesting()->GetResourceFormat();
+  ResourceFormat low_bit_depth_format =
+      tile_manager()->RasterWorkerPoolForTesting()
+          ->GetLowBitDepthResourceFormat();
+  EXPECT_EQ(3, TilesWithResourceFormatCount(active_now, default_format));
+  EXPECT_EQ(3, TilesWithResourceFormatCount(active_soon,
+                                            low_bit_depth_format));
+  EXPECT_EQ(3, TilesWithResourceFormatCount(active_soon_translucent,
+                                            default_format));
+
+  // Once the policy allows anything again, all tiles go back to the default
+  // format.
+  global_state_.memory_limit_policy = ALLOW_ANYTHING;
+  tile_manager()->AssignMemoryToTiles(global_state_);
+  EXPECT_FALSE(tile_manager()->memory_constrained());
+  tile_manager()->AssignMemoryToTiles(global_state_);
+  EXPECT_EQ(3, TilesWithResourceFormatCount(active_soon, default_format));
+}
+
+TEST_P(TileManagerTest, PrepaintOutOfMemoryIsNotMemoryConstrained) {
+  // Prepaint tiles that don't fit into the budget are expected and must not
+  // switch to low bit depth formats.
+
+  Initialize(5, ALLOW_ANYTHING, SMOOTHNESS_TAKES_PRIORITY);
+  tile_manager()->SetUseLowBitDepthTilesForTesting(true);
+  TileVector active_now = CreateTilesWithOpaqueRect(
+      3, TilePriorityForNowBin(), TilePriority(), TileRect());
+  TileVector active_eventually = CreateTilesWithOpaqueRect(
+      10, TilePriorityForEventualBin(), TilePriority(), TileRect());
+
+  tile_manager()->AssignMemoryToTiles(global_state_);
+
+  EXPECT_EQ(3, AssignedMemoryCount(active_now));
+  EXPECT_GT(10, AssignedMemoryCount(active_eventually));
+  EXPECT_FALSE(tile_manager()->memory_constrained());
+
+  // Tiles needed now that don't fit do count.
+  TileVector more_active_now = CreateTilesWithOpaqueRect(
+      5, TilePriorityForNowBin(), TilePriority(), TileRect());
+
+  tile_manager()->AssignMemoryToTiles(global_state_);
+
+  EXPECT_TRUE(tile_manager()->memory_constrained());
+}
+
+TEST_P(TileManagerTest, LowBitDepthNowTilesAreUpgradedImmediately) {
+  // Tiles that enter the NOW bin with a low bit depth resource are rastered
+  // again at the default format even while memory is constrained. They keep
+  // their old resource until the new one is ready.
+
+  Initialize(10, ALLOW_PREPAINT_ONLY, SMOOTHNESS_TAKES_PRIORITY);
+  tile_manager()->SetUseLowBitDepthTilesForTesting(true);
+  TileVector active_now = CreateTilesWithOpaqueRect(
+      3, TilePriorityForNowBin(), TilePriority(), TileRect());
+
+  std::vector<Tile*> tiles;
+  for (size_t i = 0; i < active_now.size(); ++i)
+    tiles.push_back(active_now[i].get());
+  tile_manager()->InitializeTilesWithResourcesForTesting(
+      tiles, resource_provider(), RGB_565);
+
+  tile_manager()->AssignMemoryToTiles(global_state_);
+
+  EXPECT_TRUE(tile_manager()->memory_constrained());
+  EXPECT_EQ(3, AssignedMemoryCount(active_now));
+  EXPECT_EQ(3, TilesForRasterCount(active_now));
+  for (size_t i = 0; i < active_now.size(); ++i)
+    EXPECT_TRUE(active_now[i]->IsReadyToDraw());
+}
+
 // If true, the max tile limit should be applied as bytes; if false,
 // as num_resources_limit.
 INSTANTIATE_TEST_CASE_P(TileManagerTests,
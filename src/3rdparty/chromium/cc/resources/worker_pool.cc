@@ -5,7 +5,7 @@
 #include "cc/resources/worker_pool.h"
 
 #include <algorithm>
-#include <queue>
+#include <deque>
 
 #include "base/bind.h"
 #include "base/containers/hash_tables.h"
@@ -15,6 +15,7 @@
 #include "base/threading/simple_thread.h"
 #include "base/threading/thread_restrictions.h"
 #include "cc/base/scoped_ptr_deque.h"
+#include "cc/base/scoped_ptr_vector.h"
 
 namespace cc {
 
@@ -68,17 +69,42 @@ bool WorkerPoolTask::HasCompleted() const {
 GraphNode::GraphNode(internal::WorkerPoolTask* task, unsigned priority)
     : task_(task),
       priority_(priority),
+      lane_(NOW_TASK_LANE),
       num_dependencies_(0) {
 }
 
 GraphNode::~GraphNode() {
 }
 
+// static
+bool GraphNode::RunsBefore(const GraphNode* a, const GraphNode* b) {
+  if (a->lane() != b->lane())
+    return a->lane() < b->lane();
+
+  // In this system, numerically lower priority is run first.
+  if (a->priority() != b->priority())
+    return a->priority() < b->priority();
+
+  return a->dependents().size() > b->dependents().size();
+}
+
 }  // namespace internal
 
 // Internal to the worker pool. Any data or logic that needs to be
 // shared between threads lives in this class. All members are guarded
-// by |lock_|.
+// by |lock_| except the ready to run queues of the worker threads.
+//
+// Each worker thread has its own ready to run deques, one per lane,
+// guarded by a lock of their own. A worker runs the top priority task of
+// its own deque and steals from the other workers when that deque is
+// empty, before looking at the next lane. Tasks that become ready when a
+// dependency finishes are queued on the worker that ran the dependency,
+// so image decodes and the raster work using them stay on one thread.
+//
+// Rescheduling only queues the tasks that became ready or got a new
+// priority or lane. Queue entries of tasks that got canceled or
+// requeued are left behind and dropped when a worker takes them, the
+// entry still matching |queued_tasks_| is the one that runs.
 class WorkerPool::Inner : public base::DelegateSimpleThread::Delegate {
  public:
   Inner(size_t num_threads, const std::string& thread_name_prefix);
@@ -98,25 +124,64 @@ class WorkerPool::Inner : public base::DelegateSimpleThread::Delegate {
   void CollectCompletedTasks(TaskVector* completed_tasks);
 
  private:
-  class PriorityComparator {
-   public:
-    bool operator()(const internal::GraphNode* a,
-                    const internal::GraphNode* b) {
+  // A queued ready to run task. Only the entry with the sequence number
+  // recorded in |queued_tasks_| is valid.
+  struct QueueEntry {
+    QueueEntry() : task(NULL), priority(0), num_dependents(0), sequence(0) {}
+    QueueEntry(const internal::GraphNode* node, unsigned sequence)
+        : task(node->task()),
+          priority(node->priority()),
+          num_dependents(node->dependents().size()),
+          sequence(sequence) {}
+
+    // Returns true if |this| should run before |other|.
+    bool RunsBefore(const QueueEntry& other) const {
       // In this system, numerically lower priority is run first.
-      if (a->priority() != b->priority())
-        return a->priority() > b->priority();
+      if (priority != other.priority)
+        return priority < other.priority;
 
       // Run task with most dependents first when priority is the same.
-      return a->dependents().size() < b->dependents().size();
+      return num_dependents > other.num_dependents;
     }
+
+    internal::WorkerPoolTask* task;
+    unsigned priority;
+    size_t num_dependents;
+    unsigned sequence;
+  };
+  typedef std::deque<QueueEntry> TaskDeque;
+
+  // The ready to run tasks of one worker thread, ordered by priority.
+  struct WorkerQueues {
+    base::Lock lock;
+    TaskDeque lanes[NUM_TASK_LANES];
+  };
+
+  struct QueuedTask {
+    unsigned sequence;
+    unsigned priority;
+    TaskLane lane;
   };
+  typedef base::hash_map<internal::WorkerPoolTask*, QueuedTask>
+      QueuedTaskMap;
 
   // Overridden from base::DelegateSimpleThread:
   virtual void Run() OVERRIDE;
 
+  // Queues |node| on the worker with |worker_index|. Requires |lock_|.
+  void QueueReadyTask(const internal::GraphNode* node, unsigned worker_index);
+
+  // Invalidates the queue entry of |task|, if any. Requires |lock_|.
+  void DequeueReadyTask(internal::WorkerPoolTask* task);
+
+  // Takes the top priority entry of the lowest lane that is non-empty on
+  // any worker, preferring the worker with |worker_index|. Must be called
+  // without holding |lock_|. Returns false if all queues are empty.
+  bool TakeQueueEntry(unsigned worker_index, QueueEntry* entry);
+
   // This lock protects all members of this class except
-  // |worker_pool_on_origin_thread_|. Do not read or modify anything
-  // without holding this lock. Do not block while holding this lock.
+  // |worker_queues_|. Do not read or modify anything without holding
+  // this lock. Do not block while holding this lock.
   mutable base::Lock lock_;
 
   // Condition variable that is waited on by worker threads until new
@@ -134,11 +199,20 @@ class WorkerPool::Inner : public base::DelegateSimpleThread::Delegate {
   // This set contains all pending tasks.
   GraphNodeMap pending_tasks_;
 
-  // Ordered set of tasks that are ready to run.
-  typedef std::priority_queue<internal::GraphNode*,
-                              std::vector<internal::GraphNode*>,
-                              PriorityComparator> TaskQueue;
-  TaskQueue ready_to_run_tasks_;
+  // Ready to run deques of each worker thread. Each is guarded by its own
+  // lock, which can be acquired while holding |lock_| but not the other
+  // way around.
+  ScopedPtrVector<WorkerQueues> worker_queues_;
+
+  // Pending tasks without dependencies left, with their valid queue entry.
+  QueuedTaskMap queued_tasks_;
+
+  // Sequence number of the next queue entry.
+  unsigned next_sequence_;
+
+  // Bumped every time a task is queued, lets a worker that found the
+  // queues empty tell whether it can wait.
+  unsigned queue_generation_;
 
   // This set contains all currently running tasks.
   GraphNodeMap running_tasks_;
@@ -156,9 +230,15 @@ WorkerPool::Inner::Inner(
     : lock_(),
       has_ready_to_run_tasks_cv_(&lock_),
       next_thread_index_(0),
-      shutdown_(false) {
+      shutdown_(false),
+      next_sequence_(0),
+      queue_generation_(0) {
   base::AutoLock lock(lock_);
 
+  do {
+    worker_queues_.push_back(make_scoped_ptr(new WorkerQueues));
+  } while (worker_queues_.size() < num_threads);
+
   while (workers_.size() < num_threads) {
     scoped_ptr<base::DelegateSimpleThread> worker = make_scoped_ptr(
         new base::DelegateSimpleThread(
@@ -181,7 +261,7 @@ WorkerPool::Inner::~Inner() {
   DCHECK(shutdown_);
 
   DCHECK_EQ(0u, pending_tasks_.size());
-  DCHECK_EQ(0u, ready_to_run_tasks_.size());
+  DCHECK_EQ(0u, queued_tasks_.size());
   DCHECK_EQ(0u, running_tasks_.size());
   DCHECK_EQ(0u, completed_tasks_.size());
 }
@@ -213,7 +293,7 @@ void WorkerPool::Inner::SetTaskGraph(TaskGraph* graph) {
 
   GraphNodeMap new_pending_tasks;
   GraphNodeMap new_running_tasks;
-  TaskQueue new_ready_to_run_tasks;
+  std::vector<const internal::GraphNode*> new_ready_to_run_tasks;
 
   new_pending_tasks.swap(*graph);
 
@@ -249,8 +329,8 @@ void WorkerPool::Inner::SetTaskGraph(TaskGraph* graph) {
       new_running_tasks.set(task, new_pending_tasks.take_and_erase(task));
     }
 
-    // Build new "ready to run" tasks queue.
-    // TODO(reveman): Create this queue when building the task graph instead.
+    // Only queue the tasks that weren't queued yet, or whose priority or
+    // lane changed. Queued tasks that are no longer ready are dequeued.
     for (GraphNodeMap::iterator it = new_pending_tasks.begin();
          it != new_pending_tasks.end(); ++it) {
       internal::WorkerPoolTask* task = it->first;
@@ -264,8 +344,17 @@ void WorkerPool::Inner::SetTaskGraph(TaskGraph* graph) {
       // Note: This is only for debugging purposes.
       task->DidSchedule();
 
-      if (!node->num_dependencies())
-        new_ready_to_run_tasks.push(node);
+      bool is_ready = !node->num_dependencies();
+      QueuedTaskMap::const_iterator queued_it = queued_tasks_.find(task);
+      if (queued_it != queued_tasks_.end()) {
+        if (is_ready && queued_it->second.priority == node->priority() &&
+            queued_it->second.lane == node->lane())
+          is_ready = false;
+        else
+          DequeueReadyTask(task);
+      }
+      if (is_ready)
+        new_ready_to_run_tasks.push_back(node);
 
       // Erase the task from old pending tasks.
       pending_tasks_.erase(task);
@@ -277,22 +366,29 @@ void WorkerPool::Inner::SetTaskGraph(TaskGraph* graph) {
     for (GraphNodeMap::const_iterator it = pending_tasks_.begin();
          it != pending_tasks_.end();
          ++it) {
+      DequeueReadyTask(it->first);
       completed_tasks_.push_back(it->first);
     }
 
+    // Deal the newly ready tasks out to the workers in priority order, so
+    // that each of them starts with its share of the most urgent work.
+    std::sort(new_ready_to_run_tasks.begin(), new_ready_to_run_tasks.end(),
+              &internal::GraphNode::RunsBefore);
+    for (size_t i = 0; i < new_ready_to_run_tasks.size(); ++i)
+      QueueReadyTask(new_ready_to_run_tasks[i], i % worker_queues_.size());
+
     // Swap task sets.
     // Note: old tasks are intentionally destroyed after releasing |lock_|.
     pending_tasks_.swap(new_pending_tasks);
     running_tasks_.swap(new_running_tasks);
-    std::swap(ready_to_run_tasks_, new_ready_to_run_tasks);
 
-    // If |ready_to_run_tasks_| is empty, it means we either have
+    // If |queued_tasks_| is empty, it means we either have
     // running tasks, or we have no pending tasks.
-    DCHECK(!ready_to_run_tasks_.empty() ||
+    DCHECK(!queued_tasks_.empty() ||
            (pending_tasks_.empty() || !running_tasks_.empty()));
 
     // If there is more work available, wake up worker thread.
-    if (!ready_to_run_tasks_.empty())
+    if (!queued_tasks_.empty())
       has_ready_to_run_tasks_cv_.Signal();
   }
 }
@@ -309,9 +405,10 @@ void WorkerPool::Inner::Run() {
 
   // Get a unique thread index.
   int thread_index = next_thread_index_++;
+  DCHECK_LT(static_cast<size_t>(thread_index), worker_queues_.size());
 
   while (true) {
-    if (ready_to_run_tasks_.empty()) {
+    if (queued_tasks_.empty()) {
       // Exit when shutdown is set and no more tasks are pending.
       if (shutdown_ && pending_tasks_.empty())
         break;
@@ -321,10 +418,32 @@ void WorkerPool::Inner::Run() {
       continue;
     }
 
-    // Take top priority task from |ready_to_run_tasks_|.
-    scoped_refptr<internal::WorkerPoolTask> task(
-        ready_to_run_tasks_.top()->task());
-    ready_to_run_tasks_.pop();
+    // Take the next task from the worker queues, which don't need |lock_|.
+    unsigned queue_generation = queue_generation_;
+    QueueEntry entry;
+    bool has_entry;
+    {
+      base::AutoUnlock unlock(lock_);
+
+      has_entry = TakeQueueEntry(thread_index, &entry);
+    }
+    if (!has_entry) {
+      // Another worker took the last entry but didn't start its task yet.
+      // Wait unless a task got queued or that entry got handled in the
+      // meantime, as its wake-up could have been missed.
+      if (queue_generation == queue_generation_ && !queued_tasks_.empty())
+        has_ready_to_run_tasks_cv_.Wait();
+      continue;
+    }
+
+    // Skip entries of canceled and requeued tasks.
+    QueuedTaskMap::iterator queued_it = queued_tasks_.find(entry.task);
+    if (queued_it == queued_tasks_.end() ||
+        queued_it->second.sequence != entry.sequence)
+      continue;
+    queued_tasks_.erase(queued_it);
+
+    scoped_refptr<internal::WorkerPoolTask> task(entry.task);
 
     // Move task from |pending_tasks_| to |running_tasks_|.
     DCHECK(pending_tasks_.contains(task.get()));
@@ -357,10 +476,10 @@ void WorkerPool::Inner::Run() {
         internal::GraphNode* dependent_node = *it;
 
         dependent_node->remove_dependency();
-        // Task is ready if it has no dependencies. Add it to
-        // |ready_to_run_tasks_|.
+        // Task is ready if it has no dependencies. Add it to the
+        // "ready to run" queue of this worker.
         if (!dependent_node->num_dependencies())
-          ready_to_run_tasks_.push(dependent_node);
+          QueueReadyTask(dependent_node, thread_index);
       }
     }
 
@@ -373,6 +492,56 @@ void WorkerPool::Inner::Run() {
   has_ready_to_run_tasks_cv_.Signal();
 }
 
+void WorkerPool::Inner::QueueReadyTask(const internal::GraphNode* node,
+                                       unsigned worker_index) {
+  lock_.AssertAcquired();
+  DCHECK(!node->num_dependencies());
+
+  QueuedTask& queued = queued_tasks_[node->task()];
+  queued.sequence = next_sequence_++;
+  queued.priority = node->priority();
+  queued.lane = node->lane();
+  ++queue_generation_;
+
+  QueueEntry entry(node, queued.sequence);
+  WorkerQueues* queues = worker_queues_[worker_index];
+  base::AutoLock queue_lock(queues->lock);
+  TaskDeque& deque = queues->lanes[node->lane()];
+  // Most tasks are queued in priority order and end up at the back.
+  TaskDeque::iterator it = deque.end();
+  while (it != deque.begin() && entry.RunsBefore(*(it - 1)))
+    --it;
+  deque.insert(it, entry);
+}
+
+void WorkerPool::Inner::DequeueReadyTask(internal::WorkerPoolTask* task) {
+  lock_.AssertAcquired();
+  // The entry itself stays in its deque until a worker skips it.
+  queued_tasks_.erase(task);
+}
+
+bool WorkerPool::Inner::TakeQueueEntry(unsigned worker_index,
+                                       QueueEntry* entry) {
+  for (unsigned lane = 0; lane < NUM_TASK_LANES; ++lane) {
+    // Look at the own deque first, then steal from the other workers
+    // before running anything of a later lane.
+    for (size_t i = 0; i < worker_queues_.size(); ++i) {
+      WorkerQueues* queues =
+          worker_queues_[(worker_index + i) % worker_queues_.size()];
+      base::AutoLock queue_lock(queues->lock);
+      TaskDeque& deque = queues->lanes[lane];
+      if (deque.empty())
+        continue;
+
+      *entry = deque.front();
+      deque.pop_front();
+      return true;
+    }
+  }
+
+  return false;
+}
+
 WorkerPool::WorkerPool(size_t num_threads,
                        const std::string& thread_name_prefix)
     : in_dispatch_completion_callbacks_(false),
@@ -18,6 +18,17 @@
 #include "cc/base/cc_export.h"
 
 namespace cc {
+
+// Ready to run tasks are grouped into lanes. A ready task in a lower lane
+// always runs before a ready task in a higher lane, priority only orders
+// tasks within the same lane.
+enum TaskLane {
+  NOW_TASK_LANE = 0,
+  SOON_TASK_LANE = 1,
+  EVENTUALLY_TASK_LANE = 2,
+  NUM_TASK_LANES = 3
+};
+
 namespace internal {
 
 class CC_EXPORT WorkerPoolTask
@@ -54,7 +65,7 @@ class CC_EXPORT GraphNode {
   GraphNode(internal::WorkerPoolTask* task, unsigned priority);
   ~GraphNode();
 
-  WorkerPoolTask* task() { return task_; }
+  WorkerPoolTask* task() const { return task_; }
 
   void add_dependent(GraphNode* dependent) {
     DCHECK(dependent);
@@ -64,6 +75,13 @@ class CC_EXPORT GraphNode {
 
   unsigned priority() const { return priority_; }
 
+  TaskLane lane() const { return lane_; }
+  void set_lane(TaskLane lane) { lane_ = lane; }
+
+  // Orders ready to run tasks by lane, then priority, and runs tasks with
+  // more dependents first when those are the same.
+  static bool RunsBefore(const GraphNode* a, const GraphNode* b);
+
   unsigned num_dependencies() const { return num_dependencies_; }
   void add_dependency() { ++num_dependencies_; }
   void remove_dependency() {
@@ -75,6 +93,7 @@ class CC_EXPORT GraphNode {
   WorkerPoolTask* task_;
   Vector dependents_;
   unsigned priority_;
+  TaskLane lane_;
   unsigned num_dependencies_;
 
   DISALLOW_COPY_AND_ASSIGN(GraphNode);
@@ -112,7 +131,8 @@ class CC_EXPORT WorkerPool {
   // A task graph contains a unique set of tasks with edges between
   // dependencies pointing in the direction of the dependents. Each task
   // need to be assigned a unique priority and a run count that matches
-  // the number of dependencies.
+  // the number of dependencies. Tasks are in NOW_TASK_LANE unless a
+  // different lane is set on their node.
   typedef base::ScopedPtrHashMap<internal::WorkerPoolTask*, internal::GraphNode>
       GraphNodeMap;
   typedef GraphNodeMap TaskGraph;
@@ -121,7 +141,9 @@ class CC_EXPORT WorkerPool {
 
   // Schedule running of tasks in |graph|. Any previously scheduled tasks
   // that are not already running will be canceled. Canceled tasks don't run
-  // but completion of them is still processed.
+  // but completion of them is still processed. Only the tasks that became
+  // ready or whose priority or lane changed are queued again, the others
+  // keep their place on their worker thread.
   void SetTaskGraph(TaskGraph* graph);
 
  private:
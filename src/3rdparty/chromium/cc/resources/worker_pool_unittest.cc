@@ -137,6 +137,31 @@ class FakeWorkerPool : public WorkerPool {
   DISALLOW_COPY_AND_ASSIGN(FakeWorkerPool);
 };
 
+// Schedules independent tasks spread over all lanes on several threads.
+class LaneWorkerPool : public WorkerPool {
+ public:
+  typedef std::vector<scoped_refptr<internal::WorkerPoolTask> > TaskVector;
+
+  LaneWorkerPool() : WorkerPool(4, "test") {}
+  virtual ~LaneWorkerPool() {}
+
+  void ScheduleTasks(const TaskVector& tasks, bool reverse_priorities) {
+    TaskGraph new_graph;
+    for (size_t i = 0; i < tasks.size(); ++i) {
+      if (tasks[i]->HasCompleted())
+        continue;
+      scoped_ptr<internal::GraphNode> node(new internal::GraphNode(
+          tasks[i].get(), reverse_priorities ? tasks.size() - i : i));
+      node->set_lane(static_cast<TaskLane>(i % NUM_TASK_LANES));
+      new_graph.set(tasks[i].get(), node.Pass());
+    }
+    SetTaskGraph(&new_graph);
+  }
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(LaneWorkerPool);
+};
+
 class WorkerPoolTest : public testing::Test {
  public:
   WorkerPoolTest() {}
@@ -389,6 +414,32 @@ TEST_F(WorkerPoolTest, Priority) {
   EXPECT_EQ(0u, on_task_completed_ids()[2]);
 }
 
+TEST(WorkerPoolLaneTest, Rescheduling) {
+  LaneWorkerPool worker_pool;
+  LaneWorkerPool::TaskVector tasks;
+  for (unsigned i = 0; i < 256; ++i) {
+    tasks.push_back(make_scoped_refptr(
+        new FakeWorkerPoolTaskImpl(base::Closure(), base::Closure())));
+  }
+
+  // Every round keeps some tasks in place, requeues the ones whose
+  // priority changed and cancels the ones left out.
+  for (unsigned round = 0; round < 32; ++round) {
+    LaneWorkerPool::TaskVector round_tasks(
+        tasks.begin() + round % 4, tasks.end() - round % 8);
+    worker_pool.ScheduleTasks(round_tasks, round % 3 == 0);
+    worker_pool.CheckForCompletedTasks();
+  }
+
+  // Scheduled tasks either ran once or got canceled, completion of all of
+  // them is processed.
+  worker_pool.ScheduleTasks(tasks, false);
+  worker_pool.Shutdown();
+  worker_pool.CheckForCompletedTasks();
+  for (size_t i = 0; i < tasks.size(); ++i)
+    EXPECT_TRUE(tasks[i]->HasCompleted());
+}
+
 }  // namespace
 
 }  // namespace cc
@@ -1128,6 +1128,8 @@ struct SubtreeGlobals {
   const LayerType* page_scale_application_layer;
   bool can_adjust_raster_scales;
   bool can_render_to_separate_surface;
+  bool can_reuse_unchanged_subtrees;
+  int subtree_cache_generation;
 };
 
 template<typename LayerType>
@@ -1170,6 +1172,345 @@ struct DataForRecursion {
   bool subtree_is_visible_from_ancestor;
 };
 
+template <typename LayerType>
+static bool SubtreeGlobalsAreEqual(const SubtreeGlobals<LayerType>& a,
+                                   const SubtreeGlobals<LayerType>& b) {
+  return a.max_texture_size == b.max_texture_size &&
+         a.device_scale_factor == b.device_scale_factor &&
+         a.page_scale_factor == b.page_scale_factor &&
+         a.page_scale_application_layer == b.page_scale_application_layer &&
+         a.can_adjust_raster_scales == b.can_adjust_raster_scales &&
+         a.can_render_to_separate_surface == b.can_render_to_separate_surface;
+}
+
+// The scroll compensation and fixed container are left out as they only
+// affect fixed-position layers, which are never part of a reused subtree.
+template <typename LayerType>
+static bool DataForRecursionIsEqual(const DataForRecursion<LayerType>& a,
+                                    const DataForRecursion<LayerType>& b) {
+  return a.parent_matrix == b.parent_matrix &&
+         a.full_hierarchy_matrix == b.full_hierarchy_matrix &&
+         a.clip_rect_in_target_space == b.clip_rect_in_target_space &&
+         a.clip_rect_of_target_surface_in_target_space ==
+             b.clip_rect_of_target_surface_in_target_space &&
+         a.ancestor_clips_subtree == b.ancestor_clips_subtree &&
+         a.nearest_occlusion_immune_ancestor_surface ==
+             b.nearest_occlusion_immune_ancestor_surface &&
+         a.in_subtree_of_page_scale_application_layer ==
+             b.in_subtree_of_page_scale_application_layer &&
+         a.subtree_can_use_lcd_text == b.subtree_can_use_lcd_text &&
+         a.subtree_is_visible_from_ancestor ==
+             b.subtree_is_visible_from_ancestor;
+}
+
+// What a layer keeps between calculations when
+// CalcDrawPropsInputs::can_reuse_unchanged_subtrees is set. A subtree without
+// render surfaces, scroll or clip relationships, fixed-position, 3d or
+// animating layers has draw properties that depend only on its own layers and
+// on the inputs recorded here. If none of those have changed, the draw
+// properties still stored on its layers are correct, and only the parts of the
+// calculation that touch anything outside the subtree need to be redone.
+template <typename LayerType>
+class SubtreeCache : public SubtreeDrawPropertiesCache {
+ public:
+  enum State {
+    INVALID,
+    // The subtree was skipped and added nothing to any list.
+    SKIPPED,
+    // The subtree was calculated and can be reused.
+    REUSABLE
+  };
+
+  SubtreeCache() : state(INVALID), generation(0) {}
+  virtual ~SubtreeCache() {}
+
+  void SaveInputs(LayerType* layer,
+                  const SubtreeGlobals<LayerType>& globals,
+                  const DataForRecursion<LayerType>& data_from_ancestor) {
+    LayerType* parent = layer->parent();
+    this->globals = globals;
+    this->data_from_ancestor = data_from_ancestor;
+    parent_draw_opacity = parent->draw_opacity();
+    parent_draw_opacity_is_animating = parent->draw_opacity_is_animating();
+    parent_screen_space_opacity_is_animating =
+        parent->screen_space_opacity_is_animating();
+    parent_draw_transform_is_animating =
+        parent->draw_transform_is_animating();
+    parent_screen_space_transform_is_animating =
+        parent->screen_space_transform_is_animating();
+    render_target = parent->render_target();
+    target_surface_clip_rect_is_empty =
+        render_target->render_surface()->clip_rect().IsEmpty();
+  }
+
+  bool InputsMatch(
+      LayerType* layer,
+      const SubtreeGlobals<LayerType>& globals,
+      const DataForRecursion<LayerType>& data_from_ancestor) const {
+    LayerType* parent = layer->parent();
+    return render_target == parent->render_target() &&
+           parent_draw_opacity == parent->draw_opacity() &&
+           parent_draw_opacity_is_animating ==
+               parent->draw_opacity_is_animating() &&
+           parent_screen_space_opacity_is_animating ==
+               parent->screen_space_opacity_is_animating() &&
+           parent_draw_transform_is_animating ==
+               parent->draw_transform_is_animating() &&
+           parent_screen_space_transform_is_animating ==
+               parent->screen_space_transform_is_animating() &&
+           target_surface_clip_rect_is_empty ==
+               render_target->render_surface()->clip_rect().IsEmpty() &&
+           SubtreeGlobalsAreEqual(this->globals, globals) &&
+           DataForRecursionIsEqual(this->data_from_ancestor,
+                                   data_from_ancestor);
+  }
+
+  State state;
+  // The source frame number of the tree when this was recorded. Commits and
+  // activations push properties to layers without noting them as changed.
+  int generation;
+
+  // Inputs to the subtree from outside of it.
+  SubtreeGlobals<LayerType> globals;
+  DataForRecursion<LayerType> data_from_ancestor;
+  float parent_draw_opacity;
+  bool parent_draw_opacity_is_animating;
+  bool parent_screen_space_opacity_is_animating;
+  bool parent_draw_transform_is_animating;
+  bool parent_screen_space_transform_is_animating;
+  LayerType* render_target;
+  bool target_surface_clip_rect_is_empty;
+
+  // The arguments and results of the layer's contents scale update, which is
+  // redone when the subtree is reused.
+  float ideal_contents_scale;
+  float page_scale_factor;
+  bool animating_transform_to_screen;
+  float contents_scale_x;
+  float contents_scale_y;
+  gfx::Size content_bounds;
+
+  // A scroll offset delegate can scroll a layer without it noticing.
+  gfx::Vector2dF scroll_offset;
+
+  // The layer's contributions to its target. If the layer or any of its
+  // descendants was added to the layer list, |drawable_content_rect| (empty
+  // unless the layer draws content) was accumulated into the target surface
+  // after those of its descendants.
+  bool added_to_layer_list;
+  bool accumulated_drawable_content_rect;
+  gfx::Rect drawable_content_rect;
+};
+
+template <typename LayerType>
+static SubtreeCache<LayerType>* GetSubtreeCache(LayerType* layer,
+                                                int generation) {
+  SubtreeCache<LayerType>* cache = static_cast<SubtreeCache<LayerType>*>(
+      layer->draw_properties().subtree_cache.get());
+  if (!cache || cache->state == SubtreeCache<LayerType>::INVALID ||
+      cache->generation != generation)
+    return NULL;
+  return cache;
+}
+
+template <typename LayerType>
+static SubtreeCache<LayerType>* CreateOrReuseSubtreeCache(LayerType* layer,
+                                                          int generation) {
+  if (!layer->draw_properties().subtree_cache) {
+    layer->draw_properties().subtree_cache.reset(
+        new SubtreeCache<LayerType>);
+  }
+  SubtreeCache<LayerType>* cache = static_cast<SubtreeCache<LayerType>*>(
+      layer->draw_properties().subtree_cache.get());
+  cache->generation = generation;
+  return cache;
+}
+
+template <typename LayerType>
+static void InvalidateSubtreeCache(LayerType* layer) {
+  SubtreeCache<LayerType>* cache = static_cast<SubtreeCache<LayerType>*>(
+      layer->draw_properties().subtree_cache.get());
+  if (cache)
+    cache->state = SubtreeCache<LayerType>::INVALID;
+}
+
+template <typename LayerType>
+static void SaveSkippedSubtree(LayerType* layer,
+                               const SubtreeGlobals<LayerType>& globals) {
+  if (!globals.can_reuse_unchanged_subtrees) {
+    InvalidateSubtreeCache(layer);
+    return;
+  }
+  CreateOrReuseSubtreeCache(layer, globals.subtree_cache_generation)->state =
+      SubtreeCache<LayerType>::SKIPPED;
+}
+
+template <typename LayerType>
+static bool SubtreeCanBeReused(LayerType* layer, int generation) {
+  if (IsRootLayer(layer) || layer->render_surface() || layer->mask_layer() ||
+      layer->replica_layer() || layer->preserves_3d() ||
+      layer->scroll_parent() || layer->scroll_children() ||
+      layer->clip_parent() || layer->clip_children() ||
+      layer->draw_properties().has_child_with_a_scroll_parent ||
+      layer->draw_properties().layer_or_descendant_has_copy_request ||
+      layer->position_constraint().is_fixed_position() ||
+      layer->use_parent_backface_visibility() ||
+      layer->TransformIsAnimating() || layer->OpacityIsAnimating() ||
+      layer->HasDelegatedContent() ||
+      layer->HasContributingDelegatedRenderPasses())
+    return false;
+
+  for (size_t i = 0; i < layer->children().size(); ++i) {
+    LayerType* child =
+        LayerTreeHostCommon::get_child_as_raw_ptr(layer->children(), i);
+    if (!GetSubtreeCache(child, generation))
+      return false;
+  }
+  return true;
+}
+
+template <typename LayerType>
+static void SaveReusableSubtree(
+    LayerType* layer,
+    const SubtreeGlobals<LayerType>& globals,
+    const DataForRecursion<LayerType>& data_from_ancestor,
+    float ideal_contents_scale,
+    bool animating_transform_to_screen,
+    const typename LayerType::RenderSurfaceListType& descendants,
+    size_t sorting_start_index) {
+  if (!globals.can_reuse_unchanged_subtrees ||
+      !SubtreeCanBeReused(layer, globals.subtree_cache_generation))
+    return;
+
+  SubtreeCache<LayerType>* cache =
+      CreateOrReuseSubtreeCache(layer, globals.subtree_cache_generation);
+  cache->state = SubtreeCache<LayerType>::REUSABLE;
+  cache->SaveInputs(layer, globals, data_from_ancestor);
+
+  cache->ideal_contents_scale = ideal_contents_scale;
+  cache->page_scale_factor =
+      data_from_ancestor.in_subtree_of_page_scale_application_layer
+          ? globals.page_scale_factor
+          : 1.f;
+  cache->animating_transform_to_screen = animating_transform_to_screen;
+  cache->contents_scale_x = layer->contents_scale_x();
+  cache->contents_scale_y = layer->contents_scale_y();
+  cache->content_bounds = layer->content_bounds();
+  cache->scroll_offset = GetEffectiveTotalScrollOffset(layer);
+
+  cache->added_to_layer_list = sorting_start_index < descendants.size() &&
+                               descendants[sorting_start_index] == layer;
+  cache->accumulated_drawable_content_rect =
+      sorting_start_index != descendants.size();
+  cache->drawable_content_rect =
+      layer->DrawsContent() ? layer->drawable_content_rect() : gfx::Rect();
+}
+
+// Redoes the contents scale updates of a reusable subtree, which have side
+// effects on some layer types, and checks that nothing the cache cannot see
+// has changed. Returns false if the subtree has to be recalculated.
+template <typename LayerType>
+static bool UpdateReusedSubtree(LayerType* layer,
+                                const SubtreeGlobals<LayerType>& globals) {
+  SubtreeCache<LayerType>* cache =
+      GetSubtreeCache(layer, globals.subtree_cache_generation);
+  if (!cache)
+    return false;
+  if (cache->state == SubtreeCache<LayerType>::SKIPPED)
+    return true;
+
+  // Animations can start without changing any layer property.
+  if (layer->TransformIsAnimating() || layer->OpacityIsAnimating() ||
+      GetEffectiveTotalScrollOffset(layer) != cache->scroll_offset)
+    return false;
+
+  UpdateLayerContentsScale(layer,
+                           globals.can_adjust_raster_scales,
+                           cache->ideal_contents_scale,
+                           globals.device_scale_factor,
+                           cache->page_scale_factor,
+                           cache->animating_transform_to_screen);
+  if (layer->contents_scale_x() != cache->contents_scale_x ||
+      layer->contents_scale_y() != cache->contents_scale_y ||
+      layer->content_bounds() != cache->content_bounds)
+    return false;
+
+  for (size_t i = 0; i < layer->children().size(); ++i) {
+    if (!UpdateReusedSubtree(
+            LayerTreeHostCommon::get_child_as_raw_ptr(layer->children(), i),
+            globals))
+      return false;
+  }
+  return true;
+}
+
+// Adds a reused subtree to its target's layer list and drawable content rect
+// the same way CalculateDrawPropertiesInternal would have.
+template <typename LayerType>
+static void AddReusedSubtreeContributions(
+    LayerType* layer,
+    int generation,
+    LayerType* render_target,
+    typename LayerType::RenderSurfaceListType* layer_list,
+    gfx::Rect* target_drawable_content_rect) {
+  SubtreeCache<LayerType>* cache = GetSubtreeCache(layer, generation);
+  DCHECK(cache);
+  if (cache->state == SubtreeCache<LayerType>::SKIPPED)
+    return;
+
+  if (cache->added_to_layer_list)
+    layer_list->push_back(layer);
+
+  for (size_t i = 0; i < layer->children().size(); ++i) {
+    AddReusedSubtreeContributions(
+        LayerTreeHostCommon::get_child_as_raw_ptr(layer->children(), i),
+        generation,
+        render_target,
+        layer_list,
+        target_drawable_content_rect);
+  }
+
+  if (cache->accumulated_drawable_content_rect) {
+    gfx::Rect rect = *target_drawable_content_rect;
+    rect.Union(cache->drawable_content_rect);
+    if (render_target->is_clipped())
+      rect.Intersect(render_target->clip_rect());
+    target_drawable_content_rect->Union(rect);
+  }
+}
+
+template <typename LayerType>
+static bool ReuseUnchangedSubtree(
+    LayerType* layer,
+    const SubtreeGlobals<LayerType>& globals,
+    const DataForRecursion<LayerType>& data_from_ancestor,
+    typename LayerType::RenderSurfaceListType* layer_list,
+    std::vector<AccumulatedSurfaceState<LayerType> >*
+        accumulated_surface_state) {
+  if (!globals.can_reuse_unchanged_subtrees || IsRootLayer(layer) ||
+      layer->draw_properties().subtree_property_changed)
+    return false;
+
+  SubtreeCache<LayerType>* cache =
+      GetSubtreeCache(layer, globals.subtree_cache_generation);
+  if (!cache || cache->state != SubtreeCache<LayerType>::REUSABLE ||
+      !cache->InputsMatch(layer, globals, data_from_ancestor))
+    return false;
+
+  if (!UpdateReusedSubtree(layer, globals))
+    return false;
+
+  LayerType* render_target = layer->parent()->render_target();
+  DCHECK_EQ(render_target, accumulated_surface_state->back().render_target);
+  AddReusedSubtreeContributions(
+      layer,
+      globals.subtree_cache_generation,
+      render_target,
+      layer_list,
+      &accumulated_surface_state->back().drawable_content_rect);
+  return true;
+}
+
 template <typename LayerType>
 static LayerType* GetChildContainingLayer(const LayerType& parent,
                                           LayerType* layer) {
@@ -1448,9 +1789,22 @@ static void CalculateDrawPropertiesInternal(
   if (!IsRootLayer(layer) && SubtreeShouldBeSkipped(layer, layer_is_visible)) {
     if (layer->render_surface())
       layer->ClearRenderSurface();
+    SaveSkippedSubtree(layer, globals);
     return;
   }
 
+  if (ReuseUnchangedSubtree(layer,
+                            globals,
+                            data_from_ancestor,
+                            layer_list,
+                            accumulated_surface_state))
+    return;
+
+  // The subtree is recalculated from here on, so anything saved for it from
+  // the previous calculation is stale.
+  InvalidateSubtreeCache(layer);
+  layer->draw_properties().subtree_property_changed = false;
+
   // We need to circumvent the normal recursive flow of information for clip
   // children (they don't inherit their direct ancestor's clip information).
   // This is unfortunate, and would be unnecessary if we were to formally
@@ -2103,6 +2457,14 @@ static void CalculateDrawPropertiesInternal(
 
   SavePaintPropertiesLayer(layer);
 
+  SaveReusableSubtree(layer,
+                      globals,
+                      data_from_ancestor,
+                      ideal_contents_scale,
+                      animating_transform_to_screen,
+                      descendants,
+                      sorting_start_index);
+
   // If neither this layer nor any of its children were added, early out.
   if (sorting_start_index == descendants.size()) {
     DCHECK(!layer->render_surface() || IsRootLayer(layer));
@@ -2153,6 +2515,10 @@ void LayerTreeHostCommon::CalculateDrawProperties(
   globals.can_render_to_separate_surface =
       inputs->can_render_to_separate_surface;
   globals.can_adjust_raster_scales = inputs->can_adjust_raster_scales;
+  // Layers do not record their changes on the main thread.
+  DCHECK(!inputs->can_reuse_unchanged_subtrees);
+  globals.can_reuse_unchanged_subtrees = false;
+  globals.subtree_cache_generation = 0;
 
   DataForRecursion<Layer> data_for_recursion;
   data_for_recursion.parent_matrix = scaled_device_transform;
@@ -2211,6 +2577,9 @@ void LayerTreeHostCommon::CalculateDrawProperties(
   globals.can_render_to_separate_surface =
       inputs->can_render_to_separate_surface;
   globals.can_adjust_raster_scales = inputs->can_adjust_raster_scales;
+  globals.can_reuse_unchanged_subtrees = inputs->can_reuse_unchanged_subtrees;
+  globals.subtree_cache_generation =
+      inputs->root_layer->layer_tree_impl()->source_frame_number();
 
   DataForRecursion<LayerImpl> data_for_recursion;
   data_for_recursion.parent_matrix = scaled_device_transform;
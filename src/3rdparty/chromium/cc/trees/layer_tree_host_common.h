@@ -52,6 +52,7 @@ class CC_EXPORT LayerTreeHostCommon {
           can_use_lcd_text(can_use_lcd_text),
           can_render_to_separate_surface(can_render_to_separate_surface),
           can_adjust_raster_scales(can_adjust_raster_scales),
+          can_reuse_unchanged_subtrees(false),
           render_surface_layer_list(render_surface_layer_list) {}
 
     LayerType* root_layer;
@@ -64,6 +65,11 @@ class CC_EXPORT LayerTreeHostCommon {
     bool can_use_lcd_text;
     bool can_render_to_separate_surface;
     bool can_adjust_raster_scales;
+    // When true, subtrees whose layers and inputs have not changed since the
+    // previous calculation keep the draw properties computed then instead of
+    // being recalculated. Only supported for LayerImpl trees, whose layers
+    // record their own changes.
+    bool can_reuse_unchanged_subtrees;
     RenderSurfaceLayerListType* render_surface_layer_list;
   };
 
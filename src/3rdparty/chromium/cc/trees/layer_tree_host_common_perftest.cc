@@ -109,10 +109,21 @@ class CalcDrawPropsMainTest : public LayerTreeHostCommonPerfTest {
 
 class CalcDrawPropsImplTest : public LayerTreeHostCommonPerfTest {
  public:
+  CalcDrawPropsImplTest()
+      : move_one_layer_(false), can_reuse_unchanged_subtrees_(false) {}
+
   void RunCalcDrawProps() {
     RunTestWithImplSidePainting();
   }
 
+  // Moves the last layer of the tree before every calculation, so that only
+  // the subtrees containing it need to be recalculated.
+  void RunCalcDrawPropsWithOneLayerMoving(bool can_reuse_unchanged_subtrees) {
+    move_one_layer_ = true;
+    can_reuse_unchanged_subtrees_ = can_reuse_unchanged_subtrees;
+    RunTestWithImplSidePainting();
+  }
+
   virtual void BeginTest() OVERRIDE {
     PostSetNeedsCommitToMainThread();
   }
@@ -121,7 +132,21 @@ class CalcDrawPropsImplTest : public LayerTreeHostCommonPerfTest {
     timer_.Reset();
     LayerTreeImpl* active_tree = host_impl->active_tree();
 
+    LayerImpl* moving_layer = NULL;
+    if (move_one_layer_) {
+      moving_layer = active_tree->root_layer();
+      while (!moving_layer->children().empty())
+        moving_layer = moving_layer->children().back();
+    }
+    float offset = 1.f;
+
     do {
+      if (moving_layer) {
+        moving_layer->SetPosition(moving_layer->position() +
+                                  gfx::Vector2dF(offset, 0.f));
+        offset = -offset;
+      }
+
       bool can_render_to_separate_surface = true;
       int max_texture_size = 8096;
       LayerImplList update_list;
@@ -137,6 +162,7 @@ class CalcDrawPropsImplTest : public LayerTreeHostCommonPerfTest {
           can_render_to_separate_surface,
           host_impl->settings().layer_transforms_should_scale_layer_contents,
           &update_list);
+      inputs.can_reuse_unchanged_subtrees = can_reuse_unchanged_subtrees_;
       LayerTreeHostCommon::CalculateDrawProperties(&inputs);
 
       timer_.NextLap();
@@ -144,6 +170,10 @@ class CalcDrawPropsImplTest : public LayerTreeHostCommonPerfTest {
 
     EndTest();
   }
+
+ private:
+  bool move_one_layer_;
+  bool can_reuse_unchanged_subtrees_;
 };
 
 TEST_F(CalcDrawPropsMainTest, TenTen) {
@@ -182,6 +212,30 @@ TEST_F(CalcDrawPropsImplTest, HeavyPage) {
   RunCalcDrawProps();
 }
 
+TEST_F(CalcDrawPropsImplTest, TenTenOneLayerMoving) {
+  SetTestName("10_10_one_layer_moving");
+  ReadTestFile("10_10_layer_tree");
+  RunCalcDrawPropsWithOneLayerMoving(false);
+}
+
+TEST_F(CalcDrawPropsImplTest, TenTenOneLayerMovingReuseSubtrees) {
+  SetTestName("10_10_one_layer_moving_reuse_subtrees");
+  ReadTestFile("10_10_layer_tree");
+  RunCalcDrawPropsWithOneLayerMoving(true);
+}
+
+TEST_F(CalcDrawPropsImplTest, HeavyPageOneLayerMoving) {
+  SetTestName("heavy_page_one_layer_moving");
+  ReadTestFile("heavy_layer_tree");
+  RunCalcDrawPropsWithOneLayerMoving(false);
+}
+
+TEST_F(CalcDrawPropsImplTest, HeavyPageOneLayerMovingReuseSubtrees) {
+  SetTestName("heavy_page_one_layer_moving_reuse_subtrees");
+  ReadTestFile("heavy_layer_tree");
+  RunCalcDrawPropsWithOneLayerMoving(true);
+}
+
 TEST_F(CalcDrawPropsImplTest, TouchRegionLight) {
   SetTestName("touch_region_light");
   ReadTestFile("touch_region_light");
@@ -9745,5 +9745,104 @@ TEST_F(LayerTreeHostCommonTest, ScrollCompensationWithRounding) {
   }
 }
 
+
+TEST_F(LayerTreeHostCommonTest, ReusedSubtreesMatchFullCalculation) {
+  FakeImplProxy proxy;
+  FakeLayerTreeHostImpl host_impl(&proxy);
+  gfx::Transform identity_matrix;
+
+  scoped_ptr<LayerImpl> root = LayerImpl::Create(host_impl.active_tree(), 1);
+  SetLayerPropertiesForTesting(root.get(),
+                               identity_matrix,
+                               identity_matrix,
+                               gfx::PointF(),
+                               gfx::PointF(),
+                               gfx::Size(100, 100),
+                               false);
+  for (int i = 0; i < 2; ++i) {
+    scoped_ptr<LayerImpl> parent =
+        LayerImpl::Create(host_impl.active_tree(), 2 + 2 * i);
+    SetLayerPropertiesForTesting(parent.get(),
+                                 identity_matrix,
+                                 identity_matrix,
+                                 gfx::PointF(),
+                                 gfx::PointF(10.f + 40.f * i, 10.f),
+                                 gfx::Size(30, 30),
+                                 false);
+    parent->SetDrawsContent(true);
+    scoped_ptr<LayerImpl> child =
+        LayerImpl::Create(host_impl.active_tree(), 3 + 2 * i);
+    SetLayerPropertiesForTesting(child.get(),
+                                 identity_matrix,
+                                 identity_matrix,
+                                 gfx::PointF(),
+                                 gfx::PointF(5.f, 5.f),
+                                 gfx::Size(10, 10),
+                                 false);
+    child->SetDrawsContent(true);
+    parent->AddChild(child.Pass());
+    root->AddChild(parent.Pass());
+  }
+  LayerImpl* second_child = root->children()[1]->children()[0];
+
+  {
+    LayerImplList render_surface_layer_list;
+    LayerTreeHostCommon::CalcDrawPropsImplInputsForTesting inputs(
+        root.get(), root->bounds(), &render_surface_layer_list);
+    inputs.can_reuse_unchanged_subtrees = true;
+    LayerTreeHostCommon::CalculateDrawProperties(&inputs);
+    EXPECT_EQ(4u, root->render_surface()->layer_list().size());
+  }
+
+  // Only the second subtree changes, the first one can be reused.
+  second_child->SetPosition(gfx::PointF(15.f, 5.f));
+
+  LayerImplList reused_layer_list;
+  std::vector<gfx::Transform> reused_draw_transforms;
+  std::vector<gfx::Rect> reused_drawable_content_rects;
+  std::vector<gfx::Rect> reused_visible_content_rects;
+  gfx::Rect reused_surface_content_rect;
+  {
+    LayerImplList render_surface_layer_list;
+    LayerTreeHostCommon::CalcDrawPropsImplInputsForTesting inputs(
+        root.get(), root->bounds(), &render_surface_layer_list);
+    inputs.can_reuse_unchanged_subtrees = true;
+    LayerTreeHostCommon::CalculateDrawProperties(&inputs);
+
+    reused_layer_list = root->render_surface()->layer_list();
+    for (size_t i = 0; i < reused_layer_list.size(); ++i) {
+      LayerImpl* layer = reused_layer_list[i];
+      reused_draw_transforms.push_back(layer->draw_transform());
+      reused_drawable_content_rects.push_back(layer->drawable_content_rect());
+      reused_visible_content_rects.push_back(layer->visible_content_rect());
+    }
+    reused_surface_content_rect = root->render_surface()->content_rect();
+  }
+  EXPECT_RECT_EQ(gfx::Rect(65, 15, 10, 10),
+                 second_child->drawable_content_rect());
+
+  {
+    LayerImplList render_surface_layer_list;
+    LayerTreeHostCommon::CalcDrawPropsImplInputsForTesting inputs(
+        root.get(), root->bounds(), &render_surface_layer_list);
+    LayerTreeHostCommon::CalculateDrawProperties(&inputs);
+  }
+
+  const LayerImplList& layer_list = root->render_surface()->layer_list();
+  ASSERT_EQ(reused_layer_list.size(), layer_list.size());
+  for (size_t i = 0; i < layer_list.size(); ++i) {
+    LayerImpl* layer = layer_list[i];
+    EXPECT_EQ(reused_layer_list[i], layer);
+    EXPECT_TRANSFORMATION_MATRIX_EQ(reused_draw_transforms[i],
+                                    layer->draw_transform());
+    EXPECT_RECT_EQ(reused_drawable_content_rects[i],
+                   layer->drawable_content_rect());
+    EXPECT_RECT_EQ(reused_visible_content_rects[i],
+                   layer->visible_content_rect());
+  }
+  EXPECT_RECT_EQ(reused_surface_content_rect,
+                 root->render_surface()->content_rect());
+}
+
 }  // namespace
 }  // namespace cc
@@ -1718,15 +1718,16 @@ void LayerTreeHostImpl::CreateAndSetTileManager(
     bool using_map_image) {
   DCHECK(settings_.impl_side_painting);
   DCHECK(resource_provider);
-  tile_manager_ =
-      TileManager::Create(this,
-                          resource_provider,
-                          settings_.num_raster_threads,
-                          rendering_stats_instrumentation_,
-                          using_map_image,
-                          GetMaxTransferBufferUsageBytes(context_provider),
-                          GetMaxRasterTasksUsageBytes(context_provider),
-                          GetMapImageTextureTarget(context_provider));
+  tile_manager_ = TileManager::Create(
+      this,
+      resource_provider,
+      settings_.num_raster_threads,
+      rendering_stats_instrumentation_,
+      using_map_image,
+      GetMaxTransferBufferUsageBytes(context_provider),
+      GetMaxRasterTasksUsageBytes(context_provider),
+      GetMapImageTextureTarget(context_provider),
+      settings_.use_low_bit_depth_tiles_when_memory_constrained);
 
   UpdateTileManagerMemoryPolicy(ActualManagedMemoryPolicy());
   need_to_update_visible_tiles_before_draw_ = false;
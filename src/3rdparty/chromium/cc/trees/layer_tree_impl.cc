@@ -392,6 +392,7 @@ void LayerTreeImpl::UpdateDrawProperties() {
         can_render_to_separate_surface,
         settings().layer_transforms_should_scale_layer_contents,
         &render_surface_layer_list_);
+    inputs.can_reuse_unchanged_subtrees = true;
     LayerTreeHostCommon::CalculateDrawProperties(&inputs);
   }
 
@@ -57,6 +57,7 @@ LayerTreeSettings::LayerTreeSettings()
       use_map_image(false),
       ignore_root_layer_flings(false),
       use_rgba_4444_textures(false),
+      use_low_bit_depth_tiles_when_memory_constrained(false),
       always_overscroll(false),
       touch_hit_testing(true),
       texture_id_allocation_chunk_size(64) {
@@ -67,6 +67,7 @@ class CC_EXPORT LayerTreeSettings {
   bool use_map_image;
   bool ignore_root_layer_flings;
   bool use_rgba_4444_textures;
+  bool use_low_bit_depth_tiles_when_memory_constrained;
   bool always_overscroll;
   bool touch_hit_testing;
   size_t texture_id_allocation_chunk_size;
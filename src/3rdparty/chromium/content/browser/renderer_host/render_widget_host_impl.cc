@@ -944,7 +944,10 @@ void RenderWidgetHostImpl::ForwardMouseEventWithLatencyInfo(
   if (IgnoreInputEvents())
     return;
 
-  input_router_->SendMouseEvent(mouse_event);
+  input_router_->SendMouseEvent(MouseEventWithLatencyInfo(
+      mouse_event.event,
+      CreateRWHLatencyInfoIfNotExist(&mouse_event.latency,
+                                     mouse_event.event.type)));
 }
 
 void RenderWidgetHostImpl::OnPointerEventActivate() {
@@ -965,7 +968,10 @@ void RenderWidgetHostImpl::ForwardWheelEventWithLatencyInfo(
   if (delegate_->PreHandleWheelEvent(wheel_event.event))
     return;
 
-  input_router_->SendWheelEvent(wheel_event);
+  input_router_->SendWheelEvent(MouseWheelEventWithLatencyInfo(
+      wheel_event.event,
+      CreateRWHLatencyInfoIfNotExist(&wheel_event.latency,
+                                     wheel_event.event.type)));
 }
 
 void RenderWidgetHostImpl::ForwardGestureEvent(
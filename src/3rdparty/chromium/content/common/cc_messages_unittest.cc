@@ -185,6 +185,7 @@ class CCMessagesTest : public testing::Test {
     EXPECT_EQ(a->u_plane_resource_id, b->u_plane_resource_id);
     EXPECT_EQ(a->v_plane_resource_id, b->v_plane_resource_id);
     EXPECT_EQ(a->a_plane_resource_id, b->a_plane_resource_id);
+    EXPECT_EQ(a->color_space, b->color_space);
   }
 
   void Compare(const TransferableResource& a, const TransferableResource& b) {
@@ -403,6 +404,7 @@ TEST_F(CCMessagesTest, AllQuads) {
                       arbitrary_resourceid2,
                       arbitrary_resourceid3,
                       arbitrary_resourceid4);
+  yuvvideo_in->color_space = YUVVideoDrawQuad::REC_709;
   scoped_ptr<DrawQuad> yuvvideo_cmp = yuvvideo_in->Copy(
       yuvvideo_in->shared_quad_state);
 
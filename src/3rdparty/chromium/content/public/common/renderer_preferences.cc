@@ -48,7 +48,8 @@ RendererPreferences::RendererPreferences()
       touchscreen_fling_profile(3),
       tap_multiple_targets_strategy(TAP_MULTIPLE_TARGETS_STRATEGY_POPUP),
       disable_client_blocked_error_page(false),
-      plugin_fullscreen_allowed(true) {
+      plugin_fullscreen_allowed(true),
+      use_software_compositing(false) {
   touchpad_fling_profile[0] = kDefaultAlpha;
   touchpad_fling_profile[1] = kDefaultBeta;
   touchpad_fling_profile[2] = kDefaultGamma;
@@ -147,6 +147,11 @@ struct CONTENT_EXPORT RendererPreferences {
 
   // Determines whether plugins are allowed to enter fullscreen mode.
   bool plugin_fullscreen_allowed;
+
+  // Composite the view in software and send its frames through shared memory,
+  // even if a GPU context is available. Only read when the compositor creates
+  // its output surface.
+  bool use_software_compositing;
 };
 
 }  // namespace content
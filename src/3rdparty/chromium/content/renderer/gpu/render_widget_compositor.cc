@@ -252,6 +252,9 @@ scoped_ptr<RenderWidgetCompositor> RenderWidgetCompositor::Create(
 
   settings.use_map_image = cc::switches::IsMapImageEnabled();
 
+  settings.use_low_bit_depth_tiles_when_memory_constrained =
+      cmd->HasSwitch(cc::switches::kEnableLowBitDepthTiles);
+
 #if defined(OS_ANDROID)
   // TODO(danakj): Move these to the android code.
   settings.max_partial_texture_updates = 0;
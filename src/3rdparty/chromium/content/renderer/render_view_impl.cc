@@ -5689,6 +5689,10 @@ bool RenderViewImpl::ForceCompositingModeEnabled() {
   return webkit_preferences_.force_compositing_mode;
 }
 
+bool RenderViewImpl::ForceSoftwareCompositing() {
+  return renderer_preferences_.use_software_compositing;
+}
+
 void RenderViewImpl::OnSetFocus(bool enable) {
   RenderWidget::OnSetFocus(enable);
 
@@ -869,6 +869,10 @@ bool RenderWidget::ForceCompositingModeEnabled() {
   return false;
 }
 
+bool RenderWidget::ForceSoftwareCompositing() {
+  return false;
+}
+
 scoped_ptr<cc::OutputSurface> RenderWidget::CreateOutputSurface(bool fallback) {
 
 #if defined(OS_ANDROID)
@@ -896,8 +900,9 @@ scoped_ptr<cc::OutputSurface> RenderWidget::CreateOutputSurface(bool fallback) {
   attributes.stencil = false;
 
   const CommandLine& command_line = *CommandLine::ForCurrentProcess();
+  bool force_software = ForceSoftwareCompositing();
   scoped_refptr<ContextProviderCommandBuffer> context_provider;
-  if (!fallback) {
+  if (!fallback && !force_software) {
     context_provider = ContextProviderCommandBuffer::Create(
         CreateGraphicsContext3D(attributes),
         "RenderCompositor");
@@ -905,7 +910,8 @@ scoped_ptr<cc::OutputSurface> RenderWidget::CreateOutputSurface(bool fallback) {
 
   uint32 output_surface_id = next_output_surface_id_++;
   if (!context_provider.get()) {
-    if (!command_line.HasSwitch(switches::kEnableSoftwareCompositing))
+    if (!force_software &&
+        !command_line.HasSwitch(switches::kEnableSoftwareCompositing))
       return scoped_ptr<cc::OutputSurface>();
 
     scoped_ptr<cc::SoftwareOutputDevice> software_device(
@@ -413,6 +413,10 @@ class CONTENT_EXPORT RenderWidget
 
   virtual bool ForceCompositingModeEnabled();
 
+  // Override and return true to composite in software even if a graphics
+  // context could be created for the compositor.
+  virtual bool ForceSoftwareCompositing();
+
   // Detects if a suitable opaque plugin covers the given paint bounds with no
   // compositing necessary.
   //
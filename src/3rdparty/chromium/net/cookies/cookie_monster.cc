@@ -126,6 +126,11 @@ typedef std::vector<CanonicalCookie*> CanonicalCookieVector;
 // will update it again.
 const int kDefaultAccessUpdateThresholdSeconds = 60;
 
+// Number of distinct hosts and cookie path sets a CookieMap key keeps Cookie
+// headers for. Past that, the headers are all dropped and built again as
+// requested.
+const size_t kMaxCookieLinesPerKey = 32;
+
 // Comparator to sort cookies from highest creation date to lowest
 // creation date.
 struct OrderByCreationTimeDesc {
@@ -341,6 +346,18 @@ CookieMonster::CookieMonster(PersistentCookieStore* store,
   SetDefaultCookieableSchemes();
 }
 
+CookieMonster::CookieLine::CookieLine() {
+}
+
+CookieMonster::CookieLine::~CookieLine() {
+}
+
+CookieMonster::CookieIndexEntry::CookieIndexEntry() {
+}
+
+CookieMonster::CookieIndexEntry::~CookieIndexEntry() {
+}
+
 
 // Task classes for queueing the coming request.
 
@@ -1287,6 +1304,7 @@ void CookieMonster::SetEnableFileScheme(bool accept) {
 
 void CookieMonster::SetKeepExpiredCookies() {
   keep_expired_cookies_ = true;
+  cookie_index_.clear();
 }
 
 // static
@@ -1323,11 +1341,19 @@ std::string CookieMonster::GetCookiesWithOptions(const GURL& url,
 
   TimeTicks start_time(TimeTicks::Now());
 
-  std::vector<CanonicalCookie*> cookies;
-  FindCookiesForHostAndDomain(url, options, true, &cookies);
-  std::sort(cookies.begin(), cookies.end(), CookieSorter);
+  const Time current_time(CurrentTime());
+  RecordPeriodicStats(current_time);
 
-  std::string cookie_line = BuildCookieLine(cookies);
+  std::string cookie_line;
+  const CookieLine* line =
+      FindCookieLine(GetKey(url.host()), url, options, current_time);
+  if (line) {
+    for (CanonicalCookieVector::const_iterator it = line->cookies.begin();
+         it != line->cookies.end(); ++it) {
+      InternalUpdateCookieAccessTime(*it, current_time);
+    }
+    cookie_line = line->line;
+  }
 
   histogram_time_get_->AddTime(TimeTicks::Now() - start_time);
 
@@ -1733,6 +1759,116 @@ void CookieMonster::FindCookiesForKey(const std::string& key,
   }
 }
 
+CookieMonster::CookieIndexEntry* CookieMonster::GetCookieIndexEntry(
+    const std::string& key,
+    const Time& current) {
+  lock_.AssertAcquired();
+
+  CookieIndex::iterator index_it = cookie_index_.find(key);
+  if (index_it != cookie_index_.end() &&
+      current < index_it->second.first_expiry) {
+    return &index_it->second;
+  }
+
+  std::map<std::string, CanonicalCookieVector> cookies_by_path;
+  Time first_expiry = Time::Max();
+  for (CookieMapItPair its = cookies_.equal_range(key);
+       its.first != its.second; ) {
+    CookieMap::iterator curit = its.first;
+    CanonicalCookie* cc = curit->second;
+    ++its.first;
+
+    // If the cookie is expired, delete it.  This also drops the out of date
+    // index entry.
+    if (cc->IsExpired(current) && !keep_expired_cookies_) {
+      InternalDeleteCookie(curit, true, DELETE_COOKIE_EXPIRED);
+      continue;
+    }
+    if (cc->IsPersistent() && !keep_expired_cookies_)
+      first_expiry = std::min(first_expiry, cc->ExpiryDate());
+    cookies_by_path[cc->Path()].push_back(cc);
+  }
+
+  // Don't keep entries for keys that are only ever read from.
+  if (cookies_by_path.empty()) {
+    cookie_index_.erase(key);
+    return NULL;
+  }
+
+  CookieIndexEntry* entry = &cookie_index_[key];
+  entry->cookies_by_path.swap(cookies_by_path);
+  entry->first_expiry = first_expiry;
+  entry->lines.clear();
+  return entry;
+}
+
+const CookieMonster::CookieLine* CookieMonster::FindCookieLine(
+    const std::string& key,
+    const GURL& url,
+    const CookieOptions& options,
+    const Time& current) {
+  lock_.AssertAcquired();
+
+  CookieIndexEntry* entry = GetCookieIndexEntry(key, current);
+  if (!entry)
+    return NULL;
+
+  // The cookie paths CanonicalCookie::IsOnPath() accepts for the request
+  // path are the path itself and its prefixes that end right before or at a
+  // '/'.
+  const std::string url_path = url.path();
+  std::vector<size_t> path_lengths;
+  for (size_t i = 0; i < url_path.length(); ++i) {
+    if (url_path[i] != '/')
+      continue;
+    if (i > 0 && (path_lengths.empty() || path_lengths.back() != i))
+      path_lengths.push_back(i);
+    path_lengths.push_back(i + 1);
+  }
+  if (path_lengths.empty() || path_lengths.back() != url_path.length())
+    path_lengths.push_back(url_path.length());
+
+  std::vector<const CanonicalCookieVector*> buckets;
+  std::string line_key;
+  for (size_t i = 0; i < path_lengths.size(); ++i) {
+    std::map<std::string, CanonicalCookieVector>::const_iterator bucket_it =
+        entry->cookies_by_path.find(url_path.substr(0, path_lengths[i]));
+    if (bucket_it == entry->cookies_by_path.end())
+      continue;
+    buckets.push_back(&bucket_it->second);
+    line_key += bucket_it->first;
+    line_key += '\n';
+  }
+
+  // Everything else CanonicalCookie::IncludeForRequestURL() looks at. Cookie
+  // paths can't contain a '\n', so the host can't run into them.
+  line_key += url.SchemeIsSecure() ? 's' : '-';
+  line_key += options.exclude_httponly() ? 'h' : '-';
+  line_key += url.host();
+
+  std::map<std::string, CookieLine>::iterator line_it =
+      entry->lines.find(line_key);
+  if (line_it != entry->lines.end())
+    return &line_it->second;
+
+  if (entry->lines.size() >= kMaxCookieLinesPerKey)
+    entry->lines.clear();
+  CookieLine& line = entry->lines[line_key];
+  for (size_t i = 0; i < buckets.size(); ++i) {
+    for (CanonicalCookieVector::const_iterator it = buckets[i]->begin();
+         it != buckets[i]->end(); ++it) {
+      // Filter out cookies that should not be included for a request to the
+      // given |url|. HTTP only cookies are filtered depending on the passed
+      // cookie |options|.
+      if ((*it)->IncludeForRequestURL(url, options))
+        line.cookies.push_back(*it);
+    }
+  }
+  std::sort(line.cookies.begin(), line.cookies.end(), CookieSorter);
+  line.line = BuildCookieLine(line.cookies);
+  return &line;
+}
+
 bool CookieMonster::DeleteAnyEquivalentCookie(const std::string& key,
                                               const CanonicalCookie& ecc,
                                               bool skip_httponly,
@@ -1775,6 +1911,7 @@ CookieMonster::CookieMap::iterator CookieMonster::InternalInsertCookie(
     store_->AddCookie(*cc);
   CookieMap::iterator inserted =
       cookies_.insert(CookieMap::value_type(key, cc));
+  cookie_index_.erase(key);
   if (delegate_.get()) {
     delegate_->OnCookieChanged(
         *cc, false, Delegate::CHANGE_COOKIE_EXPLICIT);
@@ -1895,6 +2032,7 @@ void CookieMonster::InternalDeleteCookie(CookieMap::iterator it,
     if (mapping.notify)
       delegate_->OnCookieChanged(*cc, true, mapping.cause);
   }
+  cookie_index_.erase(it->first);
   cookies_.erase(it);
   delete cc;
 }
@@ -321,6 +321,35 @@ class NET_EXPORT CookieMonster : public CookieStore {
   class DeleteSessionCookiesTask;
   class HasCookiesForETLDP1Task;
 
+  // A Cookie header built by GetCookiesWithOptions(), along with the cookies
+  // it was built from so that their access time keeps being updated.
+  struct CookieLine {
+    CookieLine();
+    ~CookieLine();
+
+    std::string line;
+    std::vector<CanonicalCookie*> cookies;
+  };
+
+  // What GetCookiesWithOptions() reads for a CookieMap key instead of walking
+  // |cookies_|: the cookies of the key bucketed by cookie path, and the Cookie
+  // headers already built from them. It is dropped as soon as a cookie of the
+  // key is inserted or deleted, and only exists for keys that have cookies.
+  struct CookieIndexEntry {
+    CookieIndexEntry();
+    ~CookieIndexEntry();
+
+    // Cookies by their path, expired cookies excluded.
+    std::map<std::string, std::vector<CanonicalCookie*> > cookies_by_path;
+    // Earliest expiry date of the cookies, the entry has to be rebuilt from
+    // then on so that the expired cookie is deleted.
+    base::Time first_expiry;
+    // Headers by request scheme security, HttpOnly exclusion, host and the
+    // paths of |cookies_by_path| that match the request path.
+    std::map<std::string, CookieLine> lines;
+  };
+  typedef std::map<std::string, CookieIndexEntry> CookieIndex;
+
   // Testing support.
   // For SetCookieWithCreationTime.
   FRIEND_TEST_ALL_PREFIXES(CookieMonsterTest,
@@ -344,6 +373,9 @@ class NET_EXPORT CookieMonster : public CookieStore {
   // For FindCookiesForKey.
   FRIEND_TEST_ALL_PREFIXES(CookieMonsterTest, ShortLivedSessionCookies);
 
+  // For the size of |cookie_index_|.
+  FRIEND_TEST_ALL_PREFIXES(CookieMonsterTest, CookieIndexOnlyHoldsCookieKeys);
+
   // Internal reasons for deletion, used to populate informative histograms
   // and to provide a public cause for onCookieChange notifications.
   //
@@ -507,6 +539,20 @@ class NET_EXPORT CookieMonster : public CookieStore {
                          bool update_access_time,
                          std::vector<CanonicalCookie*>* cookies);
 
+  // Returns the index entry for |key|, building it from |cookies_| if it is
+  // missing or out of date. Expired cookies of |key| are deleted then.
+  // Returns NULL if |key| has no cookies.
+  CookieIndexEntry* GetCookieIndexEntry(const std::string& key,
+                                        const base::Time& current);
+
+  // Returns the Cookie header for |url| from the index entry for |key|,
+  // building it if no request with the same host and matching cookie paths
+  // was made before. Returns NULL if |key| has no cookies.
+  const CookieLine* FindCookieLine(const std::string& key,
+                                   const GURL& url,
+                                   const CookieOptions& options,
+                                   const base::Time& current);
+
   // Delete any cookies that are equivalent to |ecc| (same path, domain, etc).
   // If |skip_httponly| is true, httponly cookies will not be deleted.  The
   // return value with be true if |skip_httponly| skipped an httponly cookie.
@@ -618,6 +664,9 @@ class NET_EXPORT CookieMonster : public CookieStore {
 
   CookieMap cookies_;
 
+  // Lookup structures for the keys of |cookies_| that were read from.
+  CookieIndex cookie_index_;
+
   // Indicates whether the cookie store has been initialized. This happens
   // lazily in InitStoreIfNecessary().
   bool initialized_;
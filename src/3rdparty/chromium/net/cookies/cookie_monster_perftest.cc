@@ -276,6 +276,55 @@ TEST_F(CookieMonsterTest, TestDomainLine) {
   timer2.Done();
 }
 
+// Subresource loads from a site that keeps about as many cookies as a domain
+// is allowed, spread over a few paths, with a cookie set now and then. Every
+// request is for a different resource, so Cookie headers can only be reused
+// between requests matching the same cookie paths.
+TEST_F(CookieMonsterTest, TestQueryManyCookiesPerDomain) {
+  scoped_refptr<CookieMonster> cm(new CookieMonster(NULL, NULL));
+  SetCookieCallback setCookieCallback;
+  GetCookiesCallback getCookiesCallback;
+  const int kNumDomainCookies = 150;
+  const int kNumPaths = 10;
+
+  // Half of the cookies are for the whole site, the others for one path.
+  for (int i = 0; i < kNumDomainCookies; ++i) {
+    GURL gurl(base::StringPrintf("https://sso.intranet.izzle/app%d",
+                                 i % kNumPaths));
+    std::string cookie = base::StringPrintf(
+        "session%03d=0123456789abcdef0123456789abcdef; path=%s",
+        i, i % 2 ? gurl.path().c_str() : "/");
+    setCookieCallback.SetCookie(cm.get(), gurl, cookie);
+  }
+  std::string cookie_line = getCookiesCallback.GetCookies(
+      cm.get(), GURL("https://sso.intranet.izzle/app1/index.html"));
+  EXPECT_EQ(kNumDomainCookies / 2 + kNumDomainCookies / kNumPaths,
+            CountInString(cookie_line, '='));
+
+  std::vector<GURL> gurls;
+  for (int i = 0; i < kNumCookies; ++i) {
+    gurls.push_back(GURL(base::StringPrintf(
+        "https://%s.intranet.izzle/app%d/resource%d.js",
+        i % 2 ? "sso" : "static", i % kNumPaths, i)));
+  }
+
+  base::PerfTimeLogger timer("Cookie_monster_query_many_cookies_per_domain");
+  for (int i = 0; i < kNumCookies; ++i)
+    getCookiesCallback.GetCookies(cm.get(), gurls[i]);
+  timer.Done();
+
+  base::PerfTimeLogger timer2(
+      "Cookie_monster_query_many_cookies_per_domain_with_updates");
+  for (int i = 0; i < kNumCookies; ++i) {
+    if (i % 100 == 0) {
+      setCookieCallback.SetCookie(cm.get(), gurls[0],
+                                  base::StringPrintf("update=%d", i));
+    }
+    getCookiesCallback.GetCookies(cm.get(), gurls[i]);
+  }
+  timer2.Done();
+}
+
 TEST_F(CookieMonsterTest, TestImport) {
   scoped_refptr<MockPersistentCookieStore> store(new MockPersistentCookieStore);
   std::vector<CanonicalCookie*> initial_cookies;
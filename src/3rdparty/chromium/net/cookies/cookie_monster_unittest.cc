@@ -1239,6 +1239,118 @@ TEST_F(CookieMonsterTest, TestDeleteSingleCookie) {
   EXPECT_EQ("A=B; E=F", GetCookies(cm.get(), url_google_));
 }
 
+// Cookie lines are reused between requests for the same host and path, they
+// have to follow any change to the cookies of the domain.
+TEST_F(CookieMonsterTest, CookieLinesFollowChanges) {
+  scoped_refptr<CookieMonster> cm(new CookieMonster(NULL, NULL));
+  GURL url_google_foo_bar(std::string(kUrlGoogleFoo) + "/bar");
+
+  EXPECT_TRUE(SetCookie(cm.get(), url_google_, "A=B"));
+  EXPECT_TRUE(SetCookie(cm.get(), url_google_, "C=D; path=/foo"));
+  CookieOptions options;
+  options.set_include_httponly();
+  EXPECT_TRUE(
+      SetCookieWithOptions(cm.get(), url_google_, "E=F; httponly", options));
+  EXPECT_EQ("A=B", GetCookies(cm.get(), url_google_));
+  EXPECT_EQ("C=D; A=B", GetCookies(cm.get(), url_google_foo_));
+  EXPECT_EQ("C=D; A=B", GetCookies(cm.get(), url_google_foo_bar));
+
+  // HttpOnly cookies are only part of the lines for requests including them.
+  EXPECT_EQ("A=B; E=F", GetCookiesWithOptions(cm.get(), url_google_, options));
+  EXPECT_EQ("A=B", GetCookies(cm.get(), url_google_));
+
+  // Inserting, overwriting and deleting cookies all show up.
+  EXPECT_TRUE(SetCookie(cm.get(), url_google_, "G=H; path=/foo/bar"));
+  EXPECT_EQ("C=D; A=B", GetCookies(cm.get(), url_google_foo_));
+  EXPECT_EQ("G=H; C=D; A=B", GetCookies(cm.get(), url_google_foo_bar));
+  EXPECT_TRUE(SetCookie(cm.get(), url_google_, "C=X; path=/foo"));
+  EXPECT_EQ("C=X; A=B", GetCookies(cm.get(), url_google_foo_));
+  DeleteCookie(cm.get(), url_google_, "A");
+  EXPECT_EQ("C=X", GetCookies(cm.get(), url_google_foo_));
+  EXPECT_EQ("", GetCookies(cm.get(), url_google_));
+
+  // A cookie expiring while its line is reused is dropped from it.
+  EXPECT_TRUE(SetCookieWithDetails(
+      cm.get(), url_google_foo_, "I", "J", std::string(), "/foo",
+      base::Time::Now() + TimeDelta::FromMilliseconds(kAccessDelayMs), false,
+      false, COOKIE_PRIORITY_DEFAULT));
+  EXPECT_EQ("C=X; I=J", GetCookies(cm.get(), url_google_foo_));
+  base::PlatformThread::Sleep(
+      base::TimeDelta::FromMilliseconds(2 * kAccessDelayMs));
+  EXPECT_EQ("C=X", GetCookies(cm.get(), url_google_foo_));
+
+  EXPECT_EQ(3, DeleteAll(cm.get()));
+  EXPECT_EQ("", GetCookies(cm.get(), url_google_foo_bar));
+}
+
+// Cookie lines are shared between request paths that match the same cookie
+// paths, and must match exactly the cookies CanonicalCookie::IsOnPath()
+// accepts.
+TEST_F(CookieMonsterTest, CookieLinesMatchCookiePaths) {
+  scoped_refptr<CookieMonster> cm(new CookieMonster(NULL, NULL));
+  const char kUrlGoogleBase[] = "http://www.google.izzle";
+
+  EXPECT_TRUE(SetCookie(cm.get(), url_google_, "A=1; path=/"));
+  EXPECT_TRUE(SetCookie(cm.get(), url_google_, "B=2; path=/a"));
+  EXPECT_TRUE(SetCookie(cm.get(), url_google_, "C=3; path=/a/"));
+  EXPECT_TRUE(SetCookie(cm.get(), url_google_, "D=4; path=/ab"));
+  EXPECT_TRUE(SetCookie(cm.get(), url_google_, "E=5; path=/a/b"));
+
+  const struct {
+    const char* path;
+    const char* expected;
+  } tests[] = {
+    { "/", "A=1" },
+    { "/a", "B=2; A=1" },
+    { "/a/", "C=3; B=2; A=1" },
+    { "/a/x", "C=3; B=2; A=1" },
+    { "/a/y", "C=3; B=2; A=1" },
+    { "/a/b", "E=5; C=3; B=2; A=1" },
+    { "/a/b/c/d", "E=5; C=3; B=2; A=1" },
+    { "/a/bc", "C=3; B=2; A=1" },
+    { "/a//b", "C=3; B=2; A=1" },
+    { "/ab", "D=4; A=1" },
+    { "/ab/", "D=4; A=1" },
+    { "/abc", "A=1" },
+    { "/b", "A=1" },
+  };
+
+  // Twice, so that the second round reads the lines built by the first one.
+  for (int round = 0; round < 2; ++round) {
+    for (size_t i = 0; i < ARRAYSIZE_UNSAFE(tests); ++i) {
+      GURL url(std::string(kUrlGoogleBase) + tests[i].path);
+      EXPECT_EQ(tests[i].expected, GetCookies(cm.get(), url))
+          << tests[i].path;
+    }
+  }
+
+  // Many distinct request paths don't affect the result.
+  for (int i = 0; i < 100; ++i) {
+    GURL url(base::StringPrintf("%s/a/b/%d", kUrlGoogleBase, i));
+    EXPECT_EQ("E=5; C=3; B=2; A=1", GetCookies(cm.get(), url));
+  }
+}
+
+// Reading the cookies of a domain that has none doesn't leave anything
+// behind.
+TEST_F(CookieMonsterTest, CookieIndexOnlyHoldsCookieKeys) {
+  scoped_refptr<CookieMonster> cm(new CookieMonster(NULL, NULL));
+
+  EXPECT_TRUE(SetCookie(cm.get(), url_google_, "A=B"));
+  EXPECT_EQ("A=B", GetCookies(cm.get(), url_google_));
+  EXPECT_EQ(1u, cm->cookie_index_.size());
+
+  for (int i = 0; i < 100; ++i) {
+    GURL url(base::StringPrintf("http://host%d.izzle/", i));
+    EXPECT_EQ("", GetCookies(cm.get(), url));
+  }
+  EXPECT_EQ(1u, cm->cookie_index_.size());
+
+  DeleteCookie(cm.get(), url_google_, "A");
+  EXPECT_EQ("", GetCookies(cm.get(), url_google_));
+  EXPECT_EQ(0u, cm->cookie_index_.size());
+}
+
 TEST_F(CookieMonsterTest, SetCookieableSchemes) {
   scoped_refptr<CookieMonster> cm(new CookieMonster(NULL, NULL));
   scoped_refptr<CookieMonster> cm_foo(new CookieMonster(NULL, NULL));
@@ -7,7 +7,11 @@
 #include "base/basictypes.h"
 #include "base/bind.h"
 #include "base/bind_helpers.h"
+#include "base/containers/hash_tables.h"
+#include "base/file_util.h"
 #include "base/hash.h"
+#include "base/message_loop/message_loop_proxy.h"
+#include "base/strings/string_number_conversions.h"
 #include "base/strings/string_util.h"
 #include "base/test/perf_time_logger.h"
 #include "base/test/test_file_util.h"
@@ -22,7 +26,11 @@
 #include "net/disk_cache/disk_cache.h"
 #include "net/disk_cache/disk_cache_test_base.h"
 #include "net/disk_cache/disk_cache_test_util.h"
+#include "net/disk_cache/simple/simple_index.h"
+#include "net/disk_cache/simple/simple_index_file.h"
+#include "net/disk_cache/simple/simple_util.h"
 #include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
 #include "testing/platform_test.h"
 
 using base::Time;
@@ -248,3 +256,85 @@ TEST_F(DiskCacheTest, BlockFilesPerformance) {
   base::MessageLoop::current()->RunUntilIdle();
   delete[] address;
 }
+
+// Measures the startup and flush costs of a large Simple Cache index: loading
+// it, writing it whole, and appending the changes to a few of its entries to
+// the journal instead, which is then replayed when loading.
+TEST_F(DiskCacheTest, SimpleIndexPerformance) {
+  ASSERT_TRUE(CleanupCacheDir());
+
+  const int kNumEntries = 200000;
+  const int kNumChangedEntries = 1000;
+  disk_cache::SimpleIndex::EntrySet entries;
+  uint64 cache_size = 0;
+  const Time now = Time::Now();
+  for (int i = 0; i < kNumEntries; i++) {
+    const int entry_size = i % kMaxSize;
+    disk_cache::SimpleIndex::InsertInEntrySet(
+        disk_cache::simple_util::GetEntryHashKey(base::IntToString(i)),
+        disk_cache::EntryMetadata(now, entry_size), &entries);
+    cache_size += entry_size;
+  }
+
+  disk_cache::SimpleIndexFile index_file(
+      base::MessageLoopProxy::current().get(),
+      base::MessageLoopProxy::current().get(),
+      net::DISK_CACHE, cache_path_);
+  const base::FilePath index_path =
+      cache_path_.AppendASCII("index-dir").AppendASCII("the-real-index");
+  const base::FilePath journal_path =
+      cache_path_.AppendASCII("index-dir").AppendASCII("index-journal");
+
+  base::PerfTimeLogger timer1("Write the whole simple cache index");
+  index_file.WriteToDisk(entries, cache_size, base::TimeTicks::Now(), false);
+  base::MessageLoop::current()->RunUntilIdle();
+  timer1.Done();
+
+  int64 index_size = 0;
+  ASSERT_TRUE(base::GetFileSize(index_path, &index_size));
+  perf_test::PrintResult("simple_index_flush", "", "whole_index",
+                         static_cast<size_t>(index_size), "bytes", true);
+
+  ASSERT_TRUE(file_util::EvictFileFromSystemCache(index_path));
+  disk_cache::SimpleIndexLoadResult load_result;
+  base::PerfTimeLogger timer2("Load the simple cache index");
+  index_file.LoadIndexEntries(Time(), base::Bind(&base::DoNothing),
+                              &load_result);
+  base::MessageLoop::current()->RunUntilIdle();
+  timer2.Done();
+  ASSERT_TRUE(load_result.did_load);
+  EXPECT_EQ(entries.size(), load_result.entries.size());
+
+  base::hash_set<uint64> changed_hashes;
+  const Time later = now + base::TimeDelta::FromMinutes(1);
+  for (disk_cache::SimpleIndex::EntrySet::iterator it = entries.begin();
+       changed_hashes.size() < static_cast<size_t>(kNumChangedEntries);
+       ++it) {
+    it->second.SetLastUsedTime(later);
+    changed_hashes.insert(it->first);
+  }
+
+  base::PerfTimeLogger timer3("Append changed entries to the journal");
+  index_file.AppendToJournal(entries, changed_hashes, base::TimeTicks::Now(),
+                             false);
+  base::MessageLoop::current()->RunUntilIdle();
+  timer3.Done();
+
+  int64 journal_size = 0;
+  ASSERT_TRUE(base::GetFileSize(journal_path, &journal_size));
+  perf_test::PrintResult("simple_index_flush", "", "journal",
+                         static_cast<size_t>(journal_size), "bytes", true);
+  EXPECT_LT(journal_size, index_size);
+
+  ASSERT_TRUE(file_util::EvictFileFromSystemCache(index_path));
+  ASSERT_TRUE(file_util::EvictFileFromSystemCache(journal_path));
+  base::PerfTimeLogger timer4("Load the simple cache index and journal");
+  index_file.LoadIndexEntries(Time(), base::Bind(&base::DoNothing),
+                              &load_result);
+  base::MessageLoop::current()->RunUntilIdle();
+  timer4.Done();
+  ASSERT_TRUE(load_result.did_load);
+  EXPECT_EQ(static_cast<uint64>(kNumChangedEntries + 1),
+            load_result.journal_records);
+  EXPECT_EQ(entries.size(), load_result.entries.size());
+}
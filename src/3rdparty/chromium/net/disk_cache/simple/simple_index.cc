@@ -48,6 +48,10 @@ const uint32 kEvictionMarginDivisor = 20;
 
 const uint32 kBytesInKb = 1024;
 
+// The whole index is written again instead of growing the journal once the
+// journal would hold more than one record per this amount of index entries.
+const uint64 kJournalCompactionDivisor = 8;
+
 // Utility class used for timestamp comparisons in entry metadata while sorting.
 class CompareHashesForTimestamp {
   typedef disk_cache::SimpleIndex SimpleIndex;
@@ -147,6 +151,8 @@ SimpleIndex::SimpleIndex(base::SingleThreadTaskRunner* io_thread,
       low_watermark_(0),
       eviction_in_progress_(false),
       initialized_(false),
+      journal_records_(0),
+      full_write_required_(false),
       index_file_(index_file.Pass()),
       io_thread_(io_thread),
       // Creating the callback once so it is reused every time
@@ -266,6 +272,7 @@ void SimpleIndex::Insert(uint64 entry_hash) {
       entry_hash, EntryMetadata(base::Time::Now(), 0), &entries_set_);
   if (!initialized_)
     removed_entries_.erase(entry_hash);
+  changed_entries_.insert(entry_hash);
   PostponeWritingToDisk();
 }
 
@@ -279,6 +286,7 @@ void SimpleIndex::Remove(uint64 entry_hash) {
 
   if (!initialized_)
     removed_entries_.insert(entry_hash);
+  changed_entries_.insert(entry_hash);
   PostponeWritingToDisk();
 }
 
@@ -297,6 +305,7 @@ bool SimpleIndex::UseIfExists(uint64 entry_hash) {
     // If not initialized, always return true, forcing it to go to the disk.
     return !initialized_;
   it->second.SetLastUsedTime(base::Time::Now());
+  changed_entries_.insert(entry_hash);
   PostponeWritingToDisk();
   return true;
 }
@@ -357,6 +366,7 @@ bool SimpleIndex::UpdateEntrySize(uint64 entry_hash, int entry_size) {
     return false;
 
   UpdateEntryIteratorSize(&it, entry_size);
+  changed_entries_.insert(entry_hash);
   PostponeWritingToDisk();
   StartEvictionIfNeeded();
   return true;
@@ -436,12 +446,15 @@ void SimpleIndex::MergeInitializingSet(
 
   entries_set_.swap(*index_file_entries);
   cache_size_ = merged_cache_size;
+  journal_records_ = load_result->journal_records;
   initialized_ = true;
 
   // The actual IO is asynchronous, so calling WriteToDisk() shouldn't slow the
   // merge down much.
-  if (load_result->flush_required)
+  if (load_result->flush_required) {
+    full_write_required_ = true;
     WriteToDisk();
+  }
 
   SIMPLE_CACHE_UMA(CUSTOM_COUNTS,
                    "IndexInitializationWaiters", cache_type_,
@@ -491,8 +504,22 @@ void SimpleIndex::WriteToDisk() {
   }
   last_write_to_disk_ = start;
 
-  index_file_->WriteToDisk(entries_set_, cache_size_,
-                           start, app_on_background_);
+  if (!full_write_required_ &&
+      (journal_records_ + changed_entries_.size()) * kJournalCompactionDivisor <=
+          entries_set_.size()) {
+    if (!changed_entries_.empty()) {
+      index_file_->AppendToJournal(entries_set_, changed_entries_,
+                                   start, app_on_background_);
+      // One more record ends each batch appended.
+      journal_records_ += changed_entries_.size() + 1;
+    }
+  } else {
+    index_file_->WriteToDisk(entries_set_, cache_size_,
+                             start, app_on_background_);
+    journal_records_ = 0;
+    full_write_required_ = false;
+  }
+  changed_entries_.clear();
 }
 
 }  // namespace disk_cache
@@ -60,10 +60,12 @@ class NET_EXPORT_PRIVATE EntryMetadata {
   }
 
  private:
+  friend class SimpleIndexFile;
   friend class SimpleIndexFileTest;
 
   // When adding new members here, you should update the Serialize() and
-  // Deserialize() methods.
+  // Deserialize() methods, as well as the records of the index file and its
+  // journal in simple_index_file.cc.
 
   uint32 last_used_time_seconds_since_epoch_;
 
@@ -137,6 +139,7 @@ class NET_EXPORT_PRIVATE SimpleIndex
   FRIEND_TEST_ALL_PREFIXES(SimpleIndexTest, DiskWriteQueued);
   FRIEND_TEST_ALL_PREFIXES(SimpleIndexTest, DiskWriteExecuted);
   FRIEND_TEST_ALL_PREFIXES(SimpleIndexTest, DiskWritePostponed);
+  FRIEND_TEST_ALL_PREFIXES(SimpleIndexTest, DiskWriteJournaled);
 
   void StartEvictionIfNeeded();
   void EvictionDone(int result);
@@ -172,6 +175,15 @@ class NET_EXPORT_PRIVATE SimpleIndex
   base::hash_set<uint64> removed_entries_;
   bool initialized_;
 
+  // The entries inserted, removed or updated since the last write to disk.
+  // While they are few compared to the whole index, only their new state is
+  // appended to the journal of the index file.
+  base::hash_set<uint64> changed_entries_;
+  // Number of records in the journal since the index file was last written.
+  uint64 journal_records_;
+  // Set when the next write to disk must rewrite the whole index file.
+  bool full_write_required_;
+
   scoped_ptr<SimpleIndexFile> index_file_;
 
   scoped_refptr<base::SingleThreadTaskRunner> io_thread_;
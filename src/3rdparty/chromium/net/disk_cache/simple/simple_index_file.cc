@@ -4,6 +4,8 @@
 
 #include "net/disk_cache/simple/simple_index_file.h"
 
+#include <cstddef>
+#include <cstring>
 #include <vector>
 
 #include "base/file_util.h"
@@ -36,6 +38,42 @@ uint32 CalculatePickleCRC(const Pickle& pickle) {
                pickle.payload_size());
 }
 
+// The record of an entry in the index file.
+struct IndexFileEntry {
+  uint64 hash_key;
+  uint32 last_used_time_seconds_since_epoch;
+  int32 entry_size;
+};
+COMPILE_ASSERT(sizeof(IndexFileEntry) == 16, index_file_entry_has_no_padding);
+
+enum JournalRecordType {
+  JOURNAL_ENTRY_SET = 1,
+  JOURNAL_ENTRY_REMOVED = 2,
+  // Ends a batch of records, |hash_key| holds the cache directory mtime.
+  JOURNAL_CACHE_MODIFIED = 3,
+};
+
+// The record of a change in the journal file.
+struct JournalRecord {
+  uint64 hash_key;
+  uint32 last_used_time_seconds_since_epoch;
+  int32 entry_size;
+  uint32 type;
+  uint32 crc;  // Of the fields above.
+};
+COMPILE_ASSERT(sizeof(JournalRecord) == 24, journal_record_has_no_padding);
+
+uint32 CalculateJournalRecordCRC(const JournalRecord& record) {
+  return crc32(crc32(0, Z_NULL, 0),
+               reinterpret_cast<const Bytef*>(&record),
+               offsetof(JournalRecord, crc));
+}
+
+void AppendJournalRecord(JournalRecord* record, std::string* records) {
+  record->crc = CalculateJournalRecordCRC(*record);
+  records->append(reinterpret_cast<const char*>(record), sizeof(*record));
+}
+
 // Used in histograms. Please only add new values at the end.
 enum IndexFileState {
   INDEX_STATE_CORRUPT = 0,
@@ -125,7 +163,8 @@ void ProcessEntryFile(SimpleIndex::EntrySet* entries,
 }  // namespace
 
 SimpleIndexLoadResult::SimpleIndexLoadResult() : did_load(false),
-                                                 flush_required(false) {
+                                                 flush_required(false),
+                                                 journal_records(0) {
 }
 
 SimpleIndexLoadResult::~SimpleIndexLoadResult() {
@@ -134,6 +173,7 @@ SimpleIndexLoadResult::~SimpleIndexLoadResult() {
 void SimpleIndexLoadResult::Reset() {
   did_load = false;
   flush_required = false;
+  journal_records = 0;
   entries.clear();
 }
 
@@ -143,6 +183,8 @@ const char SimpleIndexFile::kIndexFileName[] = "the-real-index";
 const char SimpleIndexFile::kIndexDirectory[] = "index-dir";
 // static
 const char SimpleIndexFile::kTempIndexFileName[] = "temp-index";
+// static
+const char SimpleIndexFile::kJournalFileName[] = "index-journal";
 
 SimpleIndexFile::IndexMetadata::IndexMetadata()
     : magic_number_(kSimpleIndexMagicNumber),
@@ -195,27 +237,39 @@ void SimpleIndexFile::SyncWriteToDisk(net::CacheType cache_type,
   // part of a Create operation does not fit into the time budget for the index
   // flush delay. This simple approach will be reconsidered if it does not allow
   // for maintaining freshness.
+  //
+  // Whenever the new index file can not be written, the journal is dropped:
+  // the changes it was written to complement would be lost otherwise, and
+  // without them the old index file is seen as stale on the next load.
+  const base::FilePath journal_filename =
+      index_filename.DirName().AppendASCII(kJournalFileName);
   base::PlatformFileInfo cache_dir_info;
   base::Time cache_dir_mtime;
   if (!simple_util::GetMTime(cache_directory, &cache_dir_mtime)) {
     LOG(ERROR) << "Could obtain information about cache age";
+    base::DeleteFile(journal_filename, /* recursive = */ false);
     return;
   }
   SerializeFinalData(cache_dir_mtime, pickle.get());
   if (!WritePickleFile(pickle.get(), temp_index_filename)) {
     if (!base::CreateDirectory(temp_index_filename.DirName())) {
       LOG(ERROR) << "Could not create a directory to hold the index file";
+      base::DeleteFile(journal_filename, /* recursive = */ false);
       return;
     }
     if (!WritePickleFile(pickle.get(), temp_index_filename)) {
       LOG(ERROR) << "Failed to write the temporary index file";
+      base::DeleteFile(journal_filename, /* recursive = */ false);
       return;
     }
   }
 
-  // Atomically rename the temporary index file to become the real one.
+  // Atomically rename the temporary index file to become the real one. The
+  // journal only holds changes already contained in it. Replaying it is
+  // idempotent, so being interrupted before deleting it is harmless.
   bool result = base::ReplaceFile(temp_index_filename, index_filename, NULL);
   DCHECK(result);
+  base::DeleteFile(journal_filename, /* recursive = */ false);
 
   if (app_on_background) {
     SIMPLE_CACHE_UMA(TIMES,
@@ -228,6 +282,52 @@ void SimpleIndexFile::SyncWriteToDisk(net::CacheType cache_type,
   }
 }
 
+// static
+void SimpleIndexFile::SyncAppendToJournal(
+    net::CacheType cache_type,
+    const base::FilePath& cache_directory,
+    const base::FilePath& journal_filename,
+    scoped_ptr<std::string> records,
+    const base::TimeTicks& start_time,
+    bool app_on_background) {
+  base::Time cache_dir_mtime;
+  if (!simple_util::GetMTime(cache_directory, &cache_dir_mtime)) {
+    LOG(ERROR) << "Could obtain information about cache age";
+    base::DeleteFile(journal_filename, /* recursive = */ false);
+    return;
+  }
+  JournalRecord mtime_record;
+  std::memset(&mtime_record, 0, sizeof(mtime_record));
+  mtime_record.hash_key = cache_dir_mtime.ToInternalValue();
+  mtime_record.type = JOURNAL_CACHE_MODIFIED;
+  AppendJournalRecord(&mtime_record, records.get());
+
+  // AppendToFile() doesn't create the file, and SyncWriteToDisk() deletes
+  // the journal every time the whole index is written.
+  const int records_size = implicit_cast<int>(records->size());
+  const int bytes_written = base::PathExists(journal_filename) ?
+      file_util::AppendToFile(journal_filename, records->data(),
+                              records_size) :
+      file_util::WriteFile(journal_filename, records->data(), records_size);
+  if (bytes_written != records_size) {
+    // Records appended after a torn one would never be replayed, drop the
+    // journal so that the index file is seen as stale instead.
+    LOG(ERROR) << "Failed to append to the Simple Index journal";
+    base::DeleteFile(journal_filename, /* recursive = */ false);
+    return;
+  }
+
+  if (app_on_background) {
+    SIMPLE_CACHE_UMA(TIMES,
+                     "IndexJournalAppendTime.Background", cache_type,
+                     (base::TimeTicks::Now() - start_time));
+  } else {
+    SIMPLE_CACHE_UMA(TIMES,
+                     "IndexJournalAppendTime.Foreground", cache_type,
+                     (base::TimeTicks::Now() - start_time));
+  }
+}
+
 bool SimpleIndexFile::IndexMetadata::CheckIndexMetadata() {
   return number_of_entries_ <= kMaxEntiresInIndex &&
       magic_number_ == kSimpleIndexMagicNumber &&
@@ -246,7 +346,9 @@ SimpleIndexFile::SimpleIndexFile(
       index_file_(cache_directory_.AppendASCII(kIndexDirectory)
                       .AppendASCII(kIndexFileName)),
       temp_index_file_(cache_directory_.AppendASCII(kIndexDirectory)
-                           .AppendASCII(kTempIndexFileName)) {
+                           .AppendASCII(kTempIndexFileName)),
+      journal_file_(cache_directory_.AppendASCII(kIndexDirectory)
+                        .AppendASCII(kJournalFileName)) {
 }
 
 SimpleIndexFile::~SimpleIndexFile() {}
@@ -257,7 +359,7 @@ void SimpleIndexFile::LoadIndexEntries(base::Time cache_last_modified,
   base::Closure task = base::Bind(&SimpleIndexFile::SyncLoadIndexEntries,
                                   cache_type_,
                                   cache_last_modified, cache_directory_,
-                                  index_file_, out_result);
+                                  index_file_, journal_file_, out_result);
   worker_pool_->PostTaskAndReply(FROM_HERE, task, callback);
 }
 
@@ -278,16 +380,51 @@ void SimpleIndexFile::WriteToDisk(const SimpleIndex::EntrySet& entry_set,
       app_on_background));
 }
 
+void SimpleIndexFile::AppendToJournal(
+    const SimpleIndex::EntrySet& entry_set,
+    const base::hash_set<uint64>& changed_hashes,
+    const base::TimeTicks& start,
+    bool app_on_background) {
+  scoped_ptr<std::string> records(new std::string);
+  records->reserve((changed_hashes.size() + 1) * sizeof(JournalRecord));
+  for (base::hash_set<uint64>::const_iterator it = changed_hashes.begin();
+       it != changed_hashes.end(); ++it) {
+    JournalRecord record;
+    std::memset(&record, 0, sizeof(record));
+    record.hash_key = *it;
+    SimpleIndex::EntrySet::const_iterator entry = entry_set.find(*it);
+    if (entry == entry_set.end()) {
+      record.type = JOURNAL_ENTRY_REMOVED;
+    } else {
+      record.type = JOURNAL_ENTRY_SET;
+      record.last_used_time_seconds_since_epoch =
+          entry->second.last_used_time_seconds_since_epoch_;
+      record.entry_size = entry->second.entry_size_;
+    }
+    AppendJournalRecord(&record, records.get());
+  }
+  cache_thread_->PostTask(FROM_HERE, base::Bind(
+      &SimpleIndexFile::SyncAppendToJournal,
+      cache_type_,
+      cache_directory_,
+      journal_file_,
+      base::Passed(&records),
+      base::TimeTicks::Now(),
+      app_on_background));
+}
+
 // static
 void SimpleIndexFile::SyncLoadIndexEntries(
     net::CacheType cache_type,
     base::Time cache_last_modified,
     const base::FilePath& cache_directory,
     const base::FilePath& index_file_path,
+    const base::FilePath& journal_file_path,
     SimpleIndexLoadResult* out_result) {
   // Load the index and find its age.
   base::Time last_cache_seen_by_index;
-  SyncLoadFromDisk(index_file_path, &last_cache_seen_by_index, out_result);
+  SyncLoadFromDisk(index_file_path, journal_file_path,
+                   &last_cache_seen_by_index, out_result);
 
   // Consider the index loaded if it is fresh.
   const bool index_file_existed = base::PathExists(index_file_path);
@@ -312,7 +449,8 @@ void SimpleIndexFile::SyncLoadIndexEntries(
 
   // Reconstruct the index by scanning the disk for entries.
   const base::TimeTicks start = base::TimeTicks::Now();
-  SyncRestoreFromDisk(cache_directory, index_file_path, out_result);
+  SyncRestoreFromDisk(cache_directory, index_file_path, journal_file_path,
+                      out_result);
   SIMPLE_CACHE_UMA(MEDIUM_TIMES, "IndexRestoreTime", cache_type,
                    base::TimeTicks::Now() - start);
   SIMPLE_CACHE_UMA(COUNTS, "IndexEntriesRestored", cache_type,
@@ -329,6 +467,7 @@ void SimpleIndexFile::SyncLoadIndexEntries(
 
 // static
 void SimpleIndexFile::SyncLoadFromDisk(const base::FilePath& index_filename,
+                                       const base::FilePath& journal_filename,
                                        base::Time* out_last_cache_seen_by_index,
                                        SimpleIndexLoadResult* out_result) {
   out_result->Reset();
@@ -337,6 +476,7 @@ void SimpleIndexFile::SyncLoadFromDisk(const base::FilePath& index_filename,
   if (!index_file_map.Initialize(index_filename)) {
     LOG(WARNING) << "Could not map Simple Index file.";
     base::DeleteFile(index_filename, false);
+    base::DeleteFile(journal_filename, false);
     return;
   }
 
@@ -346,8 +486,17 @@ void SimpleIndexFile::SyncLoadFromDisk(const base::FilePath& index_filename,
       out_last_cache_seen_by_index,
       out_result);
 
-  if (!out_result->did_load)
+  if (!out_result->did_load) {
     base::DeleteFile(index_filename, false);
+    base::DeleteFile(journal_filename, false);
+    return;
+  }
+
+  std::string journal;
+  if (base::ReadFileToString(journal_filename, &journal)) {
+    ReplayJournal(journal.data(), journal.size(),
+                  out_last_cache_seen_by_index, out_result);
+  }
 }
 
 // static
@@ -357,10 +506,16 @@ scoped_ptr<Pickle> SimpleIndexFile::Serialize(
   scoped_ptr<Pickle> pickle(new Pickle(sizeof(SimpleIndexFile::PickleHeader)));
 
   index_metadata.Serialize(pickle.get());
+  // The records are a multiple of the pickle alignment in size, so they end up
+  // contiguous and can be read back as a single array.
   for (SimpleIndex::EntrySet::const_iterator it = entries.begin();
        it != entries.end(); ++it) {
-    pickle->WriteUInt64(it->first);
-    it->second.Serialize(pickle.get());
+    IndexFileEntry file_entry;
+    file_entry.hash_key = it->first;
+    file_entry.last_used_time_seconds_since_epoch =
+        it->second.last_used_time_seconds_since_epoch_;
+    file_entry.entry_size = it->second.entry_size_;
+    pickle->WriteBytes(&file_entry, sizeof(file_entry));
   }
   return pickle.Pass();
 }
@@ -402,20 +557,31 @@ void SimpleIndexFile::Deserialize(const char* data, int data_len,
     return;
   }
 
+  const uint64 number_of_entries = index_metadata.GetNumberOfEntries();
+  const char* file_entries = NULL;
+  if (number_of_entries > 0 &&
+      !pickle_it.ReadBytes(&file_entries,
+                           number_of_entries * sizeof(IndexFileEntry))) {
+    LOG(WARNING) << "Invalid EntryMetadata in Simple Index file.";
+    return;
+  }
+
 #if !defined(OS_WIN)
   // TODO(gavinp): Consider using std::unordered_map.
-  entries->resize(index_metadata.GetNumberOfEntries() + kExtraSizeForMerge);
+  entries->resize(number_of_entries + kExtraSizeForMerge);
 #endif
-  while (entries->size() < index_metadata.GetNumberOfEntries()) {
-    uint64 hash_key;
+  for (uint64 i = 0; i < number_of_entries; ++i) {
+    // The records are copied out of the mapped file, they are only 4 bytes
+    // aligned there.
+    IndexFileEntry file_entry;
+    std::memcpy(&file_entry, file_entries + i * sizeof(IndexFileEntry),
+                sizeof(file_entry));
     EntryMetadata entry_metadata;
-    if (!pickle_it.ReadUInt64(&hash_key) ||
-        !entry_metadata.Deserialize(&pickle_it)) {
-      LOG(WARNING) << "Invalid EntryMetadata in Simple Index file.";
-      entries->clear();
-      return;
-    }
-    SimpleIndex::InsertInEntrySet(hash_key, entry_metadata, entries);
+    entry_metadata.last_used_time_seconds_since_epoch_ =
+        file_entry.last_used_time_seconds_since_epoch;
+    entry_metadata.entry_size_ = file_entry.entry_size;
+    SimpleIndex::InsertInEntrySet(file_entry.hash_key, entry_metadata,
+                                  entries);
   }
 
   int64 cache_last_modified;
@@ -429,13 +595,53 @@ void SimpleIndexFile::Deserialize(const char* data, int data_len,
   out_result->did_load = true;
 }
 
+// static
+void SimpleIndexFile::ReplayJournal(const char* data, int data_len,
+                                    base::Time* out_cache_last_modified,
+                                    SimpleIndexLoadResult* out_result) {
+  DCHECK(data || data_len == 0);
+  SimpleIndex::EntrySet* entries = &out_result->entries;
+  const int records_count = data_len / sizeof(JournalRecord);
+  for (int i = 0; i < records_count; ++i) {
+    JournalRecord record;
+    std::memcpy(&record, data + i * sizeof(JournalRecord), sizeof(record));
+    if (record.crc != CalculateJournalRecordCRC(record)) {
+      LOG(WARNING) << "Invalid record in Simple Index journal.";
+      return;
+    }
+    switch (record.type) {
+      case JOURNAL_ENTRY_SET: {
+        EntryMetadata& entry_metadata = (*entries)[record.hash_key];
+        entry_metadata.last_used_time_seconds_since_epoch_ =
+            record.last_used_time_seconds_since_epoch;
+        entry_metadata.entry_size_ = record.entry_size;
+        break;
+      }
+      case JOURNAL_ENTRY_REMOVED:
+        entries->erase(record.hash_key);
+        break;
+      case JOURNAL_CACHE_MODIFIED:
+        DCHECK(out_cache_last_modified);
+        *out_cache_last_modified = base::Time::FromInternalValue(
+            static_cast<int64>(record.hash_key));
+        break;
+      default:
+        LOG(WARNING) << "Unknown record in Simple Index journal.";
+        return;
+    }
+    ++out_result->journal_records;
+  }
+}
+
 // static
 void SimpleIndexFile::SyncRestoreFromDisk(
     const base::FilePath& cache_directory,
     const base::FilePath& index_file_path,
+    const base::FilePath& journal_file_path,
     SimpleIndexLoadResult* out_result) {
   LOG(INFO) << "Simple Cache Index is being restored from disk.";
   base::DeleteFile(index_file_path, /* recursive = */ false);
+  base::DeleteFile(journal_file_path, /* recursive = */ false);
   out_result->Reset();
   SimpleIndex::EntrySet* entries = &out_result->entries;
 
@@ -27,7 +27,10 @@ class TaskRunner;
 
 namespace disk_cache {
 
-const uint64 kSimpleIndexMagicNumber = GG_UINT64_C(0x656e74657220796f);
+// The magic number changed when the entries started being written as an array
+// of fixed size records, so that index files of the older layout are restored
+// from the entry files instead of being misread.
+const uint64 kSimpleIndexMagicNumber = GG_UINT64_C(0x656e74657220796e);
 
 struct NET_EXPORT_PRIVATE SimpleIndexLoadResult {
   SimpleIndexLoadResult();
@@ -37,14 +40,21 @@ struct NET_EXPORT_PRIVATE SimpleIndexLoadResult {
   bool did_load;
   SimpleIndex::EntrySet entries;
   bool flush_required;
+  // Number of records replayed from the journal on top of the index file.
+  uint64 journal_records;
 };
 
 // Simple Index File format is a pickle serialized data of IndexMetadata and
-// EntryMetadata objects. The file format is as follows: one instance of
-// serialized |IndexMetadata| followed serialized |EntryMetadata| entries
-// repeated |number_of_entries| amount of times. To know more about the format,
-// see SimpleIndexFile::Serialize() and SeeSimpleIndexFile::LoadFromDisk()
-// methods.
+// the entries. The file format is as follows: one instance of serialized
+// |IndexMetadata| followed by a single array of |number_of_entries| fixed size
+// records, one per entry, followed by the cache directory modification time.
+// The array is read in place from the memory mapped file. To know more about
+// the format, see SimpleIndexFile::Serialize() and
+// SimpleIndexFile::SyncLoadFromDisk() methods.
+//
+// Changes made between two writes of the index file are appended to a journal
+// next to it, see AppendToJournal(). The journal is replayed over the index
+// file when loading, and is removed each time the whole index is written.
 //
 // The non-static methods must run on the IO thread. All the real
 // work is done in the static methods, which are run on the cache thread
@@ -91,6 +101,13 @@ class NET_EXPORT_PRIVATE SimpleIndexFile {
                            const base::TimeTicks& start,
                            bool app_on_background);
 
+  // Append the state of the entries in |changed_hashes| to the journal. The
+  // hashes not present in |entry_set| are recorded as removed.
+  virtual void AppendToJournal(const SimpleIndex::EntrySet& entry_set,
+                               const base::hash_set<uint64>& changed_hashes,
+                               const base::TimeTicks& start,
+                               bool app_on_background);
+
  private:
   friend class WrappedSimpleIndexFile;
 
@@ -106,10 +123,13 @@ class NET_EXPORT_PRIVATE SimpleIndexFile {
                                    base::Time cache_last_modified,
                                    const base::FilePath& cache_directory,
                                    const base::FilePath& index_file_path,
+                                   const base::FilePath& journal_file_path,
                                    SimpleIndexLoadResult* out_result);
 
-  // Load the index file from disk returning an EntrySet.
+  // Load the index file from disk and replay the journal over it, returning an
+  // EntrySet.
   static void SyncLoadFromDisk(const base::FilePath& index_filename,
+                               const base::FilePath& journal_filename,
                                base::Time* out_last_cache_seen_by_index,
                                SimpleIndexLoadResult* out_result);
 
@@ -133,6 +153,14 @@ class NET_EXPORT_PRIVATE SimpleIndexFile {
                           base::Time* out_cache_last_modified,
                           SimpleIndexLoadResult* out_result);
 
+  // Applies the journal records found in |data| of length |data_len| to
+  // |out_result|, stopping at the first incomplete or corrupt record. The
+  // cache modification time of the last complete batch of records is stored
+  // in |out_cache_last_modified|.
+  static void ReplayJournal(const char* data, int data_len,
+                            base::Time* out_cache_last_modified,
+                            SimpleIndexLoadResult* out_result);
+
   // Implemented either in simple_index_file_posix.cc or
   // simple_index_file_win.cc. base::FileEnumerator turned out to be very
   // expensive in terms of memory usage therefore it's used only on non-POSIX
@@ -142,7 +170,8 @@ class NET_EXPORT_PRIVATE SimpleIndexFile {
       const base::FilePath& cache_path,
       const EntryFileCallback& entry_file_callback);
 
-  // Writes the index file to disk atomically.
+  // Writes the index file to disk atomically and removes the journal next to
+  // it.
   static void SyncWriteToDisk(net::CacheType cache_type,
                               const base::FilePath& cache_directory,
                               const base::FilePath& index_filename,
@@ -151,10 +180,20 @@ class NET_EXPORT_PRIVATE SimpleIndexFile {
                               const base::TimeTicks& start_time,
                               bool app_on_background);
 
+  // Appends the serialized journal |records| to the journal file, terminated
+  // by the current cache directory modification time.
+  static void SyncAppendToJournal(net::CacheType cache_type,
+                                  const base::FilePath& cache_directory,
+                                  const base::FilePath& journal_filename,
+                                  scoped_ptr<std::string> records,
+                                  const base::TimeTicks& start_time,
+                                  bool app_on_background);
+
   // Scan the index directory for entries, returning an EntrySet of all entries
   // found.
   static void SyncRestoreFromDisk(const base::FilePath& cache_directory,
                                   const base::FilePath& index_file_path,
+                                  const base::FilePath& journal_file_path,
                                   SimpleIndexLoadResult* out_result);
 
   // Determines if an index file is stale relative to the time of last
@@ -174,10 +213,12 @@ class NET_EXPORT_PRIVATE SimpleIndexFile {
   const base::FilePath cache_directory_;
   const base::FilePath index_file_;
   const base::FilePath temp_index_file_;
+  const base::FilePath journal_file_;
 
   static const char kIndexDirectory[];
   static const char kIndexFileName[];
   static const char kTempIndexFileName[];
+  static const char kJournalFileName[];
 
   DISALLOW_COPY_AND_ASSIGN(SimpleIndexFile);
 };
@@ -85,6 +85,10 @@ class WrappedSimpleIndexFile : public SimpleIndexFile {
     return index_file_;
   }
 
+  const base::FilePath& GetJournalFilePath() const {
+    return journal_file_;
+  }
+
   bool CreateIndexFileDirectory() const {
     return base::CreateDirectory(index_file_.DirName());
   }
@@ -233,6 +237,68 @@ TEST_F(SimpleIndexFileTest, DISABLED_WriteThenLoadIndex) {
     EXPECT_EQ(1U, load_index_result.entries.count(kHashes[i]));
 }
 
+TEST_F(SimpleIndexFileTest, ReplayJournal) {
+  base::ScopedTempDir cache_dir;
+  ASSERT_TRUE(cache_dir.CreateUniqueTempDir());
+
+  SimpleIndex::EntrySet entries;
+  static const uint64 kHashes[] = { 11, 22, 33 };
+  for (size_t i = 0; i < arraysize(kHashes); ++i) {
+    SimpleIndex::InsertInEntrySet(
+        kHashes[i], EntryMetadata(Time(), kHashes[i]), &entries);
+  }
+
+  WrappedSimpleIndexFile simple_index_file(cache_dir.path());
+  simple_index_file.WriteToDisk(entries, 66U, base::TimeTicks(), false);
+  base::RunLoop().RunUntilIdle();
+  EXPECT_TRUE(base::PathExists(simple_index_file.GetIndexFilePath()));
+  EXPECT_FALSE(base::PathExists(simple_index_file.GetJournalFilePath()));
+
+  // Remove one entry, resize another and add a new one.
+  base::hash_set<uint64> changed_hashes;
+  entries.erase(22);
+  changed_hashes.insert(22);
+  entries[33].SetEntrySize(99);
+  changed_hashes.insert(33);
+  SimpleIndex::InsertInEntrySet(44, EntryMetadata(Time(), 44), &entries);
+  changed_hashes.insert(44);
+  simple_index_file.AppendToJournal(entries, changed_hashes,
+                                    base::TimeTicks(), false);
+  base::RunLoop().RunUntilIdle();
+  ASSERT_TRUE(base::PathExists(simple_index_file.GetJournalFilePath()));
+
+  // A torn record at the end of the journal is ignored.
+  const std::string kDummyData = "torn record";
+  EXPECT_EQ(implicit_cast<int>(kDummyData.size()),
+            file_util::AppendToFile(simple_index_file.GetJournalFilePath(),
+                                    kDummyData.data(), kDummyData.size()));
+
+  SimpleIndexLoadResult load_index_result;
+  simple_index_file.LoadIndexEntries(Time(), GetCallback(),
+                                     &load_index_result);
+  base::RunLoop().RunUntilIdle();
+
+  ASSERT_TRUE(callback_called());
+  EXPECT_TRUE(load_index_result.did_load);
+  EXPECT_FALSE(load_index_result.flush_required);
+  EXPECT_EQ(changed_hashes.size() + 1, load_index_result.journal_records);
+  const SimpleIndex::EntrySet& loaded_entries = load_index_result.entries;
+  EXPECT_EQ(entries.size(), loaded_entries.size());
+  for (SimpleIndex::EntrySet::const_iterator it = entries.begin();
+       it != entries.end(); ++it) {
+    SimpleIndex::EntrySet::const_iterator loaded =
+        loaded_entries.find(it->first);
+    ASSERT_TRUE(loaded_entries.end() != loaded);
+    EXPECT_TRUE(CompareTwoEntryMetadata(it->second, loaded->second));
+  }
+
+  // Writing the whole index drops the journal.
+  simple_index_file.WriteToDisk(entries, 154U, base::TimeTicks(), false);
+  base::RunLoop().RunUntilIdle();
+  EXPECT_TRUE(base::PathExists(simple_index_file.GetIndexFilePath()));
+  EXPECT_FALSE(base::PathExists(simple_index_file.GetJournalFilePath()));
+}
+
 TEST_F(SimpleIndexFileTest, LoadCorruptIndex) {
   base::ScopedTempDir cache_dir;
   ASSERT_TRUE(cache_dir.CreateUniqueTempDir());
@@ -55,7 +55,8 @@ class MockSimpleIndexFile : public SimpleIndexFile,
       : SimpleIndexFile(NULL, NULL, net::DISK_CACHE, base::FilePath()),
         load_result_(NULL),
         load_index_entries_calls_(0),
-        disk_writes_(0) {}
+        disk_writes_(0),
+        journal_appends_(0) {}
 
   virtual void LoadIndexEntries(
       base::Time cache_last_modified,
@@ -74,6 +75,14 @@ class MockSimpleIndexFile : public SimpleIndexFile,
     disk_write_entry_set_ = entry_set;
   }
 
+  virtual void AppendToJournal(const SimpleIndex::EntrySet& entry_set,
+                               const base::hash_set<uint64>& changed_hashes,
+                               const base::TimeTicks& start,
+                               bool app_on_background) OVERRIDE {
+    journal_appends_++;
+    journal_changed_hashes_ = changed_hashes;
+  }
+
   void GetAndResetDiskWriteEntrySet(SimpleIndex::EntrySet* entry_set) {
     entry_set->swap(disk_write_entry_set_);
   }
@@ -82,6 +91,10 @@ class MockSimpleIndexFile : public SimpleIndexFile,
   SimpleIndexLoadResult* load_result() const { return load_result_; }
   int load_index_entries_calls() const { return load_index_entries_calls_; }
   int disk_writes() const { return disk_writes_; }
+  int journal_appends() const { return journal_appends_; }
+  const base::hash_set<uint64>& journal_changed_hashes() const {
+    return journal_changed_hashes_;
+  }
 
  private:
   base::Closure load_callback_;
@@ -89,6 +102,8 @@ class MockSimpleIndexFile : public SimpleIndexFile,
   int load_index_entries_calls_;
   int disk_writes_;
   SimpleIndex::EntrySet disk_write_entry_set_;
+  int journal_appends_;
+  base::hash_set<uint64> journal_changed_hashes_;
 };
 
 class SimpleIndexTest  : public testing::Test, public SimpleIndexDelegate {
@@ -605,6 +620,42 @@ TEST_F(SimpleIndexTest, DiskWriteExecuted) {
   EXPECT_EQ(20, entry1.GetEntrySize());
 }
 
+// Tests that a few changes to a large index are appended to the journal, and
+// that the whole index is written again once the journal has grown.
+TEST_F(SimpleIndexTest, DiskWriteJournaled) {
+  index()->SetMaxSize(1000000);
+  const base::Time now(base::Time::Now());
+  for (size_t i = 0; i < 16; ++i)
+    InsertIntoIndexFileReturn(HashesInitializer(i), now, 10);
+  ReturnIndexFile();
+  EXPECT_FALSE(index()->write_to_disk_timer_.IsRunning());
+
+  const uint64 kHash1 = hashes_.at<1>();
+  EXPECT_TRUE(index()->UseIfExists(kHash1));
+  EXPECT_TRUE(index()->write_to_disk_timer_.IsRunning());
+  base::Closure user_task(index()->write_to_disk_timer_.user_task());
+  index()->write_to_disk_timer_.Stop();
+  user_task.Run();
+  EXPECT_EQ(0, index_file_->disk_writes());
+  EXPECT_EQ(1, index_file_->journal_appends());
+  ASSERT_EQ(1U, index_file_->journal_changed_hashes().size());
+  EXPECT_EQ(1U, index_file_->journal_changed_hashes().count(kHash1));
+
+  // The journal would now hold too many records for the size of the index.
+  const uint64 kHash2 = hashes_.at<2>();
+  index()->Remove(kHash2);
+  EXPECT_TRUE(index()->write_to_disk_timer_.IsRunning());
+  user_task = index()->write_to_disk_timer_.user_task();
+  index()->write_to_disk_timer_.Stop();
+  user_task.Run();
+  EXPECT_EQ(1, index_file_->disk_writes());
+  EXPECT_EQ(1, index_file_->journal_appends());
+  SimpleIndex::EntrySet entry_set;
+  index_file_->GetAndResetDiskWriteEntrySet(&entry_set);
+  EXPECT_EQ(15U, entry_set.size());
+  EXPECT_EQ(0U, entry_set.count(kHash2));
+}
+
 TEST_F(SimpleIndexTest, DiskWritePostponed) {
   index()->SetMaxSize(1000);
   ReturnIndexFile();
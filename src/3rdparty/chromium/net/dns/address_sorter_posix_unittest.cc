@@ -43,6 +43,16 @@ class TestUDPClientSocket : public DatagramClientSocket {
     NOTIMPLEMENTED();
     return OK;
   }
+  virtual int WriteMultiple(IOBuffer*, const std::vector<int>&,
+                            const CompletionCallback&) OVERRIDE {
+    NOTIMPLEMENTED();
+    return OK;
+  }
+  virtual bool SupportsWriteMultiple() const OVERRIDE {
+    return false;
+  }
+  virtual void EnableReadBatching() OVERRIDE {
+  }
   virtual bool SetReceiveBufferSize(int32) OVERRIDE {
     return true;
   }
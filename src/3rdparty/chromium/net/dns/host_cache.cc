@@ -7,11 +7,21 @@
 #include "base/logging.h"
 #include "base/metrics/field_trial.h"
 #include "base/metrics/histogram.h"
+#include "base/pickle.h"
 #include "base/strings/string_number_conversions.h"
 #include "net/base/net_errors.h"
+#include "net/base/net_util.h"
 
 namespace net {
 
+namespace {
+
+// Bump when the layout written by HostCache::Serialize() changes, older
+// files are then ignored.
+const int kPersistenceVersion = 1;
+
+}  // namespace
+
 //-----------------------------------------------------------------------------
 
 HostCache::Entry::Entry(int error, const AddressList& addrlist,
@@ -34,7 +44,8 @@ HostCache::Entry::~Entry() {
 //-----------------------------------------------------------------------------
 
 HostCache::HostCache(size_t max_entries)
-    : entries_(max_entries) {
+    : entries_(max_entries),
+      persistence_delegate_(NULL) {
 }
 
 HostCache::~HostCache() {
@@ -46,7 +57,25 @@ const HostCache::Entry* HostCache::Lookup(const Key& key,
   if (caching_is_disabled())
     return NULL;
 
-  return entries_.Get(key, now);
+  const Entry* entry = entries_.Get(key, now);
+  if (!entry || entry->expires <= now)
+    return NULL;
+  return entry;
+}
+
+const HostCache::Entry* HostCache::LookupStale(const Key& key,
+                                               base::TimeTicks now,
+                                               bool* is_stale) {
+  DCHECK(CalledOnValidThread());
+  DCHECK(is_stale);
+  if (caching_is_disabled())
+    return NULL;
+
+  // |entries_| only drops entries once they are past their staleness limit.
+  const Entry* entry = entries_.Get(key, now);
+  if (entry)
+    *is_stale = entry->expires <= now;
+  return entry;
 }
 
 void HostCache::Set(const Key& key,
@@ -57,12 +86,123 @@ void HostCache::Set(const Key& key,
   if (caching_is_disabled())
     return;
 
-  entries_.Put(key, entry, now, now + ttl);
+  Entry stored_entry(entry);
+  stored_entry.expires = now + ttl;
+  entries_.Put(key, stored_entry, now, stored_entry.expires + max_staleness_);
+  if (persistence_delegate_)
+    persistence_delegate_->ScheduleWrite();
 }
 
 void HostCache::clear() {
   DCHECK(CalledOnValidThread());
   entries_.Clear();
+  if (persistence_delegate_)
+    persistence_delegate_->ScheduleWrite();
+}
+
+void HostCache::Serialize(Pickle* pickle,
+                          base::TimeTicks now,
+                          base::Time wall_now) const {
+  DCHECK(CalledOnValidThread());
+  // Negative results are cheap to get again and wouldn't be served stale.
+  int count = 0;
+  for (EntryMap::Iterator it(entries_); it.HasNext(); it.Advance()) {
+    if (it.value().error == OK && it.expiration() > now)
+      ++count;
+  }
+
+  pickle->WriteInt(kPersistenceVersion);
+  pickle->WriteInt(count);
+  for (EntryMap::Iterator it(entries_); it.HasNext(); it.Advance()) {
+    const Key& key = it.key();
+    const Entry& entry = it.value();
+    if (entry.error != OK || it.expiration() <= now)
+      continue;
+
+    base::Time wall_expires = wall_now + (entry.expires - now);
+    pickle->WriteString(key.hostname);
+    pickle->WriteInt(key.address_family);
+    pickle->WriteInt(key.host_resolver_flags);
+    pickle->WriteInt64(wall_expires.ToInternalValue());
+    pickle->WriteInt64(entry.ttl.ToInternalValue());
+    pickle->WriteString(entry.addrlist.canonical_name());
+    // Ports come from the requests, only addresses are cached.
+    pickle->WriteInt(static_cast<int>(entry.addrlist.size()));
+    for (AddressList::const_iterator address = entry.addrlist.begin();
+         address != entry.addrlist.end(); ++address) {
+      const IPAddressNumber& number = address->address();
+      pickle->WriteData(reinterpret_cast<const char*>(&number[0]),
+                        static_cast<int>(number.size()));
+    }
+  }
+}
+
+bool HostCache::Deserialize(const Pickle& pickle,
+                            base::TimeTicks now,
+                            base::Time wall_now) {
+  DCHECK(CalledOnValidThread());
+  if (caching_is_disabled())
+    return true;
+
+  PickleIterator iter(pickle);
+  int version = 0;
+  int count = 0;
+  if (!pickle.ReadInt(&iter, &version) || version != kPersistenceVersion ||
+      !pickle.ReadInt(&iter, &count) || count < 0) {
+    return false;
+  }
+
+  for (int i = 0; i < count; ++i) {
+    std::string hostname;
+    int address_family = 0;
+    int host_resolver_flags = 0;
+    int64 wall_expires = 0;
+    int64 ttl = 0;
+    std::string canonical_name;
+    int address_count = 0;
+    if (!pickle.ReadString(&iter, &hostname) ||
+        !pickle.ReadInt(&iter, &address_family) ||
+        !pickle.ReadInt(&iter, &host_resolver_flags) ||
+        !pickle.ReadInt64(&iter, &wall_expires) ||
+        !pickle.ReadInt64(&iter, &ttl) ||
+        !pickle.ReadString(&iter, &canonical_name) ||
+        !pickle.ReadInt(&iter, &address_count) ||
+        address_family < ADDRESS_FAMILY_UNSPECIFIED ||
+        address_family > ADDRESS_FAMILY_IPV6 || address_count < 0) {
+      return false;
+    }
+
+    AddressList addrlist;
+    addrlist.set_canonical_name(canonical_name);
+    for (int j = 0; j < address_count; ++j) {
+      const char* data = NULL;
+      int length = 0;
+      if (!pickle.ReadData(&iter, &data, &length) ||
+          (static_cast<size_t>(length) != kIPv4AddressSize &&
+           static_cast<size_t>(length) != kIPv6AddressSize)) {
+        return false;
+      }
+      addrlist.push_back(IPEndPoint(
+          IPAddressNumber(data, data + length), 0));
+    }
+
+    base::TimeDelta remaining =
+        base::Time::FromInternalValue(wall_expires) - wall_now;
+    if (remaining + max_staleness_ <= base::TimeDelta())
+      continue;
+
+    Key key(hostname, static_cast<AddressFamily>(address_family),
+            host_resolver_flags);
+    // What was resolved since the start is more recent.
+    if (entries_.Get(key, now))
+      continue;
+
+    Entry entry(OK, addrlist);
+    entry.ttl = base::TimeDelta::FromInternalValue(ttl);
+    entry.expires = now + remaining;
+    entries_.Put(key, entry, now, entry.expires + max_staleness_);
+  }
+  return true;
 }
 
 size_t HostCache::size() const {
@@ -17,6 +17,8 @@
 #include "net/base/expiring_cache.h"
 #include "net/base/net_export.h"
 
+class Pickle;
+
 namespace net {
 
 // Cache used by HostResolver to map hostnames to their resolved result.
@@ -36,6 +38,9 @@ class NET_EXPORT HostCache : NON_EXPORTED_BASE(public base::NonThreadSafe) {
     AddressList addrlist;
     // TTL obtained from the nameserver. Negative if unknown.
     base::TimeDelta ttl;
+    // When the entry stops being fresh, set by HostCache::Set(). The entry
+    // can still be served stale for up to max_staleness() after that.
+    base::TimeTicks expires;
   };
 
   struct Key {
@@ -73,6 +78,16 @@ class NET_EXPORT HostCache : NON_EXPORTED_BASE(public base::NonThreadSafe) {
                         std::less<base::TimeTicks>,
                         EvictionHandler> EntryMap;
 
+  // Notified whenever the contents of the cache change, so that they can be
+  // written back to disk.
+  class PersistenceDelegate {
+   public:
+    virtual void ScheduleWrite() = 0;
+
+   protected:
+    virtual ~PersistenceDelegate() {}
+  };
+
   // Constructs a HostCache that stores up to |max_entries|.
   explicit HostCache(size_t max_entries);
 
@@ -82,6 +97,12 @@ class NET_EXPORT HostCache : NON_EXPORTED_BASE(public base::NonThreadSafe) {
   // |now|. If there is no such entry, returns NULL.
   const Entry* Lookup(const Key& key, base::TimeTicks now);
 
+  // Like Lookup(), but also returns entries that expired less than
+  // max_staleness() ago, in which case |is_stale| is set to true.
+  const Entry* LookupStale(const Key& key,
+                           base::TimeTicks now,
+                           bool* is_stale);
+
   // Overwrites or creates an entry for |key|.
   // |entry| is the value to set, |now| is the current time
   // |ttl| is the "time to live".
@@ -93,6 +114,32 @@ class NET_EXPORT HostCache : NON_EXPORTED_BASE(public base::NonThreadSafe) {
   // Empties the cache
   void clear();
 
+  // How long expired entries are kept to be returned by LookupStale().
+  // Only applies to entries set afterwards.
+  void set_max_staleness(base::TimeDelta max_staleness) {
+    max_staleness_ = max_staleness;
+  }
+  base::TimeDelta max_staleness() const { return max_staleness_; }
+
+  // |delegate| must outlive the cache or be reset before it is destroyed.
+  void set_persistence_delegate(PersistenceDelegate* delegate) {
+    persistence_delegate_ = delegate;
+  }
+
+  // Writes the successful entries that can still be served to |pickle|.
+  // Expiration times are stored as wall clock times, which is what survives
+  // a restart, |now| and |wall_now| being the same instant on both clocks.
+  void Serialize(Pickle* pickle,
+                 base::TimeTicks now,
+                 base::Time wall_now) const;
+
+  // Adds the entries written by Serialize() that aren't in the cache yet and
+  // haven't expired for longer than max_staleness(). Returns false if
+  // |pickle| is malformed, entries read until then are kept.
+  bool Deserialize(const Pickle& pickle,
+                   base::TimeTicks now,
+                   base::Time wall_now);
+
   // Returns the number of entries in the cache.
   size_t size() const;
 
@@ -116,6 +163,9 @@ class NET_EXPORT HostCache : NON_EXPORTED_BASE(public base::NonThreadSafe) {
   // a resolved result entry.
   EntryMap entries_;
 
+  base::TimeDelta max_staleness_;
+  PersistenceDelegate* persistence_delegate_;
+
   DISALLOW_COPY_AND_ASSIGN(HostCache);
 };
 
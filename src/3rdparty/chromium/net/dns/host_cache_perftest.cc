@@ -0,0 +1,99 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/dns/host_cache.h"
+
+#include <vector>
+
+#include "base/pickle.h"
+#include "base/strings/stringprintf.h"
+#include "base/test/perf_time_logger.h"
+#include "net/base/net_errors.h"
+#include "net/base/net_util.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace net {
+
+namespace {
+
+const int kNumEntries = 10000;
+
+class HostCachePerfTest : public testing::Test {
+ public:
+  HostCachePerfTest()
+      : cache_(kNumEntries),
+        wall_now_(base::Time::Now()) {
+    cache_.set_max_staleness(base::TimeDelta::FromHours(6));
+    IPAddressNumber address;
+    EXPECT_TRUE(ParseIPLiteralToNumber("192.168.1.1", &address));
+    addrlist_.push_back(IPEndPoint(address, 0));
+    EXPECT_TRUE(ParseIPLiteralToNumber("2001:db8::1", &address));
+    addrlist_.push_back(IPEndPoint(address, 0));
+
+    for (int i = 0; i < kNumEntries; ++i) {
+      keys_.push_back(HostCache::Key(
+          base::StringPrintf("host%05d.example.com", i),
+          ADDRESS_FAMILY_UNSPECIFIED, 0));
+    }
+  }
+
+ protected:
+  void FillCache() {
+    for (std::vector<HostCache::Key>::const_iterator it = keys_.begin();
+         it != keys_.end(); ++it) {
+      cache_.Set(*it, HostCache::Entry(OK, addrlist_), now_,
+                 base::TimeDelta::FromMinutes(1));
+    }
+  }
+
+  HostCache cache_;
+  base::TimeTicks now_;
+  base::Time wall_now_;
+  AddressList addrlist_;
+  std::vector<HostCache::Key> keys_;
+};
+
+}  // namespace
+
+TEST_F(HostCachePerfTest, Lookup) {
+  base::PerfTimeLogger timer("Host_cache_set");
+  FillCache();
+  timer.Done();
+  ASSERT_EQ(static_cast<size_t>(kNumEntries), cache_.size());
+
+  base::PerfTimeLogger timer2("Host_cache_lookup");
+  for (std::vector<HostCache::Key>::const_iterator it = keys_.begin();
+       it != keys_.end(); ++it) {
+    EXPECT_TRUE(cache_.Lookup(*it, now_));
+  }
+  timer2.Done();
+
+  // Every entry is stale, but none is past the staleness limit.
+  base::TimeTicks later = now_ + base::TimeDelta::FromHours(1);
+  bool is_stale = false;
+  base::PerfTimeLogger timer3("Host_cache_lookup_stale");
+  for (std::vector<HostCache::Key>::const_iterator it = keys_.begin();
+       it != keys_.end(); ++it) {
+    EXPECT_TRUE(cache_.LookupStale(*it, later, &is_stale));
+  }
+  timer3.Done();
+}
+
+TEST_F(HostCachePerfTest, Serialize) {
+  FillCache();
+
+  Pickle pickle;
+  base::PerfTimeLogger timer("Host_cache_serialize");
+  cache_.Serialize(&pickle, now_, wall_now_);
+  timer.Done();
+
+  HostCache restored_cache(kNumEntries);
+  restored_cache.set_max_staleness(cache_.max_staleness());
+  base::PerfTimeLogger timer2("Host_cache_deserialize");
+  EXPECT_TRUE(restored_cache.Deserialize(pickle, now_, wall_now_));
+  timer2.Done();
+  EXPECT_EQ(static_cast<size_t>(kNumEntries), restored_cache.size());
+}
+
+}  // namespace net
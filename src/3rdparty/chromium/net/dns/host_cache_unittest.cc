@@ -5,10 +5,12 @@
 #include "net/dns/host_cache.h"
 
 #include "base/format_macros.h"
+#include "base/pickle.h"
 #include "base/stl_util.h"
 #include "base/strings/string_util.h"
 #include "base/strings/stringprintf.h"
 #include "net/base/net_errors.h"
+#include "net/base/net_util.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
 namespace net {
@@ -296,6 +298,110 @@ TEST(HostCacheTest, Clear) {
   EXPECT_EQ(0u, cache.size());
 }
 
+// Expired entries are only returned by LookupStale(), and only for as long as
+// the configured staleness allows.
+TEST(HostCacheTest, StaleLookup) {
+  const base::TimeDelta kTTL = base::TimeDelta::FromSeconds(10);
+  const base::TimeDelta kMaxStaleness = base::TimeDelta::FromSeconds(20);
+
+  HostCache cache(kMaxCacheEntries);
+  cache.set_max_staleness(kMaxStaleness);
+
+  // Set t=0.
+  base::TimeTicks now;
+
+  HostCache::Key key1 = Key("foobar.com");
+  HostCache::Entry entry = HostCache::Entry(OK, AddressList());
+  cache.Set(key1, entry, now, kTTL);
+
+  bool is_stale = true;
+  EXPECT_TRUE(cache.LookupStale(key1, now, &is_stale));
+  EXPECT_FALSE(is_stale);
+
+  // Advance to t=10; the entry is now stale.
+  now += base::TimeDelta::FromSeconds(10);
+
+  EXPECT_FALSE(cache.Lookup(key1, now));
+  is_stale = false;
+  EXPECT_TRUE(cache.LookupStale(key1, now, &is_stale));
+  EXPECT_TRUE(is_stale);
+
+  // Refreshing the entry makes it fresh again.
+  cache.Set(key1, entry, now, kTTL);
+  EXPECT_TRUE(cache.Lookup(key1, now));
+
+  // Advance to t=40; the entry has been stale for longer than allowed.
+  now += base::TimeDelta::FromSeconds(30);
+
+  EXPECT_FALSE(cache.LookupStale(key1, now, &is_stale));
+  EXPECT_EQ(0U, cache.size());
+}
+
+TEST(HostCacheTest, SerializeRoundTrip) {
+  const base::TimeDelta kTTL = base::TimeDelta::FromSeconds(10);
+  const base::TimeDelta kMaxStaleness = base::TimeDelta::FromSeconds(20);
+
+  HostCache cache(kMaxCacheEntries);
+  cache.set_max_staleness(kMaxStaleness);
+
+  base::TimeTicks now;
+  base::Time wall_now = base::Time::Now();
+
+  IPAddressNumber ipv4;
+  ASSERT_TRUE(ParseIPLiteralToNumber("192.168.1.1", &ipv4));
+  IPAddressNumber ipv6;
+  ASSERT_TRUE(ParseIPLiteralToNumber("2001:db8::1", &ipv6));
+  AddressList addrlist;
+  addrlist.push_back(IPEndPoint(ipv4, 0));
+  addrlist.push_back(IPEndPoint(ipv6, 0));
+  addrlist.set_canonical_name("canonical.foobar.com");
+
+  HostCache::Key key1 = Key("foobar.com");
+  HostCache::Key key2 = Key("foobar2.com");
+  HostCache::Key key3 = Key("foobar3.com");
+  cache.Set(key1, HostCache::Entry(OK, addrlist), now, kTTL);
+  cache.Set(key2, HostCache::Entry(OK, addrlist),
+            now - base::TimeDelta::FromSeconds(15), kTTL);
+  // Negative entries aren't written.
+  cache.Set(key3, HostCache::Entry(ERR_NAME_NOT_RESOLVED, AddressList()),
+            now, kTTL);
+
+  Pickle pickle;
+  cache.Serialize(&pickle, now, wall_now);
+
+  // Restore one second later, on a clock with a different origin.
+  base::TimeTicks restored_now = now + base::TimeDelta::FromSeconds(1000);
+  base::Time restored_wall_now = wall_now + base::TimeDelta::FromSeconds(1);
+  HostCache restored_cache(kMaxCacheEntries);
+  restored_cache.set_max_staleness(kMaxStaleness);
+  EXPECT_TRUE(restored_cache.Deserialize(pickle, restored_now,
+                                         restored_wall_now));
+  EXPECT_EQ(2U, restored_cache.size());
+
+  const HostCache::Entry* restored = restored_cache.Lookup(key1, restored_now);
+  ASSERT_TRUE(restored);
+  EXPECT_EQ(OK, restored->error);
+  EXPECT_EQ(kTTL, restored->ttl);
+  EXPECT_EQ(restored_now + base::TimeDelta::FromSeconds(9),
+            restored->expires);
+  EXPECT_EQ("canonical.foobar.com", restored->addrlist.canonical_name());
+  ASSERT_EQ(2U, restored->addrlist.size());
+  EXPECT_EQ(ipv4, restored->addrlist[0].address());
+  EXPECT_EQ(ipv6, restored->addrlist[1].address());
+
+  bool is_stale = false;
+  EXPECT_TRUE(restored_cache.LookupStale(key2, restored_now, &is_stale));
+  EXPECT_TRUE(is_stale);
+  EXPECT_FALSE(restored_cache.Lookup(key3, restored_now));
+
+  // Truncated data is rejected.
+  Pickle truncated(static_cast<const char*>(pickle.data()),
+                   pickle.size() - 1);
+  HostCache truncated_cache(kMaxCacheEntries);
+  EXPECT_FALSE(truncated_cache.Deserialize(truncated, restored_now,
+                                           restored_wall_now));
+}
+
 // Tests the less than and equal operators for HostCache::Key work.
 TEST(HostCacheTest, KeyComparators) {
   struct {
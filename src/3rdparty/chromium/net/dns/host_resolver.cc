@@ -119,8 +119,10 @@ base::Value* HostResolver::GetDnsConfigAsValue() const {
 scoped_ptr<HostResolver>
 HostResolver::CreateSystemResolver(const Options& options, NetLog* net_log) {
   scoped_ptr<HostCache> cache;
-  if (options.enable_caching)
+  if (options.enable_caching) {
     cache = HostCache::CreateDefaultCache();
+    cache->set_max_staleness(options.max_cache_staleness);
+  }
   return scoped_ptr<HostResolver>(new HostResolverImpl(
       cache.Pass(),
       GetDispatcherLimits(options),
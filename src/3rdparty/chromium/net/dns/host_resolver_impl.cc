@@ -1205,6 +1205,7 @@ class HostResolverImpl::Job : public PrioritizedDispatcher::Job,
         priority_tracker_(priority),
         had_non_speculative_request_(false),
         had_dns_config_(false),
+        is_stale_refresh_(false),
         num_occupied_job_slots_(0),
         dns_task_error_(OK),
         creation_time_(base::TimeTicks::Now()),
@@ -1252,6 +1253,10 @@ class HostResolverImpl::Job : public PrioritizedDispatcher::Job,
     }
   }
 
+  // Marks a Job started to refresh a stale cache entry. It runs even when no
+  // request is attached to it, and only caches successful results.
+  void set_is_stale_refresh() { is_stale_refresh_ = true; }
+
   // Add this job to the dispatcher.  If "at_head" is true, adds at the front
   // of the queue.
   void Schedule(bool at_head) {
@@ -1316,7 +1321,7 @@ class HostResolverImpl::Job : public PrioritizedDispatcher::Job,
                                  req->request_net_log().source(),
                                  priority()));
 
-    if (num_active_requests() > 0) {
+    if (num_active_requests() > 0 || is_stale_refresh_) {
       UpdatePriority();
     } else {
       // If we were called from a Request's callback within CompleteRequests,
@@ -1358,6 +1363,9 @@ class HostResolverImpl::Job : public PrioritizedDispatcher::Job,
   // Attempts to serve the job from HOSTS. Returns true if succeeded and
   // this Job was destroyed.
   bool ServeFromHosts() {
+    // A stale refresh without requests has no RequestInfo to serve.
+    if (is_stale_refresh_ && num_active_requests() == 0)
+      return false;
     DCHECK_GT(num_active_requests(), 0u);
     AddressList addr_list;
     if (resolver_->ServeFromHosts(key(),
@@ -1666,6 +1674,10 @@ class HostResolverImpl::Job : public PrioritizedDispatcher::Job,
     }
 
     if (num_active_requests() == 0) {
+      // Nobody waits for the refresh of a stale entry, but it still replaces
+      // the entry. Failures keep serving the stale one until its limit.
+      if (is_stale_refresh_ && entry.error == OK)
+        resolver_->CacheResult(key_, entry, ttl);
       net_log_.AddEvent(NetLog::TYPE_CANCELLED);
       net_log_.EndEventWithNetErrorCode(NetLog::TYPE_HOST_RESOLVER_IMPL_JOB,
                                         OK);
@@ -1750,6 +1762,8 @@ class HostResolverImpl::Job : public PrioritizedDispatcher::Job,
   // Distinguishes measurements taken while DnsClient was fully configured.
   bool had_dns_config_;
 
+  bool is_stale_refresh_;
+
   // Number of slots occupied by this Job in resolver's PrioritizedDispatcher.
   unsigned num_occupied_job_slots_;
 
@@ -2056,10 +2070,15 @@ bool HostResolverImpl::ServeFromCache(const Key& key,
   if (!info.allow_cached_response() || !cache_.get())
     return false;
 
-  const HostCache::Entry* cache_entry = cache_->Lookup(
-      key, base::TimeTicks::Now());
-  if (!cache_entry)
+  bool is_stale = false;
+  const HostCache::Entry* cache_entry = cache_->LookupStale(
+      key, base::TimeTicks::Now(), &is_stale);
+  if (!cache_entry || (is_stale && cache_entry->error != OK))
     return false;
+  if (is_stale) {
+    // |cache_entry| stays valid, refreshing can't complete synchronously.
+    RefreshStaleEntry(key);
+  }
 
   *net_error = cache_entry->error;
   if (*net_error == OK) {
@@ -2125,6 +2144,22 @@ void HostResolverImpl::CacheResult(const Key& key,
     cache_->Set(key, entry, base::TimeTicks::Now(), ttl);
 }
 
+void HostResolverImpl::RefreshStaleEntry(const Key& key) {
+  JobMap::iterator jobit = jobs_.find(key);
+  if (jobit != jobs_.end())
+    return;
+  // Don't push requests that are waiting for a result out of the queue.
+  if (dispatcher_.num_queued_jobs() >= max_queued_jobs_)
+    return;
+
+  Job* job = new Job(weak_ptr_factory_.GetWeakPtr(), key, IDLE,
+                     BoundNetLog::Make(net_log_,
+                         NetLog::SOURCE_HOST_RESOLVER_IMPL_REQUEST));
+  job->set_is_stale_refresh();
+  job->Schedule(false);
+  jobs_.insert(jobit, std::make_pair(key, job));
+}
+
 void HostResolverImpl::RemoveJob(Job* job) {
   DCHECK(job);
   JobMap::iterator it = jobs_.find(job->key());
@@ -179,7 +179,8 @@ class NET_EXPORT HostResolverImpl
 
   // If |key| is not found in cache returns false, otherwise returns
   // true, sets |net_error| to the cached error code and fills |addresses|
-  // if it is a positive entry.
+  // if it is a positive entry. Positive entries that expired less than the
+  // cache's max_staleness() ago are served too, while they get refreshed.
   bool ServeFromCache(const Key& key,
                       const RequestInfo& info,
                       int* net_error,
@@ -205,6 +206,10 @@ class NET_EXPORT HostResolverImpl
                    const HostCache::Entry& entry,
                    base::TimeDelta ttl);
 
+  // Starts a Job for |key| without any request attached, unless there is
+  // already one, so that a stale cache entry gets replaced by a fresh one.
+  void RefreshStaleEntry(const Key& key);
+
   // Removes |job| from |jobs_|, only if it exists.
   void RemoveJob(Job* job);
 
@@ -93,7 +93,9 @@ HttpCache::ActiveEntry::ActiveEntry(disk_cache::Entry* entry)
     : disk_entry(entry),
       writer(NULL),
       will_process_pending_queue(false),
-      doomed(false) {
+      doomed(false),
+      streaming(false),
+      streaming_incomplete(false) {
 }
 
 HttpCache::ActiveEntry::~ActiveEntry() {
@@ -306,6 +308,7 @@ HttpCache::~HttpCache() {
     entry->will_process_pending_queue = false;
     entry->pending_queue.clear();
     entry->readers.clear();
+    entry->waiting_readers.clear();
     entry->writer = NULL;
     DeactivateEntry(entry);
   }
@@ -778,13 +781,20 @@ int HttpCache::AddTransactionToEntry(ActiveEntry* entry, Transaction* trans) {
 
   // We implement a basic reader/writer lock for the disk cache entry.  If
   // there is already a writer, then everyone has to wait for the writer to
-  // finish before they can access the cache entry.  There can be multiple
-  // readers.
+  // finish before they can access the cache entry, unless the writer is
+  // streaming the body and the transaction can follow it.  There can be
+  // multiple readers.
   //
   // NOTE: If the transaction can only write, then the entry should not be in
   // use (since any existing entry should have already been doomed).
 
   if (entry->writer || entry->will_process_pending_queue) {
+    if (entry->writer && entry->streaming &&
+        !entry->will_process_pending_queue && entry->pending_queue.empty() &&
+        trans->StartReadingWhileWriting()) {
+      entry->readers.push_back(trans);
+      return OK;
+    }
     entry->pending_queue.push_back(trans);
     return ERR_IO_PENDING;
   }
@@ -815,16 +825,19 @@ void HttpCache::DoneWithEntry(ActiveEntry* entry, Transaction* trans,
                               bool cancel) {
   // If we already posted a task to move on to the next transaction and this was
   // the writer, there is nothing to cancel.
-  if (entry->will_process_pending_queue && entry->readers.empty())
+  if (entry->will_process_pending_queue && !entry->writer &&
+      entry->readers.empty())
     return;
 
-  if (entry->writer) {
-    DCHECK(trans == entry->writer);
-
+  if (entry->writer == trans) {
     // Assume there was a failure.
     bool success = false;
     if (cancel) {
       DCHECK(entry->disk_entry);
+      // Readers following the writer will not get the rest of the body, even
+      // if we keep the entry around as truncated.
+      if (entry->streaming)
+        entry->streaming_incomplete = true;
       // This is a successful operation in the sense that we want to keep the
       // entry.
       success = trans->AddTruncatedFlag();
@@ -834,26 +847,43 @@ void HttpCache::DoneWithEntry(ActiveEntry* entry, Transaction* trans,
     }
     DoneWritingToEntry(entry, success);
   } else {
+    DCHECK(!entry->writer || entry->streaming);
     DoneReadingFromEntry(entry, trans);
   }
 }
 
 void HttpCache::DoneWritingToEntry(ActiveEntry* entry, bool success) {
-  DCHECK(entry->readers.empty());
+  // Transactions may be following a streaming writer, in which case the entry
+  // has to stay around until they are done with it.
+  bool in_use = !entry->readers.empty() || entry->will_process_pending_queue;
+  DCHECK(entry->streaming || !in_use);
+
+  if (!success) {
+    if (entry->streaming)
+      entry->streaming_incomplete = true;
+    // Nobody else should find this entry. Note that we have to do this while
+    // the writer is still attached to the entry.
+    if (in_use && !entry->doomed)
+      DoomEntry(entry->disk_entry->GetKey(), NULL);
+  }
 
   entry->writer = NULL;
+  if (entry->streaming) {
+    entry->streaming = false;
+    ResumeStreamingReaders(entry);
+  }
 
   if (success) {
     ProcessPendingQueue(entry);
   } else {
-    DCHECK(!entry->will_process_pending_queue);
-
     // We failed to create this entry.
     TransactionList pending_queue;
     pending_queue.swap(entry->pending_queue);
 
-    entry->disk_entry->Doom();
-    DestroyEntry(entry);
+    if (!in_use) {
+      entry->disk_entry->Doom();
+      DestroyEntry(entry);
+    }
 
     // We need to do something about these pending entries, which now need to
     // be added to a new entry.
@@ -866,7 +896,7 @@ void HttpCache::DoneWritingToEntry(ActiveEntry* entry, bool success) {
 }
 
 void HttpCache::DoneReadingFromEntry(ActiveEntry* entry, Transaction* trans) {
-  DCHECK(!entry->writer);
+  DCHECK(!entry->writer || entry->streaming);
 
   TransactionList::iterator it =
       std::find(entry->readers.begin(), entry->readers.end(), trans);
@@ -874,6 +904,11 @@ void HttpCache::DoneReadingFromEntry(ActiveEntry* entry, Transaction* trans) {
 
   entry->readers.erase(it);
 
+  it = std::find(entry->waiting_readers.begin(), entry->waiting_readers.end(),
+                 trans);
+  if (it != entry->waiting_readers.end())
+    entry->waiting_readers.erase(it);
+
   ProcessPendingQueue(entry);
 }
 
@@ -890,6 +925,35 @@ void HttpCache::ConvertWriterToReader(ActiveEntry* entry) {
   ProcessPendingQueue(entry);
 }
 
+void HttpCache::ShareEntryWithReaders(ActiveEntry* entry) {
+  DCHECK(entry->writer);
+  if (entry->streaming)
+    return;
+
+  entry->streaming = true;
+  if (!entry->pending_queue.empty())
+    ProcessPendingQueue(entry);
+}
+
+int HttpCache::WaitForStreamedData(ActiveEntry* entry, Transaction* trans) {
+  DCHECK(entry->writer);
+  DCHECK(entry->streaming);
+  entry->waiting_readers.push_back(trans);
+  return ERR_IO_PENDING;
+}
+
+void HttpCache::ResumeStreamingReaders(ActiveEntry* entry) {
+  // The writer is in the middle of its own IO, so let the readers continue
+  // from a fresh stack.
+  TransactionList waiting_readers;
+  waiting_readers.swap(entry->waiting_readers);
+  while (!waiting_readers.empty()) {
+    base::MessageLoop::current()->PostTask(
+        FROM_HERE, base::Bind(waiting_readers.front()->io_callback(), OK));
+    waiting_readers.pop_front();
+  }
+}
+
 LoadState HttpCache::GetLoadStateForPendingTransaction(
       const Transaction* trans) {
   ActiveEntriesMap::const_iterator i = active_entries_.find(trans->key());
@@ -983,17 +1047,32 @@ void HttpCache::ProcessPendingQueue(ActiveEntry* entry) {
 
 void HttpCache::OnProcessPendingQueue(ActiveEntry* entry) {
   entry->will_process_pending_queue = false;
-  DCHECK(!entry->writer);
+  DCHECK(!entry->writer || entry->streaming);
 
   // If no one is interested in this entry, then we can deactivate it.
   if (entry->pending_queue.empty()) {
-    if (entry->readers.empty())
+    if (!entry->writer && entry->readers.empty())
       DestroyEntry(entry);
     return;
   }
 
   // Promote next transaction from the pending queue.
   Transaction* next = entry->pending_queue.front();
+  if (entry->writer) {
+    // The writer is streaming the body, so the next transaction can read it
+    // as it arrives if it is a plain reader of this response.
+    if (!next->StartReadingWhileWriting())
+      return;  // Have to wait.
+
+    entry->pending_queue.erase(entry->pending_queue.begin());
+    entry->readers.push_back(next);
+    if (!entry->pending_queue.empty())
+      ProcessPendingQueue(entry);
+
+    next->io_callback().Run(OK);
+    return;
+  }
+
   if ((next->mode() & Transaction::WRITE) && !entry->readers.empty())
     return;  // Have to wait.
 
@@ -228,8 +228,14 @@ class NET_EXPORT HttpCache : public HttpTransactionFactory,
     Transaction*       writer;
     TransactionList    readers;
     TransactionList    pending_queue;
+    // Readers that caught up with a streaming writer and wait for more data.
+    TransactionList    waiting_readers;
     bool               will_process_pending_queue;
     bool               doomed;
+    // The writer lets readers follow the body while it is being written.
+    bool               streaming;
+    // The streaming writer went away before storing the whole body.
+    bool               streaming_incomplete;
   };
 
   typedef base::hash_map<std::string, ActiveEntry*> ActiveEntriesMap;
@@ -332,6 +338,19 @@ class NET_EXPORT HttpCache : public HttpTransactionFactory,
   // transactions can start reading from this entry.
   void ConvertWriterToReader(ActiveEntry* entry);
 
+  // Called by the writer of |entry| once it has started storing the response
+  // body, so that pending transactions for the same resource can read the
+  // body as it arrives instead of waiting for the writer to finish.
+  void ShareEntryWithReaders(ActiveEntry* entry);
+
+  // Called by a reader that consumed all the data stored so far by the
+  // streaming writer of |entry|. |trans| will be notified via its IO callback
+  // when there is more data (or the writer is done). Returns ERR_IO_PENDING.
+  int WaitForStreamedData(ActiveEntry* entry, Transaction* trans);
+
+  // Wakes up the readers waiting for more data from the writer of |entry|.
+  void ResumeStreamingReaders(ActiveEntry* entry);
+
   // Returns the LoadState of the provided pending transaction.
   LoadState GetLoadStateForPendingTransaction(const Transaction* trans);
 
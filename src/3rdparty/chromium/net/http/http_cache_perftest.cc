@@ -0,0 +1,136 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/http/http_cache.h"
+
+#include <string>
+
+#include "base/basictypes.h"
+#include "base/bind.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/memory/scoped_vector.h"
+#include "base/message_loop/message_loop.h"
+#include "base/test/perf_time_logger.h"
+#include "net/base/io_buffer.h"
+#include "net/base/net_errors.h"
+#include "net/base/net_log.h"
+#include "net/http/http_transaction.h"
+#include "net/http/http_transaction_unittest.h"
+#include "net/http/mock_http_cache.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace net {
+
+namespace {
+
+const int kNumRequests = 10;
+const int kBodySize = 1024 * 1024;
+const int kReadSize = 32 * 1024;
+
+// Reads a whole response through the cache, one chunk at a time.
+class CacheRequest {
+ public:
+  CacheRequest(HttpCache* cache, const MockHttpRequest* request)
+      : cache_(cache),
+        request_(request),
+        buf_(new IOBuffer(kReadSize)),
+        result_(ERR_IO_PENDING),
+        bytes_read_(0) {
+  }
+
+  void Start() {
+    EXPECT_EQ(OK, cache_->CreateTransaction(DEFAULT_PRIORITY, &trans_, NULL));
+    int rv = trans_->Start(
+        request_,
+        base::Bind(&CacheRequest::OnStartComplete, base::Unretained(this)),
+        BoundNetLog());
+    if (rv != ERR_IO_PENDING)
+      OnStartComplete(rv);
+  }
+
+  int result() const { return result_; }
+  int bytes_read() const { return bytes_read_; }
+
+ private:
+  void OnStartComplete(int result) {
+    if (result != OK)
+      return Done(result);
+    ReadMore();
+  }
+
+  void ReadMore() {
+    int rv;
+    do {
+      rv = trans_->Read(
+          buf_.get(), kReadSize,
+          base::Bind(&CacheRequest::OnReadComplete, base::Unretained(this)));
+      if (rv > 0)
+        bytes_read_ += rv;
+    } while (rv > 0);
+
+    if (rv != ERR_IO_PENDING)
+      Done(rv);
+  }
+
+  void OnReadComplete(int result) {
+    if (result <= 0)
+      return Done(result);
+    bytes_read_ += result;
+    ReadMore();
+  }
+
+  void Done(int result) {
+    result_ = result;
+    trans_.reset();
+  }
+
+  HttpCache* cache_;
+  const MockHttpRequest* request_;
+  scoped_ptr<HttpTransaction> trans_;
+  scoped_refptr<IOBuffer> buf_;
+  int result_;
+  int bytes_read_;
+
+  DISALLOW_COPY_AND_ASSIGN(CacheRequest);
+};
+
+class HttpCachePerfTest : public testing::Test {
+ public:
+  HttpCachePerfTest() : message_loop_(new base::MessageLoopForIO()) {}
+
+ protected:
+  scoped_ptr<base::MessageLoop> message_loop_;
+};
+
+}  // namespace
+
+// Measures the time to the last byte of a number of requests for the same
+// resource, started at the same time against an empty cache.
+TEST_F(HttpCachePerfTest, ConcurrentRequests) {
+  MockHttpCache cache;
+
+  std::string body(kBodySize, 'x');
+  ScopedMockTransaction transaction(kSimpleGET_Transaction);
+  transaction.data = body.c_str();
+  MockHttpRequest request(transaction);
+
+  ScopedVector<CacheRequest> requests;
+  for (int i = 0; i < kNumRequests; ++i)
+    requests.push_back(new CacheRequest(cache.http_cache(), &request));
+
+  base::PerfTimeLogger timer("Http_cache_concurrent_requests_last_byte");
+  for (int i = 0; i < kNumRequests; ++i)
+    requests[i]->Start();
+  base::MessageLoop::current()->RunUntilIdle();
+  timer.Done();
+
+  for (int i = 0; i < kNumRequests; ++i) {
+    EXPECT_EQ(OK, requests[i]->result());
+    EXPECT_EQ(kBodySize, requests[i]->bytes_read());
+  }
+  EXPECT_EQ(1, cache.network_layer()->transaction_count());
+}
+
+}  // namespace net
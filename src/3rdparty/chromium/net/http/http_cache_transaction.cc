@@ -204,6 +204,8 @@ HttpCache::Transaction::Transaction(
       cache_pending_(false),
       done_reading_(false),
       vary_mismatch_(false),
+      streaming_reader_(false),
+      must_validate_(false),
       couldnt_conditionalize_request_(false),
       io_buf_len_(0),
       read_offset_(0),
@@ -282,6 +284,22 @@ bool HttpCache::Transaction::AddTruncatedFlag() {
   return true;
 }
 
+bool HttpCache::Transaction::StartReadingWhileWriting() {
+  // Only plain requests for the whole resource can follow the writer; anything
+  // else may need to issue its own network request.
+  if (mode_ != READ && mode_ != READ_WRITE)
+    return false;
+
+  if (partial_.get() || range_requested_ || must_validate_ ||
+      (effective_load_flags_ & LOAD_VALIDATE_CACHE) ||
+      request_->method != "GET") {
+    return false;
+  }
+
+  streaming_reader_ = true;
+  return true;
+}
+
 LoadState HttpCache::Transaction::GetWriterLoadState() const {
   if (network_trans_.get())
     return network_trans_->GetLoadState();
@@ -605,6 +623,14 @@ int HttpCache::Transaction::HandleResult(int rv) {
 //   Read():
 //   NetworkRead* -> CacheWriteData*
 //
+// Entry being written by another transaction (following the writer):
+//   Start():
+//   GetBackend* -> InitEntry -> OpenEntry* -> AddToEntry* -> CacheReadResponse*
+//   -> BeginPartialCacheValidation() -> BeginCacheValidation()
+//
+//   Read():
+//   CacheReadData* (waiting for the writer when it reaches the stored data)
+//
 // Sparse entry, partially cached, byte range request:
 //   Start():
 //   GetBackend* -> InitEntry -> OpenEntry* -> AddToEntry* -> CacheReadResponse*
@@ -1580,6 +1606,22 @@ int HttpCache::Transaction::DoCacheReadDataComplete(int result) {
   if (result > 0) {
     read_offset_ += result;
   } else if (result == 0) {  // End of file.
+    if (streaming_reader_) {
+      // The writer may still be storing the body.
+      if (read_offset_ <
+          entry_->disk_entry->GetDataSize(kResponseContentIndex)) {
+        next_state_ = STATE_CACHE_READ_DATA;
+        return OK;
+      }
+      if (entry_->writer) {
+        next_state_ = STATE_CACHE_READ_DATA;
+        return cache_->WaitForStreamedData(entry_, this);
+      }
+      if (!IsStreamedBodyComplete()) {
+        DLOG(ERROR) << "the writer stopped before storing the whole body";
+        return ERR_CACHE_READ_FAILURE;
+      }
+    }
     RecordHistograms();
     cache_->DoneReadingFromEntry(entry_, this);
     entry_ = NULL;
@@ -1634,6 +1676,16 @@ int HttpCache::Transaction::DoCacheWriteDataComplete(int result) {
       return DoPartialNetworkReadCompleted(result);
   }
 
+  if (result > 0 && entry_) {
+    // Let other transactions for this resource follow the body as we store it.
+    if (mode_ == WRITE && !partial_.get() && !truncated_ &&
+        request_->method == "GET" &&
+        response_.headers->response_code() == 200) {
+      cache_->ShareEntryWithReaders(entry_);
+    }
+    cache_->ResumeStreamingReaders(entry_);
+  }
+
   if (result == 0) {
     // End of file. This may be the result of a connection problem so see if we
     // have to keep the entry around to be flagged as truncated later on.
@@ -1804,6 +1856,26 @@ int HttpCache::Transaction::BeginCacheRead() {
 int HttpCache::Transaction::BeginCacheValidation() {
   DCHECK(mode_ == READ_WRITE);
 
+  if (streaming_reader_) {
+    // If the response being written cannot be used without validation, we
+    // have to wait for the writer to finish before issuing our own request.
+    if (RequiresValidation()) {
+      must_validate_ = true;
+      streaming_reader_ = false;
+      cache_->DoneReadingFromEntry(entry_, this);
+      new_entry_ = entry_;
+      entry_ = NULL;
+      next_state_ = STATE_ADD_TO_ENTRY;
+      return OK;
+    }
+
+    UpdateTransactionPattern(PATTERN_ENTRY_USED);
+    mode_ = READ;
+    if (entry_->disk_entry->GetDataSize(kMetadataIndex))
+      next_state_ = STATE_CACHE_READ_METADATA;
+    return OK;
+  }
+
   bool skip_validation = !RequiresValidation();
 
   if (truncated_) {
@@ -2297,6 +2369,13 @@ int HttpCache::Transaction::AppendResponseDataToEntry(
                       callback);
 }
 
+bool HttpCache::Transaction::IsStreamedBodyComplete() const {
+  int64 content_length = response_.headers->GetContentLength();
+  if (content_length >= 0)
+    return read_offset_ >= content_length;
+  return !entry_->streaming_incomplete;
+}
+
 void HttpCache::Transaction::DoneWritingToEntry(bool success) {
   if (!entry_)
     return;
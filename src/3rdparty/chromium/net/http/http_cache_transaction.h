@@ -101,6 +101,11 @@ class HttpCache::Transaction : public HttpTransaction {
   // to the cache entry.
   LoadState GetWriterLoadState() const;
 
+  // Returns true if this transaction can read the response body while another
+  // transaction is still writing it to the cache entry, in which case the
+  // transaction is set up to follow the writer.
+  bool StartReadingWhileWriting();
+
   const CompletionCallback& io_callback() { return io_callback_; }
 
   const BoundNetLog& net_log() const;
@@ -339,6 +344,10 @@ class HttpCache::Transaction : public HttpTransaction {
   int AppendResponseDataToEntry(IOBuffer* data, int data_len,
                                 const CompletionCallback& callback);
 
+  // Returns true if a reader that followed the writer of the entry got the
+  // whole body, once the writer is gone.
+  bool IsStreamedBodyComplete() const;
+
   // Called when we are done writing to the cache entry.
   void DoneWritingToEntry(bool success);
 
@@ -412,6 +421,8 @@ class HttpCache::Transaction : public HttpTransaction {
   bool cache_pending_;  // We are waiting for the HttpCache.
   bool done_reading_;
   bool vary_mismatch_;  // The request doesn't match the stored vary data.
+  bool streaming_reader_;  // We read the body while it is being written.
+  bool must_validate_;  // We can't follow the writer of the entry.
   bool couldnt_conditionalize_request_;
   scoped_refptr<IOBuffer> read_buf_;
   int io_buf_len_;
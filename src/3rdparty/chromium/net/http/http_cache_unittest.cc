@@ -1413,11 +1413,12 @@ TEST(HttpCache, SimpleGET_RacingReaders) {
   c->result = c->callback.WaitForResult();
   ReadAndVerifyTransaction(c->trans.get(), kSimpleGET_Transaction);
 
-  // Now we have 2 active readers and two queued transactions.
+  // Now we have 4 active readers, all of them joined while the first request
+  // was storing the body.
 
   EXPECT_EQ(net::LOAD_STATE_IDLE,
             context_list[2]->trans->GetLoadState());
-  EXPECT_EQ(net::LOAD_STATE_WAITING_FOR_CACHE,
+  EXPECT_EQ(net::LOAD_STATE_IDLE,
             context_list[3]->trans->GetLoadState());
 
   c = context_list[1];
@@ -1426,10 +1427,8 @@ TEST(HttpCache, SimpleGET_RacingReaders) {
   if (c->result == net::OK)
     ReadAndVerifyTransaction(c->trans.get(), kSimpleGET_Transaction);
 
-  // At this point we have one reader, two pending transactions and a task on
-  // the queue to move to the next transaction. Now we cancel the request that
-  // is the current reader, and expect the queued task to be able to start the
-  // next request.
+  // At this point we have three readers. Now we cancel one of them, and expect
+  // the rest to be able to finish reading the entry.
 
   c = context_list[2];
   c->trans.reset();
@@ -1454,6 +1453,127 @@ TEST(HttpCache, SimpleGET_RacingReaders) {
   }
 }
 
+// Tests that transactions waiting for an entry that is being written read the
+// body as it is stored, instead of waiting for the writer to finish.
+TEST(HttpCache, SimpleGET_ReadersFollowWriter) {
+  MockHttpCache cache;
+
+  std::string body;
+  for (int i = 0; i < 64; ++i)
+    body.append(base::StringPrintf("line %02d of the body\n", i));
+  ScopedMockTransaction transaction(kSimpleGET_Transaction);
+  transaction.data = body.c_str();
+  MockHttpRequest request(transaction);
+
+  ScopedVector<Context> context_list;
+  std::vector<scoped_refptr<net::IOBuffer> > buffers;
+  const int kNumTransactions = 3;
+  const int kBufferSize = 256;
+
+  for (int i = 0; i < kNumTransactions; ++i) {
+    context_list.push_back(new Context());
+    buffers.push_back(new net::IOBuffer(kBufferSize));
+    Context* c = context_list[i];
+
+    c->result = cache.http_cache()->CreateTransaction(
+        net::DEFAULT_PRIORITY, &c->trans, NULL);
+    EXPECT_EQ(net::OK, c->result);
+
+    c->result = c->trans->Start(
+        &request, c->callback.callback(), net::BoundNetLog());
+  }
+
+  // The first request is the writer. Store the first part of the body.
+  Context* writer = context_list[0];
+  ASSERT_EQ(net::OK, writer->callback.GetResult(writer->result));
+  int rv = writer->trans->Read(buffers[0].get(), kBufferSize,
+                               writer->callback.callback());
+  ASSERT_EQ(kBufferSize, writer->callback.GetResult(rv));
+  std::string writer_content(buffers[0]->data(), kBufferSize);
+
+  // The other requests read what is stored so far, and then wait for the
+  // writer.
+  for (int i = 1; i < kNumTransactions; ++i) {
+    Context* c = context_list[i];
+    ASSERT_EQ(net::OK, c->callback.GetResult(c->result));
+    rv = c->trans->Read(buffers[i].get(), kBufferSize, c->callback.callback());
+    ASSERT_EQ(kBufferSize, c->callback.GetResult(rv));
+    EXPECT_EQ(writer_content, std::string(buffers[i]->data(), kBufferSize));
+
+    c->result = c->trans->Read(buffers[i].get(), kBufferSize,
+                               c->callback.callback());
+    EXPECT_EQ(net::ERR_IO_PENDING, c->result);
+  }
+  base::MessageLoop::current()->RunUntilIdle();
+  for (int i = 1; i < kNumTransactions; ++i)
+    EXPECT_FALSE(context_list[i]->callback.have_result());
+
+  std::string content;
+  EXPECT_EQ(net::OK, ReadTransaction(writer->trans.get(), &content));
+  EXPECT_EQ(body, writer_content + content);
+
+  for (int i = 1; i < kNumTransactions; ++i) {
+    Context* c = context_list[i];
+    ASSERT_EQ(kBufferSize, c->callback.WaitForResult());
+    std::string reader_content = writer_content +
+        std::string(buffers[i]->data(), kBufferSize);
+    EXPECT_EQ(net::OK, ReadTransaction(c->trans.get(), &content));
+    EXPECT_EQ(body, reader_content + content);
+  }
+
+  EXPECT_EQ(1, cache.network_layer()->transaction_count());
+  EXPECT_EQ(0, cache.disk_cache()->open_count());
+  EXPECT_EQ(1, cache.disk_cache()->create_count());
+}
+
+// Tests that a transaction reading the body while it is being written fails if
+// the writer goes away before storing the whole body, and that the entry is
+// not used again.
+TEST(HttpCache, SimpleGET_ReadersFollowWriter_CancelWriter) {
+  MockHttpCache cache;
+
+  std::string body(2048, 'x');
+  ScopedMockTransaction transaction(kSimpleGET_Transaction);
+  transaction.data = body.c_str();
+  MockHttpRequest request(transaction);
+
+  Context writer;
+  Context reader;
+  scoped_refptr<net::IOBuffer> buf(new net::IOBuffer(256));
+
+  EXPECT_EQ(net::OK, cache.http_cache()->CreateTransaction(
+      net::DEFAULT_PRIORITY, &writer.trans, NULL));
+  writer.result = writer.trans->Start(
+      &request, writer.callback.callback(), net::BoundNetLog());
+  EXPECT_EQ(net::OK, cache.http_cache()->CreateTransaction(
+      net::DEFAULT_PRIORITY, &reader.trans, NULL));
+  reader.result = reader.trans->Start(
+      &request, reader.callback.callback(), net::BoundNetLog());
+
+  ASSERT_EQ(net::OK, writer.callback.GetResult(writer.result));
+  int rv = writer.trans->Read(buf.get(), 256, writer.callback.callback());
+  ASSERT_EQ(256, writer.callback.GetResult(rv));
+
+  ASSERT_EQ(net::OK, reader.callback.GetResult(reader.result));
+  rv = reader.trans->Read(buf.get(), 256, reader.callback.callback());
+  ASSERT_EQ(256, reader.callback.GetResult(rv));
+  reader.result = reader.trans->Read(buf.get(), 256,
+                                     reader.callback.callback());
+  EXPECT_EQ(net::ERR_IO_PENDING, reader.result);
+
+  // Cancel the writer in the middle of the body.
+  writer.trans.reset();
+  EXPECT_EQ(net::ERR_CACHE_READ_FAILURE, reader.callback.WaitForResult());
+  reader.trans.reset();
+
+  // The next request goes to the network.
+  RunTransactionTest(cache.http_cache(), transaction);
+
+  EXPECT_EQ(2, cache.network_layer()->transaction_count());
+  EXPECT_EQ(0, cache.disk_cache()->open_count());
+  EXPECT_EQ(2, cache.disk_cache()->create_count());
+}
+
 // Tests that we can doom an entry with pending transactions and delete one of
 // the pending transactions before the first one completes.
 // See http://code.google.com/p/chromium/issues/detail?id=25588
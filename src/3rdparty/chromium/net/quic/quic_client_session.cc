@@ -488,14 +488,21 @@ void QuicClientSession::OnReadComplete(int result) {
   IPEndPoint peer_address;
   socket_->GetLocalAddress(&local_address);
   socket_->GetPeerAddress(&peer_address);
+  // Packets written while processing this packet, and any others read
+  // right after it, go out in as few writes as possible.
+  base::WeakPtr<QuicClientSession> weak_this = weak_factory_.GetWeakPtr();
+  connection()->StartBatchedWrites();
   // ProcessUdpPacket might result in |this| being deleted, so we
   // use a weak pointer to be safe.
   connection()->ProcessUdpPacket(local_address, peer_address, packet);
   if (!connection()->connected()) {
+    connection()->FinishBatchedWrites();
     stream_factory_->OnSessionClosed(this);
     return;
   }
   StartReading();
+  if (weak_this.get())
+    connection()->FinishBatchedWrites();
 }
 
 void QuicClientSession::NotifyFactoryOfSessionGoingAway() {
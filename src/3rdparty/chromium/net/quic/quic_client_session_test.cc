@@ -54,6 +54,14 @@ class TestPacketWriter : public QuicDefaultPacketWriter {
     return true;
   }
 
+  virtual bool IsBatchMode() const OVERRIDE {
+    return false;
+  }
+
+  virtual WriteResult Flush() OVERRIDE {
+    return WriteResult(WRITE_STATUS_OK, 0);
+  }
+
   // Returns the header from the last packet written.
   const QuicPacketHeader& header() { return header_; }
 
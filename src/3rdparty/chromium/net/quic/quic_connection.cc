@@ -188,6 +188,7 @@ QuicConnection::QuicConnection(QuicGuid guid,
       largest_seen_packet_with_ack_(0),
       pending_version_negotiation_packet_(false),
       write_blocked_(false),
+      batched_writes_depth_(0),
       received_packet_manager_(kTCP),
       ack_alarm_(helper->CreateAlarm(new AckAlarm(this))),
       retransmission_alarm_(helper->CreateAlarm(new RetransmissionAlarm(this))),
@@ -911,6 +912,30 @@ bool QuicConnection::WriteIfNotBlocked() {
   return DoWrite();
 }
 
+void QuicConnection::StartBatchedWrites() {
+  ++batched_writes_depth_;
+}
+
+void QuicConnection::FinishBatchedWrites() {
+  DCHECK_LT(0, batched_writes_depth_);
+  --batched_writes_depth_;
+  FlushWriter();
+}
+
+void QuicConnection::FlushWriter() {
+  if (batched_writes_depth_ > 0 || packet_generator_.InBatchMode() ||
+      !writer_->IsBatchMode()) {
+    return;
+  }
+  WriteResult result = writer_->Flush();
+  if (result.status == WRITE_STATUS_BLOCKED) {
+    write_blocked_ = true;
+  } else if (result.status == WRITE_STATUS_ERROR) {
+    DVLOG(1) << "Flush failed with error code: " << result.error_code;
+    CloseConnection(QUIC_PACKET_WRITE_ERROR, false);
+  }
+}
+
 bool QuicConnection::DoWrite() {
   DCHECK(!write_blocked_);
   WriteQueuedPackets();
@@ -1208,6 +1233,8 @@ bool QuicConnection::WritePacket(EncryptionLevel level,
 
   if (OnPacketSent(result)) {
     delete packet;
+    // Outside of a bundler, nothing else would flush a batched packet.
+    FlushWriter();
     return true;
   }
   return false;
@@ -1689,6 +1716,7 @@ QuicConnection::ScopedPacketBundler::~ScopedPacketBundler() {
   if (!already_in_batch_mode_) {
     DVLOG(1) << "Leaving Batch Mode.";
     connection_->packet_generator_.FinishBatchOperations();
+    connection_->FlushWriter();
   }
   DCHECK_EQ(already_in_batch_mode_,
             connection_->packet_generator_.InBatchMode());
@@ -256,6 +256,12 @@ class NET_EXPORT_PRIVATE QuicConnection
   // false if the socket has become blocked.
   bool WriteIfNotBlocked();
 
+  // Packets written between these calls are held back by a batching writer
+  // and flushed together once the outermost FinishBatchedWrites() is called,
+  // e.g. while processing a run of packets read from the socket at once.
+  void StartBatchedWrites();
+  void FinishBatchedWrites();
+
   // Do any work which logically would be done in OnPacket but can not be
   // safely done until the packet is validated.  Returns true if the packet
   // can be handled, false otherwise.
@@ -606,6 +612,10 @@ class NET_EXPORT_PRIVATE QuicConnection
   // Writes as many pending retransmissions as possible.
   void WritePendingRetransmissions();
 
+  // Writes out packets held back by a batching writer, unless a bundler or
+  // StartBatchedWrites() still wants them held.
+  void FlushWriter();
+
   // Returns true if the packet should be discarded and not sent.
   bool ShouldDiscardPacket(EncryptionLevel level,
                            QuicPacketSequenceNumber sequence_number,
@@ -694,6 +704,10 @@ class NET_EXPORT_PRIVATE QuicConnection
   // True when the socket becomes unwritable.
   bool write_blocked_;
 
+  // Number of StartBatchedWrites() calls not yet matched by
+  // FinishBatchedWrites().
+  int batched_writes_depth_;
+
   FecGroupMap group_map_;
 
   QuicReceivedPacketManager received_packet_manager_;
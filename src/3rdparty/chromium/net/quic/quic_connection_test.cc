@@ -313,6 +313,14 @@ class TestPacketWriter : public QuicPacketWriter {
     return is_write_blocked_data_buffered_;
   }
 
+  virtual bool IsBatchMode() const OVERRIDE {
+    return false;
+  }
+
+  virtual WriteResult Flush() OVERRIDE {
+    return WriteResult(WRITE_STATUS_OK, 0);
+  }
+
   // Resets the visitor's state by clearing out the headers and frames.
   void Reset() {
     visitor_.Reset();
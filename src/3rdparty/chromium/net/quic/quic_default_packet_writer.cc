@@ -12,12 +12,40 @@
 
 namespace net {
 
-QuicDefaultPacketWriter::QuicDefaultPacketWriter() : weak_factory_(this) {
+namespace {
+
+// Most packets held back before the writer flushes on its own.
+const size_t kMaxBatchedPackets = 32;
+
+WriteResult ToWriteResult(int rv) {
+  WriteStatus status = WRITE_STATUS_OK;
+  if (rv < 0) {
+    if (rv != ERR_IO_PENDING) {
+      UMA_HISTOGRAM_SPARSE_SLOWLY("Net.QuicSession.WriteError", -rv);
+      status = WRITE_STATUS_ERROR;
+    } else {
+      status = WRITE_STATUS_BLOCKED;
+    }
+  }
+  return WriteResult(status, rv);
+}
+
+}  // namespace
+
+QuicDefaultPacketWriter::QuicDefaultPacketWriter()
+    : weak_factory_(this),
+      socket_(NULL),
+      connection_(NULL),
+      flush_pending_(false),
+      blocked_packet_size_(0) {
 }
 
 QuicDefaultPacketWriter::QuicDefaultPacketWriter(DatagramClientSocket* socket)
     : weak_factory_(this),
-      socket_(socket) {
+      socket_(socket),
+      connection_(NULL),
+      flush_pending_(false),
+      blocked_packet_size_(0) {
 }
 
 QuicDefaultPacketWriter::~QuicDefaultPacketWriter() {}
@@ -27,23 +55,31 @@ WriteResult QuicDefaultPacketWriter::WritePacket(
     const net::IPAddressNumber& self_address,
     const net::IPEndPoint& peer_address,
     QuicBlockedWriterInterface* blocked_writer) {
+  if (IsBatchMode()) {
+    batch_.append(buffer, buf_len);
+    batch_sizes_.push_back(buf_len);
+    WriteResult result(WRITE_STATUS_OK, buf_len);
+    if (flush_pending_) {
+      // The packet goes out with the next batch, once the socket is done
+      // with the current one.
+      result = WriteResult(WRITE_STATUS_BLOCKED, ERR_IO_PENDING);
+    } else if (batch_sizes_.size() >= kMaxBatchedPackets) {
+      result = Flush();
+      if (result.status == WRITE_STATUS_OK)
+        result.bytes_written = buf_len;
+    }
+    if (result.status == WRITE_STATUS_BLOCKED)
+      blocked_packet_size_ = buf_len;
+    return result;
+  }
+
   scoped_refptr<StringIOBuffer> buf(
       new StringIOBuffer(std::string(buffer, buf_len)));
   int rv = socket_->Write(buf.get(),
                           buf_len,
                           base::Bind(&QuicDefaultPacketWriter::OnWriteComplete,
                                      weak_factory_.GetWeakPtr()));
-  WriteStatus status = WRITE_STATUS_OK;
-  if (rv < 0) {
-    if (rv != ERR_IO_PENDING) {
-      UMA_HISTOGRAM_SPARSE_SLOWLY("Net.QuicSession.WriteError", -rv);
-      status = WRITE_STATUS_ERROR;
-    } else {
-      status = WRITE_STATUS_BLOCKED;
-    }
-  }
-
-  return WriteResult(status, rv);
+  return ToWriteResult(rv);
 }
 
 bool QuicDefaultPacketWriter::IsWriteBlockedDataBuffered() const {
@@ -52,6 +88,52 @@ bool QuicDefaultPacketWriter::IsWriteBlockedDataBuffered() const {
   return true;
 }
 
+bool QuicDefaultPacketWriter::IsBatchMode() const {
+  return socket_ && socket_->SupportsWriteMultiple();
+}
+
+WriteResult QuicDefaultPacketWriter::Flush() {
+  if (flush_pending_)
+    return WriteResult(WRITE_STATUS_BLOCKED, ERR_IO_PENDING);
+  if (batch_sizes_.empty())
+    return WriteResult(WRITE_STATUS_OK, 0);
+
+  scoped_refptr<StringIOBuffer> buf(new StringIOBuffer(batch_));
+  std::vector<int> sizes;
+  sizes.swap(batch_sizes_);
+  batch_.clear();
+  int rv = socket_->WriteMultiple(
+      buf.get(), sizes,
+      base::Bind(&QuicDefaultPacketWriter::OnFlushComplete,
+                 weak_factory_.GetWeakPtr()));
+  if (rv == ERR_IO_PENDING)
+    flush_pending_ = true;
+  return ToWriteResult(rv);
+}
+
+void QuicDefaultPacketWriter::OnFlushComplete(int rv) {
+  DCHECK_NE(rv, ERR_IO_PENDING);
+  flush_pending_ = false;
+  if (rv >= 0 && !batch_sizes_.empty()) {
+    // Send what was held back while the socket was busy.
+    WriteResult result = Flush();
+    if (result.status == WRITE_STATUS_BLOCKED)
+      return;
+    rv = result.bytes_written;
+  }
+
+  WriteResult result(rv < 0 ? WRITE_STATUS_ERROR : WRITE_STATUS_OK, rv);
+  if (blocked_packet_size_ != 0) {
+    if (result.status == WRITE_STATUS_OK)
+      result.bytes_written = blocked_packet_size_;
+    blocked_packet_size_ = 0;
+    connection_->OnPacketSent(result);
+  } else if (result.status == WRITE_STATUS_ERROR) {
+    connection_->CloseConnection(QUIC_PACKET_WRITE_ERROR, false);
+  }
+  connection_->OnCanWrite();
+}
+
 void QuicDefaultPacketWriter::OnWriteComplete(int rv) {
   DCHECK_NE(rv, ERR_IO_PENDING);
   WriteResult result(rv < 0 ? WRITE_STATUS_ERROR : WRITE_STATUS_OK, rv);
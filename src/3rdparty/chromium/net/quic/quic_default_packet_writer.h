@@ -5,6 +5,9 @@
 #ifndef NET_QUIC_QUIC_DEFAULT_PACKET_WRITER_H_
 #define NET_QUIC_QUIC_DEFAULT_PACKET_WRITER_H_
 
+#include <string>
+#include <vector>
+
 #include "base/basictypes.h"
 #include "base/memory/weak_ptr.h"
 #include "net/base/ip_endpoint.h"
@@ -33,8 +36,11 @@ class NET_EXPORT_PRIVATE QuicDefaultPacketWriter : public QuicPacketWriter {
       QuicBlockedWriterInterface* blocked_writer) OVERRIDE;
 
   virtual bool IsWriteBlockedDataBuffered() const OVERRIDE;
+  virtual bool IsBatchMode() const OVERRIDE;
+  virtual WriteResult Flush() OVERRIDE;
 
   void OnWriteComplete(int rv);
+  void OnFlushComplete(int rv);
   void SetConnection(QuicConnection* connection) {
     connection_ = connection;
   }
@@ -43,6 +49,17 @@ class NET_EXPORT_PRIVATE QuicDefaultPacketWriter : public QuicPacketWriter {
   base::WeakPtrFactory<QuicDefaultPacketWriter> weak_factory_;
   DatagramClientSocket* socket_;
   QuicConnection* connection_;
+
+  // Packets held back until the next Flush(), stored back to back.
+  std::string batch_;
+  std::vector<int> batch_sizes_;
+
+  // True while the socket is still writing the previous batch.
+  bool flush_pending_;
+
+  // Size of the packet that was reported to |connection_| as blocked because
+  // the socket was busy, or 0.
+  size_t blocked_packet_size_;
 };
 
 }  // namespace net
@@ -0,0 +1,198 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <string>
+
+#include "base/basictypes.h"
+#include "base/compiler_specific.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/memory/scoped_vector.h"
+#include "base/message_loop/message_loop.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/test/perf_time_logger.h"
+#include "net/cert/mock_cert_verifier.h"
+#include "net/dns/mapped_host_resolver.h"
+#include "net/dns/mock_host_resolver.h"
+#include "net/http/http_auth_handler_factory.h"
+#include "net/http/http_network_session.h"
+#include "net/http/http_network_transaction.h"
+#include "net/http/http_server_properties_impl.h"
+#include "net/http/http_transaction_unittest.h"
+#include "net/http/transport_security_state.h"
+#include "net/proxy/proxy_service.h"
+#include "net/ssl/ssl_config_service_defaults.h"
+#include "net/tools/quic/quic_in_memory_cache.h"
+#include "net/tools/quic/test_tools/quic_in_memory_cache_peer.h"
+#include "net/tools/quic/test_tools/server_thread.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+using base::StringPiece;
+using net::tools::QuicInMemoryCache;
+using net::tools::test::QuicInMemoryCachePeer;
+using net::tools::test::ServerThread;
+
+namespace net {
+namespace test {
+
+namespace {
+
+const size_t kLargeResponseSize = 16 * 1024 * 1024;
+const size_t kNumConcurrentRequests = 8;
+const size_t kConcurrentResponseSize = 2 * 1024 * 1024;
+
+// Factory for creating HttpTransactions, used by TestTransactionConsumer.
+class TestTransactionFactory : public HttpTransactionFactory {
+ public:
+  explicit TestTransactionFactory(const HttpNetworkSession::Params& params)
+      : session_(new HttpNetworkSession(params)) {}
+
+  // HttpTransactionFactory methods
+  virtual int CreateTransaction(RequestPriority priority,
+                                scoped_ptr<HttpTransaction>* trans,
+                                HttpTransactionDelegate* delegate) OVERRIDE {
+    trans->reset(new HttpNetworkTransaction(priority, session_));
+    return OK;
+  }
+
+  virtual HttpCache* GetCache() OVERRIDE {
+    return NULL;
+  }
+
+  virtual HttpNetworkSession* GetSession() OVERRIDE {
+    return session_;
+  };
+
+ private:
+  scoped_refptr<HttpNetworkSession> session_;
+};
+
+}  // namespace
+
+// Measures how fast the QUIC client stack pulls data from a QUIC server
+// running on the loopback interface.
+class QuicEndToEndPerfTest : public testing::Test {
+ protected:
+  QuicEndToEndPerfTest()
+      : message_loop_(new base::MessageLoopForIO()),
+        host_resolver_impl_(CreateResolverImpl()),
+        host_resolver_(host_resolver_impl_.PassAs<HostResolver>()),
+        ssl_config_service_(new SSLConfigServiceDefaults),
+        proxy_service_(ProxyService::CreateDirect()),
+        auth_handler_factory_(
+            HttpAuthHandlerFactory::CreateDefault(&host_resolver_)) {
+    request_.method = "GET";
+    request_.url = GURL("http://www.google.com/");
+    request_.load_flags = 0;
+
+    params_.enable_quic = true;
+    params_.quic_clock = NULL;
+    params_.quic_random = NULL;
+    params_.host_resolver = &host_resolver_;
+    params_.cert_verifier = &cert_verifier_;
+    params_.transport_security_state = &transport_security_state_;
+    params_.proxy_service = proxy_service_.get();
+    params_.ssl_config_service = ssl_config_service_.get();
+    params_.http_auth_handler_factory = auth_handler_factory_.get();
+    params_.http_server_properties = http_server_properties_.GetWeakPtr();
+  }
+
+  // Creates a mock host resolver in which www.google.com
+  // resolves to localhost.
+  static MockHostResolver* CreateResolverImpl() {
+    MockHostResolver* resolver = new MockHostResolver();
+    resolver->rules()->AddRule("www.google.com", "127.0.0.1");
+    return resolver;
+  }
+
+  virtual void SetUp() OVERRIDE {
+    QuicInMemoryCachePeer::ResetForTests();
+
+    IPAddressNumber ip;
+    CHECK(ParseIPLiteralToNumber("127.0.0.1", &ip));
+    server_config_.SetDefaults();
+    server_thread_.reset(new ServerThread(IPEndPoint(ip, 0), server_config_,
+                                          QuicSupportedVersions(), false));
+    server_thread_->Start();
+    server_thread_->WaitForServerStartup();
+
+    std::string map_rule = "MAP www.google.com www.google.com:" +
+        base::IntToString(server_thread_->GetPort());
+    EXPECT_TRUE(host_resolver_.AddRuleFromString(map_rule));
+    params_.origin_to_force_quic_on =
+        HostPortPair::FromString("www.google.com:80");
+
+    transaction_factory_.reset(new TestTransactionFactory(params_));
+  }
+
+  virtual void TearDown() OVERRIDE {
+    transaction_factory_.reset();
+    server_thread_->Quit();
+    server_thread_->Join();
+    QuicInMemoryCachePeer::ResetForTests();
+  }
+
+  void AddToCache(const StringPiece& path, const StringPiece& body) {
+    QuicInMemoryCache::GetInstance()->AddSimpleResponse(
+        "GET", path, "HTTP/1.1", "200", "OK", body);
+  }
+
+  scoped_ptr<base::MessageLoop> message_loop_;
+  scoped_ptr<MockHostResolver> host_resolver_impl_;
+  MappedHostResolver host_resolver_;
+  MockCertVerifier cert_verifier_;
+  TransportSecurityState transport_security_state_;
+  scoped_refptr<SSLConfigServiceDefaults> ssl_config_service_;
+  scoped_ptr<ProxyService> proxy_service_;
+  scoped_ptr<HttpAuthHandlerFactory> auth_handler_factory_;
+  HttpServerPropertiesImpl http_server_properties_;
+  HttpNetworkSession::Params params_;
+  scoped_ptr<TestTransactionFactory> transaction_factory_;
+  HttpRequestInfo request_;
+  scoped_ptr<ServerThread> server_thread_;
+  QuicConfig server_config_;
+};
+
+TEST_F(QuicEndToEndPerfTest, LargeDownload) {
+  std::string response(kLargeResponseSize, 'x');
+  AddToCache(request_.url.spec(), response);
+
+  TestTransactionConsumer consumer(DEFAULT_PRIORITY,
+                                   transaction_factory_.get());
+  base::PerfTimeLogger timer("Quic_loopback_16MB_download");
+  consumer.Start(&request_, BoundNetLog());
+  // Will terminate when the consumer completes.
+  base::MessageLoop::current()->Run();
+  timer.Done();
+
+  ASSERT_TRUE(consumer.is_done());
+  EXPECT_EQ(OK, consumer.error());
+  EXPECT_EQ(kLargeResponseSize, consumer.content().size());
+}
+
+TEST_F(QuicEndToEndPerfTest, ConcurrentDownloads) {
+  std::string response(kConcurrentResponseSize, 'x');
+  AddToCache(request_.url.spec(), response);
+
+  ScopedVector<TestTransactionConsumer> consumers;
+  for (size_t i = 0; i < kNumConcurrentRequests; ++i) {
+    consumers.push_back(new TestTransactionConsumer(
+        DEFAULT_PRIORITY, transaction_factory_.get()));
+  }
+
+  base::PerfTimeLogger timer("Quic_loopback_concurrent_downloads");
+  for (size_t i = 0; i < kNumConcurrentRequests; ++i)
+    consumers[i]->Start(&request_, BoundNetLog());
+  // Will terminate when the last consumer completes.
+  base::MessageLoop::current()->Run();
+  timer.Done();
+
+  for (size_t i = 0; i < kNumConcurrentRequests; ++i) {
+    ASSERT_TRUE(consumers[i]->is_done());
+    EXPECT_EQ(OK, consumers[i]->error());
+    EXPECT_EQ(kConcurrentResponseSize, consumers[i]->content().size());
+  }
+}
+
+}  // namespace test
+}  // namespace net
@@ -34,6 +34,16 @@ class NET_EXPORT_PRIVATE QuicPacketWriter {
   // when an attempt to write results in the underlying socket becoming
   // write blocked.
   virtual bool IsWriteBlockedDataBuffered() const = 0;
+
+  // Returns true if WritePacket() may hold packets back until Flush() is
+  // called, so that several go out with a single system call. Packets held
+  // back are reported as written.
+  virtual bool IsBatchMode() const = 0;
+
+  // Writes out the packets held back by WritePacket(). Returns
+  // WRITE_STATUS_OK with the number of bytes written, WRITE_STATUS_BLOCKED
+  // if the socket filled up, or WRITE_STATUS_ERROR.
+  virtual WriteResult Flush() = 0;
 };
 
 }  // namespace net
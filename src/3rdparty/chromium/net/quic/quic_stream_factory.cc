@@ -474,6 +474,8 @@ int QuicStreamFactory::CreateSession(
   int rv = socket->Connect(addr);
   if (rv != OK)
     return rv;
+  // Packets are read into kMaxPacketSize buffers and often arrive in bursts.
+  socket->EnableReadBatching();
   UMA_HISTOGRAM_COUNTS("Net.QuicEphemeralPortsSuggested",
                        port_suggester->call_count());
 
@@ -370,6 +370,8 @@ class MockPacketWriter : public QuicPacketWriter {
                            const IPEndPoint& peer_address,
                            QuicBlockedWriterInterface* blocked_writer));
   MOCK_CONST_METHOD0(IsWriteBlockedDataBuffered, bool());
+  MOCK_CONST_METHOD0(IsBatchMode, bool());
+  MOCK_METHOD0(Flush, WriteResult());
 };
 
 class MockSendAlgorithm : public SendAlgorithmInterface {
@@ -19,5 +19,13 @@ void QuicTestWriter::set_writer(QuicPacketWriter* writer) {
   writer_.reset(writer);
 }
 
+bool QuicTestWriter::IsBatchMode() const {
+  return false;
+}
+
+WriteResult QuicTestWriter::Flush() {
+  return WriteResult(WRITE_STATUS_OK, 0);
+}
+
 }  // namespace test
 }  // namespace net
@@ -20,6 +20,11 @@ class QuicTestWriter : public QuicPacketWriter {
   // Takes ownership of |writer|.
   void set_writer(QuicPacketWriter* writer);
 
+  // QuicPacketWriter
+  // Test writers hand each packet to the wrapped writer straight away.
+  virtual bool IsBatchMode() const OVERRIDE;
+  virtual WriteResult Flush() OVERRIDE;
+
  protected:
   QuicPacketWriter* writer();
 
@@ -1128,6 +1128,21 @@ int DeterministicMockUDPClientSocket::Connect(const IPEndPoint& address) {
   return helper_.data()->connect_data().result;
 };
 
+int DeterministicMockUDPClientSocket::WriteMultiple(
+    IOBuffer* buf,
+    const std::vector<int>& datagram_sizes,
+    const CompletionCallback& callback) {
+  NOTIMPLEMENTED();
+  return ERR_NOT_IMPLEMENTED;
+}
+
+bool DeterministicMockUDPClientSocket::SupportsWriteMultiple() const {
+  return false;
+}
+
+void DeterministicMockUDPClientSocket::EnableReadBatching() {
+}
+
 int DeterministicMockUDPClientSocket::Write(
     IOBuffer* buf,
     int buf_len,
@@ -1527,6 +1542,20 @@ int MockUDPClientSocket::Connect(const IPEndPoint& address) {
   return OK;
 }
 
+int MockUDPClientSocket::WriteMultiple(IOBuffer* buf,
+                                       const std::vector<int>& datagram_sizes,
+                                       const CompletionCallback& callback) {
+  NOTIMPLEMENTED();
+  return ERR_NOT_IMPLEMENTED;
+}
+
+bool MockUDPClientSocket::SupportsWriteMultiple() const {
+  return false;
+}
+
+void MockUDPClientSocket::EnableReadBatching() {
+}
+
 void MockUDPClientSocket::OnReadComplete(const MockRead& data) {
   // There must be a read pending.
   DCHECK(pending_buf_);
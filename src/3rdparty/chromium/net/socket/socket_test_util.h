@@ -857,6 +857,11 @@ class DeterministicMockUDPClientSocket
 
   // DatagramClientSocket implementation.
   virtual int Connect(const IPEndPoint& address) OVERRIDE;
+  virtual int WriteMultiple(IOBuffer* buf,
+                            const std::vector<int>& datagram_sizes,
+                            const CompletionCallback& callback) OVERRIDE;
+  virtual bool SupportsWriteMultiple() const OVERRIDE;
+  virtual void EnableReadBatching() OVERRIDE;
 
   // AsyncSocket implementation.
   virtual void OnReadComplete(const MockRead& data) OVERRIDE;
@@ -996,6 +1001,11 @@ class MockUDPClientSocket : public DatagramClientSocket, public AsyncSocket {
 
   // DatagramClientSocket implementation.
   virtual int Connect(const IPEndPoint& address) OVERRIDE;
+  virtual int WriteMultiple(IOBuffer* buf,
+                            const std::vector<int>& datagram_sizes,
+                            const CompletionCallback& callback) OVERRIDE;
+  virtual bool SupportsWriteMultiple() const OVERRIDE;
+  virtual void EnableReadBatching() OVERRIDE;
 
   // AsyncSocket implementation.
   virtual void OnReadComplete(const MockRead& data) OVERRIDE;
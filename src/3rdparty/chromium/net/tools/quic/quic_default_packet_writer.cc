@@ -26,5 +26,13 @@ bool QuicDefaultPacketWriter::IsWriteBlockedDataBuffered() const {
   return false;
 }
 
+bool QuicDefaultPacketWriter::IsBatchMode() const {
+  return false;
+}
+
+WriteResult QuicDefaultPacketWriter::Flush() {
+  return WriteResult(WRITE_STATUS_OK, 0);
+}
+
 }  // namespace tools
 }  // namespace net
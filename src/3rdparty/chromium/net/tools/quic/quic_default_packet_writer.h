@@ -29,6 +29,8 @@ class QuicDefaultPacketWriter : public QuicPacketWriter {
       const net::IPEndPoint& peer_address,
       QuicBlockedWriterInterface* blocked_writer) OVERRIDE;
   virtual bool IsWriteBlockedDataBuffered() const OVERRIDE;
+  virtual bool IsBatchMode() const OVERRIDE;
+  virtual WriteResult Flush() OVERRIDE;
 
  private:
   int fd_;
@@ -85,6 +85,14 @@ bool QuicDispatcher::IsWriteBlockedDataBuffered() const {
   return writer_->IsWriteBlockedDataBuffered();
 }
 
+bool QuicDispatcher::IsBatchMode() const {
+  return writer_->IsBatchMode();
+}
+
+WriteResult QuicDispatcher::Flush() {
+  return writer_->Flush();
+}
+
 void QuicDispatcher::ProcessPacket(const IPEndPoint& server_address,
                                    const IPEndPoint& client_address,
                                    QuicGuid guid,
@@ -71,6 +71,8 @@ class QuicDispatcher : public QuicPacketWriter, public QuicSessionOwner {
       const IPEndPoint& peer_address,
       QuicBlockedWriterInterface* writer) OVERRIDE;
   virtual bool IsWriteBlockedDataBuffered() const OVERRIDE;
+  virtual bool IsBatchMode() const OVERRIDE;
+  virtual WriteResult Flush() OVERRIDE;
 
   // Process the incoming packet by creating a new session, passing it to
   // an existing session, or passing it to the TimeWaitListManager.
@@ -5,11 +5,14 @@
 #ifndef NET_UDP_DATAGRAM_CLIENT_SOCKET_H_
 #define NET_UDP_DATAGRAM_CLIENT_SOCKET_H_
 
+#include <vector>
+
 #include "net/socket/socket.h"
 #include "net/udp/datagram_socket.h"
 
 namespace net {
 
+class IOBuffer;
 class IPEndPoint;
 
 class NET_EXPORT_PRIVATE DatagramClientSocket : public DatagramSocket,
@@ -20,6 +23,24 @@ class NET_EXPORT_PRIVATE DatagramClientSocket : public DatagramSocket,
   // Initialize this socket as a client socket to server at |address|.
   // Returns a network error code.
   virtual int Connect(const IPEndPoint& address) = 0;
+
+  // Writes several datagrams, stored back to back in |buf| and sized by
+  // |datagram_sizes|. Returns the number of bytes written or a net error
+  // code. If ERR_IO_PENDING is returned, the socket keeps |buf| and runs
+  // |callback| once every datagram has been written.
+  virtual int WriteMultiple(IOBuffer* buf,
+                            const std::vector<int>& datagram_sizes,
+                            const CompletionCallback& callback) = 0;
+
+  // Returns true if WriteMultiple() needs fewer system calls than calling
+  // Write() for each datagram. Callers should not use WriteMultiple()
+  // otherwise.
+  virtual bool SupportsWriteMultiple() const = 0;
+
+  // Lets Read() receive several datagrams per system call where the
+  // platform supports it. Meant for sockets that receive many small
+  // datagrams, as it costs a buffer for a whole batch.
+  virtual void EnableReadBatching() = 0;
 };
 
 }  // namespace net
@@ -34,6 +34,20 @@ int UDPClientSocket::Write(IOBuffer* buf,
   return socket_.Write(buf, buf_len, callback);
 }
 
+int UDPClientSocket::WriteMultiple(IOBuffer* buf,
+                                   const std::vector<int>& datagram_sizes,
+                                   const CompletionCallback& callback) {
+  return socket_.WriteMultiple(buf, datagram_sizes, callback);
+}
+
+bool UDPClientSocket::SupportsWriteMultiple() const {
+  return socket_.SupportsWriteMultiple();
+}
+
+void UDPClientSocket::EnableReadBatching() {
+  socket_.EnableReadBatching();
+}
+
 void UDPClientSocket::Close() {
   socket_.Close();
 }
@@ -29,6 +29,11 @@ class NET_EXPORT_PRIVATE UDPClientSocket : public DatagramClientSocket {
                    const CompletionCallback& callback) OVERRIDE;
   virtual int Write(IOBuffer* buf, int buf_len,
                     const CompletionCallback& callback) OVERRIDE;
+  virtual int WriteMultiple(IOBuffer* buf,
+                            const std::vector<int>& datagram_sizes,
+                            const CompletionCallback& callback) OVERRIDE;
+  virtual bool SupportsWriteMultiple() const OVERRIDE;
+  virtual void EnableReadBatching() OVERRIDE;
   virtual void Close() OVERRIDE;
   virtual int GetPeerAddress(IPEndPoint* address) const OVERRIDE;
   virtual int GetLocalAddress(IPEndPoint* address) const OVERRIDE;
@@ -9,8 +9,12 @@
 #include <netdb.h>
 #include <net/if.h>
 #include <netinet/in.h>
+#include <string.h>
 #include <sys/ioctl.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
+
+#include <algorithm>
 
 #include "base/callback.h"
 #include "base/logging.h"
@@ -57,8 +61,45 @@ int GetIPv4AddressFromIndex(int socket, uint32 index, uint32* address){
 
 #endif  // OS_MACOSX
 
+#if defined(OS_LINUX)
+
+#ifndef SOL_UDP
+#define SOL_UDP 17
+#endif
+
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT 103
+#endif
+
+// Read() calls with buffers up to this size are served from datagrams
+// received in batches; bigger reads get one datagram per system call.
+const int kMaxBatchedDatagramSize = 2048;
+const int kReadBatchSize = 16;
+
+// Most datagrams handed to a single sendmmsg() call.
+const size_t kWriteBatchSize = 64;
+
+// Limits the kernel puts on a single UDP_SEGMENT write.
+const size_t kMaxSegments = 64;
+const int kMaxSegmentedBytes = 65000;
+
+#endif  // OS_LINUX
+
 }  // namespace
 
+#if defined(OS_LINUX)
+struct UDPSocketLibevent::ReadBatch {
+  ReadBatch() : count(0), next(0) {}
+
+  char data[kReadBatchSize][kMaxBatchedDatagramSize];
+  int sizes[kReadBatchSize];
+  sockaddr_storage addrs[kReadBatchSize];
+  socklen_t addr_lens[kReadBatchSize];
+  int count;
+  int next;
+};
+#endif  // OS_LINUX
+
 UDPSocketLibevent::UDPSocketLibevent(
     DatagramSocket::BindType bind_type,
     const RandIntCallback& rand_int_cb,
@@ -76,6 +117,12 @@ UDPSocketLibevent::UDPSocketLibevent(
           read_buf_len_(0),
           recv_from_address_(NULL),
           write_buf_len_(0),
+          write_datagram_index_(0),
+          write_datagram_offset_(0),
+#if defined(OS_LINUX)
+          read_batching_enabled_(false),
+          use_segmentation_offload_(true),
+#endif
           net_log_(BoundNetLog::Make(net_log, NetLog::SOURCE_UDP_SOCKET)) {
   net_log_.BeginEvent(NetLog::TYPE_SOCKET_ALIVE,
                       source.ToEventParametersCallback());
@@ -103,6 +150,12 @@ void UDPSocketLibevent::Close() {
   write_buf_len_ = 0;
   write_callback_.Reset();
   send_to_address_.reset();
+  write_datagram_sizes_.clear();
+  write_datagram_index_ = 0;
+  write_datagram_offset_ = 0;
+#if defined(OS_LINUX)
+  read_batch_.reset();
+#endif
 
   bool ok = read_socket_watcher_.StopWatchingFileDescriptor();
   DCHECK(ok);
@@ -201,6 +254,52 @@ int UDPSocketLibevent::Write(IOBuffer* buf,
   return SendToOrWrite(buf, buf_len, NULL, callback);
 }
 
+int UDPSocketLibevent::WriteMultiple(IOBuffer* buf,
+                                     const std::vector<int>& datagram_sizes,
+                                     const CompletionCallback& callback) {
+  DCHECK(CalledOnValidThread());
+  DCHECK_NE(kInvalidSocket, socket_);
+  DCHECK(write_callback_.is_null());
+  DCHECK(!callback.is_null());  // Synchronous operation not supported
+  DCHECK(!datagram_sizes.empty());
+
+  write_buf_ = buf;
+  write_datagram_sizes_ = datagram_sizes;
+  write_datagram_index_ = 0;
+  write_datagram_offset_ = 0;
+
+  int result = InternalWriteMultiple();
+  if (result == ERR_IO_PENDING) {
+    if (base::MessageLoopForIO::current()->WatchFileDescriptor(
+            socket_, true, base::MessageLoopForIO::WATCH_WRITE,
+            &write_socket_watcher_, &write_watcher_)) {
+      write_callback_ = callback;
+      return ERR_IO_PENDING;
+    }
+    DVLOG(1) << "WatchFileDescriptor failed on write, errno " << errno;
+    result = MapSystemError(errno);
+    LogWrite(result, NULL, NULL);
+  }
+
+  write_buf_ = NULL;
+  write_datagram_sizes_.clear();
+  return result;
+}
+
+bool UDPSocketLibevent::SupportsWriteMultiple() const {
+#if defined(OS_LINUX)
+  return true;
+#else
+  return false;
+#endif
+}
+
+void UDPSocketLibevent::EnableReadBatching() {
+#if defined(OS_LINUX)
+  read_batching_enabled_ = true;
+#endif
+}
+
 int UDPSocketLibevent::SendTo(IOBuffer* buf,
                               int buf_len,
                               const IPEndPoint& address,
@@ -428,13 +527,19 @@ int UDPSocketLibevent::CreateSocket(int addr_family) {
 }
 
 void UDPSocketLibevent::DidCompleteWrite() {
-  int result =
-      InternalSendTo(write_buf_.get(), write_buf_len_, send_to_address_.get());
+  int result;
+  if (!write_datagram_sizes_.empty()) {
+    result = InternalWriteMultiple();
+  } else {
+    result = InternalSendTo(write_buf_.get(), write_buf_len_,
+                            send_to_address_.get());
+  }
 
   if (result != ERR_IO_PENDING) {
     write_buf_ = NULL;
     write_buf_len_ = 0;
     send_to_address_.reset();
+    write_datagram_sizes_.clear();
     write_socket_watcher_.StopWatchingFileDescriptor();
     DoWriteCallback(result);
   }
@@ -460,6 +565,19 @@ void UDPSocketLibevent::LogWrite(int result,
 
 int UDPSocketLibevent::InternalRecvFrom(IOBuffer* buf, int buf_len,
                                         IPEndPoint* address) {
+#if defined(OS_LINUX)
+  if (read_batching_enabled_ && !address) {
+    // Datagrams already received in a batch go out first, whatever the size
+    // of |buf|, so that they are not reordered.
+    if (read_batch_ && read_batch_->next < read_batch_->count)
+      return InternalReadBatched(buf, buf_len);
+    // A bigger buffer may be meant for a datagram that doesn't fit in a
+    // batch slot, so it gets one without batching.
+    if (buf_len <= kMaxBatchedDatagramSize)
+      return InternalReadBatched(buf, buf_len);
+  }
+#endif
+
   int bytes_transferred;
   int flags = 0;
 
@@ -513,6 +631,149 @@ int UDPSocketLibevent::InternalSendTo(IOBuffer* buf, int buf_len,
   return result;
 }
 
+int UDPSocketLibevent::InternalWriteMultiple() {
+  while (write_datagram_index_ < write_datagram_sizes_.size()) {
+    int sent = SendDatagrams();
+    if (sent < 0) {
+      if (sent != ERR_IO_PENDING)
+        LogWrite(sent, NULL, NULL);
+      return sent;
+    }
+    for (int i = 0; i < sent; ++i) {
+      int size = write_datagram_sizes_[write_datagram_index_++];
+      LogWrite(size, write_buf_->data() + write_datagram_offset_, NULL);
+      write_datagram_offset_ += size;
+    }
+  }
+  return write_datagram_offset_;
+}
+
+int UDPSocketLibevent::SendDatagrams() {
+  char* data = write_buf_->data() + write_datagram_offset_;
+#if defined(OS_LINUX)
+  if (use_segmentation_offload_) {
+    int sent = SendSegmentedDatagrams();
+    if (sent != 0)
+      return sent;
+  }
+
+  size_t count = std::min(write_datagram_sizes_.size() - write_datagram_index_,
+                          kWriteBatchSize);
+  mmsghdr msgs[kWriteBatchSize];
+  iovec iovs[kWriteBatchSize];
+  memset(msgs, 0, count * sizeof(msgs[0]));
+  for (size_t i = 0; i < count; ++i) {
+    iovs[i].iov_base = data;
+    iovs[i].iov_len = write_datagram_sizes_[write_datagram_index_ + i];
+    msgs[i].msg_hdr.msg_iov = &iovs[i];
+    msgs[i].msg_hdr.msg_iovlen = 1;
+    data += iovs[i].iov_len;
+  }
+  int rv = HANDLE_EINTR(sendmmsg(socket_, msgs, count, 0));
+  return rv < 0 ? MapSystemError(errno) : rv;
+#else
+  int rv = HANDLE_EINTR(
+      send(socket_, data, write_datagram_sizes_[write_datagram_index_], 0));
+  return rv < 0 ? MapSystemError(errno) : 1;
+#endif
+}
+
+#if defined(OS_LINUX)
+int UDPSocketLibevent::InternalReadBatched(IOBuffer* buf, int buf_len) {
+  if (!read_batch_)
+    read_batch_.reset(new ReadBatch());
+  ReadBatch* batch = read_batch_.get();
+
+  if (batch->next == batch->count) {
+    mmsghdr msgs[kReadBatchSize];
+    iovec iovs[kReadBatchSize];
+    memset(msgs, 0, sizeof(msgs));
+    for (int i = 0; i < kReadBatchSize; ++i) {
+      iovs[i].iov_base = batch->data[i];
+      iovs[i].iov_len = kMaxBatchedDatagramSize;
+      msgs[i].msg_hdr.msg_iov = &iovs[i];
+      msgs[i].msg_hdr.msg_iovlen = 1;
+      msgs[i].msg_hdr.msg_name = &batch->addrs[i];
+      msgs[i].msg_hdr.msg_namelen = sizeof(batch->addrs[i]);
+    }
+    int count =
+        HANDLE_EINTR(recvmmsg(socket_, msgs, kReadBatchSize, 0, NULL));
+    if (count < 0) {
+      int result = MapSystemError(errno);
+      if (result != ERR_IO_PENDING)
+        LogRead(result, NULL, 0, NULL);
+      return result;
+    }
+    DCHECK_GT(count, 0);
+    for (int i = 0; i < count; ++i) {
+      batch->sizes[i] = msgs[i].msg_len;
+      batch->addr_lens[i] = msgs[i].msg_hdr.msg_namelen;
+    }
+    batch->count = count;
+    batch->next = 0;
+  }
+
+  // Datagrams that don't fit in |buf| are truncated, just like recvfrom()
+  // would have done.
+  int i = batch->next++;
+  int result = std::min(batch->sizes[i], buf_len);
+  memcpy(buf->data(), batch->data[i], result);
+  LogRead(result, buf->data(), batch->addr_lens[i],
+          reinterpret_cast<const sockaddr*>(&batch->addrs[i]));
+  return result;
+}
+
+int UDPSocketLibevent::SendSegmentedDatagrams() {
+  // The kernel splits a UDP_SEGMENT write into datagrams of the segment
+  // size, with only the last one allowed to be shorter.
+  size_t first = write_datagram_index_;
+  int segment_size = write_datagram_sizes_[first];
+  int total = segment_size;
+  size_t count = 1;
+  while (first + count < write_datagram_sizes_.size() &&
+         count < kMaxSegments &&
+         write_datagram_sizes_[first + count - 1] == segment_size) {
+    int size = write_datagram_sizes_[first + count];
+    if (size > segment_size || total + size > kMaxSegmentedBytes)
+      break;
+    total += size;
+    ++count;
+  }
+  if (count < 2)
+    return 0;
+
+  iovec iov;
+  iov.iov_base = write_buf_->data() + write_datagram_offset_;
+  iov.iov_len = total;
+  char control[CMSG_SPACE(sizeof(uint16))];
+  memset(control, 0, sizeof(control));
+  msghdr msg;
+  memset(&msg, 0, sizeof(msg));
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control;
+  msg.msg_controllen = sizeof(control);
+  cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+  cmsg->cmsg_level = SOL_UDP;
+  cmsg->cmsg_type = UDP_SEGMENT;
+  cmsg->cmsg_len = CMSG_LEN(sizeof(uint16));
+  uint16 gso_size = segment_size;
+  memcpy(CMSG_DATA(cmsg), &gso_size, sizeof(gso_size));
+
+  int rv = HANDLE_EINTR(sendmsg(socket_, &msg, 0));
+  if (rv >= 0)
+    return count;
+  // Kernels without UDP GSO reject the option, and devices that can't
+  // offload checksums fail the write; use sendmmsg() from now on.
+  if (errno == EINVAL || errno == ENOPROTOOPT || errno == EOPNOTSUPP ||
+      errno == EIO) {
+    use_segmentation_offload_ = false;
+    return 0;
+  }
+  return MapSystemError(errno);
+}
+#endif  // OS_LINUX
+
 int UDPSocketLibevent::SetSocketOptions() {
   int true_value = 1;
   if (socket_options_ & SOCKET_OPTION_REUSE_ADDRESS) {
@@ -5,6 +5,8 @@
 #ifndef NET_UDP_UDP_SOCKET_LIBEVENT_H_
 #define NET_UDP_UDP_SOCKET_LIBEVENT_H_
 
+#include <vector>
+
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/message_loop/message_loop.h"
@@ -61,6 +63,27 @@ class NET_EXPORT UDPSocketLibevent : public base::NonThreadSafe {
   // has been connected.
   int Write(IOBuffer* buf, int buf_len, const CompletionCallback& callback);
 
+  // Writes several datagrams, stored back to back in |buf| and sized by
+  // |datagram_sizes|, with as few system calls as the platform allows.
+  // Returns the number of bytes written, or a net error code. If
+  // ERR_IO_PENDING is returned, the datagrams that did not fit are written
+  // once the socket becomes writable, and |callback| gets the total.
+  // Only usable from the client-side of a UDP socket, after the socket
+  // has been connected.
+  int WriteMultiple(IOBuffer* buf,
+                    const std::vector<int>& datagram_sizes,
+                    const CompletionCallback& callback);
+
+  // Returns true if WriteMultiple() needs fewer system calls than writing
+  // each datagram with Write().
+  bool SupportsWriteMultiple() const;
+
+  // Lets Read() calls with buffers of up to 2048 bytes receive several
+  // datagrams with a single system call and hand them out one by one.
+  // Bigger datagrams received in a batch are truncated to 2048 bytes, so
+  // this is only meant for sockets that receive many small datagrams.
+  void EnableReadBatching();
+
   // Read from a socket and receive sender address information.
   // |buf| is the buffer to read data into.
   // |buf_len| is the maximum amount of data to read.
@@ -230,6 +253,28 @@ class NET_EXPORT UDPSocketLibevent : public base::NonThreadSafe {
   int InternalRecvFrom(IOBuffer* buf, int buf_len, IPEndPoint* address);
   int InternalSendTo(IOBuffer* buf, int buf_len, const IPEndPoint* address);
 
+  // Writes the datagrams of a WriteMultiple() call that have not been
+  // written yet. Returns the total number of bytes written once they all
+  // are, or a net error code.
+  int InternalWriteMultiple();
+  // Sends one or more datagrams starting at |write_datagram_index_| and
+  // returns how many were sent, or a net error code.
+  int SendDatagrams();
+
+#if defined(OS_LINUX)
+  // Datagrams received by one recvmmsg() call that have not been handed out
+  // by Read() yet.
+  struct ReadBatch;
+
+  // Hands out the next batched datagram, receiving a new batch first if
+  // none are left.
+  int InternalReadBatched(IOBuffer* buf, int buf_len);
+  // Sends a run of equally sized datagrams as a single UDP_SEGMENT (GSO)
+  // write. Returns 0 if the run is too short to be worth it or the kernel
+  // doesn't support segmentation offload.
+  int SendSegmentedDatagrams();
+#endif
+
   // Applies |socket_options_| to |socket_|. Should be called before
   // Bind().
   int SetSocketOptions();
@@ -281,6 +326,22 @@ class NET_EXPORT UDPSocketLibevent : public base::NonThreadSafe {
   int write_buf_len_;
   scoped_ptr<IPEndPoint> send_to_address_;
 
+  // Sizes of the datagrams in |write_buf_| while a WriteMultiple() call is
+  // in progress, the first one not written yet, and where it starts.
+  std::vector<int> write_datagram_sizes_;
+  size_t write_datagram_index_;
+  int write_datagram_offset_;
+
+#if defined(OS_LINUX)
+  // Set by EnableReadBatching(); |read_batch_| is allocated on the first
+  // batched read.
+  bool read_batching_enabled_;
+  scoped_ptr<ReadBatch> read_batch_;
+
+  // Cleared once the kernel rejects a UDP_SEGMENT write.
+  bool use_segmentation_offload_;
+#endif
+
   // External callback; called when read is complete.
   CompletionCallback read_callback_;
 
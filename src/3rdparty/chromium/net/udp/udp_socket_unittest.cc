@@ -202,6 +202,52 @@ TEST_F(UDPSocketTest, Connect) {
       client_entries, 5, NetLog::TYPE_SOCKET_ALIVE));
 }
 
+// Writes several datagrams at once, and reads several that arrived together,
+// making sure that datagram boundaries and order are preserved both ways.
+TEST_F(UDPSocketTest, WriteMultipleAndReadBatched) {
+  IPEndPoint bind_address;
+  CreateUDPAddress("127.0.0.1", 0, &bind_address);
+  UDPServerSocket server(NULL, NetLog::Source());
+  ASSERT_EQ(OK, server.Listen(bind_address));
+  IPEndPoint server_address;
+  ASSERT_EQ(OK, server.GetLocalAddress(&server_address));
+
+  UDPClientSocket client(DatagramSocket::DEFAULT_BIND, RandIntCallback(),
+                         NULL, NetLog::Source());
+  ASSERT_EQ(OK, client.Connect(server_address));
+  client.EnableReadBatching();
+  if (!client.SupportsWriteMultiple())
+    return;
+
+  // The first three datagrams can be sent as a single segmented write.
+  std::vector<std::string> messages;
+  messages.push_back(std::string(100, 'a'));
+  messages.push_back(std::string(100, 'b'));
+  messages.push_back(std::string(60, 'c'));
+  messages.push_back(std::string(200, 'd'));
+  std::string data;
+  std::vector<int> sizes;
+  for (size_t i = 0; i < messages.size(); ++i) {
+    data += messages[i];
+    sizes.push_back(messages[i].size());
+  }
+
+  TestCompletionCallback callback;
+  scoped_refptr<StringIOBuffer> buffer(new StringIOBuffer(data));
+  int rv = client.WriteMultiple(buffer.get(), sizes, callback.callback());
+  EXPECT_EQ(static_cast<int>(data.size()), callback.GetResult(rv));
+
+  for (size_t i = 0; i < messages.size(); ++i)
+    EXPECT_EQ(messages[i], RecvFromSocket(&server));
+
+  for (size_t i = 0; i < messages.size(); ++i) {
+    EXPECT_EQ(static_cast<int>(messages[i].size()),
+              SendToSocket(&server, messages[i]));
+  }
+  for (size_t i = 0; i < messages.size(); ++i)
+    EXPECT_EQ(messages[i], ReadSocket(&client));
+}
+
 #if defined(OS_MACOSX)
 // UDPSocketPrivate_Broadcast is disabled for OSX because it requires
 // root permissions on OSX 10.7+.
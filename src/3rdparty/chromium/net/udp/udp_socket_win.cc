@@ -282,6 +282,20 @@ int UDPSocketWin::Write(IOBuffer* buf,
   return SendToOrWrite(buf, buf_len, NULL, callback);
 }
 
+int UDPSocketWin::WriteMultiple(IOBuffer* buf,
+                                const std::vector<int>& datagram_sizes,
+                                const CompletionCallback& callback) {
+  NOTIMPLEMENTED();
+  return ERR_NOT_IMPLEMENTED;
+}
+
+bool UDPSocketWin::SupportsWriteMultiple() const {
+  return false;
+}
+
+void UDPSocketWin::EnableReadBatching() {
+}
+
 int UDPSocketWin::SendTo(IOBuffer* buf,
                          int buf_len,
                          const IPEndPoint& address,
@@ -7,6 +7,8 @@
 
 #include <winsock2.h>
 
+#include <vector>
+
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/threading/non_thread_safe.h"
@@ -62,6 +64,15 @@ class NET_EXPORT UDPSocketWin : NON_EXPORTED_BASE(public base::NonThreadSafe) {
   // has been connected.
   int Write(IOBuffer* buf, int buf_len, const CompletionCallback& callback);
 
+  // Not implemented on Windows; SupportsWriteMultiple() returns false.
+  int WriteMultiple(IOBuffer* buf,
+                    const std::vector<int>& datagram_sizes,
+                    const CompletionCallback& callback);
+  bool SupportsWriteMultiple() const;
+
+  // Does nothing on Windows, Read() gets one datagram per system call.
+  void EnableReadBatching();
+
   // Read from a socket and receive sender address information.
   // |buf| is the buffer to read data into.
   // |buf_len| is the maximum amount of data to read.
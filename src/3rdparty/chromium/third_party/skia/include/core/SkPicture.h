@@ -193,6 +193,14 @@ public:
      */
     bool willPlayBackBitmaps() const;
 
+    /**
+     * Returns true if drawing this SkPicture leaves all of its recorded state
+     * untouched, in which case the same instance can be played back on several
+     * threads at once. Otherwise each thread needs its own clone().
+     * Returns false if called while still recording.
+     */
+    bool isThreadSafeForPlayback() const;
+
 #ifdef SK_BUILD_FOR_ANDROID
     /** Signals that the caller is prematurely done replaying the drawing
         commands. This can be called from a canvas virtual while the picture
@@ -367,6 +367,11 @@ bool SkPicture::willPlayBackBitmaps() const {
     return fPlayback->containsBitmaps();
 }
 
+bool SkPicture::isThreadSafeForPlayback() const {
+    if (!fPlayback) return false;
+    return fPlayback->isThreadSafeForPlayback();
+}
+
 #ifdef SK_BUILD_FOR_ANDROID
 void SkPicture::abortPlayback() {
     if (NULL == fPlayback) {
@@ -312,6 +312,21 @@ bool SkPicturePlayback::containsBitmaps() const {
     return false;
 }
 
+bool SkPicturePlayback::isThreadSafeForPlayback() const {
+    // Drawing locks the pixels of the bitmaps and sets up per-draw state in the
+    // effects of the paints needing a deep copy, both are what a clone duplicates.
+    // Nested pictures are cloned unconditionally.
+    if (this->containsBitmaps() || fPictureCount > 0) {
+        return false;
+    }
+    for (int i = 0; i < SafeCount(fPaints); ++i) {
+        if (needs_deep_copy(fPaints->at(i))) {
+            return false;
+        }
+    }
+    return true;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////
 
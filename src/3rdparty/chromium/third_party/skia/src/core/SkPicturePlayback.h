@@ -74,6 +74,7 @@ public:
     void dumpSize() const;
 
     bool containsBitmaps() const;
+    bool isThreadSafeForPlayback() const;
 
 #ifdef SK_BUILD_FOR_ANDROID
     // Can be called in the middle of playback (the draw() call). WIll abort the
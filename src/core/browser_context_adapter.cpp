@@ -0,0 +1,138 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "browser_context_adapter.h"
+
+#include "browser_context_qt.h"
+#include "renderer_process_pool_qt.h"
+
+#include "content/public/browser/browser_thread.h"
+
+#include <QtGlobal>
+
+Q_GLOBAL_STATIC(BrowserContextAdapter, defaultBrowserContextAdapter)
+
+BrowserContextAdapter::BrowserContextAdapter(bool offTheRecord)
+    : m_offTheRecord(offTheRecord)
+    , m_httpCacheType(DefaultHttpCache)
+    , m_httpCacheMaxSize(0)
+    , m_memoryOnly(false)
+    , m_spareRendererProcessCount(0)
+    , m_browserContext(0)
+{
+}
+
+BrowserContextAdapter::~BrowserContextAdapter()
+{
+    // The default context is deleted by the browser main parts before the browser threads stop.
+    // Render process hosts of the last pages still reference the context until they are deleted
+    // from the event loop, delete it after them.
+    if (m_browserContext) {
+        m_browserContext->m_adapter = 0;
+        content::BrowserThread::DeleteSoon(content::BrowserThread::UI, FROM_HERE, m_browserContext);
+    }
+}
+
+BrowserContextAdapter *BrowserContextAdapter::defaultContext()
+{
+    return defaultBrowserContextAdapter();
+}
+
+BrowserContextQt *BrowserContextAdapter::browserContext()
+{
+    if (!m_browserContext)
+        new BrowserContextQt(this);
+    return m_browserContext;
+}
+
+bool BrowserContextAdapter::isOffTheRecord() const
+{
+    return m_offTheRecord;
+}
+
+BrowserContextAdapter::HttpCacheType BrowserContextAdapter::httpCacheType() const
+{
+    return isMemoryOnly() ? MemoryHttpCache : m_httpCacheType;
+}
+
+void BrowserContextAdapter::setHttpCacheType(HttpCacheType type)
+{
+    m_httpCacheType = type;
+}
+
+int BrowserContextAdapter::httpCacheMaxSize() const
+{
+    return m_httpCacheMaxSize;
+}
+
+void BrowserContextAdapter::setHttpCacheMaxSize(int maxSize)
+{
+    m_httpCacheMaxSize = qMax(0, maxSize);
+}
+
+bool BrowserContextAdapter::isMemoryOnly() const
+{
+    return m_offTheRecord || m_memoryOnly;
+}
+
+void BrowserContextAdapter::setMemoryOnly(bool memoryOnly)
+{
+    m_memoryOnly = memoryOnly;
+}
+
+HttpCacheStatistics BrowserContextAdapter::httpCacheStatistics() const
+{
+    if (!m_browserContext)
+        return HttpCacheStatistics();
+    return m_browserContext->httpCacheStatistics();
+}
+
+int BrowserContextAdapter::spareRendererProcessCount() const
+{
+    return m_spareRendererProcessCount;
+}
+
+void BrowserContextAdapter::setSpareRendererProcessCount(int count)
+{
+    m_spareRendererProcessCount = qMax(0, count);
+    if (m_browserContext)
+        m_browserContext->rendererProcessPool()->setSize(m_spareRendererProcessCount);
+}
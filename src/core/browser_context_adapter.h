@@ -0,0 +1,111 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef BROWSER_CONTEXT_ADAPTER_H
+#define BROWSER_CONTEXT_ADAPTER_H
+
+#include "qtwebenginecoreglobal.h"
+
+class BrowserContextQt;
+
+struct HttpCacheStatistics {
+    HttpCacheStatistics() : hitCount(0), missCount(0), cachedBytes(0), networkBytes(0) { }
+    // Completed HTTP(S) requests answered from the cache or from the network.
+    qint64 hitCount;
+    qint64 missCount;
+    // Response bytes read from the cache or from the network.
+    qint64 cachedBytes;
+    qint64 networkBytes;
+};
+
+// Qt facing side of the browser context: the settings of what is stored and where.
+// Any number of contexts can be used in the same process, pages of different contexts don't
+// share cookies, caches, storage or renderer processes.
+class QWEBENGINE_EXPORT BrowserContextAdapter
+{
+public:
+    enum HttpCacheType {
+        DefaultHttpCache,
+        BlockfileHttpCache,
+        SimpleHttpCache,
+        MemoryHttpCache
+    };
+
+    // Off-the-record contexts keep everything in memory and never touch the data path: cookies,
+    // the HTTP cache, DOM storage, IndexedDB and the other storage partition databases.
+    explicit BrowserContextAdapter(bool offTheRecord = false);
+    // Must outlive the pages using this context.
+    ~BrowserContextAdapter();
+    static BrowserContextAdapter *defaultContext();
+
+    // Created with the first page using this context, the default one with the browser main loop.
+    BrowserContextQt *browserContext();
+    bool isOffTheRecord() const;
+
+    // The cache and cookie settings are read when the first request is made, set them before loading any page.
+    HttpCacheType httpCacheType() const;
+    void setHttpCacheType(HttpCacheType);
+    // In bytes, zero lets the backend choose from the available disk space.
+    int httpCacheMaxSize() const;
+    void setHttpCacheMaxSize(int maxSize);
+    // Keeps the HTTP cache and cookies in memory, nothing is written to the data path.
+    // Always true for off-the-record contexts.
+    bool isMemoryOnly() const;
+    void setMemoryOnly(bool);
+
+    HttpCacheStatistics httpCacheStatistics() const;
+
+    // Renderer processes kept launched and initialized for the next pages to be created.
+    int spareRendererProcessCount() const;
+    void setSpareRendererProcessCount(int count);
+
+private:
+    friend class BrowserContextQt;
+
+    bool m_offTheRecord;
+    HttpCacheType m_httpCacheType;
+    int m_httpCacheMaxSize;
+    bool m_memoryOnly;
+    int m_spareRendererProcessCount;
+    BrowserContextQt *m_browserContext;
+};
+
+#endif // BROWSER_CONTEXT_ADAPTER_H
@@ -59,14 +59,22 @@
 #include <QString>
 #include <QStringBuilder>
 
-BrowserContextQt::BrowserContextQt()
+BrowserContextQt::BrowserContextQt(BrowserContextAdapter *adapter)
+    : m_adapter(adapter)
+    , m_offTheRecord(adapter->isOffTheRecord())
 {
+    Q_ASSERT(!m_adapter->m_browserContext);
+    m_adapter->m_browserContext = this;
     resourceContext.reset(new ResourceContextQt(this));
     downloadManagerDelegate.reset(new DownloadManagerDelegateQt);
+    m_rendererProcessPool.reset(new RendererProcessPoolQt(this, m_adapter->spareRendererProcessCount()));
 }
 
 BrowserContextQt::~BrowserContextQt()
 {
+    m_rendererProcessPool.reset();
+    if (m_adapter)
+        m_adapter->m_browserContext = 0;
     if (resourceContext)
         content::BrowserThread::DeleteSoon(content::BrowserThread::IO, FROM_HERE, resourceContext.release());
 }
@@ -83,7 +91,8 @@ base::FilePath BrowserContextQt::GetPath() const
 
 bool BrowserContextQt::IsOffTheRecord() const
 {
-    return false;
+    // Makes Chromium create in-memory storage partitions, GetPath is then only used as a key.
+    return m_offTheRecord;
 }
 
 net::URLRequestContextGetter *BrowserContextQt::GetRequestContext()
@@ -145,7 +154,14 @@ quota::SpecialStoragePolicy *BrowserContextQt::GetSpecialStoragePolicy()
 
 net::URLRequestContextGetter *BrowserContextQt::CreateRequestContext(content::ProtocolHandlerMap *protocol_handlers)
 {
-    url_request_getter_ = new URLRequestContextGetterQt(GetPath(), protocol_handlers);
+    url_request_getter_ = new URLRequestContextGetterQt(GetPath(), protocol_handlers, m_adapter->httpCacheType(), m_adapter->httpCacheMaxSize(), m_adapter->isMemoryOnly());
     static_cast<ResourceContextQt*>(resourceContext.get())->set_url_request_context_getter(url_request_getter_.get());
     return url_request_getter_.get();
 }
+
+HttpCacheStatistics BrowserContextQt::httpCacheStatistics() const
+{
+    if (!url_request_getter_)
+        return HttpCacheStatistics();
+    return static_cast<URLRequestContextGetterQt*>(url_request_getter_.get())->httpCacheStatistics();
+}
@@ -46,12 +46,14 @@
 #include "content/public/browser/content_browser_client.h"
 #include "content/public/browser/resource_context.h"
 #include "net/url_request/url_request_context.h"
+#include "browser_context_adapter.h"
 #include "download_manager_delegate_qt.h"
+#include "renderer_process_pool_qt.h"
 
 class BrowserContextQt : public content::BrowserContext
 {
 public:
-    explicit BrowserContextQt();
+    explicit BrowserContextQt(BrowserContextAdapter *adapter);
 
     virtual ~BrowserContextQt();
 
@@ -71,10 +73,19 @@ public:
     virtual quota::SpecialStoragePolicy *GetSpecialStoragePolicy() Q_DECL_OVERRIDE;
     net::URLRequestContextGetter *CreateRequestContext(content::ProtocolHandlerMap *protocol_handlers);
 
+    BrowserContextAdapter *adapter() const { return m_adapter; }
+    HttpCacheStatistics httpCacheStatistics() const;
+    RendererProcessPoolQt *rendererProcessPool() const { return m_rendererProcessPool.get(); }
+
 private:
+    friend class BrowserContextAdapter;
+    // Reset when the adapter is deleted before this context.
+    BrowserContextAdapter *m_adapter;
+    bool m_offTheRecord;
     scoped_ptr<content::ResourceContext> resourceContext;
     scoped_refptr<net::URLRequestContextGetter> url_request_getter_;
     scoped_ptr<DownloadManagerDelegateQt> downloadManagerDelegate;
+    scoped_ptr<RendererProcessPoolQt> m_rendererProcessPool;
 
     DISALLOW_COPY_AND_ASSIGN(BrowserContextQt);
 };
@@ -29,14 +29,28 @@ IPC_MESSAGE_ROUTED1(QtRenderViewObserver_FetchDocumentMarkup,
 IPC_MESSAGE_ROUTED1(QtRenderViewObserver_FetchDocumentInnerText,
                     uint64 /* requestId */)
 
+IPC_MESSAGE_ROUTED1(QtRenderViewObserver_FetchDocumentTextNodes,
+                    uint64 /* requestId */)
+
 //-----------------------------------------------------------------------------
 // WebContents messages
 // These are messages sent from the renderer back to the browser process.
 
-IPC_MESSAGE_ROUTED2(QtRenderViewObserverHost_DidFetchDocumentMarkup,
+// Documents are sent in consecutive chunks of bounded size, the last one has |done| set.
+IPC_MESSAGE_ROUTED3(QtRenderViewObserverHost_DidFetchDocumentMarkup,
+                    uint64 /* requestId */,
+                    base::string16 /* markup chunk */,
+                    bool /* done */)
+
+IPC_MESSAGE_ROUTED3(QtRenderViewObserverHost_DidFetchDocumentInnerText,
                     uint64 /* requestId */,
-                    base::string16 /* markup */)
+                    base::string16 /* innerText chunk */,
+                    bool /* done */)
 
-IPC_MESSAGE_ROUTED2(QtRenderViewObserverHost_DidFetchDocumentInnerText,
+IPC_MESSAGE_ROUTED6(QtRenderViewObserverHost_DidFetchDocumentTextNodes,
                     uint64 /* requestId */,
-                    base::string16 /* innerText */)
+                    base::string16 /* text chunk, the text nodes' content concatenated */,
+                    std::vector<int> /* offset of each text node within the chunk */,
+                    std::vector<std::string> /* child index path of each text node, like "0/1/3" */,
+                    bool /* restarted, the DOM changed and the previous chunks are stale */,
+                    bool /* done */)
@@ -177,7 +177,7 @@ public:
 
     void PreMainMessageLoopRun() Q_DECL_OVERRIDE
     {
-        m_browserContext.reset(new BrowserContextQt());
+        m_browserContext.reset(new BrowserContextQt(BrowserContextAdapter::defaultContext()));
     }
 
     void PostMainMessageLoopRun()
@@ -308,6 +308,7 @@ void ContentBrowserClientQt::RenderProcessHostCreated(content::RenderProcessHost
 {
     // FIXME: Add a settings variable to enable/disable the file scheme.
     content::ChildProcessSecurityPolicy::GetInstance()->GrantScheme(host->GetID(), chrome::kFileScheme);
+    static_cast<BrowserContextQt*>(host->GetBrowserContext())->rendererProcessPool()->processLaunchStarted(host);
 }
 
 void ContentBrowserClientQt::ResourceDispatcherHostCreated()
@@ -335,9 +336,7 @@ BrowserContextQt* ContentBrowserClientQt::browser_context() {
 
 net::URLRequestContextGetter* ContentBrowserClientQt::CreateRequestContext(content::BrowserContext* content_browser_context, content::ProtocolHandlerMap* protocol_handlers)
 {
-    if (content_browser_context != browser_context())
-        fprintf(stderr, "Warning: off the record browser context not implemented !\n");
-    return static_cast<BrowserContextQt*>(browser_context())->CreateRequestContext(protocol_handlers);
+    return static_cast<BrowserContextQt*>(content_browser_context)->CreateRequestContext(protocol_handlers);
 }
 
 void ContentBrowserClientQt::enableInspector(bool enable)
@@ -36,6 +36,7 @@ RESOURCES += devtools.qrc
 INCLUDEPATH += $$[QT_INSTALL_HEADERS] $$PWD
 
 SOURCES = \
+        browser_context_adapter.cpp \
         browser_context_qt.cpp \
         chromium_gpu_helper.cpp \
         chromium_overrides.cpp \
@@ -44,19 +45,26 @@ SOURCES = \
         content_client_qt.cpp \
         content_browser_client_qt.cpp \
         content_main_delegate_qt.cpp \
+        content_protocol_interceptor_qt.cpp \
         delegated_frame_node.cpp \
+        delegated_frame_recorder.cpp \
+        delegated_frame_replayer.cpp \
         desktop_screen_qt.cpp \
         dev_tools_http_handler_delegate_qt.cpp \
         download_manager_delegate_qt.cpp \
+        frame_statistics.cpp \
         gl_context_qt.cpp \
+        host_cache_persister_qt.cpp \
         javascript_dialog_controller.cpp \
         javascript_dialog_manager_qt.cpp \
         media_capture_devices_dispatcher.cpp \
         process_main.cpp \
         qt_render_view_observer_host.cpp \
         render_widget_host_view_qt.cpp \
+        render_widget_host_view_qt_delegate_headless.cpp \
         renderer/content_renderer_client_qt.cpp \
         renderer/qt_render_view_observer.cpp \
+        renderer_process_pool_qt.cpp \
         resource_bundle_qt.cpp \
         resource_context_qt.cpp \
         resource_dispatcher_host_delegate_qt.cpp \
@@ -72,11 +80,13 @@ SOURCES = \
         yuv_video_node.cpp \
         qrc_protocol_handler_qt.cpp \
         url_request_qrc_job_qt.cpp \
+        url_request_content_job_qt.cpp \
         surface_factory_qt.cpp \
         ozone_platform_eglfs.cpp
 
 
 HEADERS = \
+        browser_context_adapter.h \
         browser_context_qt.h \
         chromium_overrides.h \
         clipboard_qt.h \
@@ -84,12 +94,17 @@ HEADERS = \
         content_client_qt.h \
         content_browser_client_qt.h \
         content_main_delegate_qt.h \
+        content_protocol_interceptor_qt.h \
         delegated_frame_node.h \
+        delegated_frame_recorder.h \
+        delegated_frame_replayer.h \
         desktop_screen_qt.h \
         dev_tools_http_handler_delegate_qt.h \
         download_manager_delegate_qt.h \
+        frame_statistics.h \
         chromium_gpu_helper.h \
         gl_context_qt.h \
+        host_cache_persister_qt.h \
         javascript_dialog_controller_p.h \
         javascript_dialog_controller.h \
         javascript_dialog_manager_qt.h \
@@ -98,8 +113,10 @@ HEADERS = \
         qt_render_view_observer_host.h \
         render_widget_host_view_qt.h \
         render_widget_host_view_qt_delegate.h \
+        render_widget_host_view_qt_delegate_headless.h \
         renderer/content_renderer_client_qt.h \
         renderer/qt_render_view_observer.h \
+        renderer_process_pool_qt.h \
         resource_context_qt.h \
         resource_dispatcher_host_delegate_qt.h \
         stream_video_node.h \
@@ -115,5 +132,6 @@ HEADERS = \
         yuv_video_node.h \
         qrc_protocol_handler_qt.h \
         url_request_qrc_job_qt.h \
+        url_request_content_job_qt.h \
         surface_factory_qt.h \
         ozone_platform_eglfs.h
@@ -51,13 +51,17 @@
 #include "delegated_frame_node.h"
 
 #include "chromium_gpu_helper.h"
+#include "delegated_frame_recorder.h"
 #include "stream_video_node.h"
 #include "type_conversion.h"
 #include "yuv_video_node.h"
 
 #include "base/message_loop/message_loop.h"
 #include "base/bind.h"
+#include "cc/base/math_util.h"
+#include "cc/base/region.h"
 #include "cc/output/delegated_frame_data.h"
+#include "content/public/browser/browser_thread.h"
 #include "cc/quads/checkerboard_draw_quad.h"
 #include "cc/quads/draw_quad.h"
 #include "cc/quads/render_pass_draw_quad.h"
@@ -66,7 +70,10 @@
 #include "cc/quads/texture_draw_quad.h"
 #include "cc/quads/tile_draw_quad.h"
 #include "cc/quads/yuv_video_draw_quad.h"
+#include "ui/gfx/rect_conversions.h"
+#include <QOpenGLContext>
 #include <QOpenGLFramebufferObject>
+#include <QOpenGLFunctions>
 #include <QSGSimpleTextureNode>
 #include <QSGTexture>
 #include <QtQuick/private/qquickclipnode_p.h>
@@ -80,10 +87,74 @@
 #include <EGL/eglext.h>
 #endif
 
+typedef QPair<int, quintptr> QuadNodeKey;
+
+// A scene graph node built for a quad, with what is needed to match it with a
+// similar quad in the next frame and to tell if its geometry has to be updated.
+struct QuadNodeEntry {
+    QuadNodeEntry() : node(0), material(cc::DrawQuad::INVALID), resourceKey(0) { }
+    QuadNodeKey key() const { return qMakePair(int(material), resourceKey); }
+
+    QSGNode *node;
+    cc::DrawQuad::Material material;
+    // The resource ID for quads using a MailboxTexture, the RenderPassTexture for render pass quads.
+    quintptr resourceKey;
+    QRectF rect;
+    QRectF sourceRect;
+    QColor color;
+};
+
+// The clip, transform and opacity nodes built for a SharedQuadState.
+// The values they currently hold are used to match them with the layers of the next frame.
+struct LayerChainEntry {
+    LayerChainEntry() : clipNode(0), transformNode(0), opacityNode(0) { }
+    QSGNode *root() const;
+    QSGNode *leaf() const;
+    int nodeCount() const { return !!clipNode + !!transformNode + !!opacityNode; }
+    bool hasSameStructure(const cc::SharedQuadState *layerState) const;
+    bool matches(const cc::SharedQuadState *layerState) const;
+    void update(const cc::SharedQuadState *layerState);
+
+    QQuickDefaultClipNode *clipNode;
+    QSGTransformNode *transformNode;
+    QSGOpacityNode *opacityNode;
+};
+
+// The nodes that were built for a RenderPass during the last commit.
+class RenderPassNodes {
+public:
+    RenderPassNodes() : chainNode(0) { }
+
+    QSGNode *chainNode;
+    QList<LayerChainEntry> layers;
+    QList<QuadNodeEntry> quads;
+};
+
+// Recycles the framebuffer objects of render passes across frames and DelegatedFrameNodes
+// sharing a GL context. Sizes are rounded up to buckets so that a pass being resized slightly,
+// or a short-lived pass being replaced by another one of similar size, doesn't need a new allocation.
+class FramebufferObjectPool : public QObject {
+public:
+    static FramebufferObjectPool *forContext(QOpenGLContext *context);
+    static QSize bucketSize(const QSize &size);
+
+    QOpenGLFramebufferObject *acquire(const QSize &size, GLenum internalFormat);
+    void release(QOpenGLFramebufferObject *fbo);
+
+private:
+    FramebufferObjectPool(QOpenGLContext *context) : m_context(context) { }
+    void contextAboutToBeDestroyed();
+
+    QOpenGLContext *m_context;
+    // Least recently released first.
+    QList<QOpenGLFramebufferObject *> m_available;
+};
+
 class RenderPassTexture : public QSGTexture
 {
 public:
     RenderPassTexture(const cc::RenderPass::Id &id, QSGRenderContext *context);
+    ~RenderPassTexture();
 
     const cc::RenderPass::Id &id() const { return m_id; }
     void bind();
@@ -92,23 +163,34 @@ public:
     QSize textureSize() const { return m_rect.size(); }
     bool hasAlphaChannel() const { return m_format != GL_RGB; }
     bool hasMipmaps() const { return false; }
+    QRectF normalizedTextureSubRect() const;
 
     void setRect(const QRect &rect) { m_rect = rect; }
     void setFormat(GLenum format) { m_format = format; }
     void setDevicePixelRatio(qreal ratio) { m_device_pixel_ratio = ratio; }
-    QSGNode *rootNode() { return m_rootNode.data(); }
+    void addDamage(const QRect &damage) { m_pendingDamage |= damage; }
+    QSGNode *rootNode() { return m_damageClipNode; }
+    RenderPassNodes *passNodes() { return &m_passNodes; }
 
     void grab();
 
 private:
+    void releaseFbo();
+
     cc::RenderPass::Id m_id;
     QRect m_rect;
     qreal m_device_pixel_ratio;
     GLenum m_format;
+    QRect m_pendingDamage;
+    // What the FBO contents were last rendered with.
+    QRect m_grabbedRect;
+    qreal m_grabbedDevicePixelRatio;
 
     QScopedPointer<QSGRootNode> m_rootNode;
+    QQuickDefaultClipNode *m_damageClipNode;
+    RenderPassNodes m_passNodes;
     QScopedPointer<QSGRenderer> m_renderer;
-    QScopedPointer<QOpenGLFramebufferObject> m_fbo;
+    QOpenGLFramebufferObject *m_fbo;
 
     QSGRenderContext *m_context;
 };
@@ -124,16 +206,19 @@ public:
     virtual bool hasMipmaps() const Q_DECL_OVERRIDE { return false; }
     virtual void bind() Q_DECL_OVERRIDE;
 
-    bool needsToFetch() const { return !m_textureId; }
+    bool needsToFetch() const { return !m_fetched; }
     cc::TransferableResource &resource() { return m_resource; }
     cc::ReturnedResource returnResource();
     void fetchTexture(gpu::gles2::MailboxManager *mailboxManager);
+    void setFetchedTexture(int textureId) { m_textureId = textureId; m_fetched = true; }
     void setTarget(GLenum target);
+    GLenum target() const { return m_target; }
     void incImportCount() { ++m_importCount; }
 
 private:
     cc::TransferableResource m_resource;
     int m_textureId;
+    bool m_fetched;
     QSize m_textureSize;
     bool m_hasAlpha;
     GLenum m_target;
@@ -143,6 +228,28 @@ private:
 #endif
 };
 
+// Rows are returned in the order of the texture, bottom-up.
+static QImage readTextureContents(GLuint textureId, const QSize &size)
+{
+    QOpenGLFunctions *gl = QOpenGLContext::currentContext()->functions();
+    GLint previousFramebuffer = 0;
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previousFramebuffer);
+    GLuint framebuffer = 0;
+    gl->glGenFramebuffers(1, &framebuffer);
+    gl->glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    gl->glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, textureId, 0);
+
+    QImage contents;
+    if (gl->glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE) {
+        contents = QImage(size, QImage::Format_RGBA8888_Premultiplied);
+        glReadPixels(0, 0, size.width(), size.height(), GL_RGBA, GL_UNSIGNED_BYTE, contents.bits());
+    }
+
+    gl->glBindFramebuffer(GL_FRAMEBUFFER, previousFramebuffer);
+    gl->glDeleteFramebuffers(1, &framebuffer);
+    return contents;
+}
+
 static inline QSharedPointer<RenderPassTexture> findRenderPassTexture(const cc::RenderPass::Id &id, const QList<QSharedPointer<RenderPassTexture> > &list)
 {
     Q_FOREACH (const QSharedPointer<RenderPassTexture> &texture, list)
@@ -179,28 +286,255 @@ static QSGNode *buildRenderPassChain(QSGNode *chainParent)
     return zCompressNode;
 }
 
-static QSGNode *buildLayerChain(QSGNode *chainParent, const cc::SharedQuadState *layerState)
+QSGNode *LayerChainEntry::root() const
 {
-    QSGNode *layerChain = chainParent;
-    if (layerState->is_clipped) {
-        QQuickDefaultClipNode *clipNode = new QQuickDefaultClipNode(toQt(layerState->clip_rect));
+    if (clipNode)
+        return clipNode;
+    if (transformNode)
+        return transformNode;
+    return opacityNode;
+}
+
+QSGNode *LayerChainEntry::leaf() const
+{
+    if (opacityNode)
+        return opacityNode;
+    if (transformNode)
+        return transformNode;
+    return clipNode;
+}
+
+bool LayerChainEntry::hasSameStructure(const cc::SharedQuadState *layerState) const
+{
+    return !!clipNode == layerState->is_clipped
+        && !!transformNode == !layerState->content_to_target_transform.IsIdentity()
+        && !!opacityNode == (layerState->opacity < 1.0);
+}
+
+bool LayerChainEntry::matches(const cc::SharedQuadState *layerState) const
+{
+    return hasSameStructure(layerState)
+        && (!clipNode || clipNode->rect() == QRectF(toQt(layerState->clip_rect)))
+        && (!transformNode || transformNode->matrix() == toQt(layerState->content_to_target_transform.matrix()))
+        && (!opacityNode || opacityNode->opacity() == layerState->opacity);
+}
+
+void LayerChainEntry::update(const cc::SharedQuadState *layerState)
+{
+    Q_ASSERT(hasSameStructure(layerState));
+    // Only touch nodes whose value changed, setters mark the nodes dirty unconditionally.
+    if (clipNode && clipNode->rect() != QRectF(toQt(layerState->clip_rect))) {
+        clipNode->setRect(toQt(layerState->clip_rect));
         clipNode->update();
-        layerChain->appendChildNode(clipNode);
-        layerChain = clipNode;
+    }
+    if (transformNode) {
+        QMatrix4x4 matrix = toQt(layerState->content_to_target_transform.matrix());
+        if (transformNode->matrix() != matrix)
+            transformNode->setMatrix(matrix);
+    }
+    if (opacityNode && opacityNode->opacity() != layerState->opacity)
+        opacityNode->setOpacity(layerState->opacity);
+}
+
+static LayerChainEntry buildLayerChain(const cc::SharedQuadState *layerState)
+{
+    LayerChainEntry chain;
+    QSGNode *layerChain = 0;
+    if (layerState->is_clipped) {
+        chain.clipNode = new QQuickDefaultClipNode(toQt(layerState->clip_rect));
+        chain.clipNode->update();
+        layerChain = chain.clipNode;
     }
     if (!layerState->content_to_target_transform.IsIdentity()) {
-        QSGTransformNode *transformNode = new QSGTransformNode;
-        transformNode->setMatrix(toQt(layerState->content_to_target_transform.matrix()));
-        layerChain->appendChildNode(transformNode);
-        layerChain = transformNode;
+        chain.transformNode = new QSGTransformNode;
+        chain.transformNode->setMatrix(toQt(layerState->content_to_target_transform.matrix()));
+        if (layerChain)
+            layerChain->appendChildNode(chain.transformNode);
+        layerChain = chain.transformNode;
     }
     if (layerState->opacity < 1.0) {
-        QSGOpacityNode *opacityNode = new QSGOpacityNode;
-        opacityNode->setOpacity(layerState->opacity);
-        layerChain->appendChildNode(opacityNode);
-        layerChain = opacityNode;
+        chain.opacityNode = new QSGOpacityNode;
+        chain.opacityNode->setOpacity(layerState->opacity);
+        if (layerChain)
+            layerChain->appendChildNode(chain.opacityNode);
+    }
+    return chain;
+}
+
+static LayerChainEntry takeLayerChain(QList<LayerChainEntry> &candidates, const cc::SharedQuadState *layerState, DelegatedFrameNodeStats *stats)
+{
+    // Prefer a chain already holding the right values, then one that only needs new values.
+    int index = -1;
+    for (int i = 0; index < 0 && i < candidates.size(); ++i)
+        if (candidates.at(i).matches(layerState))
+            index = i;
+    for (int i = 0; index < 0 && i < candidates.size(); ++i)
+        if (candidates.at(i).hasSameStructure(layerState))
+            index = i;
+
+    if (index < 0) {
+        LayerChainEntry chain = buildLayerChain(layerState);
+        stats->nodesCreated += chain.nodeCount();
+        return chain;
+    }
+
+    LayerChainEntry chain = candidates.takeAt(index);
+    chain.update(layerState);
+    stats->nodesReused += chain.nodeCount();
+    return chain;
+}
+
+static bool takeQuadNode(QHash<QuadNodeKey, QList<QuadNodeEntry> > &candidates, QuadNodeEntry *entry)
+{
+    QHash<QuadNodeKey, QList<QuadNodeEntry> >::iterator it = candidates.find(entry->key());
+    if (it == candidates.end() || it->isEmpty())
+        return false;
+    *entry = it->takeFirst();
+    return true;
+}
+
+// Moves |node| right after |*previous| in |parent|'s children, unless it's already there.
+static void placeNode(QSGNode *parent, QSGNode *node, QSGNode **previous)
+{
+    QSGNode *expected = *previous ? (*previous)->nextSibling() : parent->firstChild();
+    if (node != expected) {
+        if (node->parent())
+            node->parent()->removeChildNode(node);
+        if (*previous)
+            parent->insertChildNodeAfter(node, *previous);
+        else
+            parent->prependChildNode(node);
+    }
+    *previous = node;
+}
+
+static int countNodes(QSGNode *node)
+{
+    int count = 1;
+    for (QSGNode *child = node->firstChild(); child; child = child->nextSibling())
+        count += countNodes(child);
+    return count;
+}
+
+// Deletes the children of |parent| following |last|, or all of them if |last| is null.
+static int deleteNodesAfter(QSGNode *parent, QSGNode *last)
+{
+    int deleted = 0;
+    while (QSGNode *node = last ? last->nextSibling() : parent->firstChild()) {
+        deleted += countNodes(node);
+        delete node;
     }
-    return layerChain;
+    return deleted;
+}
+
+// Opaque quads smaller than this in either dimension don't occlude anything. This bounds the
+// complexity of the occlusion region, it's the same value that cc uses for layers by default.
+static const int minimumOccluderSize = 160;
+
+static bool quadCanOcclude(const cc::DrawQuad *quad)
+{
+    switch (quad->material) {
+    case cc::DrawQuad::CHECKERBOARD:
+    case cc::DrawQuad::SOLID_COLOR:
+    case cc::DrawQuad::TEXTURE_CONTENT:
+    case cc::DrawQuad::TILED_CONTENT:
+    case cc::DrawQuad::YUV_VIDEO_CONTENT:
+        break;
+    default:
+        // Render pass quads are skipped when their pass is missing and other materials aren't drawn.
+        return false;
+    }
+    const cc::SharedQuadState *layerState = quad->shared_quad_state;
+    return !quad->needs_blending
+        && layerState->opacity == 1
+        && layerState->blend_mode == SkXfermode::kSrcOver_Mode
+        && layerState->content_to_target_transform.Preserves2dAxisAlignment();
+}
+
+// Returns the part of |pass| covered by |contentRect|, in the space of the pass.
+static gfx::Rect targetRect(const cc::RenderPass *pass, const cc::DrawQuad *quad, const gfx::Rect &contentRect, bool enclosed)
+{
+    const cc::SharedQuadState *layerState = quad->shared_quad_state;
+    gfx::RectF mapped = cc::MathUtil::MapClippedRect(layerState->content_to_target_transform, gfx::RectF(contentRect));
+    gfx::Rect rect = enclosed ? gfx::ToEnclosedRect(mapped) : gfx::ToEnclosingRect(mapped);
+    if (layerState->is_clipped)
+        rect.Intersect(layerState->clip_rect);
+    rect.Intersect(pass->output_rect);
+    return rect;
+}
+
+// Fills |visibleQuads| with the quads of |pass| that aren't hidden behind opaque quads drawn
+// after them, back to front, and |culledQuads| with the others. Chromium culls quads against
+// the layers of its own tree already, but the frame we get still contains what it couldn't
+// prove hidden there, e.g. content below an opaque quad of a different layer.
+static void cullQuads(const cc::RenderPass *pass, QVector<const cc::DrawQuad *> *visibleQuads, QVector<const cc::DrawQuad *> *culledQuads, DelegatedFrameNodeStats *stats)
+{
+    QVector<const cc::DrawQuad *> frontToBack;
+    frontToBack.reserve(pass->quad_list.size());
+    cc::Region occlusion;
+    for (size_t i = 0; i < pass->quad_list.size(); ++i) {
+        const cc::DrawQuad *quad = pass->quad_list.at(i);
+        gfx::Rect drawnRect = targetRect(pass, quad, quad->visible_rect, false);
+        stats->pixelsBeforeCulling += qint64(drawnRect.width()) * drawnRect.height();
+        if (drawnRect.IsEmpty() || occlusion.Contains(drawnRect)) {
+            culledQuads->append(quad);
+            continue;
+        }
+        stats->pixelsAfterCulling += qint64(drawnRect.width()) * drawnRect.height();
+        frontToBack.append(quad);
+
+        if (quadCanOcclude(quad)) {
+            gfx::Rect opaqueRect = targetRect(pass, quad, gfx::IntersectRects(quad->opaque_rect, quad->visible_rect), true);
+            if (opaqueRect.width() >= minimumOccluderSize && opaqueRect.height() >= minimumOccluderSize)
+                occlusion.Union(opaqueRect);
+        }
+    }
+    stats->quadsCulled += culledQuads->size();
+    stats->outputPixels += qint64(pass->output_rect.width()) * pass->output_rect.height();
+
+    visibleQuads->reserve(frontToBack.size());
+    for (int i = frontToBack.size() - 1; i >= 0; --i)
+        visibleQuads->append(frontToBack.at(i));
+}
+
+// Keeps the textures of a culled quad imported, the quad could become visible in the next
+// frame without Chromium sending its resources again.
+static void retainQuadResources(const cc::DrawQuad *quad
+    , QHash<unsigned, QSharedPointer<MailboxTexture> > &usedTextures
+    , QHash<unsigned, QSharedPointer<MailboxTexture> > &candidateTextures)
+{
+    switch (quad->material) {
+    case cc::DrawQuad::TEXTURE_CONTENT:
+        findMailboxTexture(cc::TextureDrawQuad::MaterialCast(quad)->resource_id, usedTextures, candidateTextures);
+        break;
+    case cc::DrawQuad::TILED_CONTENT:
+        findMailboxTexture(cc::TileDrawQuad::MaterialCast(quad)->resource_id, usedTextures, candidateTextures);
+        break;
+    case cc::DrawQuad::YUV_VIDEO_CONTENT: {
+        const cc::YUVVideoDrawQuad *vquad = cc::YUVVideoDrawQuad::MaterialCast(quad);
+        findMailboxTexture(vquad->y_plane_resource_id, usedTextures, candidateTextures);
+        findMailboxTexture(vquad->u_plane_resource_id, usedTextures, candidateTextures);
+        if (vquad->v_plane_resource_id)
+            findMailboxTexture(vquad->v_plane_resource_id, usedTextures, candidateTextures);
+        if (vquad->a_plane_resource_id)
+            findMailboxTexture(vquad->a_plane_resource_id, usedTextures, candidateTextures);
+        break;
+    }
+#ifdef GL_OES_EGL_image_external
+    case cc::DrawQuad::STREAM_VIDEO_CONTENT:
+        findMailboxTexture(cc::StreamVideoDrawQuad::MaterialCast(quad)->resource_id, usedTextures, candidateTextures)->setTarget(GL_TEXTURE_EXTERNAL_OES);
+        break;
+#endif
+    default:
+        break;
+    }
+}
+
+// Enables the pipelined mailbox fetching mode, see DelegatedFrameNode::commit.
+static bool pipelinedMailboxFetchEnabled()
+{
+    static bool enabled = qgetenv("QTWEBENGINE_PIPELINED_MAILBOX_FETCH").toInt();
+    return enabled;
 }
 
 #if !defined(QT_NO_EGL)
@@ -226,19 +560,33 @@ static void waitAndDeleteChromiumSync(FenceSync *sync)
         static bool resolved = false;
         static PFNEGLCLIENTWAITSYNCKHRPROC eglClientWaitSyncKHR = 0;
         static PFNEGLDESTROYSYNCKHRPROC eglDestroySyncKHR = 0;
+#ifdef EGL_KHR_wait_sync
+        static PFNEGLWAITSYNCKHRPROC eglWaitSyncKHR = 0;
+#endif
 
         if (!resolved) {
             if (hasEGLExtension(sync->egl.display, "EGL_KHR_reusable_sync")) {
                 QOpenGLContext *context = QOpenGLContext::currentContext();
                 eglClientWaitSyncKHR = (PFNEGLCLIENTWAITSYNCKHRPROC)context->getProcAddress("eglClientWaitSyncKHR");
                 eglDestroySyncKHR = (PFNEGLDESTROYSYNCKHRPROC)context->getProcAddress("eglDestroySyncKHR");
+#ifdef EGL_KHR_wait_sync
+                if (hasEGLExtension(sync->egl.display, "EGL_KHR_wait_sync"))
+                    eglWaitSyncKHR = (PFNEGLWAITSYNCKHRPROC)context->getProcAddress("eglWaitSyncKHR");
+#endif
             }
             resolved = true;
         }
 
         if (eglClientWaitSyncKHR && eglDestroySyncKHR) {
-            // FIXME: Use the less wasteful eglWaitSyncKHR once we have a device that supports EGL_KHR_wait_sync.
-            eglClientWaitSyncKHR(sync->egl.display, sync->egl.sync, 0, EGL_FOREVER_KHR);
+            // Prefer a server-side wait, it only makes our GL command stream wait on the GPU
+            // instead of blocking the scene graph thread until Chromium's commands completed.
+            bool waited = false;
+#ifdef EGL_KHR_wait_sync
+            if (eglWaitSyncKHR)
+                waited = eglWaitSyncKHR(sync->egl.display, sync->egl.sync, 0) == EGL_TRUE;
+#endif
+            if (!waited)
+                eglClientWaitSyncKHR(sync->egl.display, sync->egl.sync, 0, EGL_FOREVER_KHR);
             eglDestroySyncKHR(sync->egl.display, sync->egl.sync);
             sync->reset();
         }
@@ -257,14 +605,84 @@ static void waitAndDeleteChromiumSync(FenceSync *sync)
     Q_ASSERT(!*sync);
 }
 
+static QMutex framebufferObjectPoolsMutex;
+static QHash<QOpenGLContext *, FramebufferObjectPool *> framebufferObjectPools;
+static const int maxPooledFramebufferObjects = 8;
+
+FramebufferObjectPool *FramebufferObjectPool::forContext(QOpenGLContext *context)
+{
+    // Each scene graph render thread has its own context, protect the map.
+    QMutexLocker lock(&framebufferObjectPoolsMutex);
+    FramebufferObjectPool *&pool = framebufferObjectPools[context];
+    if (!pool) {
+        pool = new FramebufferObjectPool(context);
+        QObject::connect(context, &QOpenGLContext::aboutToBeDestroyed, pool, &FramebufferObjectPool::contextAboutToBeDestroyed, Qt::DirectConnection);
+    }
+    return pool;
+}
+
+void FramebufferObjectPool::contextAboutToBeDestroyed()
+{
+    {
+        QMutexLocker lock(&framebufferObjectPoolsMutex);
+        framebufferObjectPools.remove(m_context);
+    }
+
+    // Qt defers the deletion of the FBOs to a context of their share group when theirs isn't current,
+    // or drops them if there is none since the context takes its objects along.
+    qDeleteAll(m_available);
+    m_available.clear();
+    deleteLater();
+}
+
+QSize FramebufferObjectPool::bucketSize(const QSize &size)
+{
+    const int granularity = 64;
+    return QSize((qMax(size.width(), 1) + granularity - 1) / granularity * granularity,
+                 (qMax(size.height(), 1) + granularity - 1) / granularity * granularity);
+}
+
+QOpenGLFramebufferObject *FramebufferObjectPool::acquire(const QSize &size, GLenum internalFormat)
+{
+    QSize fboSize = bucketSize(size);
+    // Prefer the most recently released FBO, its memory is the most likely to still be resident.
+    for (int i = m_available.size() - 1; i >= 0; --i) {
+        QOpenGLFramebufferObject *fbo = m_available.at(i);
+        if (fbo->size() == fboSize && fbo->format().internalTextureFormat() == internalFormat)
+            return m_available.takeAt(i);
+    }
+
+    QOpenGLFramebufferObjectFormat format;
+    format.setAttachment(QOpenGLFramebufferObject::CombinedDepthStencil);
+    format.setInternalTextureFormat(internalFormat);
+    return new QOpenGLFramebufferObject(fboSize, format);
+}
+
+void FramebufferObjectPool::release(QOpenGLFramebufferObject *fbo)
+{
+    m_available.append(fbo);
+    while (m_available.size() > maxPooledFramebufferObjects)
+        delete m_available.takeFirst();
+}
+
 RenderPassTexture::RenderPassTexture(const cc::RenderPass::Id &id, QSGRenderContext *context)
     : QSGTexture()
     , m_id(id)
     , m_device_pixel_ratio(1)
     , m_format(GL_RGBA)
+    , m_grabbedDevicePixelRatio(1)
     , m_rootNode(new QSGRootNode)
+    , m_damageClipNode(new QQuickDefaultClipNode(QRectF()))
+    , m_fbo(0)
     , m_context(context)
 {
+    // Scissors the repaint of the pass to the region that Chromium reported as damaged.
+    m_rootNode->appendChildNode(m_damageClipNode);
+}
+
+RenderPassTexture::~RenderPassTexture()
+{
+    releaseFbo();
 }
 
 void RenderPassTexture::bind()
@@ -273,32 +691,82 @@ void RenderPassTexture::bind()
     updateBindOptions();
 }
 
+QRectF RenderPassTexture::normalizedTextureSubRect() const
+{
+    // Pooled FBOs can be larger than the pass, which is rendered in their bottom-left corner.
+    if (!m_fbo)
+        return QRectF(0, 0, 1, 1);
+    return QRectF(0, 0, qreal(m_rect.width()) / m_fbo->width(), qreal(m_rect.height()) / m_fbo->height());
+}
+
+void RenderPassTexture::releaseFbo()
+{
+    if (!m_fbo)
+        return;
+    // The render context loses its OpenGL context when it gets invalidated, nothing can pool the FBO anymore.
+    if (QOpenGLContext *context = m_context->openglContext())
+        FramebufferObjectPool::forContext(context)->release(m_fbo);
+    else
+        delete m_fbo;
+    m_fbo = 0;
+}
+
 void RenderPassTexture::grab()
 {
-    if (!m_rootNode->firstChild()) {
+    if (!m_damageClipNode->firstChild()) {
         m_renderer.reset();
-        m_fbo.reset();
+        releaseFbo();
         return;
     }
+
+    // Anything that invalidates what's already in the FBO requires repainting the whole pass.
+    bool fullRepaint = m_rect != m_grabbedRect || m_device_pixel_ratio != m_grabbedDevicePixelRatio;
     if (!m_renderer) {
         m_renderer.reset(m_context->createRenderer());
         m_renderer->setRootNode(m_rootNode.data());
+        // Nodes were added before the renderer could be notified about them.
+        m_rootNode->markDirty(QSGNode::DirtyForceUpdate); // Force matrix, clip and opacity update.
+        m_renderer->nodeChanged(m_rootNode.data(), QSGNode::DirtyForceUpdate); // Force render list update.
+        fullRepaint = true;
     }
     m_renderer->setDevicePixelRatio(m_device_pixel_ratio);
 
-    if (!m_fbo || m_fbo->size() != m_rect.size() || m_fbo->format().internalTextureFormat() != m_format)
+    if (!m_fbo || m_fbo->size() != FramebufferObjectPool::bucketSize(m_rect.size()) || m_fbo->format().internalTextureFormat() != m_format)
     {
-        QOpenGLFramebufferObjectFormat format;
-        format.setAttachment(QOpenGLFramebufferObject::CombinedDepthStencil);
-        format.setInternalTextureFormat(m_format);
-
-        m_fbo.reset(new QOpenGLFramebufferObject(m_rect.size(), format));
+        releaseFbo();
+        m_fbo = FramebufferObjectPool::forContext(m_context->openglContext())->acquire(m_rect.size(), m_format);
         glBindTexture(GL_TEXTURE_2D, m_fbo->texture());
         updateBindOptions(true);
+        fullRepaint = true;
+    }
+
+    QRect damage = fullRepaint ? m_rect : m_pendingDamage.intersected(m_rect);
+    m_pendingDamage = QRect();
+    m_grabbedRect = m_rect;
+    m_grabbedDevicePixelRatio = m_device_pixel_ratio;
+    // Nothing changed in the pass since the last time, keep what the FBO already contains.
+    if (damage.isEmpty())
+        return;
+
+    if (m_damageClipNode->rect() != QRectF(damage)) {
+        m_damageClipNode->setRect(damage);
+        m_damageClipNode->update();
     }
 
-    m_rootNode->markDirty(QSGNode::DirtyForceUpdate); // Force matrix, clip and opacity update.
-    m_renderer->nodeChanged(m_rootNode.data(), QSGNode::DirtyForceUpdate); // Force render list update.
+    if (damage != m_rect) {
+        // Only clear the damaged region, the renderer would otherwise clear the whole color buffer.
+        // The projection below mirrors the pass vertically, GL window coordinates thus
+        // have the same orientation as the pass' coordinates.
+        m_fbo->bind();
+        glEnable(GL_SCISSOR_TEST);
+        glScissor(damage.x() - m_rect.x(), damage.y() - m_rect.y(), damage.width(), damage.height());
+        glClearColor(0, 0, 0, 0);
+        glClear(GL_COLOR_BUFFER_BIT);
+        glDisable(GL_SCISSOR_TEST);
+        m_fbo->release();
+        m_renderer->setClearMode(QSGRenderer::ClearDepthBuffer | QSGRenderer::ClearStencilBuffer);
+    } else
+        m_renderer->setClearMode(QSGRenderer::ClearColorBuffer | QSGRenderer::ClearDepthBuffer | QSGRenderer::ClearStencilBuffer);
 
     m_renderer->setDeviceRect(m_rect.size());
     m_renderer->setViewportRect(m_rect.size());
@@ -312,6 +780,7 @@ void RenderPassTexture::grab()
 MailboxTexture::MailboxTexture(const cc::TransferableResource &resource)
     : m_resource(resource)
     , m_textureId(0)
+    , m_fetched(false)
     , m_textureSize(toQt(resource.size))
     , m_hasAlpha(false)
     , m_target(GL_TEXTURE_2D)
@@ -362,6 +831,7 @@ cc::ReturnedResource MailboxTexture::returnResource()
 void MailboxTexture::fetchTexture(gpu::gles2::MailboxManager *mailboxManager)
 {
     gpu::gles2::Texture *tex = ConsumeTexture(mailboxManager, m_target, *reinterpret_cast<const gpu::gles2::MailboxName*>(m_resource.mailbox.name));
+    m_fetched = true;
 
     // The texture might already have been deleted (e.g. when navigating away from a page).
     if (tex) {
@@ -376,6 +846,9 @@ void MailboxTexture::fetchTexture(gpu::gles2::MailboxManager *mailboxManager)
 
 DelegatedFrameNode::DelegatedFrameNode(QSGRenderContext *sgRenderContext)
     : m_sgRenderContext(sgRenderContext)
+    , m_rootPassNodes(new RenderPassNodes)
+    , m_pipelinedFetch(pipelinedMailboxFetchEnabled())
+    , m_fetchInFlight(false)
     , m_numPendingSyncPoints(0)
 {
     setFlag(UsePreprocess);
@@ -383,73 +856,130 @@ DelegatedFrameNode::DelegatedFrameNode(QSGRenderContext *sgRenderContext)
 
 DelegatedFrameNode::~DelegatedFrameNode()
 {
+    // The GPU thread still references us until the pending fetch is done.
+    QMutexLocker lock(&m_mutex);
+    while (m_fetchInFlight)
+        m_mailboxesFetchedWaitCond.wait(&m_mutex);
 }
 
 void DelegatedFrameNode::preprocess()
 {
-    // With the threaded render loop the GUI thread has been unlocked at this point.
-    // We can now wait for the Chromium GPU thread to produce textures that will be
-    // rendered on our quads and fetch the IDs from the mailboxes we were given.
-    QList<MailboxTexture *> mailboxesToFetch;
-    Q_FOREACH (const QSharedPointer<MailboxTexture> &mailboxTexture, m_data->mailboxTextures.values())
-        if (mailboxTexture->needsToFetch())
-            mailboxesToFetch.append(mailboxTexture.data());
-
-    if (!mailboxesToFetch.isEmpty()) {
+    if (m_pipelinedFetch) {
+        // Commit only applies frames once their textures were fetched, just make sure
+        // that GL waits for Chromium to be done generating their content.
         QMutexLocker lock(&m_mutex);
-        base::MessageLoop *gpuMessageLoop = gpu_message_loop();
-        content::SyncPointManager *syncPointManager = sync_point_manager();
-
-        Q_FOREACH (MailboxTexture *mailboxTexture, mailboxesToFetch) {
-            m_numPendingSyncPoints++;
-            AddSyncPointCallbackOnGpuThread(gpuMessageLoop, syncPointManager, mailboxTexture->resource().sync_point, base::Bind(&DelegatedFrameNode::syncPointRetired, this, &mailboxesToFetch));
-        }
-
-        m_mailboxesFetchedWaitCond.wait(&m_mutex);
+        waitAndDeleteChromiumSync(&m_mailboxesGLFence);
+    } else if (collectMailboxesToFetch()) {
+        // With the threaded render loop the GUI thread has been unlocked at this point.
+        // We can now wait for the Chromium GPU thread to produce textures that will be
+        // rendered on our quads and fetch the IDs from the mailboxes we were given.
+        QMutexLocker lock(&m_mutex);
+        fetchMailboxes();
+        while (m_fetchInFlight)
+            m_mailboxesFetchedWaitCond.wait(&m_mutex);
 
         // Tell GL to wait until Chromium is done generating resource textures on the GPU thread.
         // We can safely start referencing those textures onto geometries afterward.
         waitAndDeleteChromiumSync(&m_mailboxesGLFence);
     }
 
+    // The textures of new resources are complete once GL waited for Chromium, record them.
+    if (!m_texturesToRecord.isEmpty())
+        recordTextures();
+
     // Then render any intermediate RenderPass in order.
     Q_FOREACH (const QSharedPointer<RenderPassTexture> &renderPass, m_renderPassTextures)
         renderPass->grab();
 }
 
-void DelegatedFrameNode::commit(DelegatedFrameNodeData* data, cc::ReturnedResourceArray *resourcesToRelease)
+bool DelegatedFrameNode::commit(DelegatedFrameNodeData* data, cc::ReturnedResourceArray *resourcesToRelease)
 {
     m_data = data;
-    cc::DelegatedFrameData* frameData = m_data->frameData.get();
-    if (!frameData)
-        return;
+    if (!m_data->frameData)
+        return true;
 
-    // DelegatedFrameNode is a transform node only for the purpose of
-    // countering the scale of devicePixel-scaled tiles when rendering them
-    // to the final surface.
-    QMatrix4x4 matrix;
-    matrix.scale(1 / m_data->frameDevicePixelRatio, 1 / m_data->frameDevicePixelRatio);
-    setMatrix(matrix);
+    importResources();
 
-    // Keep the old texture lists around to find the ones we can re-use.
-    QList<QSharedPointer<RenderPassTexture> > oldRenderPassTextures;
-    m_renderPassTextures.swap(oldRenderPassTextures);
-    QHash<unsigned, QSharedPointer<MailboxTexture> > mailboxTextureCandidates;
-    m_data->mailboxTextures.swap(mailboxTextureCandidates);
+    if (m_pipelinedFetch) {
+        // Fetch the mailboxes of the new frame on the GPU thread while the scene graph keeps
+        // rendering the previous one, which stays on screen until everything is ready.
+        // This avoids blocking the render thread in preprocess, at the cost of a frame of latency.
+        QMutexLocker lock(&m_mutex);
+        if (m_fetchInFlight)
+            return false;
+        if (collectMailboxesToFetch()) {
+            // The fence of the previous fetch hasn't been consumed if we haven't been rendered since.
+            waitAndDeleteChromiumSync(&m_mailboxesGLFence);
+            fetchMailboxes();
+            return false;
+        }
+    }
 
+    applyFrame(resourcesToRelease);
+    return true;
+}
+
+void DelegatedFrameNode::importResources()
+{
     // A frame's resource_list only contains the new resources to be added to the scene. Quads can
     // still reference resources that were added in previous frames. Add them to the list of
     // candidates to be picked up by quads, it's then our responsibility to return unused resources
     // to the producing child compositor.
+    cc::DelegatedFrameData* frameData = m_data->frameData.get();
     for (unsigned i = 0; i < frameData->resource_list.size(); ++i) {
         const cc::TransferableResource &res = frameData->resource_list.at(i);
-        if (QSharedPointer<MailboxTexture> texture = mailboxTextureCandidates.value(res.id))
+        if (m_frameRecorder)
+            m_importedResourceIds.append(res.id);
+        if (QSharedPointer<MailboxTexture> texture = m_data->mailboxTextures.value(res.id))
             texture->incImportCount();
         else
-            mailboxTextureCandidates[res.id] = QSharedPointer<MailboxTexture>(new MailboxTexture(res));
+            m_data->mailboxTextures[res.id] = QSharedPointer<MailboxTexture>(new MailboxTexture(res));
     }
 
     frameData->resource_list.clear();
+}
+
+bool DelegatedFrameNode::collectMailboxesToFetch()
+{
+    Q_ASSERT(m_mailboxesToFetch.isEmpty());
+    Q_FOREACH (const QSharedPointer<MailboxTexture> &mailboxTexture, m_data->mailboxTextures.values())
+        if (mailboxTexture->needsToFetch())
+            m_mailboxesToFetch.append(mailboxTexture);
+    return !m_mailboxesToFetch.isEmpty();
+}
+
+void DelegatedFrameNode::fetchMailboxes()
+{
+    // Must be called with m_mutex locked, syncPointRetired needs it to be released before it can proceed.
+    Q_ASSERT(!m_fetchInFlight);
+    m_fetchInFlight = true;
+    m_fetchStartTime = base::TimeTicks::Now();
+    base::MessageLoop *gpuMessageLoop = gpu_message_loop();
+    content::SyncPointManager *syncPointManager = sync_point_manager();
+
+    Q_FOREACH (const QSharedPointer<MailboxTexture> &mailboxTexture, m_mailboxesToFetch) {
+        m_numPendingSyncPoints++;
+        AddSyncPointCallbackOnGpuThread(gpuMessageLoop, syncPointManager, mailboxTexture->resource().sync_point, base::Bind(&DelegatedFrameNode::syncPointRetired, this));
+    }
+}
+
+void DelegatedFrameNode::applyFrame(cc::ReturnedResourceArray *resourcesToRelease)
+{
+    cc::DelegatedFrameData* frameData = m_data->frameData.get();
+    m_lastCommitStats = DelegatedFrameNodeStats();
+
+    // DelegatedFrameNode is a transform node only for the purpose of
+    // countering the scale of devicePixel-scaled tiles when rendering them
+    // to the final surface.
+    QMatrix4x4 matrix;
+    matrix.scale(1 / m_data->frameDevicePixelRatio, 1 / m_data->frameDevicePixelRatio);
+    setMatrix(matrix);
+
+    // Keep the old texture lists around to find the ones we can re-use.
+    QList<QSharedPointer<RenderPassTexture> > oldRenderPassTextures;
+    m_renderPassTextures.swap(oldRenderPassTextures);
+    QHash<unsigned, QSharedPointer<MailboxTexture> > mailboxTextureCandidates;
+    m_data->mailboxTextures.swap(mailboxTextureCandidates);
 
     // The RenderPasses list is actually a tree where a parent RenderPass is connected
     // to its dependencies through a RenderPass::Id reference in one or more RenderPassQuads.
@@ -463,6 +993,7 @@ void DelegatedFrameNode::commit(DelegatedFrameNodeData* data, cc::ReturnedResour
         cc::RenderPass *pass = frameData->render_pass_list.at(i);
 
         QSGNode *renderPassParent = 0;
+        RenderPassNodes *passNodes = 0;
         if (pass != rootRenderPass) {
             QSharedPointer<RenderPassTexture> rpTexture = findRenderPassTexture(pass->id, oldRenderPassTextures);
             if (!rpTexture)
@@ -471,149 +1002,294 @@ void DelegatedFrameNode::commit(DelegatedFrameNodeData* data, cc::ReturnedResour
             rpTexture->setDevicePixelRatio(m_data->frameDevicePixelRatio);
             rpTexture->setRect(toQt(pass->output_rect));
             rpTexture->setFormat(pass->has_transparent_background ? GL_RGBA : GL_RGB);
+            rpTexture->addDamage(toQt(pass->damage_rect).toAlignedRect());
             renderPassParent = rpTexture->rootNode();
-        } else
+            passNodes = rpTexture->passNodes();
+        } else {
             renderPassParent = this;
+            passNodes = m_rootPassNodes.data();
+        }
 
-        // There is currently no way to know which and how quads changed since the last frame.
-        // We have to reconstruct the node chain with their geometries on every update.
-        while (QSGNode *oldChain = renderPassParent->firstChild())
-            delete oldChain;
-
-        QSGNode *renderPassChain = buildRenderPassChain(renderPassParent);
-        const cc::SharedQuadState *currentLayerState = 0;
-        QSGNode *currentLayerChain = 0;
+        updateRenderPassNodes(renderPassParent, passNodes, pass, mailboxTextureCandidates);
+    }
 
-        cc::QuadList::ConstBackToFrontIterator it = pass->quad_list.BackToFrontBegin();
-        cc::QuadList::ConstBackToFrontIterator end = pass->quad_list.BackToFrontEnd();
-        for (; it != end; ++it) {
-            cc::DrawQuad *quad = *it;
+    // Send resources of remaining candidates back to the child compositors so that they can be freed or reused.
+    Q_FOREACH (const QSharedPointer<MailboxTexture> &mailboxTexture, mailboxTextureCandidates.values())
+        resourcesToRelease->push_back(mailboxTexture->returnResource());
 
-            if (currentLayerState != quad->shared_quad_state) {
-                currentLayerState = quad->shared_quad_state;
-                currentLayerChain = buildLayerChain(renderPassChain, currentLayerState);
-            }
+    if (m_frameStatistics) {
+        m_frameStatistics->addOverdrawSample(m_lastCommitStats.outputPixels, m_lastCommitStats.pixelsBeforeCulling, m_lastCommitStats.pixelsAfterCulling);
+        m_frameStatistics->addSceneGraphNodesSample(m_lastCommitStats.nodesReused, m_lastCommitStats.nodesCreated, m_lastCommitStats.nodesDeleted);
+    }
 
-            switch (quad->material) {
-            case cc::DrawQuad::CHECKERBOARD: {
-                const cc::CheckerboardDrawQuad *cbquad = cc::CheckerboardDrawQuad::MaterialCast(quad);
-                QSGRectangleNode *rectangleNode = m_sgRenderContext->sceneGraphContext()->createRectangleNode();
+    if (m_frameRecorder && !m_data->serializedFrame.isEmpty()) {
+        m_frameRecorder->recordFrame(m_data->serializedFrame, m_data->frameDevicePixelRatio);
+        m_data->serializedFrame.clear();
+        // Resources returned without being used by this frame are recorded without contents.
+        Q_FOREACH (unsigned resourceId, m_importedResourceIds) {
+            if (QSharedPointer<MailboxTexture> texture = m_data->mailboxTextures.value(resourceId))
+                m_texturesToRecord.append(texture);
+            else
+                m_frameRecorder->recordResource(resourceId, QImage());
+        }
+    }
+    m_importedResourceIds.clear();
+}
 
-                rectangleNode->setRect(toQt(quad->rect));
-                rectangleNode->setColor(toQt(cbquad->color));
-                rectangleNode->update();
-                currentLayerChain->appendChildNode(rectangleNode);
-                break;
-            } case cc::DrawQuad::RENDER_PASS: {
-                const cc::RenderPassDrawQuad *renderPassQuad = cc::RenderPassDrawQuad::MaterialCast(quad);
-                QSGTexture *texture = findRenderPassTexture(renderPassQuad->render_pass_id, m_renderPassTextures).data();
-                // cc::GLRenderer::DrawRenderPassQuad silently ignores missing render passes.
-                if (!texture)
-                    continue;
-
-                QSGSimpleTextureNode *textureNode = new QSGSimpleTextureNode;
-                textureNode->setRect(toQt(quad->rect));
-                textureNode->setTexture(texture);
-                currentLayerChain->appendChildNode(textureNode);
-                break;
-            } case cc::DrawQuad::TEXTURE_CONTENT: {
-                const cc::TextureDrawQuad *tquad = cc::TextureDrawQuad::MaterialCast(quad);
-                QSharedPointer<MailboxTexture> &texture = findMailboxTexture(tquad->resource_id, m_data->mailboxTextures, mailboxTextureCandidates);
-
-                // FIXME: TransferableResource::size isn't always set properly for TextureDrawQuads, use the size of its DrawQuad::rect instead.
-                texture->setTextureSize(toQt(quad->rect.size()));
-
-                // TransferableResource::format seems to always be GL_BGRA even though it might not
-                // contain any pixel with alpha < 1.0. The information about if they need blending
-                // for the contents itself is actually stored in quads.
-                // Tell the scene graph to enable blending for a texture only when at least one quad asks for it.
-                // Do not rely on DrawQuad::ShouldDrawWithBlending() since the shared_quad_state->opacity
-                // case will be handled by QtQuick by fetching this information from QSGOpacityNodes.
-                if (!quad->visible_rect.IsEmpty() && !quad->opaque_rect.Contains(quad->visible_rect))
-                    texture->setHasAlphaChannel(true);
-
-                QSGSimpleTextureNode *textureNode = new QSGSimpleTextureNode;
-                textureNode->setTextureCoordinatesTransform(tquad->flipped ? QSGSimpleTextureNode::MirrorVertically : QSGSimpleTextureNode::NoTransform);
-                textureNode->setRect(toQt(quad->rect));
-                textureNode->setFiltering(texture->resource().filter == GL_LINEAR ? QSGTexture::Linear : QSGTexture::Nearest);
-                textureNode->setTexture(texture.data());
-                currentLayerChain->appendChildNode(textureNode);
-                break;
-            } case cc::DrawQuad::SOLID_COLOR: {
-                const cc::SolidColorDrawQuad *scquad = cc::SolidColorDrawQuad::MaterialCast(quad);
-                QSGRectangleNode *rectangleNode = m_sgRenderContext->sceneGraphContext()->createRectangleNode();
-
-                // Qt only supports MSAA and this flag shouldn't be needed.
-                // If we ever want to use QSGRectangleNode::setAntialiasing for this we should
-                // try to see if we can do something similar for tile quads first.
-                Q_UNUSED(scquad->force_anti_aliasing_off);
-
-                rectangleNode->setRect(toQt(quad->rect));
-                rectangleNode->setColor(toQt(scquad->color));
-                rectangleNode->update();
-                currentLayerChain->appendChildNode(rectangleNode);
-                break;
-            } case cc::DrawQuad::TILED_CONTENT: {
-                const cc::TileDrawQuad *tquad = cc::TileDrawQuad::MaterialCast(quad);
-                QSharedPointer<MailboxTexture> &texture = findMailboxTexture(tquad->resource_id, m_data->mailboxTextures, mailboxTextureCandidates);
+void DelegatedFrameNode::recordTextures()
+{
+    Q_FOREACH (const QSharedPointer<MailboxTexture> &texture, m_texturesToRecord) {
+        QImage contents;
+        // External textures can't be attached to a framebuffer.
+        if (texture->textureId() && texture->target() == GL_TEXTURE_2D)
+            contents = readTextureContents(texture->textureId(), toQt(texture->resource().size));
+        m_frameRecorder->recordResource(texture->resource().id, contents);
+    }
+    m_texturesToRecord.clear();
+}
 
-                if (!quad->visible_rect.IsEmpty() && !quad->opaque_rect.Contains(quad->visible_rect))
-                    texture->setHasAlphaChannel(true);
+bool DelegatedFrameNode::importTexture(DelegatedFrameNodeData *data, const cc::TransferableResource &resource, int textureId)
+{
+    if (QSharedPointer<MailboxTexture> texture = data->mailboxTextures.value(resource.id)) {
+        texture->incImportCount();
+        return false;
+    }
+    QSharedPointer<MailboxTexture> texture(new MailboxTexture(resource));
+    texture->setFetchedTexture(textureId);
+    data->mailboxTextures[resource.id] = texture;
+    return true;
+}
 
-                QSGSimpleTextureNode *textureNode = new QSGSimpleTextureNode;
-                textureNode->setRect(toQt(quad->rect));
-                textureNode->setFiltering(texture->resource().filter == GL_LINEAR ? QSGTexture::Linear : QSGTexture::Nearest);
-                textureNode->setTexture(texture.data());
+void DelegatedFrameNode::updateRenderPassNodes(QSGNode *renderPassParent, RenderPassNodes *passNodes, cc::RenderPass *pass, QHash<unsigned, QSharedPointer<MailboxTexture> > &mailboxTextureCandidates)
+{
+    // Chromium doesn't tell us which quads changed since the last frame. Instead of rebuilding
+    // the node chain on every update, match the new quads against the nodes built for this
+    // RenderPass in the previous frame and only touch their geometry or material if needed.
+    // Layer chains are matched by the values of their SharedQuadState and quad nodes by their
+    // material and resource. Candidates left unused once all quads are placed get deleted.
+    if (!passNodes->chainNode) {
+        passNodes->chainNode = buildRenderPassChain(renderPassParent);
+        ++m_lastCommitStats.nodesCreated;
+    } else
+        ++m_lastCommitStats.nodesReused;
+    QSGNode *renderPassChain = passNodes->chainNode;
+
+    QList<LayerChainEntry> layerCandidates;
+    layerCandidates.swap(passNodes->layers);
+    QHash<QuadNodeKey, QList<QuadNodeEntry> > quadCandidates;
+    Q_FOREACH (const QuadNodeEntry &entry, passNodes->quads)
+        quadCandidates[entry.key()].append(entry);
+    passNodes->quads.clear();
+
+    // Don't build nodes for quads that would be entirely painted over, but keep their resources.
+    QVector<const cc::DrawQuad *> visibleQuads;
+    QVector<const cc::DrawQuad *> culledQuads;
+    cullQuads(pass, &visibleQuads, &culledQuads, &m_lastCommitStats);
+    Q_FOREACH (const cc::DrawQuad *quad, culledQuads)
+        retainQuadResources(quad, m_data->mailboxTextures, mailboxTextureCandidates);
+
+    QSGNode *lastInRenderPassChain = 0;
+    QVector<QSGNode *> lastInLayerChains;
+    QSGNode **lastInCurrentChain = &lastInRenderPassChain;
+    const cc::SharedQuadState *currentLayerState = 0;
+    QSGNode *currentLayerChain = 0;
+
+    Q_FOREACH (const cc::DrawQuad *quad, visibleQuads) {
+
+        if (currentLayerState != quad->shared_quad_state) {
+            currentLayerState = quad->shared_quad_state;
+            LayerChainEntry layerChain = takeLayerChain(layerCandidates, currentLayerState, &m_lastCommitStats);
+            if (QSGNode *layerChainRoot = layerChain.root()) {
+                placeNode(renderPassChain, layerChainRoot, &lastInRenderPassChain);
+                passNodes->layers.append(layerChain);
+                lastInLayerChains.append(0);
+                currentLayerChain = layerChain.leaf();
+                lastInCurrentChain = &lastInLayerChains.last();
+            } else {
+                currentLayerChain = renderPassChain;
+                lastInCurrentChain = &lastInRenderPassChain;
+            }
+        }
 
+        QuadNodeEntry entry;
+        entry.material = quad->material;
+        bool reused = false;
+
+        switch (quad->material) {
+        case cc::DrawQuad::CHECKERBOARD: {
+            const cc::CheckerboardDrawQuad *cbquad = cc::CheckerboardDrawQuad::MaterialCast(quad);
+            reused = takeQuadNode(quadCandidates, &entry);
+            if (!reused)
+                entry.node = m_sgRenderContext->sceneGraphContext()->createRectangleNode();
+
+            if (!reused || entry.rect != toQt(quad->rect) || entry.color != toQt(cbquad->color)) {
+                QSGRectangleNode *rectangleNode = static_cast<QSGRectangleNode *>(entry.node);
+                entry.rect = toQt(quad->rect);
+                entry.color = toQt(cbquad->color);
+                rectangleNode->setRect(entry.rect);
+                rectangleNode->setColor(entry.color);
+                rectangleNode->update();
+            }
+            break;
+        } case cc::DrawQuad::RENDER_PASS: {
+            const cc::RenderPassDrawQuad *renderPassQuad = cc::RenderPassDrawQuad::MaterialCast(quad);
+            QSGTexture *texture = findRenderPassTexture(renderPassQuad->render_pass_id, m_renderPassTextures).data();
+            // cc::GLRenderer::DrawRenderPassQuad silently ignores missing render passes.
+            if (!texture)
+                continue;
+
+            entry.resourceKey = reinterpret_cast<quintptr>(texture);
+            reused = takeQuadNode(quadCandidates, &entry);
+            if (!reused)
+                entry.node = new QSGSimpleTextureNode;
+
+            // QSGSimpleTextureNode setters only mark the node dirty if the value changed.
+            QSGSimpleTextureNode *textureNode = static_cast<QSGSimpleTextureNode *>(entry.node);
+            textureNode->setRect(toQt(quad->rect));
+            textureNode->setTexture(texture);
+            break;
+        } case cc::DrawQuad::TEXTURE_CONTENT: {
+            const cc::TextureDrawQuad *tquad = cc::TextureDrawQuad::MaterialCast(quad);
+            QSharedPointer<MailboxTexture> &texture = findMailboxTexture(tquad->resource_id, m_data->mailboxTextures, mailboxTextureCandidates);
+
+            // FIXME: TransferableResource::size isn't always set properly for TextureDrawQuads, use the size of its DrawQuad::rect instead.
+            texture->setTextureSize(toQt(quad->rect.size()));
+
+            // TransferableResource::format seems to always be GL_BGRA even though it might not
+            // contain any pixel with alpha < 1.0. The information about if they need blending
+            // for the contents itself is actually stored in quads.
+            // Tell the scene graph to enable blending for a texture only when at least one quad asks for it.
+            // Do not rely on DrawQuad::ShouldDrawWithBlending() since the shared_quad_state->opacity
+            // case will be handled by QtQuick by fetching this information from QSGOpacityNodes.
+            if (!quad->visible_rect.IsEmpty() && !quad->opaque_rect.Contains(quad->visible_rect))
+                texture->setHasAlphaChannel(true);
+
+            entry.resourceKey = tquad->resource_id;
+            reused = takeQuadNode(quadCandidates, &entry);
+            if (!reused)
+                entry.node = new QSGSimpleTextureNode;
+
+            QSGSimpleTextureNode *textureNode = static_cast<QSGSimpleTextureNode *>(entry.node);
+            textureNode->setTextureCoordinatesTransform(tquad->flipped ? QSGSimpleTextureNode::MirrorVertically : QSGSimpleTextureNode::NoTransform);
+            textureNode->setRect(toQt(quad->rect));
+            textureNode->setFiltering(texture->resource().filter == GL_LINEAR ? QSGTexture::Linear : QSGTexture::Nearest);
+            textureNode->setTexture(texture.data());
+            break;
+        } case cc::DrawQuad::SOLID_COLOR: {
+            const cc::SolidColorDrawQuad *scquad = cc::SolidColorDrawQuad::MaterialCast(quad);
+            reused = takeQuadNode(quadCandidates, &entry);
+            if (!reused)
+                entry.node = m_sgRenderContext->sceneGraphContext()->createRectangleNode();
+
+            // Qt only supports MSAA and this flag shouldn't be needed.
+            // If we ever want to use QSGRectangleNode::setAntialiasing for this we should
+            // try to see if we can do something similar for tile quads first.
+            Q_UNUSED(scquad->force_anti_aliasing_off);
+
+            if (!reused || entry.rect != toQt(quad->rect) || entry.color != toQt(scquad->color)) {
+                QSGRectangleNode *rectangleNode = static_cast<QSGRectangleNode *>(entry.node);
+                entry.rect = toQt(quad->rect);
+                entry.color = toQt(scquad->color);
+                rectangleNode->setRect(entry.rect);
+                rectangleNode->setColor(entry.color);
+                rectangleNode->update();
+            }
+            break;
+        } case cc::DrawQuad::TILED_CONTENT: {
+            const cc::TileDrawQuad *tquad = cc::TileDrawQuad::MaterialCast(quad);
+            QSharedPointer<MailboxTexture> &texture = findMailboxTexture(tquad->resource_id, m_data->mailboxTextures, mailboxTextureCandidates);
+
+            if (!quad->visible_rect.IsEmpty() && !quad->opaque_rect.Contains(quad->visible_rect))
+                texture->setHasAlphaChannel(true);
+
+            entry.resourceKey = tquad->resource_id;
+            reused = takeQuadNode(quadCandidates, &entry);
+            if (!reused)
+                entry.node = new QSGSimpleTextureNode;
+
+            QSGSimpleTextureNode *textureNode = static_cast<QSGSimpleTextureNode *>(entry.node);
+            QRectF rect = toQt(quad->rect);
+            QRectF sourceRect = toQt(tquad->tex_coord_rect);
+            bool geometryChanged = !reused || entry.rect != rect || entry.sourceRect != sourceRect || textureNode->texture() != texture.data();
+            textureNode->setRect(rect);
+            textureNode->setFiltering(texture->resource().filter == GL_LINEAR ? QSGTexture::Linear : QSGTexture::Nearest);
+            textureNode->setTexture(texture.data());
+
+            if (geometryChanged) {
                 // FIXME: Find out if we can implement a QSGSimpleTextureNode::setSourceRect instead of this hack.
                 // This has to be done at the end since many QSGSimpleTextureNode methods would overwrite this.
-                QSGGeometry::updateTexturedRectGeometry(textureNode->geometry(), textureNode->rect(), textureNode->texture()->convertToNormalizedSourceRect(toQt(tquad->tex_coord_rect)));
-                currentLayerChain->appendChildNode(textureNode);
-                break;
-            } case cc::DrawQuad::YUV_VIDEO_CONTENT: {
-                const cc::YUVVideoDrawQuad *vquad = cc::YUVVideoDrawQuad::MaterialCast(quad);
-                QSharedPointer<MailboxTexture> &yTexture = findMailboxTexture(vquad->y_plane_resource_id, m_data->mailboxTextures, mailboxTextureCandidates);
-                QSharedPointer<MailboxTexture> &uTexture = findMailboxTexture(vquad->u_plane_resource_id, m_data->mailboxTextures, mailboxTextureCandidates);
-                QSharedPointer<MailboxTexture> &vTexture = findMailboxTexture(vquad->v_plane_resource_id, m_data->mailboxTextures, mailboxTextureCandidates);
-
-                // Do not use a reference for this one, it might be null.
-                QSharedPointer<MailboxTexture> aTexture;
-                // This currently requires --enable-vp8-alpha-playback and needs a video with alpha data to be triggered.
-                if (vquad->a_plane_resource_id)
-                    aTexture = findMailboxTexture(vquad->a_plane_resource_id, m_data->mailboxTextures, mailboxTextureCandidates);
-
-                YUVVideoNode *videoNode = new YUVVideoNode(yTexture.data(), uTexture.data(), vTexture.data(), aTexture.data(), toQt(vquad->tex_scale));
-                videoNode->setRect(toQt(quad->rect));
-                currentLayerChain->appendChildNode(videoNode);
-                break;
+                QSGGeometry::updateTexturedRectGeometry(textureNode->geometry(), textureNode->rect(), textureNode->texture()->convertToNormalizedSourceRect(sourceRect));
+                textureNode->markDirty(QSGNode::DirtyGeometry);
+                entry.rect = rect;
+                entry.sourceRect = sourceRect;
+            }
+            break;
+        } case cc::DrawQuad::YUV_VIDEO_CONTENT: {
+            const cc::YUVVideoDrawQuad *vquad = cc::YUVVideoDrawQuad::MaterialCast(quad);
+            QSharedPointer<MailboxTexture> &yTexture = findMailboxTexture(vquad->y_plane_resource_id, m_data->mailboxTextures, mailboxTextureCandidates);
+            QSharedPointer<MailboxTexture> &uTexture = findMailboxTexture(vquad->u_plane_resource_id, m_data->mailboxTextures, mailboxTextureCandidates);
+
+            // Do not use a reference for these ones, they might be null.
+            // Without a V plane, the U plane holds the interleaved chroma of a two-plane NV12 frame.
+            QSharedPointer<MailboxTexture> vTexture;
+            if (vquad->v_plane_resource_id)
+                vTexture = findMailboxTexture(vquad->v_plane_resource_id, m_data->mailboxTextures, mailboxTextureCandidates);
+            QSharedPointer<MailboxTexture> aTexture;
+            // This currently requires --enable-vp8-alpha-playback and needs a video with alpha data to be triggered.
+            if (vquad->a_plane_resource_id)
+                aTexture = findMailboxTexture(vquad->a_plane_resource_id, m_data->mailboxTextures, mailboxTextureCandidates);
+
+            // YUVVideoNode binds its planes at construction and each video frame comes
+            // with new resources anyway, always build a new node.
+            entry.resourceKey = vquad->y_plane_resource_id;
+            YUVVideoMaterial::ColorSpace colorSpace = vquad->color_space == cc::YUVVideoDrawQuad::REC_709 ? YUVVideoMaterial::BT709 : YUVVideoMaterial::BT601;
+            YUVVideoMaterial::ColorRange colorRange = vquad->color_space == cc::YUVVideoDrawQuad::REC_601_JPEG ? YUVVideoMaterial::FullRange : YUVVideoMaterial::LimitedRange;
+            YUVVideoNode *videoNode = new YUVVideoNode(yTexture.data(), uTexture.data(), vTexture.data(), aTexture.data(), toQt(vquad->tex_scale), colorSpace, colorRange);
+            videoNode->setRect(toQt(quad->rect));
+            entry.node = videoNode;
+            break;
 #ifdef GL_OES_EGL_image_external
-            } case cc::DrawQuad::STREAM_VIDEO_CONTENT: {
-                const cc::StreamVideoDrawQuad *squad = cc::StreamVideoDrawQuad::MaterialCast(quad);
-                QSharedPointer<MailboxTexture> &texture = findMailboxTexture(squad->resource_id, m_data->mailboxTextures, mailboxTextureCandidates);
-                texture->setTarget(GL_TEXTURE_EXTERNAL_OES); // since this is not default TEXTURE_2D type
-
-                StreamVideoNode *svideoNode = new StreamVideoNode(texture.data());
-                svideoNode->setRect(toQt(squad->rect));
-                svideoNode->setTextureMatrix(toQt(squad->matrix.matrix()));
-                currentLayerChain->appendChildNode(svideoNode);
-                break;
+        } case cc::DrawQuad::STREAM_VIDEO_CONTENT: {
+            const cc::StreamVideoDrawQuad *squad = cc::StreamVideoDrawQuad::MaterialCast(quad);
+            QSharedPointer<MailboxTexture> &texture = findMailboxTexture(squad->resource_id, m_data->mailboxTextures, mailboxTextureCandidates);
+            texture->setTarget(GL_TEXTURE_EXTERNAL_OES); // since this is not default TEXTURE_2D type
+
+            entry.resourceKey = squad->resource_id;
+            reused = takeQuadNode(quadCandidates, &entry);
+            if (!reused)
+                entry.node = new StreamVideoNode(texture.data());
+
+            StreamVideoNode *svideoNode = static_cast<StreamVideoNode *>(entry.node);
+            svideoNode->setRect(toQt(squad->rect));
+            svideoNode->setTextureMatrix(toQt(squad->matrix.matrix()));
+            break;
 #endif
-            } default:
-                qWarning("Unimplemented quad material: %d", quad->material);
-            }
+        } default:
+            qWarning("Unimplemented quad material: %d", quad->material);
+            continue;
         }
+
+        if (reused)
+            ++m_lastCommitStats.nodesReused;
+        else
+            ++m_lastCommitStats.nodesCreated;
+        passNodes->quads.append(entry);
+        placeNode(currentLayerChain, entry.node, lastInCurrentChain);
     }
 
-    // Send resources of remaining candidates back to the child compositors so that they can be freed or reused.
-    Q_FOREACH (const QSharedPointer<MailboxTexture> &mailboxTexture, mailboxTextureCandidates.values())
-        resourcesToRelease->push_back(mailboxTexture->returnResource());
+    // Every node that was picked up is now placed before the last one we placed in its
+    // parent. What follows them are candidates that nothing in this frame matched.
+    for (int i = 0; i < passNodes->layers.size(); ++i)
+        m_lastCommitStats.nodesDeleted += deleteNodesAfter(passNodes->layers.at(i).leaf(), lastInLayerChains.at(i));
+    m_lastCommitStats.nodesDeleted += deleteNodesAfter(renderPassChain, lastInRenderPassChain);
 }
 
-void DelegatedFrameNode::fetchTexturesAndUnlockQt(DelegatedFrameNode *frameNode, QList<MailboxTexture *> *mailboxesToFetch)
+void DelegatedFrameNode::fetchTexturesAndUnlockQt(DelegatedFrameNode *frameNode)
 {
     // Fetch texture IDs from the mailboxes while we're on the GPU thread, where the MailboxManager lives.
+    // The render thread doesn't touch the list until m_fetchInFlight is reset.
     gpu::gles2::MailboxManager *mailboxManager = mailbox_manager();
-    Q_FOREACH (MailboxTexture *mailboxTexture, *mailboxesToFetch)
+    Q_FOREACH (const QSharedPointer<MailboxTexture> &mailboxTexture, frameNode->m_mailboxesToFetch)
         mailboxTexture->fetchTexture(mailboxManager);
 
     // Set a fence at this point in Chromium's GL command stream
@@ -624,10 +1300,18 @@ void DelegatedFrameNode::fetchTexturesAndUnlockQt(DelegatedFrameNode *frameNode,
     QMutexLocker lock(&frameNode->m_mutex);
     Q_ASSERT(!frameNode->m_mailboxesGLFence);
     frameNode->m_mailboxesGLFence = fence;
-    frameNode->m_mailboxesFetchedWaitCond.wakeOne();
+    frameNode->m_mailboxesToFetch.clear();
+    if (frameNode->m_frameStatistics)
+        frameNode->m_frameStatistics->addSample(FrameStatistics::MailboxWait, base::TimeTicks::Now() - frameNode->m_fetchStartTime);
+    frameNode->m_fetchInFlight = false;
+    frameNode->m_mailboxesFetchedWaitCond.wakeAll();
+
+    // Nobody is waiting in pipelined mode, ask the view for another commit.
+    if (frameNode->m_pipelinedFetch && !frameNode->m_texturesFetchedCallback.is_null())
+        content::BrowserThread::PostTask(content::BrowserThread::UI, FROM_HERE, frameNode->m_texturesFetchedCallback);
 }
 
-void DelegatedFrameNode::syncPointRetired(DelegatedFrameNode *frameNode, QList<MailboxTexture *> *mailboxesToFetch)
+void DelegatedFrameNode::syncPointRetired(DelegatedFrameNode *frameNode)
 {
     // The way that sync points are normally used by the GpuCommandBufferStub is that it asks
     // the GpuScheduler to resume the work of the associated GL command stream / context once
@@ -639,6 +1323,5 @@ void DelegatedFrameNode::syncPointRetired(DelegatedFrameNode *frameNode, QList<M
     // only at this point we wake the Qt rendering thread.
     QMutexLocker lock(&frameNode->m_mutex);
     if (!--frameNode->m_numPendingSyncPoints)
-        base::MessageLoop::current()->PostTask(FROM_HERE, base::Bind(&DelegatedFrameNode::fetchTexturesAndUnlockQt, frameNode, mailboxesToFetch));
+        base::MessageLoop::current()->PostTask(FROM_HERE, base::Bind(&DelegatedFrameNode::fetchTexturesAndUnlockQt, frameNode));
 }
-
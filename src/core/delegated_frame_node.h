@@ -42,15 +42,19 @@
 #ifndef DELEGATED_FRAME_NODE_H
 #define DELEGATED_FRAME_NODE_H
 
+#include "base/callback.h"
 #include "base/memory/scoped_ptr.h"
 #include "cc/resources/transferable_resource.h"
+#include <QByteArray>
 #include <QMutex>
 #include <QSGNode>
+#include <QScopedPointer>
 #include <QSharedData>
 #include <QSharedPointer>
 #include <QWaitCondition>
 
 #include "chromium_gpu_helper.h"
+#include "frame_statistics.h"
 
 QT_BEGIN_NAMESPACE
 class QSGRenderContext;
@@ -58,9 +62,12 @@ QT_END_NAMESPACE
 
 namespace cc {
 class DelegatedFrameData;
+class RenderPass;
 }
 
+class DelegatedFrameRecorder;
 class MailboxTexture;
+class RenderPassNodes;
 class RenderPassTexture;
 
 // Separating this data allows another DelegatedFrameNode to reconstruct the QSGNode tree from the mailbox textures
@@ -71,19 +78,71 @@ public:
     QHash<unsigned, QSharedPointer<MailboxTexture> > mailboxTextures;
     scoped_ptr<cc::DelegatedFrameData> frameData;
     qreal frameDevicePixelRatio;
+    // Only set while frames are being recorded.
+    QByteArray serializedFrame;
+};
+
+// Counts the scene graph nodes that the last commit could reuse from the previous frame,
+// had to create, or deleted because nothing in the new frame matched them anymore.
+// Pixel counts are summed over all render passes, the overdraw of a frame being the
+// number of pixels covered by its quads divided by the number of pixels of its passes.
+struct DelegatedFrameNodeStats {
+    DelegatedFrameNodeStats()
+        : nodesReused(0), nodesCreated(0), nodesDeleted(0), quadsCulled(0)
+        , outputPixels(0), pixelsBeforeCulling(0), pixelsAfterCulling(0) { }
+    int nodesReused;
+    int nodesCreated;
+    int nodesDeleted;
+    // Quads hidden behind opaque quads.
+    int quadsCulled;
+    qint64 outputPixels;
+    qint64 pixelsBeforeCulling;
+    qint64 pixelsAfterCulling;
 };
 
 class DelegatedFrameNode : public QSGTransformNode {
 public:
+    // Imports |resource| as already fetched into |textureId| instead of going through its
+    // mailbox, for replaying recorded frames without the Chromium GPU thread. The resource
+    // must be removed from the frame's resource_list. Returns false if the resource was
+    // still imported, in which case its previous texture keeps being used.
+    static bool importTexture(DelegatedFrameNodeData *data, const cc::TransferableResource &resource, int textureId);
+
     DelegatedFrameNode(QSGRenderContext *sgRenderContext);
     ~DelegatedFrameNode();
     void preprocess();
-    void commit(DelegatedFrameNodeData* data, cc::ReturnedResourceArray *resourcesToRelease);
+    // Returns false if the frame couldn't be applied yet because its textures are still being
+    // fetched from the Chromium GPU thread, the previous frame stays displayed in the meantime.
+    // This only happens when pipelined mailbox fetching is enabled, in which case the
+    // textures fetched callback is posted to the UI thread once commit can be called again.
+    bool commit(DelegatedFrameNodeData* data, cc::ReturnedResourceArray *resourcesToRelease);
+    void setTexturesFetchedCallback(const base::Closure &callback) { m_texturesFetchedCallback = callback; }
+    const DelegatedFrameNodeStats &lastCommitStats() const { return m_lastCommitStats; }
+    void setFrameStatistics(const QSharedPointer<FrameStatistics> &statistics) { m_frameStatistics = statistics; }
+    void setFrameRecorder(const QSharedPointer<DelegatedFrameRecorder> &recorder) { m_frameRecorder = recorder; }
 
 private:
+    void importResources();
+    void applyFrame(cc::ReturnedResourceArray *resourcesToRelease);
+    void recordTextures();
+    bool collectMailboxesToFetch();
+    void fetchMailboxes();
+    void updateRenderPassNodes(QSGNode *renderPassParent, RenderPassNodes *passNodes, cc::RenderPass *pass, QHash<unsigned, QSharedPointer<MailboxTexture> > &mailboxTextureCandidates);
+
     QExplicitlySharedDataPointer<DelegatedFrameNodeData> m_data;
     QSGRenderContext *m_sgRenderContext;
     QList<QSharedPointer<RenderPassTexture> > m_renderPassTextures;
+    QScopedPointer<RenderPassNodes> m_rootPassNodes;
+    DelegatedFrameNodeStats m_lastCommitStats;
+    bool m_pipelinedFetch;
+    bool m_fetchInFlight;
+    QList<QSharedPointer<MailboxTexture> > m_mailboxesToFetch;
+    base::Closure m_texturesFetchedCallback;
+    QSharedPointer<FrameStatistics> m_frameStatistics;
+    QSharedPointer<DelegatedFrameRecorder> m_frameRecorder;
+    QList<unsigned> m_importedResourceIds;
+    QList<QSharedPointer<MailboxTexture> > m_texturesToRecord;
+    base::TimeTicks m_fetchStartTime;
     int m_numPendingSyncPoints;
     FenceSync m_mailboxesGLFence;
     QWaitCondition m_mailboxesFetchedWaitCond;
@@ -91,8 +150,8 @@ private:
 
     // Making those callbacks static bypasses base::Bind's ref-counting requirement
     // of the this pointer when the callback is a method.
-    static void fetchTexturesAndUnlockQt(DelegatedFrameNode *frameNode, QList<MailboxTexture *> *mailboxesToFetch);
-    static void syncPointRetired(DelegatedFrameNode *frameNode, QList<MailboxTexture *> *mailboxesToFetch);
+    static void fetchTexturesAndUnlockQt(DelegatedFrameNode *frameNode);
+    static void syncPointRetired(DelegatedFrameNode *frameNode);
 };
 
 #endif // DELEGATED_FRAME_NODE_H
@@ -0,0 +1,156 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "delegated_frame_recorder.h"
+
+#include "cc/output/delegated_frame_data.h"
+#include "content/common/cc_messages.h"
+#include "ipc/ipc_message.h"
+#include <QAtomicInt>
+#include <QCoreApplication>
+#include <QDir>
+
+static const quint32 recordingMagic = 0x51574652; // "QWFR"
+static const quint32 recordingVersion = 1;
+
+enum RecordType {
+    FrameRecord = 1,
+    ResourceRecord = 2
+};
+
+QSharedPointer<DelegatedFrameRecorder> DelegatedFrameRecorder::createFromEnvironment()
+{
+    const QByteArray directory = qgetenv("QTWEBENGINE_RECORD_FRAMES");
+    if (directory.isEmpty())
+        return QSharedPointer<DelegatedFrameRecorder>();
+
+    // Every view records to its own file.
+    static QAtomicInt recordingCount;
+    const QString fileName = QDir(QString::fromLocal8Bit(directory)).filePath(QStringLiteral("frames-%1-%2.qwfr")
+        .arg(QCoreApplication::applicationPid()).arg(recordingCount.fetchAndAddRelaxed(1)));
+    QSharedPointer<DelegatedFrameRecorder> recorder(new DelegatedFrameRecorder(fileName));
+    if (!recorder->isOpen()) {
+        qWarning("Could not open %s to record frames.", qPrintable(fileName));
+        return QSharedPointer<DelegatedFrameRecorder>();
+    }
+    return recorder;
+}
+
+QByteArray DelegatedFrameRecorder::serializeFrame(const cc::DelegatedFrameData &frameData)
+{
+    IPC::Message message;
+    IPC::ParamTraits<cc::DelegatedFrameData>::Write(&message, frameData);
+    return QByteArray(static_cast<const char *>(message.data()), message.size());
+}
+
+scoped_ptr<cc::DelegatedFrameData> DelegatedFrameRecorder::deserializeFrame(const QByteArray &serializedFrame)
+{
+    IPC::Message message(serializedFrame.constData(), serializedFrame.size());
+    PickleIterator iterator(message);
+    scoped_ptr<cc::DelegatedFrameData> frameData(new cc::DelegatedFrameData);
+    if (!IPC::ParamTraits<cc::DelegatedFrameData>::Read(&message, &iterator, frameData.get()))
+        return scoped_ptr<cc::DelegatedFrameData>();
+    return frameData.Pass();
+}
+
+bool DelegatedFrameRecorder::readRecording(const QString &fileName, QList<RecordedFrame> *frames)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_2);
+
+    quint32 magic = 0;
+    quint32 version = 0;
+    stream >> magic >> version;
+    if (magic != recordingMagic || version != recordingVersion)
+        return false;
+
+    while (!stream.atEnd() && stream.status() == QDataStream::Ok) {
+        quint8 type = 0;
+        stream >> type;
+        if (type == FrameRecord) {
+            RecordedFrame frame;
+            double devicePixelRatio = 1;
+            stream >> devicePixelRatio >> frame.serializedFrame;
+            frame.devicePixelRatio = devicePixelRatio;
+            frames->append(frame);
+        } else if (type == ResourceRecord && !frames->isEmpty()) {
+            quint32 resourceId = 0;
+            QSize size;
+            QByteArray pixels;
+            stream >> resourceId >> size >> pixels;
+            QImage contents;
+            if (!pixels.isEmpty() && pixels.size() == size.width() * size.height() * 4) {
+                contents = QImage(size, QImage::Format_RGBA8888_Premultiplied);
+                memcpy(contents.bits(), pixels.constData(), pixels.size());
+            }
+            frames->last().resources.insert(resourceId, contents);
+        } else
+            return false;
+    }
+    return stream.status() == QDataStream::Ok;
+}
+
+DelegatedFrameRecorder::DelegatedFrameRecorder(const QString &fileName)
+    : m_file(fileName)
+{
+    if (!m_file.open(QIODevice::WriteOnly))
+        return;
+    m_stream.setDevice(&m_file);
+    m_stream.setVersion(QDataStream::Qt_5_2);
+    m_stream << recordingMagic << recordingVersion;
+}
+
+void DelegatedFrameRecorder::recordFrame(const QByteArray &serializedFrame, qreal devicePixelRatio)
+{
+    m_stream << quint8(FrameRecord) << double(devicePixelRatio) << serializedFrame;
+}
+
+void DelegatedFrameRecorder::recordResource(unsigned resourceId, const QImage &contents)
+{
+    // Write the raw pixels, encoding them would slow down the render thread even more.
+    // Rows are kept in the order of the texture, bottom-up, the replay uploads them as is.
+    Q_ASSERT(contents.isNull() || contents.format() == QImage::Format_RGBA8888_Premultiplied);
+    m_stream << quint8(ResourceRecord) << quint32(resourceId) << contents.size()
+             << QByteArray::fromRawData(reinterpret_cast<const char *>(contents.constBits()), contents.byteCount());
+}
@@ -0,0 +1,92 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef DELEGATED_FRAME_RECORDER_H
+#define DELEGATED_FRAME_RECORDER_H
+
+#include "base/memory/scoped_ptr.h"
+#include <QByteArray>
+#include <QDataStream>
+#include <QFile>
+#include <QHash>
+#include <QImage>
+#include <QList>
+#include <QSharedPointer>
+
+namespace cc {
+class DelegatedFrameData;
+}
+
+// A frame read back from a recording, with the contents of the resources it added.
+struct RecordedFrame {
+    RecordedFrame() : devicePixelRatio(1) { }
+    QByteArray serializedFrame;
+    qreal devicePixelRatio;
+    // Null images for resources that couldn't be read back.
+    QHash<unsigned, QImage> resources;
+};
+
+// Writes the delegated frames committed to a DelegatedFrameNode to a file, each followed by the
+// contents of the resources it added, so that they can be replayed by DelegatedFrameReplayer.
+// Frames are serialized with the same IPC traits that are used to send them to the browser.
+class DelegatedFrameRecorder {
+public:
+    // Returns a recorder writing to a new file in the directory named by the
+    // QTWEBENGINE_RECORD_FRAMES environment variable, or null if it isn't set.
+    static QSharedPointer<DelegatedFrameRecorder> createFromEnvironment();
+
+    static QByteArray serializeFrame(const cc::DelegatedFrameData &frameData);
+    static scoped_ptr<cc::DelegatedFrameData> deserializeFrame(const QByteArray &serializedFrame);
+    static bool readRecording(const QString &fileName, QList<RecordedFrame> *frames);
+
+    explicit DelegatedFrameRecorder(const QString &fileName);
+    bool isOpen() const { return m_file.isOpen(); }
+
+    // Both are called from the Qt render thread, resources after the frame that added them.
+    void recordFrame(const QByteArray &serializedFrame, qreal devicePixelRatio);
+    void recordResource(unsigned resourceId, const QImage &contents);
+
+private:
+    QFile m_file;
+    QDataStream m_stream;
+};
+
+#endif // DELEGATED_FRAME_RECORDER_H
@@ -0,0 +1,235 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "delegated_frame_replayer.h"
+
+#include "delegated_frame_node.h"
+#include "delegated_frame_recorder.h"
+#include "type_conversion.h"
+
+#include "cc/output/delegated_frame_data.h"
+#include "cc/quads/render_pass.h"
+#include <QElapsedTimer>
+#include <QOpenGLContext>
+#include <QOpenGLFramebufferObject>
+#include <QSGNode>
+#include <QtQuick/private/qsgcontext_p.h>
+#include <QtQuick/private/qsgrenderer_p.h>
+
+class DelegatedFrameReplayerPrivate {
+public:
+    DelegatedFrameReplayerPrivate()
+        : nextFrame(0)
+        , devicePixelRatio(1)
+        , frameNode(0)
+    { }
+
+    void createNodes();
+    void releaseTextures(const cc::ReturnedResourceArray &resources);
+
+    QList<RecordedFrame> frames;
+    int nextFrame;
+    QSize frameSize;
+    qreal devicePixelRatio;
+
+    QScopedPointer<QSGContext> sgContext;
+    QScopedPointer<QSGRenderContext> sgRenderContext;
+    QScopedPointer<QSGRenderer> renderer;
+    QScopedPointer<QSGRootNode> rootNode;
+    // Owned by rootNode.
+    DelegatedFrameNode *frameNode;
+    QExplicitlySharedDataPointer<DelegatedFrameNodeData> frameNodeData;
+    QScopedPointer<QOpenGLFramebufferObject> fbo;
+    QHash<unsigned, GLuint> textures;
+};
+
+static GLuint uploadTexture(const QImage &contents, const QSize &size)
+{
+    GLuint texture = 0;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    // Resources that couldn't be read back while recording are left uninitialized.
+    const bool hasContents = !contents.isNull() && contents.size() == size;
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, size.width(), size.height(), 0, GL_RGBA, GL_UNSIGNED_BYTE, hasContents ? contents.constBits() : 0);
+    return texture;
+}
+
+void DelegatedFrameReplayerPrivate::createNodes()
+{
+    if (!sgContext) {
+        sgContext.reset(QSGContext::createDefaultContext());
+        sgRenderContext.reset(new QSGRenderContext(sgContext.data()));
+        sgRenderContext->initialize(QOpenGLContext::currentContext());
+        fbo.reset(new QOpenGLFramebufferObject(frameSize, QOpenGLFramebufferObject::CombinedDepthStencil));
+    }
+
+    rootNode.reset(new QSGRootNode);
+    frameNode = new DelegatedFrameNode(sgRenderContext.data());
+    // replayNextFrame() preprocesses the node itself to time it separately, keep the renderer from
+    // doing it a second time within the render measurement.
+    frameNode->setFlag(QSGNode::UsePreprocess, false);
+    rootNode->appendChildNode(frameNode);
+    frameNodeData = new DelegatedFrameNodeData;
+
+    renderer.reset(sgRenderContext->createRenderer());
+    renderer->setRootNode(rootNode.data());
+    // Nodes were added before the renderer could be notified about them.
+    rootNode->markDirty(QSGNode::DirtyForceUpdate);
+    renderer->nodeChanged(rootNode.data(), QSGNode::DirtyForceUpdate);
+    renderer->setDevicePixelRatio(devicePixelRatio);
+    renderer->setDeviceRect(frameSize);
+    renderer->setViewportRect(frameSize);
+    renderer->setProjectionMatrixToRect(QRectF(QPointF(), QSizeF(frameSize) / devicePixelRatio));
+    renderer->setClearColor(Qt::white);
+}
+
+void DelegatedFrameReplayerPrivate::releaseTextures(const cc::ReturnedResourceArray &resources)
+{
+    for (unsigned i = 0; i < resources.size(); ++i) {
+        GLuint texture = textures.take(resources.at(i).id);
+        glDeleteTextures(1, &texture);
+    }
+}
+
+DelegatedFrameReplayer::DelegatedFrameReplayer()
+    : d(new DelegatedFrameReplayerPrivate)
+{
+}
+
+DelegatedFrameReplayer::~DelegatedFrameReplayer()
+{
+    reset();
+    d->fbo.reset();
+    if (d->sgRenderContext)
+        d->sgRenderContext->invalidate();
+}
+
+bool DelegatedFrameReplayer::load(const QString &fileName)
+{
+    reset();
+    d->frames.clear();
+    if (!DelegatedFrameRecorder::readRecording(fileName, &d->frames) || d->frames.isEmpty())
+        return false;
+
+    // The root pass of the first frame gives the size of the view that was recorded.
+    scoped_ptr<cc::DelegatedFrameData> frameData = DelegatedFrameRecorder::deserializeFrame(d->frames.first().serializedFrame);
+    if (!frameData || frameData->render_pass_list.empty())
+        return false;
+    d->frameSize = toQt(frameData->render_pass_list.back()->output_rect.size());
+    d->devicePixelRatio = d->frames.first().devicePixelRatio;
+    return !d->frameSize.isEmpty();
+}
+
+int DelegatedFrameReplayer::frameCount() const
+{
+    return d->frames.size();
+}
+
+QSize DelegatedFrameReplayer::frameSize() const
+{
+    return d->frameSize;
+}
+
+DelegatedFrameReplayer::FrameTimings DelegatedFrameReplayer::replayNextFrame()
+{
+    Q_ASSERT(!d->frames.isEmpty());
+    if (d->nextFrame == d->frames.size())
+        reset();
+    if (!d->frameNode)
+        d->createNodes();
+
+    const RecordedFrame &frame = d->frames.at(d->nextFrame++);
+    DelegatedFrameNodeData *data = d->frameNodeData.data();
+    data->frameData = DelegatedFrameRecorder::deserializeFrame(frame.serializedFrame);
+    data->frameDevicePixelRatio = frame.devicePixelRatio;
+    if (!data->frameData)
+        return FrameTimings();
+
+    // Stand in for the Chromium GPU thread, outside of the measurements.
+    cc::TransferableResourceArray &resources = data->frameData->resource_list;
+    for (unsigned i = 0; i < resources.size(); ++i) {
+        const cc::TransferableResource &resource = resources.at(i);
+        GLuint texture = uploadTexture(frame.resources.value(resource.id), toQt(resource.size));
+        if (DelegatedFrameNode::importTexture(data, resource, texture))
+            d->textures.insert(resource.id, texture);
+        else
+            glDeleteTextures(1, &texture);
+    }
+    resources.clear();
+    glFinish();
+
+    FrameTimings timings;
+    QElapsedTimer timer;
+    cc::ReturnedResourceArray resourcesToRelease;
+    timer.start();
+    d->frameNode->commit(data, &resourcesToRelease);
+    timings.commit = timer.nsecsElapsed();
+
+    timer.restart();
+    d->frameNode->preprocess();
+    glFinish();
+    timings.preprocess = timer.nsecsElapsed();
+
+    timer.restart();
+    d->sgRenderContext->renderNextFrame(d->renderer.data(), d->fbo->handle());
+    glFinish();
+    timings.render = timer.nsecsElapsed();
+
+    d->releaseTextures(resourcesToRelease);
+    return timings;
+}
+
+void DelegatedFrameReplayer::reset()
+{
+    // Nodes reference the uploaded textures, delete them first.
+    d->renderer.reset();
+    d->rootNode.reset();
+    d->frameNode = 0;
+    d->frameNodeData.reset();
+    Q_FOREACH (GLuint texture, d->textures)
+        glDeleteTextures(1, &texture);
+    d->textures.clear();
+    d->nextFrame = 0;
+}
@@ -0,0 +1,83 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef DELEGATED_FRAME_REPLAYER_H
+#define DELEGATED_FRAME_REPLAYER_H
+
+#include "qtwebenginecoreglobal.h"
+#include <QScopedPointer>
+#include <QSize>
+#include <QString>
+
+class DelegatedFrameReplayerPrivate;
+
+// Feeds the frames of a recording made with QTWEBENGINE_RECORD_FRAMES through a DelegatedFrameNode
+// and renders them into an offscreen framebuffer, without a renderer process or the Chromium GPU
+// thread. Resource contents are uploaded before each measurement, like the GPU thread would have
+// produced them. Must be used with the same OpenGL context current throughout.
+class QWEBENGINE_EXPORT DelegatedFrameReplayer {
+public:
+    // Durations in nanoseconds, GL commands are finished before each measurement ends.
+    // The node is preprocessed once per frame, within |preprocess| only.
+    struct FrameTimings {
+        FrameTimings() : commit(0), preprocess(0), render(0) { }
+        qint64 commit;
+        qint64 preprocess;
+        qint64 render;
+    };
+
+    DelegatedFrameReplayer();
+    ~DelegatedFrameReplayer();
+
+    bool load(const QString &fileName);
+    int frameCount() const;
+    QSize frameSize() const;
+
+    // Frames reference resources added by previous frames and have to be replayed in order.
+    // The replay starts over with new scene graph nodes after the last frame.
+    FrameTimings replayNextFrame();
+    void reset();
+
+private:
+    QScopedPointer<DelegatedFrameReplayerPrivate> d;
+};
+
+#endif // DELEGATED_FRAME_REPLAYER_H
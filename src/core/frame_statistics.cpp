@@ -0,0 +1,208 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "frame_statistics.h"
+
+#include <QVariantList>
+#include <QVector>
+#include <algorithm>
+
+// Upper bounds of the histogram buckets in milliseconds, the last bucket is unbounded.
+static const double histogramBucketBounds[] = { 1, 2, 4, 8, 16.7, 33.3, 50, 100, 250 };
+static const int histogramBucketCount = sizeof(histogramBucketBounds) / sizeof(histogramBucketBounds[0]) + 1;
+
+static const char *metricNames[FrameStatistics::MetricCount] = {
+    "commitToSwap",
+    "mailboxWait",
+    "inputLatency"
+};
+
+static inline double toMilliseconds(qint64 microseconds)
+{
+    return microseconds / double(base::Time::kMicrosecondsPerMillisecond);
+}
+
+static inline double percentile(const QVector<qint64> &sorted, int percent)
+{
+    int index = qMin(sorted.size() - 1, sorted.size() * percent / 100);
+    return toMilliseconds(sorted.at(index));
+}
+
+FrameStatistics::FrameStatistics()
+    : m_swapPending(false)
+    , m_framesCommitted(0)
+    , m_framesSwapped(0)
+    , m_framesDropped(0)
+    , m_outputPixels(0)
+    , m_pixelsBeforeCulling(0)
+    , m_pixelsAfterCulling(0)
+    , m_nodesReused(0)
+    , m_nodesCreated(0)
+    , m_nodesDeleted(0)
+{
+}
+
+void FrameStatistics::addSample(Metric metric, base::TimeDelta value)
+{
+    Q_ASSERT(metric < MetricCount);
+    QMutexLocker lock(&m_mutex);
+    SampleRing &ring = m_rings[metric];
+    ring.samples[ring.next] = value.InMicroseconds();
+    ring.next = (ring.next + 1) % kMaxSamples;
+    ring.count = qMin(ring.count + 1, kMaxSamples);
+}
+
+void FrameStatistics::frameCommitted(base::TimeTicks inputEventTime)
+{
+    base::TimeTicks now = base::TimeTicks::Now();
+    QMutexLocker lock(&m_mutex);
+    ++m_framesCommitted;
+    // The previous frame got replaced in the scene graph before it could reach the screen.
+    if (m_swapPending) {
+        ++m_framesDropped;
+        // Its input events are still handled by this frame, keep the oldest timestamp.
+        if (inputEventTime.is_null() || (!m_inputEventTime.is_null() && m_inputEventTime < inputEventTime))
+            inputEventTime = m_inputEventTime;
+    }
+    m_swapPending = true;
+    m_commitTime = now;
+    m_inputEventTime = inputEventTime;
+}
+
+void FrameStatistics::frameSwapped()
+{
+    base::TimeTicks now = base::TimeTicks::Now();
+    base::TimeTicks commitTime;
+    base::TimeTicks inputEventTime;
+    {
+        QMutexLocker lock(&m_mutex);
+        // The scene is also swapped when something else than our frame changed.
+        if (!m_swapPending)
+            return;
+        ++m_framesSwapped;
+        m_swapPending = false;
+        commitTime = m_commitTime;
+        inputEventTime = m_inputEventTime;
+    }
+
+    addSample(CommitToSwap, now - commitTime);
+    if (!inputEventTime.is_null())
+        addSample(InputLatency, now - inputEventTime);
+}
+
+void FrameStatistics::addOverdrawSample(qint64 outputPixels, qint64 pixelsBeforeCulling, qint64 pixelsAfterCulling)
+{
+    QMutexLocker lock(&m_mutex);
+    m_outputPixels += outputPixels;
+    m_pixelsBeforeCulling += pixelsBeforeCulling;
+    m_pixelsAfterCulling += pixelsAfterCulling;
+}
+
+void FrameStatistics::addSceneGraphNodesSample(int reused, int created, int deleted)
+{
+    QMutexLocker lock(&m_mutex);
+    m_nodesReused += reused;
+    m_nodesCreated += created;
+    m_nodesDeleted += deleted;
+}
+
+QVariantMap FrameStatistics::toVariantMap() const
+{
+    QVariantMap result;
+    QVariantList bucketBounds;
+    for (int i = 0; i < histogramBucketCount - 1; ++i)
+        bucketBounds.append(histogramBucketBounds[i]);
+    result.insert(QStringLiteral("histogramBucketBounds"), bucketBounds);
+
+    QMutexLocker lock(&m_mutex);
+    result.insert(QStringLiteral("framesCommitted"), m_framesCommitted);
+    result.insert(QStringLiteral("framesSwapped"), m_framesSwapped);
+    result.insert(QStringLiteral("framesDropped"), m_framesDropped);
+
+    // Average number of times each pixel is drawn, over all committed frames.
+    if (m_outputPixels) {
+        QVariantMap overdrawMap;
+        overdrawMap.insert(QStringLiteral("beforeCulling"), double(m_pixelsBeforeCulling) / m_outputPixels);
+        overdrawMap.insert(QStringLiteral("afterCulling"), double(m_pixelsAfterCulling) / m_outputPixels);
+        result.insert(QStringLiteral("overdraw"), overdrawMap);
+    }
+
+    // Totals over all committed frames.
+    QVariantMap nodesMap;
+    nodesMap.insert(QStringLiteral("reused"), m_nodesReused);
+    nodesMap.insert(QStringLiteral("created"), m_nodesCreated);
+    nodesMap.insert(QStringLiteral("deleted"), m_nodesDeleted);
+    result.insert(QStringLiteral("sceneGraphNodes"), nodesMap);
+
+    for (int metric = 0; metric < MetricCount; ++metric) {
+        const SampleRing &ring = m_rings[metric];
+        QVector<qint64> sorted(ring.count);
+        std::copy(ring.samples, ring.samples + ring.count, sorted.begin());
+        std::sort(sorted.begin(), sorted.end());
+
+        QVariantMap metricMap;
+        metricMap.insert(QStringLiteral("count"), ring.count);
+        if (!sorted.isEmpty()) {
+            qint64 total = 0;
+            QVector<int> histogram(histogramBucketCount, 0);
+            int bucket = 0;
+            Q_FOREACH (qint64 sample, sorted) {
+                total += sample;
+                while (bucket < histogramBucketCount - 1 && toMilliseconds(sample) >= histogramBucketBounds[bucket])
+                    ++bucket;
+                ++histogram[bucket];
+            }
+            QVariantList histogramList;
+            Q_FOREACH (int bucketCount, histogram)
+                histogramList.append(bucketCount);
+
+            metricMap.insert(QStringLiteral("average"), toMilliseconds(total) / sorted.size());
+            metricMap.insert(QStringLiteral("min"), toMilliseconds(sorted.first()));
+            metricMap.insert(QStringLiteral("max"), toMilliseconds(sorted.last()));
+            metricMap.insert(QStringLiteral("p50"), percentile(sorted, 50));
+            metricMap.insert(QStringLiteral("p90"), percentile(sorted, 90));
+            metricMap.insert(QStringLiteral("p99"), percentile(sorted, 99));
+            metricMap.insert(QStringLiteral("histogram"), histogramList);
+        }
+        result.insert(QLatin1String(metricNames[metric]), metricMap);
+    }
+    return result;
+}
@@ -0,0 +1,101 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef FRAME_STATISTICS_H
+#define FRAME_STATISTICS_H
+
+#include "base/time/time.h"
+#include <QMutex>
+#include <QVariantMap>
+
+// Collects the timing of the frames presented by a RenderWidgetHostViewQt.
+// Samples are kept in fixed size rings so that recording stays a constant time
+// operation and can be left enabled, the statistics are only computed on request.
+// Recording can happen from the UI, Qt render and Chromium GPU threads.
+class FrameStatistics {
+public:
+    enum Metric {
+        CommitToSwap, // From the commit of a frame to the scene graph until its swap.
+        MailboxWait,  // From the request of a frame's mailbox textures until they can be used.
+        InputLatency, // From the input event reaching the RenderWidgetHost until the swap of its frame.
+        MetricCount
+    };
+
+    FrameStatistics();
+
+    void addSample(Metric, base::TimeDelta);
+    // |inputEventTime| is null if no input event contributed to this frame.
+    void frameCommitted(base::TimeTicks inputEventTime);
+    void frameSwapped();
+    // Pixels covered by the quads of a committed frame, before and after occlusion culling.
+    void addOverdrawSample(qint64 outputPixels, qint64 pixelsBeforeCulling, qint64 pixelsAfterCulling);
+    // Scene graph nodes reused from the previous frame, created and deleted by the commit of a frame.
+    void addSceneGraphNodesSample(int reused, int created, int deleted);
+
+    QVariantMap toVariantMap() const;
+
+private:
+    static const int kMaxSamples = 128;
+
+    struct SampleRing {
+        SampleRing() : count(0), next(0) { }
+        qint64 samples[kMaxSamples];
+        int count;
+        int next;
+    };
+
+    mutable QMutex m_mutex;
+    SampleRing m_rings[MetricCount];
+    base::TimeTicks m_commitTime;
+    base::TimeTicks m_inputEventTime;
+    bool m_swapPending;
+    quint64 m_framesCommitted;
+    quint64 m_framesSwapped;
+    quint64 m_framesDropped;
+    qint64 m_outputPixels;
+    qint64 m_pixelsBeforeCulling;
+    qint64 m_pixelsAfterCulling;
+    quint64 m_nodesReused;
+    quint64 m_nodesCreated;
+    quint64 m_nodesDeleted;
+};
+
+#endif // FRAME_STATISTICS_H
@@ -0,0 +1,118 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "host_cache_persister_qt.h"
+
+#include "base/bind.h"
+#include "base/bind_helpers.h"
+#include "base/file_util.h"
+#include "base/files/important_file_writer.h"
+#include "base/pickle.h"
+#include "base/sequenced_task_runner.h"
+#include "base/task_runner_util.h"
+#include "base/threading/thread_restrictions.h"
+#include "base/time/time.h"
+
+// Batches the changes of a burst of resolutions into one write.
+static const int kWriteDelaySeconds = 10;
+
+HostCachePersisterQt::HostCachePersisterQt(net::HostCache *cache, const base::FilePath &path, base::SequencedTaskRunner *fileTaskRunner)
+    : m_cache(cache)
+    , m_loaded(false)
+    , m_writeRequested(false)
+    , m_path(path)
+    , m_fileTaskRunner(fileTaskRunner)
+    , m_weakFactory(this)
+{
+    m_cache->set_persistence_delegate(this);
+
+    // The writes go through the same task runner, so none of them can happen before this read.
+    std::string *data = new std::string;
+    base::PostTaskAndReplyWithResult(fileTaskRunner, FROM_HERE,
+                                     base::Bind(&base::ReadFileToString, path, data),
+                                     base::Bind(&HostCachePersisterQt::loaded, m_weakFactory.GetWeakPtr(), base::Owned(data)));
+}
+
+HostCachePersisterQt::~HostCachePersisterQt()
+{
+    m_cache->set_persistence_delegate(0);
+    if (m_writeTimer.IsRunning()) {
+        m_writeTimer.Stop();
+        write();
+    }
+}
+
+void HostCachePersisterQt::ScheduleWrite()
+{
+    // Writing before the file was loaded would drop the entries it contains.
+    if (!m_loaded) {
+        m_writeRequested = true;
+        return;
+    }
+    if (!m_writeTimer.IsRunning())
+        m_writeTimer.Start(FROM_HERE, base::TimeDelta::FromSeconds(kWriteDelaySeconds), this, &HostCachePersisterQt::write);
+}
+
+void HostCachePersisterQt::write()
+{
+    Pickle pickle;
+    m_cache->Serialize(&pickle, base::TimeTicks::Now(), base::Time::Now());
+    std::string data(static_cast<const char *>(pickle.data()), pickle.size());
+
+    if (m_fileTaskRunner->PostTask(FROM_HERE, base::Bind(base::IgnoreResult(&base::ImportantFileWriter::WriteFileAtomically), m_path, data)))
+        return;
+    // The file thread is already gone when the persister is destroyed late in the shutdown, write on this thread instead.
+    base::ThreadRestrictions::ScopedAllowIO allowIO;
+    base::ImportantFileWriter::WriteFileAtomically(m_path, data);
+}
+
+void HostCachePersisterQt::loaded(const std::string *data, bool success)
+{
+    m_loaded = true;
+    // A missing or unreadable file leaves the cache as it is, it gets replaced by the next write.
+    if (success) {
+        Pickle pickle(data->data(), static_cast<int>(data->size()));
+        if (!m_cache->Deserialize(pickle, base::TimeTicks::Now(), base::Time::Now()))
+            m_writeRequested = true;
+    }
+    if (m_writeRequested)
+        ScheduleWrite();
+}
@@ -0,0 +1,85 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef HOST_CACHE_PERSISTER_QT_H
+#define HOST_CACHE_PERSISTER_QT_H
+
+#include "base/files/file_path.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/weak_ptr.h"
+#include "base/timer/timer.h"
+#include "net/dns/host_cache.h"
+
+#include <QtGlobal>
+
+#include <string>
+
+namespace base {
+class SequencedTaskRunner;
+}
+
+// Keeps a copy of a HostCache in a file of the profile directory, so that a new
+// process starts with the addresses resolved by the previous one instead of an empty cache.
+// Lives on the IO thread, the file itself is read and written on |fileTaskRunner|.
+class HostCachePersisterQt : public net::HostCache::PersistenceDelegate {
+public:
+    HostCachePersisterQt(net::HostCache *cache, const base::FilePath &path, base::SequencedTaskRunner *fileTaskRunner);
+    // Writes pending changes out, must be destroyed before |cache|.
+    virtual ~HostCachePersisterQt();
+
+    virtual void ScheduleWrite() Q_DECL_OVERRIDE;
+
+private:
+    void loaded(const std::string *data, bool success);
+    void write();
+
+    net::HostCache *m_cache;
+    bool m_loaded;
+    bool m_writeRequested;
+    const base::FilePath m_path;
+    scoped_refptr<base::SequencedTaskRunner> m_fileTaskRunner;
+    base::OneShotTimer<HostCachePersisterQt> m_writeTimer;
+    base::WeakPtrFactory<HostCachePersisterQt> m_weakFactory;
+
+    DISALLOW_COPY_AND_ASSIGN(HostCachePersisterQt);
+};
+
+#endif // HOST_CACHE_PERSISTER_QT_H
@@ -42,12 +42,18 @@
 #define NETWORK_DELEGATE_QT_H
 
 #include "net/base/network_delegate.h"
+#include "net/url_request/url_request.h"
+
+#include "url_request_context_getter_qt.h"
 
 #include "qglobal.h"
 
 class NetworkDelegateQt : public net::NetworkDelegate {
 public:
-    NetworkDelegateQt() {}
+    // |requestContextGetter| owns the delegate and collects its HTTP cache statistics.
+    explicit NetworkDelegateQt(URLRequestContextGetterQt *requestContextGetter)
+        : m_requestContextGetter(requestContextGetter)
+    {}
     virtual ~NetworkDelegateQt() {}
 
 
@@ -70,8 +76,17 @@ public:
 
     virtual void OnBeforeRedirect(net::URLRequest* request, const GURL& new_location) Q_DECL_OVERRIDE { }
     virtual void OnResponseStarted(net::URLRequest* request) Q_DECL_OVERRIDE { }
-    virtual void OnRawBytesRead(const net::URLRequest& request, int bytes_read) Q_DECL_OVERRIDE { }
-    virtual void OnCompleted(net::URLRequest* request, bool started) Q_DECL_OVERRIDE { }
+    virtual void OnRawBytesRead(const net::URLRequest& request, int bytes_read) Q_DECL_OVERRIDE
+    {
+        if (request.url().SchemeIsHTTPOrHTTPS())
+            m_requestContextGetter->recordHttpCacheBytesRead(request.was_cached(), bytes_read);
+    }
+
+    virtual void OnCompleted(net::URLRequest* request, bool started) Q_DECL_OVERRIDE
+    {
+        if (started && request->status().is_success() && request->url().SchemeIsHTTPOrHTTPS())
+            m_requestContextGetter->recordHttpCacheLookup(request->was_cached());
+    }
     virtual void OnURLRequestDestroyed(net::URLRequest* request) Q_DECL_OVERRIDE { }
 
     virtual void OnPACScriptError(int line_number, const base::string16& error) Q_DECL_OVERRIDE { }
@@ -84,6 +99,9 @@ public:
     virtual bool OnCanThrottleRequest(const net::URLRequest& request) const Q_DECL_OVERRIDE { return false; }
     virtual int OnBeforeSocketStreamConnect(net::SocketStream* stream, const net::CompletionCallback& callback) Q_DECL_OVERRIDE { return net::OK; }
     virtual void OnRequestWaitStateChange(const net::URLRequest& request, RequestWaitState state) Q_DECL_OVERRIDE { }
+
+private:
+    URLRequestContextGetterQt *m_requestContextGetter;
 };
 
 #endif // NETWORK_DELEGATE_QT_H
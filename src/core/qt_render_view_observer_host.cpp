@@ -45,22 +45,36 @@
 #include "type_conversion.h"
 #include "web_contents_adapter_client.h"
 
+#include <QVariantMap>
+
 QtRenderViewObserverHost::QtRenderViewObserverHost(content::WebContents *webContents, WebContentsAdapterClient *adapterClient)
     : content::WebContentsObserver(webContents)
     , m_adapterClient(adapterClient)
 {
 }
 
-void QtRenderViewObserverHost::fetchDocumentMarkup(quint64 requestId)
+void QtRenderViewObserverHost::fetchDocumentMarkup(quint64 requestId, bool streamed)
 {
+    m_pendingRequests.insert(requestId, DocumentMarkupRequest);
+    if (streamed)
+        m_streamedRequests.insert(requestId);
     Send(new QtRenderViewObserver_FetchDocumentMarkup(routing_id(), requestId));
 }
 
-void QtRenderViewObserverHost::fetchDocumentInnerText(quint64 requestId)
+void QtRenderViewObserverHost::fetchDocumentInnerText(quint64 requestId, bool streamed)
 {
+    m_pendingRequests.insert(requestId, DocumentInnerTextRequest);
+    if (streamed)
+        m_streamedRequests.insert(requestId);
     Send(new QtRenderViewObserver_FetchDocumentInnerText(routing_id(), requestId));
 }
 
+void QtRenderViewObserverHost::fetchDocumentTextNodes(quint64 requestId)
+{
+    m_pendingRequests.insert(requestId, DocumentTextNodesRequest);
+    Send(new QtRenderViewObserver_FetchDocumentTextNodes(routing_id(), requestId));
+}
+
 bool QtRenderViewObserverHost::OnMessageReceived(const IPC::Message& message)
 {
     bool handled = true;
@@ -69,18 +83,120 @@ bool QtRenderViewObserverHost::OnMessageReceived(const IPC::Message& message)
                             onDidFetchDocumentMarkup)
         IPC_MESSAGE_HANDLER(QtRenderViewObserverHost_DidFetchDocumentInnerText,
                             onDidFetchDocumentInnerText)
+        IPC_MESSAGE_HANDLER(QtRenderViewObserverHost_DidFetchDocumentTextNodes,
+                            onDidFetchDocumentTextNodes)
         IPC_MESSAGE_UNHANDLED(handled = false)
     IPC_END_MESSAGE_MAP()
     return handled;
 
 }
 
-void QtRenderViewObserverHost::onDidFetchDocumentMarkup(quint64 requestId, const base::string16& markup)
+void QtRenderViewObserverHost::RenderProcessGone(base::TerminationStatus)
+{
+    failPendingRequests();
+}
+
+void QtRenderViewObserverHost::RenderViewHostChanged(content::RenderViewHost *oldHost, content::RenderViewHost *)
+{
+    // The new renderer doesn't know about the requests sent to the old one.
+    if (oldHost)
+        failPendingRequests();
+}
+
+// Hands an empty result to every request the renderer will no longer answer.
+void QtRenderViewObserverHost::failPendingRequests()
+{
+    const QHash<quint64, RequestType> requests = m_pendingRequests;
+    const QSet<quint64> streamedRequests = m_streamedRequests;
+    m_pendingRequests.clear();
+    m_streamedRequests.clear();
+    m_pendingDocuments.clear();
+    m_pendingTextNodes.clear();
+
+    QHash<quint64, RequestType>::const_iterator it = requests.constBegin();
+    for (; it != requests.constEnd(); ++it) {
+        if (streamedRequests.contains(it.key())) {
+            m_adapterClient->didFetchDocumentChunk(it.key(), QString(), true);
+            continue;
+        }
+        switch (it.value()) {
+        case DocumentMarkupRequest:
+            m_adapterClient->didFetchDocumentMarkup(it.key(), QString());
+            break;
+        case DocumentInnerTextRequest:
+            m_adapterClient->didFetchDocumentInnerText(it.key(), QString());
+            break;
+        case DocumentTextNodesRequest:
+            m_adapterClient->didFetchDocumentTextNodes(it.key(), QVariant());
+            break;
+        }
+    }
+}
+
+// Returns true once the whole document of a non-streamed request is in |document|.
+bool QtRenderViewObserverHost::appendDocumentChunk(quint64 requestId, const base::string16& chunk, bool done, QString *document)
+{
+    // Ignore late chunks of requests that were already failed.
+    if (!m_pendingRequests.contains(requestId))
+        return false;
+
+    if (m_streamedRequests.contains(requestId)) {
+        if (done) {
+            m_streamedRequests.remove(requestId);
+            m_pendingRequests.remove(requestId);
+        }
+        m_adapterClient->didFetchDocumentChunk(requestId, toQt(chunk), done);
+        return false;
+    }
+
+    if (!done) {
+        m_pendingDocuments[requestId].append(toQt(chunk));
+        return false;
+    }
+    m_pendingRequests.remove(requestId);
+    *document = m_pendingDocuments.take(requestId);
+    document->append(toQt(chunk));
+    return true;
+}
+
+void QtRenderViewObserverHost::onDidFetchDocumentMarkup(quint64 requestId, const base::string16& chunk, bool done)
+{
+    QString markup;
+    if (appendDocumentChunk(requestId, chunk, done, &markup))
+        m_adapterClient->didFetchDocumentMarkup(requestId, markup);
+}
+
+void QtRenderViewObserverHost::onDidFetchDocumentInnerText(quint64 requestId, const base::string16& chunk, bool done)
 {
-    m_adapterClient->didFetchDocumentMarkup(requestId, toQt(markup));
+    QString innerText;
+    if (appendDocumentChunk(requestId, chunk, done, &innerText))
+        m_adapterClient->didFetchDocumentInnerText(requestId, innerText);
 }
 
-void QtRenderViewObserverHost::onDidFetchDocumentInnerText(quint64 requestId, const base::string16& innerText)
+void QtRenderViewObserverHost::onDidFetchDocumentTextNodes(quint64 requestId, const base::string16& chunk, const std::vector<int>& offsets,
+                                                           const std::vector<std::string>& paths, bool restarted, bool done)
 {
-    m_adapterClient->didFetchDocumentInnerText(requestId, toQt(innerText));
+    if (!m_pendingRequests.contains(requestId))
+        return;
+
+    TextNodes &nodes = m_pendingTextNodes[requestId];
+    if (restarted)
+        nodes = TextNodes();
+    // Offsets are relative to the chunk, make them relative to the whole text.
+    const int base = nodes.text.length();
+    for (size_t i = 0; i < offsets.size() && i < paths.size(); ++i) {
+        nodes.offsets.append(base + offsets[i]);
+        nodes.paths.append(QString::fromStdString(paths[i]));
+    }
+    nodes.text.append(toQt(chunk));
+    if (!done)
+        return;
+
+    QVariantMap result;
+    result.insert(QStringLiteral("text"), nodes.text);
+    result.insert(QStringLiteral("offsets"), nodes.offsets);
+    result.insert(QStringLiteral("paths"), nodes.paths);
+    m_pendingTextNodes.remove(requestId);
+    m_pendingRequests.remove(requestId);
+    m_adapterClient->didFetchDocumentTextNodes(requestId, QVariant(result));
 }
@@ -44,9 +44,17 @@
 
 #include "content/public/browser/web_contents_observer.h"
 
-#include <QtGlobal>
+#include <QHash>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QVariantList>
+
+#include <string>
+#include <vector>
 
 namespace content {
+    class RenderViewHost;
     class WebContents;
 }
 class WebContentsAdapterClient;
@@ -55,15 +63,39 @@ class QtRenderViewObserverHost : public content::WebContentsObserver
 {
 public:
     QtRenderViewObserverHost(content::WebContents*, WebContentsAdapterClient *adapterClient);
-    void fetchDocumentMarkup(quint64 requestId);
-    void fetchDocumentInnerText(quint64 requestId);
+    // Streamed requests hand each chunk to the client as it arrives instead of the whole document at the end.
+    void fetchDocumentMarkup(quint64 requestId, bool streamed);
+    void fetchDocumentInnerText(quint64 requestId, bool streamed);
+    void fetchDocumentTextNodes(quint64 requestId);
 
 private:
+    enum RequestType {
+        DocumentMarkupRequest,
+        DocumentInnerTextRequest,
+        DocumentTextNodesRequest
+    };
+
+    struct TextNodes {
+        QString text;
+        QVariantList offsets;
+        QStringList paths;
+    };
+
     bool OnMessageReceived(const IPC::Message& message) Q_DECL_OVERRIDE;
-    void onDidFetchDocumentMarkup(quint64 requestId, const base::string16& markup);
-    void onDidFetchDocumentInnerText(quint64 requestId, const base::string16& innerText);
+    void RenderProcessGone(base::TerminationStatus) Q_DECL_OVERRIDE;
+    void RenderViewHostChanged(content::RenderViewHost *oldHost, content::RenderViewHost *newHost) Q_DECL_OVERRIDE;
+    void failPendingRequests();
+    void onDidFetchDocumentMarkup(quint64 requestId, const base::string16& chunk, bool done);
+    void onDidFetchDocumentInnerText(quint64 requestId, const base::string16& chunk, bool done);
+    void onDidFetchDocumentTextNodes(quint64 requestId, const base::string16& chunk, const std::vector<int>& offsets,
+                                     const std::vector<std::string>& paths, bool restarted, bool done);
+    bool appendDocumentChunk(quint64 requestId, const base::string16& chunk, bool done, QString *document);
 
     WebContentsAdapterClient *m_adapterClient;
+    QHash<quint64, RequestType> m_pendingRequests;
+    QSet<quint64> m_streamedRequests;
+    QHash<quint64, QString> m_pendingDocuments;
+    QHash<quint64, TextNodes> m_pendingTextNodes;
 };
 
 #endif // QT_RENDER_VIEW_OBSERVER_HOST_H
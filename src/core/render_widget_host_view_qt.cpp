@@ -43,34 +43,42 @@
 
 #include "chromium_overrides.h"
 #include "delegated_frame_node.h"
+#include "delegated_frame_recorder.h"
 #include "render_widget_host_view_qt_delegate.h"
+#include "render_widget_host_view_qt_delegate_headless.h"
 #include "type_conversion.h"
 #include "web_contents_adapter_client.h"
 #include "web_event_factory.h"
 
 #include "base/command_line.h"
 #include "cc/output/compositor_frame_ack.h"
+#include "cc/output/software_frame_data.h"
 #include "content/browser/renderer_host/render_view_host_impl.h"
 #include "content/browser/renderer_host/ui_events_helper.h"
+#include "content/public/browser/browser_thread.h"
 #include "content/public/common/content_switches.h"
 #include "content/common/gpu/gpu_messages.h"
 #include "content/common/view_messages.h"
+#include "third_party/skia/include/core/SkBitmap.h"
 #include "third_party/skia/include/core/SkColor.h"
 #include "third_party/WebKit/public/platform/WebColor.h"
 #include "third_party/WebKit/public/platform/WebCursorInfo.h"
 #include "third_party/WebKit/public/web/WebCompositionUnderline.h"
 #include "ui/base/clipboard/scoped_clipboard_writer.h"
 #include "ui/events/event.h"
+#include "ui/events/latency_info.h"
 #include "ui/gfx/size_conversions.h"
 #include "webkit/common/cursors/webcursor.h"
 
 #include <QEvent>
 #include <QFocusEvent>
 #include <QGuiApplication>
+#include <QImage>
 #include <QInputMethodEvent>
 #include <QTextFormat>
 #include <QKeyEvent>
 #include <QMouseEvent>
+#include <QPainter>
 #include <QScreen>
 #include <QStyleHints>
 #include <QVariant>
@@ -144,6 +152,25 @@ static void UpdateWebTouchEventAfterDispatch(blink::WebTouchEvent* event, blink:
     }
 }
 
+static QImage scaleGrabbedImage(const QImage &image, const QSize &size, qreal scale)
+{
+    const QSize targetSize = (QSizeF(size) * scale).toSize();
+    if (image.isNull() || image.size() == targetSize)
+        return image;
+    return image.scaled(targetSize, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+}
+
+static void grabbedSnapshot(const QSize &size, qreal scale, const base::Callback<void(const QImage &)> &callback, bool success, const SkBitmap &bitmap)
+{
+    QImage image;
+    if (success) {
+        SkAutoLockPixels lock(bitmap);
+        image = QImage(static_cast<const uchar *>(bitmap.getPixels()), bitmap.width(), bitmap.height(),
+                       bitmap.rowBytes(), QImage::Format_ARGB32_Premultiplied).copy();
+    }
+    callback.Run(scaleGrabbedImage(image, size, scale));
+}
+
 static bool shouldSendPinchGesture()
 {
     static bool pinchAllowed = CommandLine::ForCurrentProcess()->HasSwitch(switches::kEnablePinch);
@@ -155,18 +182,33 @@ RenderWidgetHostViewQt::RenderWidgetHostViewQt(content::RenderWidgetHost* widget
     , m_gestureRecognizer(ui::GestureRecognizer::Create())
     , m_frameNodeData(new DelegatedFrameNodeData)
     , m_needsDelegatedFrameAck(false)
+    , m_softwareCompositing(false)
+    , m_headless(false)
+    , m_needsSoftwareFrameAck(false)
+    , m_hasReleasedSoftwareFrame(false)
+    , m_releasedSoftwareFrameOutputSurfaceId(0)
+    , m_releasedSoftwareFrameId(0)
+    , m_frameStatistics(new FrameStatistics)
+    , m_frameRecorder(DelegatedFrameRecorder::createFromEnvironment())
+    , m_inputFlushScheduled(false)
     , m_adapterClient(0)
     , m_anchorPositionWithinSelection(0)
     , m_cursorPositionWithinSelection(0)
     , m_initPending(false)
 {
+    for (size_t i = 0; i < arraysize(m_touchIdMapping); ++i)
+        m_touchIdMapping[i] = -1;
     m_host->SetView(this);
     m_gestureRecognizer->AddGestureEventHelper(this);
+    m_softwareFrameManager.reset(new content::SoftwareFrameManager(AsWeakPtr()));
+    m_uiThreadWeakPtr = AsWeakPtr();
 }
 
 RenderWidgetHostViewQt::~RenderWidgetHostViewQt()
 {
     m_gestureRecognizer->RemoveGestureEventHelper(this);
+    // Return the frame while we can still be called back.
+    m_softwareFrameManager->DiscardCurrentFrame();
 }
 
 void RenderWidgetHostViewQt::setDelegate(RenderWidgetHostViewQtDelegate* delegate)
@@ -232,6 +274,8 @@ void RenderWidgetHostViewQt::SetBounds(const gfx::Rect& rect)
 
 gfx::Size RenderWidgetHostViewQt::GetPhysicalBackingSize() const
 {
+    if (m_headless)
+        return gfx::ToCeiledSize(toGfx(m_delegate->screenRect().size()));
     if (!m_delegate || !m_delegate->window() || !m_delegate->window()->screen())
         return gfx::Size();
 
@@ -329,11 +373,13 @@ void RenderWidgetHostViewQt::UnlockMouse()
 void RenderWidgetHostViewQt::WasShown()
 {
     m_host->WasShown();
+    m_softwareFrameManager->SetVisibility(true);
 }
 
 void RenderWidgetHostViewQt::WasHidden()
 {
     m_host->WasHidden();
+    m_softwareFrameManager->SetVisibility(false);
 }
 
 void RenderWidgetHostViewQt::MovePluginWindows(const gfx::Vector2d&, const std::vector<content::WebPluginGeometry>&)
@@ -466,11 +512,13 @@ void RenderWidgetHostViewQt::ImeCompositionRangeChanged(const gfx::Range&, const
     QT_NOT_YET_IMPLEMENTED
 }
 
-void RenderWidgetHostViewQt::DidUpdateBackingStore(const gfx::Rect& scroll_rect, const gfx::Vector2d& scroll_delta, const std::vector<gfx::Rect>& copy_rects, const ui::LatencyInfo& /* latency_info */)
+void RenderWidgetHostViewQt::DidUpdateBackingStore(const gfx::Rect& scroll_rect, const gfx::Vector2d& scroll_delta, const std::vector<gfx::Rect>& copy_rects, const ui::LatencyInfo& latency_info)
 {
     if (!m_delegate->isVisible())
         return;
 
+    recordLatencyInfo(latency_info);
+
     Paint(scroll_rect);
 
     for (size_t i = 0; i < copy_rects.size(); ++i) {
@@ -579,13 +627,34 @@ bool RenderWidgetHostViewQt::HasAcceleratedSurface(const gfx::Size&)
 
 void RenderWidgetHostViewQt::OnSwapCompositorFrame(uint32 output_surface_id, scoped_ptr<cc::CompositorFrame> frame)
 {
+    if (frame->software_frame_data) {
+        recordLatencyInfo(frame->metadata.latency_info);
+        swapSoftwareFrame(output_surface_id, frame->software_frame_data.Pass(), frame->metadata.device_scale_factor);
+        return;
+    }
+    if (m_headless) {
+        // Only software frames can be kept offscreen, hand the resources of this one back right away.
+        cc::CompositorFrameAck ack;
+        if (frame->delegated_frame_data)
+            cc::TransferableResource::ReturnResources(frame->delegated_frame_data->resource_list, &ack.resources);
+        content::RenderWidgetHostImpl::SendSwapCompositorFrameAck(
+            m_host->GetRoutingID(), output_surface_id,
+            m_host->GetProcess()->GetID(), ack);
+        return;
+    }
+    setSoftwareCompositing(false);
+
     Q_ASSERT(!m_needsDelegatedFrameAck);
     m_needsDelegatedFrameAck = true;
     m_pendingOutputSurfaceId = output_surface_id;
     Q_ASSERT(frame->delegated_frame_data);
     Q_ASSERT(!m_frameNodeData->frameData || m_frameNodeData->frameData->resource_list.empty());
     m_frameNodeData->frameData = frame->delegated_frame_data.Pass();
+    // Serialize before the resource list gets consumed by DelegatedFrameNode::commit.
+    if (m_frameRecorder)
+        m_frameNodeData->serializedFrame = DelegatedFrameRecorder::serializeFrame(*m_frameNodeData->frameData);
     m_frameNodeData->frameDevicePixelRatio = frame->metadata.device_scale_factor;
+    recordLatencyInfo(frame->metadata.latency_info);
 
     // Support experimental.viewport.devicePixelRatio, see GetScreenInfo implementation below.
     float dpiScale = this->dpiScale();
@@ -598,8 +667,18 @@ void RenderWidgetHostViewQt::OnSwapCompositorFrame(uint32 output_surface_id, sco
 void RenderWidgetHostViewQt::GetScreenInfo(blink::WebScreenInfo* results)
 {
     QWindow* window = m_delegate->window();
-    if (!window)
+    if (!window) {
+        if (m_headless) {
+            // There is no screen to describe, make the whole viewport available.
+            const QSize viewportSize = m_delegate->screenRect().size().toSize();
+            results->rect = blink::WebRect(0, 0, viewportSize.width(), viewportSize.height());
+            results->availableRect = results->rect;
+            results->depth = 32;
+            results->depthPerComponent = 8;
+            results->deviceScaleFactor *= dpiScale();
+        }
         return;
+    }
     GetScreenInfoFromNativeWindow(window, results);
 
     // Support experimental.viewport.devicePixelRatio
@@ -659,6 +738,7 @@ void RenderWidgetHostViewQt::DispatchCancelTouchEvent(ui::TouchEvent *event)
 {
     if (!m_host)
         return;
+    flushCoalescedInput();
 
     blink::WebTouchEvent cancelEvent;
     cancelEvent.type = blink::WebInputEvent::TouchCancel;
@@ -669,15 +749,24 @@ void RenderWidgetHostViewQt::DispatchCancelTouchEvent(ui::TouchEvent *event)
 QSGNode *RenderWidgetHostViewQt::updatePaintNode(QSGNode *oldNode, QSGRenderContext *sgRenderContext)
 {
     DelegatedFrameNode *frameNode = static_cast<DelegatedFrameNode *>(oldNode);
-    if (!frameNode)
+    if (!frameNode) {
         frameNode = new DelegatedFrameNode(sgRenderContext);
+        frameNode->setTexturesFetchedCallback(base::Bind(&RenderWidgetHostViewQt::delegatedFrameTexturesFetched, AsWeakPtr()));
+        frameNode->setFrameStatistics(m_frameStatistics);
+        frameNode->setFrameRecorder(m_frameRecorder);
+    }
 
-    frameNode->commit(m_frameNodeData.data(), &m_resourcesToRelease);
+    // Hold the ack until the frame could be applied, this keeps Chromium from
+    // producing new frames while we are still fetching the textures of this one.
+    if (!frameNode->commit(m_frameNodeData.data(), &m_resourcesToRelease))
+        return frameNode;
 
     // This is possibly called from the Qt render thread, post the ack back to the UI
     // to tell the child compositors to release resources and trigger a new frame.
     if (m_needsDelegatedFrameAck) {
         m_needsDelegatedFrameAck = false;
+        m_frameStatistics->frameCommitted(m_pendingInputEventTime);
+        m_pendingInputEventTime = base::TimeTicks();
         content::BrowserThread::PostTask(content::BrowserThread::UI, FROM_HERE,
             base::Bind(&RenderWidgetHostViewQt::sendDelegatedFrameAck, AsWeakPtr()));
     }
@@ -685,6 +774,36 @@ QSGNode *RenderWidgetHostViewQt::updatePaintNode(QSGNode *oldNode, QSGRenderCont
     return frameNode;
 }
 
+void RenderWidgetHostViewQt::paint(QPainter *painter, const QRectF &boundingRect)
+{
+    if (m_softwareFrameManager->HasCurrentFrame()) {
+        const gfx::Size frameSize = m_softwareFrameManager->GetCurrentFrameSizeInPixels();
+        // Wrap the shared memory of the frame, the painter copies it directly to the backing store.
+        const QImage frame(static_cast<const uchar *>(m_softwareFrameManager->GetCurrentFramePixels()),
+                           frameSize.width(), frameSize.height(), QImage::Format_ARGB32_Premultiplied);
+
+        qreal frameDevicePixelRatio = m_softwareFrameManager->GetCurrentFrameDeviceScaleFactor();
+        // Support experimental.viewport.devicePixelRatio, see GetScreenInfo implementation below.
+        float dpiScale = this->dpiScale();
+        if (dpiScale != 0 && dpiScale != 1)
+            frameDevicePixelRatio /= dpiScale;
+
+        const QRectF frameRect(QPointF(), QSizeF(frameSize.width(), frameSize.height()) / frameDevicePixelRatio);
+        if (!frameRect.contains(boundingRect))
+            painter->fillRect(boundingRect, Qt::white);
+        const QRectF targetRect = boundingRect & frameRect;
+        const QRectF sourceRect(targetRect.topLeft() * frameDevicePixelRatio, targetRect.size() * frameDevicePixelRatio);
+        painter->drawImage(targetRect, frame, sourceRect);
+    } else
+        painter->fillRect(boundingRect, Qt::white);
+
+    // Like the delegated frames, only let the renderer produce a new frame once this one reached the screen.
+    if (m_needsSoftwareFrameAck) {
+        m_needsSoftwareFrameAck = false;
+        sendSoftwareFrameAck(m_pendingOutputSurfaceId);
+    }
+}
+
 void RenderWidgetHostViewQt::notifyResize()
 {
     GetRenderWidgetHost()->WasResized();
@@ -692,6 +811,17 @@ void RenderWidgetHostViewQt::notifyResize()
 
 bool RenderWidgetHostViewQt::forwardEvent(QEvent *event)
 {
+    switch (event->type()) {
+    case QEvent::MouseMove:
+    case QEvent::Wheel:
+    case QEvent::TouchUpdate:
+    case QEvent::HoverMove:
+        // Might be merged into the pending events.
+        break;
+    default:
+        flushCoalescedInput();
+    }
+
     switch (event->type()) {
     case QEvent::MouseButtonPress:
         Focus(); // Fall through.
@@ -762,6 +892,28 @@ void RenderWidgetHostViewQt::windowChanged()
         m_host->NotifyScreenInfoChanged();
 }
 
+void RenderWidgetHostViewQt::notifyFrameSwapped()
+{
+    m_frameStatistics->frameSwapped();
+    // Deliver the input merged during this frame, this is possibly called from the Qt render thread.
+    // The weak pointer must not be created here, it is only dereferenced once back on the UI thread.
+    content::BrowserThread::PostTask(content::BrowserThread::UI, FROM_HERE,
+        base::Bind(&RenderWidgetHostViewQt::flushCoalescedInput, m_uiThreadWeakPtr));
+}
+
+void RenderWidgetHostViewQt::recordLatencyInfo(const ui::LatencyInfo &latencyInfo)
+{
+    // Input events get their begin component when the RenderWidgetHost receives them from forwardEvent.
+    // Keep the oldest one until the frame gets committed to our node, its swap is the end of the latency.
+    ui::LatencyInfo::LatencyMap::const_iterator it = latencyInfo.latency_components.begin();
+    for (; it != latencyInfo.latency_components.end(); ++it) {
+        if (it->first.first != ui::INPUT_EVENT_LATENCY_BEGIN_RWH_COMPONENT)
+            continue;
+        if (m_pendingInputEventTime.is_null() || it->second.event_time < m_pendingInputEventTime)
+            m_pendingInputEventTime = it->second.event_time;
+    }
+}
+
 void RenderWidgetHostViewQt::ProcessAckedTouchEvent(const content::TouchEventWithLatencyInfo &touch, content::InputEventAckState ack_result) {
     ScopedVector<ui::TouchEvent> events;
     if (!content::MakeUITouchEventsFromWebTouchEvents(touch, &events, content::LOCAL_COORDINATES))
@@ -775,6 +927,184 @@ void RenderWidgetHostViewQt::ProcessAckedTouchEvent(const content::TouchEventWit
     }
 }
 
+void RenderWidgetHostViewQt::delegatedFrameTexturesFetched()
+{
+    // The pending frame can now be committed.
+    m_delegate->update();
+}
+
+void RenderWidgetHostViewQt::SoftwareFrameWasFreed(uint32 output_surface_id, unsigned frame_id)
+{
+    releaseSoftwareFrame(output_surface_id, frame_id);
+}
+
+void RenderWidgetHostViewQt::ReleaseReferencesToSoftwareFrame()
+{
+    // The frame's pixels are only referenced while painting, nothing to release.
+}
+
+bool RenderWidgetHostViewQt::setSoftwareCompositing(bool enabled)
+{
+    if (enabled == m_softwareCompositing)
+        return true;
+    if (m_headless)
+        return false;
+    // The renderer decides how it composites, from the renderer preferences. Follow it by replacing
+    // the delegate with one able to display the kind of frames that it now produces.
+    if (IsPopup() || !m_adapterClient)
+        return false;
+    RenderWidgetHostViewQtDelegate *delegate = enabled
+        ? m_adapterClient->CreateRenderWidgetHostViewQtDelegateForSoftwareCompositing(this)
+        : m_adapterClient->CreateRenderWidgetHostViewQtDelegate(this);
+    if (!delegate)
+        return false;
+
+    m_delegate.reset(delegate);
+    m_softwareCompositing = enabled;
+    if (enabled) {
+        // Resources of the previous output surface don't need to be returned.
+        m_frameNodeData = new DelegatedFrameNodeData;
+        m_resourcesToRelease.clear();
+    } else {
+        m_softwareFrameManager->DiscardCurrentFrame();
+        sendReclaimSoftwareFrames();
+        m_needsSoftwareFrameAck = false;
+    }
+    InitAsChild(0);
+    return true;
+}
+
+void RenderWidgetHostViewQt::swapSoftwareFrame(uint32 output_surface_id, scoped_ptr<cc::SoftwareFrameData> frameData, float frameDeviceScaleFactor)
+{
+    if (!setSoftwareCompositing(true)
+            || !m_softwareFrameManager->SwapToNewFrame(output_surface_id, frameData.get(), frameDeviceScaleFactor, m_host->GetProcess()->GetHandle())) {
+        releaseSoftwareFrame(output_surface_id, frameData->id);
+        sendSoftwareFrameAck(output_surface_id);
+        return;
+    }
+    m_softwareFrameManager->SwapToNewFrameComplete(!m_host->is_hidden());
+
+    if (m_headless) {
+        // Nothing gets presented, the frame stays current until the next one replaces it.
+        m_frameStatistics->frameCommitted(m_pendingInputEventTime);
+        m_pendingInputEventTime = base::TimeTicks();
+        m_frameStatistics->frameSwapped();
+        sendSoftwareFrameAck(output_surface_id);
+        return;
+    }
+
+    if (!m_delegate->isVisible()) {
+        sendSoftwareFrameAck(output_surface_id);
+        return;
+    }
+
+    // A new output surface can start producing frames before the last one was painted.
+    if (m_needsSoftwareFrameAck)
+        sendSoftwareFrameAck(m_pendingOutputSurfaceId);
+    m_needsSoftwareFrameAck = true;
+    m_pendingOutputSurfaceId = output_surface_id;
+    m_frameStatistics->frameCommitted(m_pendingInputEventTime);
+    m_pendingInputEventTime = base::TimeTicks();
+
+    // Only repaint the damaged area, converted to the delegate's coordinates.
+    QRectF damageRect = toQt(frameData->damage_rect);
+    qreal frameDevicePixelRatio = frameDeviceScaleFactor;
+    float dpiScale = this->dpiScale();
+    if (dpiScale != 0 && dpiScale != 1)
+        frameDevicePixelRatio /= dpiScale;
+    damageRect = QRectF(damageRect.topLeft() / frameDevicePixelRatio, damageRect.size() / frameDevicePixelRatio);
+    m_delegate->updateRect(damageRect.toAlignedRect());
+}
+
+void RenderWidgetHostViewQt::setHeadless(const QSize &viewportSize)
+{
+    if (m_headless) {
+        m_delegate->resize(viewportSize.width(), viewportSize.height());
+        return;
+    }
+    m_headless = true;
+    m_delegate.reset(new RenderWidgetHostViewQtDelegateHeadless(this, viewportSize));
+    // The renderer was told to composite in software, drop whatever GL frame we still hold.
+    m_softwareCompositing = true;
+    m_frameNodeData = new DelegatedFrameNodeData;
+    m_resourcesToRelease.clear();
+    if (m_needsDelegatedFrameAck) {
+        m_needsDelegatedFrameAck = false;
+        sendDelegatedFrameAck();
+    }
+    if (m_needsSoftwareFrameAck) {
+        m_needsSoftwareFrameAck = false;
+        sendSoftwareFrameAck(m_pendingOutputSurfaceId);
+    }
+    m_initPending = false;
+    m_host->WasResized();
+}
+
+void RenderWidgetHostViewQt::grabToImage(const QRect &rect, qreal scale, const base::Callback<void(const QImage &)> &callback)
+{
+    const QRect viewRect(QPoint(), m_delegate->screenRect().size().toSize());
+    const QRect sourceRect = rect.isNull() ? viewRect : rect & viewRect;
+    if (sourceRect.isEmpty() || scale <= 0) {
+        content::BrowserThread::PostTask(content::BrowserThread::UI, FROM_HERE, base::Bind(callback, QImage()));
+        return;
+    }
+
+    if (!m_softwareFrameManager->HasCurrentFrame()) {
+        // GL frames only live in textures of the scene graph, let the renderer read back the region instead.
+        m_host->GetSnapshotFromRenderer(gfx::Rect(sourceRect.x(), sourceRect.y(), sourceRect.width(), sourceRect.height()),
+                                        base::Bind(&grabbedSnapshot, sourceRect.size(), scale, callback));
+        return;
+    }
+
+    const gfx::Size frameSize = m_softwareFrameManager->GetCurrentFrameSizeInPixels();
+    const QImage frame(static_cast<const uchar *>(m_softwareFrameManager->GetCurrentFramePixels()),
+                       frameSize.width(), frameSize.height(), QImage::Format_ARGB32_Premultiplied);
+    qreal frameDevicePixelRatio = m_softwareFrameManager->GetCurrentFrameDeviceScaleFactor();
+    float dpiScale = this->dpiScale();
+    if (dpiScale != 0 && dpiScale != 1)
+        frameDevicePixelRatio /= dpiScale;
+
+    // Only copy the requested region out of the shared memory, the frame itself can be replaced at any time.
+    const QRect pixelRect = QRectF(QPointF(sourceRect.topLeft()) * frameDevicePixelRatio,
+                                   QSizeF(sourceRect.size()) * frameDevicePixelRatio).toAlignedRect() & frame.rect();
+    const QImage image = scaleGrabbedImage(frame.copy(pixelRect), sourceRect.size(), scale);
+    content::BrowserThread::PostTask(content::BrowserThread::UI, FROM_HERE, base::Bind(callback, image));
+}
+
+void RenderWidgetHostViewQt::releaseSoftwareFrame(uint32 output_surface_id, unsigned frame_id)
+{
+    // Only one frame can be returned per ack, reclaim the previous one separately if needed.
+    sendReclaimSoftwareFrames();
+    m_hasReleasedSoftwareFrame = true;
+    m_releasedSoftwareFrameOutputSurfaceId = output_surface_id;
+    m_releasedSoftwareFrameId = frame_id;
+}
+
+void RenderWidgetHostViewQt::sendSoftwareFrameAck(uint32 output_surface_id)
+{
+    cc::CompositorFrameAck ack;
+    if (m_hasReleasedSoftwareFrame && m_releasedSoftwareFrameOutputSurfaceId == output_surface_id) {
+        ack.last_software_frame_id = m_releasedSoftwareFrameId;
+        m_hasReleasedSoftwareFrame = false;
+    }
+    content::RenderWidgetHostImpl::SendSwapCompositorFrameAck(
+        m_host->GetRoutingID(), output_surface_id,
+        m_host->GetProcess()->GetID(), ack);
+    sendReclaimSoftwareFrames();
+}
+
+void RenderWidgetHostViewQt::sendReclaimSoftwareFrames()
+{
+    if (!m_hasReleasedSoftwareFrame)
+        return;
+    cc::CompositorFrameAck ack;
+    ack.last_software_frame_id = m_releasedSoftwareFrameId;
+    content::RenderWidgetHostImpl::SendReclaimCompositorResources(
+        m_host->GetRoutingID(), m_releasedSoftwareFrameOutputSurfaceId,
+        m_host->GetProcess()->GetID(), ack);
+    m_hasReleasedSoftwareFrame = false;
+}
+
 void RenderWidgetHostViewQt::sendDelegatedFrameAck()
 {
     cc::CompositorFrameAck ack;
@@ -827,32 +1157,142 @@ void RenderWidgetHostViewQt::ProcessGestures(ui::GestureRecognizer::Gestures *ge
     }
 }
 
-// Find (or create) a mapping to a 0-based ID.
+// Find (or create) a mapping to a 0-based ID, -1 if all of them are in use.
 int RenderWidgetHostViewQt::GetMappedTouch(int qtTouchId)
 {
-    QMap<int, int>::const_iterator it = m_touchIdMapping.find(qtTouchId);
-    if (it != m_touchIdMapping.end())
-        return it.value();
-    int nextValue = 0;
-    for (it = m_touchIdMapping.begin(); it != m_touchIdMapping.end(); ++it)
-        nextValue = std::max(nextValue, it.value() + 1);
-    m_touchIdMapping[qtTouchId] = nextValue;
-    return nextValue;
+    int freeId = -1;
+    for (size_t i = 0; i < arraysize(m_touchIdMapping); ++i) {
+        if (m_touchIdMapping[i] == qtTouchId)
+            return i;
+        if (freeId < 0 && m_touchIdMapping[i] < 0)
+            freeId = i;
+    }
+    if (freeId >= 0)
+        m_touchIdMapping[freeId] = qtTouchId;
+    return freeId;
 }
 
 void RenderWidgetHostViewQt::RemoveExpiredMappings(QTouchEvent *ev)
 {
-    QMap<int, int> newMap;
-    for (QMap<int, int>::const_iterator it = m_touchIdMapping.begin(); it != m_touchIdMapping.end(); ++it) {
+    for (size_t i = 0; i < arraysize(m_touchIdMapping); ++i) {
+        if (m_touchIdMapping[i] < 0)
+            continue;
+        bool active = false;
         Q_FOREACH (const QTouchEvent::TouchPoint& touchPoint, ev->touchPoints()) {
-            if ((touchPoint.id() == it.key()) &&
-                (touchPoint.state() != Qt::TouchPointReleased)) {
-                newMap.insert(it.key(), it.value());
+            if (touchPoint.id() == m_touchIdMapping[i]) {
+                active = touchPoint.state() != Qt::TouchPointReleased;
                 break;
             }
         }
+        if (!active)
+            m_touchIdMapping[i] = -1;
+    }
+}
+
+// Chromium expects the event timestamps to be comparable to base::TimeTicks::Now().
+// Most importantly we also have to preserve the relative time distance between events.
+// Calculate a delta between event timestamps and Now() on the first received event, and
+// apply this delta to all successive events. This delta is most likely smaller than it
+// should by calculating it here but this will hopefully cause less than one frame of delay.
+base::TimeDelta RenderWidgetHostViewQt::eventTimestamp(const QInputEvent *ev)
+{
+    base::TimeDelta eventTimestamp = base::TimeDelta::FromMilliseconds(ev->timestamp());
+    if (m_eventsToNowDelta == base::TimeDelta())
+        m_eventsToNowDelta = base::TimeTicks::Now() - base::TimeTicks() - eventTimestamp;
+    return eventTimestamp + m_eventsToNowDelta;
+}
+
+ui::LatencyInfo RenderWidgetHostViewQt::eventLatencyInfo(base::TimeDelta eventTimestamp)
+{
+    // Merging adds up the event counts and averages the times of those components,
+    // so each coalesced event still accounts for its own latency.
+    ui::LatencyInfo latency;
+    latency.AddLatencyNumberWithTimestamp(ui::INPUT_EVENT_LATENCY_ORIGINAL_COMPONENT, 0, 0,
+                                          base::TimeTicks() + eventTimestamp, 1, false);
+    latency.AddLatencyNumberWithTimestamp(ui::INPUT_EVENT_LATENCY_UI_COMPONENT, 0, 0,
+                                          base::TimeTicks::Now(), 1, false);
+    // The RenderWidgetHost adds its begin component, with its own input number, once the event gets forwarded.
+    return latency;
+}
+
+void RenderWidgetHostViewQt::forwardMouseEvent(const content::MouseEventWithLatencyInfo &event)
+{
+    if (m_pendingMouseEvent && m_pendingMouseEvent->CanCoalesceWith(event)) {
+        content::WebInputEventTraits::Coalesce(event.event, &m_pendingMouseEvent->event);
+        m_pendingMouseEvent->latency.MergeWith(event.latency);
+        return;
+    }
+
+    flushCoalescedInput();
+    if (event.event.type == blink::WebInputEvent::MouseMove) {
+        m_pendingMouseEvent.reset(new content::MouseEventWithLatencyInfo(event));
+        scheduleInputFlush();
+    } else
+        m_host->ForwardMouseEventWithLatencyInfo(event);
+}
+
+void RenderWidgetHostViewQt::forwardWheelEvent(const content::MouseWheelEventWithLatencyInfo &event)
+{
+    if (m_pendingWheelEvent && m_pendingWheelEvent->CanCoalesceWith(event)) {
+        content::WebInputEventTraits::Coalesce(event.event, &m_pendingWheelEvent->event);
+        m_pendingWheelEvent->latency.MergeWith(event.latency);
+        return;
+    }
+
+    flushCoalescedInput();
+    m_pendingWheelEvent.reset(new content::MouseWheelEventWithLatencyInfo(event));
+    scheduleInputFlush();
+}
+
+void RenderWidgetHostViewQt::forwardTouchEvent(const content::TouchEventWithLatencyInfo &event)
+{
+    if (m_pendingTouchEvent && m_pendingTouchEvent->CanCoalesceWith(event)) {
+        content::WebInputEventTraits::Coalesce(event.event, &m_pendingTouchEvent->event);
+        m_pendingTouchEvent->latency.MergeWith(event.latency);
+        return;
+    }
+
+    flushCoalescedInput();
+    if (event.event.type == blink::WebInputEvent::TouchMove) {
+        m_pendingTouchEvent.reset(new content::TouchEventWithLatencyInfo(event));
+        scheduleInputFlush();
+    } else
+        // This will come back through ProcessAckedTouchEvent if the page didn't want it.
+        m_host->ForwardTouchEventWithLatencyInfo(event.event, event.latency);
+}
+
+void RenderWidgetHostViewQt::scheduleInputFlush()
+{
+    if (m_inputFlushScheduled)
+        return;
+    m_inputFlushScheduled = true;
+
+    // notifyFrameSwapped normally flushes first, this only kicks in when nothing is being
+    // rendered. Wait for at most one refresh interval of the screen we are shown on.
+    qreal refreshRate = 60;
+    if (m_delegate && m_delegate->window() && m_delegate->window()->screen())
+        refreshRate = qMax(m_delegate->window()->screen()->refreshRate(), qreal(1));
+    content::BrowserThread::PostDelayedTask(content::BrowserThread::UI, FROM_HERE,
+        base::Bind(&RenderWidgetHostViewQt::flushCoalescedInput, AsWeakPtr()),
+        base::TimeDelta::FromMicroseconds(base::Time::kMicrosecondsPerSecond / refreshRate));
+}
+
+void RenderWidgetHostViewQt::flushCoalescedInput()
+{
+    m_inputFlushScheduled = false;
+    // At most one of them is pending since queuing any of them flushes the others.
+    if (m_pendingMouseEvent) {
+        scoped_ptr<content::MouseEventWithLatencyInfo> event(m_pendingMouseEvent.Pass());
+        m_host->ForwardMouseEventWithLatencyInfo(*event);
+    }
+    if (m_pendingWheelEvent) {
+        scoped_ptr<content::MouseWheelEventWithLatencyInfo> event(m_pendingWheelEvent.Pass());
+        m_host->ForwardWheelEventWithLatencyInfo(*event);
+    }
+    if (m_pendingTouchEvent) {
+        scoped_ptr<content::TouchEventWithLatencyInfo> event(m_pendingTouchEvent.Pass());
+        m_host->ForwardTouchEventWithLatencyInfo(event->event, event->latency);
     }
-    m_touchIdMapping.swap(newMap);
 }
 
 float RenderWidgetHostViewQt::dpiScale() const
@@ -880,7 +1320,7 @@ void RenderWidgetHostViewQt::handleMouseEvent(QMouseEvent* event)
         m_clickHelper.lastPressPosition = QPointF(event->pos()).toPoint();
     }
 
-    m_host->ForwardMouseEvent(webEvent);
+    forwardMouseEvent(content::MouseEventWithLatencyInfo(webEvent, eventLatencyInfo(eventTimestamp(event))));
 }
 
 void RenderWidgetHostViewQt::handleKeyEvent(QKeyEvent *ev)
@@ -954,20 +1394,12 @@ void RenderWidgetHostViewQt::handleInputMethodEvent(QInputMethodEvent *ev)
 
 void RenderWidgetHostViewQt::handleWheelEvent(QWheelEvent *ev)
 {
-    m_host->ForwardWheelEvent(WebEventFactory::toWebWheelEvent(ev, dpiScale()));
+    forwardWheelEvent(content::MouseWheelEventWithLatencyInfo(WebEventFactory::toWebWheelEvent(ev, dpiScale()), eventLatencyInfo(eventTimestamp(ev))));
 }
 
 void RenderWidgetHostViewQt::handleTouchEvent(QTouchEvent *ev)
 {
-    // Chromium expects the touch event timestamps to be comparable to base::TimeTicks::Now().
-    // Most importantly we also have to preserve the relative time distance between events.
-    // Calculate a delta between event timestamps and Now() on the first received event, and
-    // apply this delta to all successive events. This delta is most likely smaller than it
-    // should by calculating it here but this will hopefully cause less than one frame of delay.
-    base::TimeDelta eventTimestamp = base::TimeDelta::FromMilliseconds(ev->timestamp());
-    if (m_eventsToNowDelta == base::TimeDelta())
-        m_eventsToNowDelta = base::TimeTicks::Now() - base::TimeTicks() - eventTimestamp;
-    eventTimestamp += m_eventsToNowDelta;
+    base::TimeDelta eventTimestamp = this->eventTimestamp(ev);
 
     // Convert each of our QTouchEvent::TouchPoint to the simpler ui::TouchEvent to
     // be able to use the same code path for both gesture recognition and WebTouchEvents.
@@ -978,12 +1410,16 @@ void RenderWidgetHostViewQt::handleTouchEvent(QTouchEvent *ev)
         // Stationary touch points are already in our accumulator.
         if (touchPoint.state() == Qt::TouchPointStationary)
             continue;
+        // Chromium can't track more points than that, drop the extra ones.
+        int touchId = GetMappedTouch(touchPoint.id());
+        if (touchId < 0)
+            continue;
 
         ui::TouchEvent uiEvent(
             toUIEventType(touchPoint.state()),
             toGfxPoint((touchPoint.pos() / dpiScale()).toPoint()),
             0, // flags
-            GetMappedTouch(touchPoint.id()),
+            touchId,
             eventTimestamp,
             0, 0, // radius
             0, // angle
@@ -992,8 +1428,7 @@ void RenderWidgetHostViewQt::handleTouchEvent(QTouchEvent *ev)
         blink::WebTouchPoint *point = content::UpdateWebTouchEventFromUIEvent(uiEvent, &m_accumTouchEvent);
         if (point) {
             if (m_host->ShouldForwardTouchEvent())
-                // This will come back through ProcessAckedTouchEvent if the page didn't want it.
-                m_host->ForwardTouchEventWithLatencyInfo(m_accumTouchEvent, ui::LatencyInfo());
+                forwardTouchEvent(content::TouchEventWithLatencyInfo(m_accumTouchEvent, eventLatencyInfo(eventTimestamp)));
             else {
                 scoped_ptr<ui::GestureRecognizer::Gestures> gestures;
                 gestures.reset(m_gestureRecognizer->ProcessTouchEventForGesture(uiEvent, ui::ER_UNHANDLED, this));
@@ -1007,7 +1442,7 @@ void RenderWidgetHostViewQt::handleTouchEvent(QTouchEvent *ev)
 
 void RenderWidgetHostViewQt::handleHoverEvent(QHoverEvent *ev)
 {
-    m_host->ForwardMouseEvent(WebEventFactory::toWebMouseEvent(ev, dpiScale()));
+    forwardMouseEvent(content::MouseEventWithLatencyInfo(WebEventFactory::toWebMouseEvent(ev, dpiScale()), eventLatencyInfo(eventTimestamp(ev))));
 }
 
 void RenderWidgetHostViewQt::handleFocusEvent(QFocusEvent *ev)
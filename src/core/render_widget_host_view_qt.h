@@ -44,24 +44,31 @@
 
 #include "render_widget_host_view_qt_delegate.h"
 
+#include "base/callback.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/memory/weak_ptr.h"
 #include "cc/resources/transferable_resource.h"
 #include "content/browser/renderer_host/render_widget_host_view_base.h"
+#include "content/browser/renderer_host/software_frame_manager.h"
+#include "content/port/browser/event_with_latency_info.h"
 #include "delegated_frame_node.h"
+#include "frame_statistics.h"
 #include "ui/events/gestures/gesture_recognizer.h"
 #include "ui/events/gestures/gesture_types.h"
-#include <QMap>
 #include <QPoint>
 #include <QRect>
+#include <QSharedPointer>
 #include <QtGlobal>
 
 QT_BEGIN_NAMESPACE
 class QEvent;
 class QFocusEvent;
 class QHoverEvent;
+class QImage;
+class QInputEvent;
 class QKeyEvent;
 class QMouseEvent;
+class QPainter;
 class QTouchEvent;
 class QVariant;
 class QWheelEvent;
@@ -90,6 +97,7 @@ class RenderWidgetHostViewQt
     , public ui::GestureConsumer
     , public ui::GestureEventHelper
     , public RenderWidgetHostViewQtDelegateClient
+    , public content::SoftwareFrameManagerClient
     , public base::SupportsWeakPtr<RenderWidgetHostViewQt>
 {
 public:
@@ -165,10 +173,25 @@ public:
 
     // Overridden from RenderWidgetHostViewQtDelegateClient.
     virtual QSGNode *updatePaintNode(QSGNode *, QSGRenderContext *) Q_DECL_OVERRIDE;
+    virtual void paint(QPainter *, const QRectF &boundingRect) Q_DECL_OVERRIDE;
     virtual void notifyResize() Q_DECL_OVERRIDE;
     virtual bool forwardEvent(QEvent *) Q_DECL_OVERRIDE;
     virtual QVariant inputMethodQuery(Qt::InputMethodQuery query) const Q_DECL_OVERRIDE;
     virtual void windowChanged() Q_DECL_OVERRIDE;
+    virtual void notifyFrameSwapped() Q_DECL_OVERRIDE;
+
+    QSharedPointer<FrameStatistics> frameStatistics() const { return m_frameStatistics; }
+
+    // Renders without a window from now on, frames are only kept for grabToImage.
+    void setHeadless(const QSize &viewportSize);
+    bool isHeadless() const { return m_headless; }
+    // Reads back the given region of the view, in device independent pixels. The callback is always
+    // run asynchronously on the UI thread, with a null image if the region could not be read.
+    void grabToImage(const QRect &rect, qreal scale, const base::Callback<void(const QImage &)> &callback);
+
+    // Overridden from content::SoftwareFrameManagerClient.
+    virtual void SoftwareFrameWasFreed(uint32 output_surface_id, unsigned frame_id) Q_DECL_OVERRIDE;
+    virtual void ReleaseReferencesToSoftwareFrame() Q_DECL_OVERRIDE;
 
     void handleMouseEvent(QMouseEvent*);
     void handleKeyEvent(QKeyEvent*);
@@ -208,12 +231,28 @@ public:
 #endif // defined(OS_WIN)
 
 private:
+    void delegatedFrameTexturesFetched();
+    void recordLatencyInfo(const ui::LatencyInfo &);
     void sendDelegatedFrameAck();
+    bool setSoftwareCompositing(bool);
+    void swapSoftwareFrame(uint32 output_surface_id, scoped_ptr<cc::SoftwareFrameData>, float frameDeviceScaleFactor);
+    void releaseSoftwareFrame(uint32 output_surface_id, unsigned frame_id);
+    void sendSoftwareFrameAck(uint32 output_surface_id);
+    void sendReclaimSoftwareFrames();
     void Paint(const gfx::Rect& damage_rect);
     void ProcessGestures(ui::GestureRecognizer::Gestures *gestures);
     void ForwardGestureEventToRenderer(ui::GestureEvent* gesture);
     int GetMappedTouch(int qtTouchId);
     void RemoveExpiredMappings(QTouchEvent *ev);
+    base::TimeDelta eventTimestamp(const QInputEvent *);
+    ui::LatencyInfo eventLatencyInfo(base::TimeDelta eventTimestamp);
+    // Consecutive mouse moves, wheel deltas and touch moves are merged and sent once per
+    // frame by flushCoalescedInput, any other event flushes them first to keep the ordering.
+    void forwardMouseEvent(const content::MouseEventWithLatencyInfo &);
+    void forwardWheelEvent(const content::MouseWheelEventWithLatencyInfo &);
+    void forwardTouchEvent(const content::TouchEventWithLatencyInfo &);
+    void scheduleInputFlush();
+    void flushCoalescedInput();
     float dpiScale() const;
 
     bool IsPopup() const;
@@ -221,7 +260,8 @@ private:
     content::RenderWidgetHostImpl *m_host;
     scoped_ptr<ui::GestureRecognizer> m_gestureRecognizer;
     base::TimeDelta m_eventsToNowDelta;
-    QMap<int, int> m_touchIdMapping;
+    // Qt touch point id for each of the 0-based ids given to Chromium, -1 if unused.
+    int m_touchIdMapping[blink::WebTouchEvent::touchesLengthCap];
     blink::WebTouchEvent m_accumTouchEvent;
     scoped_ptr<RenderWidgetHostViewQtDelegate> m_delegate;
 
@@ -230,6 +270,25 @@ private:
     bool m_needsDelegatedFrameAck;
     uint32 m_pendingOutputSurfaceId;
 
+    bool m_softwareCompositing;
+    bool m_headless;
+    scoped_ptr<content::SoftwareFrameManager> m_softwareFrameManager;
+    bool m_needsSoftwareFrameAck;
+    bool m_hasReleasedSoftwareFrame;
+    uint32 m_releasedSoftwareFrameOutputSurfaceId;
+    unsigned m_releasedSoftwareFrameId;
+
+    QSharedPointer<FrameStatistics> m_frameStatistics;
+    QSharedPointer<DelegatedFrameRecorder> m_frameRecorder;
+    base::TimeTicks m_pendingInputEventTime;
+
+    scoped_ptr<content::MouseEventWithLatencyInfo> m_pendingMouseEvent;
+    scoped_ptr<content::MouseWheelEventWithLatencyInfo> m_pendingWheelEvent;
+    scoped_ptr<content::TouchEventWithLatencyInfo> m_pendingTouchEvent;
+    bool m_inputFlushScheduled;
+    // Bound to the UI thread on construction, notifyFrameSwapped only posts copies of it.
+    base::WeakPtr<RenderWidgetHostViewQt> m_uiThreadWeakPtr;
+
     WebContentsAdapterClient *m_adapterClient;
     MultipleMouseClickHelper m_clickHelper;
 
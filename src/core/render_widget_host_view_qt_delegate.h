@@ -64,10 +64,14 @@ class QWEBENGINE_EXPORT RenderWidgetHostViewQtDelegateClient {
 public:
     virtual ~RenderWidgetHostViewQtDelegateClient() { }
     virtual QSGNode *updatePaintNode(QSGNode *, QSGRenderContext *) = 0;
+    // Used instead of updatePaintNode by delegates created for software compositing.
+    virtual void paint(QPainter *, const QRectF &boundingRect) = 0;
     virtual void notifyResize() = 0;
     virtual bool forwardEvent(QEvent *) = 0;
     virtual QVariant inputMethodQuery(Qt::InputMethodQuery query) const = 0;
     virtual void windowChanged() = 0;
+    // Called, possibly from the Qt render thread, once the scene containing our node was presented.
+    virtual void notifyFrameSwapped() = 0;
 };
 
 class QWEBENGINE_EXPORT RenderWidgetHostViewQtDelegate {
@@ -83,6 +87,8 @@ public:
     virtual bool isVisible() const = 0;
     virtual QWindow* window() const = 0;
     virtual void update() = 0;
+    // Only software compositing delegates can make use of the damaged area.
+    virtual void updateRect(const QRect &) { update(); }
     virtual void updateCursor(const QCursor &) = 0;
     virtual void resize(int width, int height) = 0;
     virtual void move(const QPoint &) = 0;
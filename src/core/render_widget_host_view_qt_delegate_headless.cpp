@@ -0,0 +1,89 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "render_widget_host_view_qt_delegate_headless.h"
+
+RenderWidgetHostViewQtDelegateHeadless::RenderWidgetHostViewQtDelegateHeadless(RenderWidgetHostViewQtDelegateClient *client, const QSize &viewportSize)
+    : m_client(client)
+    , m_viewportSize(viewportSize)
+    , m_isVisible(true)
+    , m_hasKeyboardFocus(false)
+{
+}
+
+QRectF RenderWidgetHostViewQtDelegateHeadless::screenRect() const
+{
+    return QRectF(QPointF(), m_viewportSize);
+}
+
+void RenderWidgetHostViewQtDelegateHeadless::setKeyboardFocus()
+{
+    m_hasKeyboardFocus = true;
+}
+
+bool RenderWidgetHostViewQtDelegateHeadless::hasKeyboardFocus()
+{
+    return m_hasKeyboardFocus;
+}
+
+void RenderWidgetHostViewQtDelegateHeadless::show()
+{
+    m_isVisible = true;
+}
+
+void RenderWidgetHostViewQtDelegateHeadless::hide()
+{
+    m_isVisible = false;
+}
+
+bool RenderWidgetHostViewQtDelegateHeadless::isVisible() const
+{
+    return m_isVisible;
+}
+
+void RenderWidgetHostViewQtDelegateHeadless::resize(int width, int height)
+{
+    const QSize size(width, height);
+    if (size == m_viewportSize)
+        return;
+    m_viewportSize = size;
+    m_client->notifyResize();
+}
@@ -0,0 +1,80 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef RENDER_WIDGET_HOST_VIEW_QT_DELEGATE_HEADLESS_H
+#define RENDER_WIDGET_HOST_VIEW_QT_DELEGATE_HEADLESS_H
+
+#include "render_widget_host_view_qt_delegate.h"
+
+#include <QSize>
+
+// Stands in for a window when a page is rendered offscreen. It only provides the geometry
+// the renderer lays out against, software frames are kept by the RenderWidgetHostViewQt
+// until grabbed and nothing is ever presented.
+class RenderWidgetHostViewQtDelegateHeadless : public RenderWidgetHostViewQtDelegate
+{
+public:
+    RenderWidgetHostViewQtDelegateHeadless(RenderWidgetHostViewQtDelegateClient *client, const QSize &viewportSize);
+
+    virtual void initAsChild(WebContentsAdapterClient*) Q_DECL_OVERRIDE { }
+    virtual void initAsPopup(const QRect&) Q_DECL_OVERRIDE { }
+    virtual QRectF screenRect() const Q_DECL_OVERRIDE;
+    virtual void setKeyboardFocus() Q_DECL_OVERRIDE;
+    virtual bool hasKeyboardFocus() Q_DECL_OVERRIDE;
+    virtual void show() Q_DECL_OVERRIDE;
+    virtual void hide() Q_DECL_OVERRIDE;
+    virtual bool isVisible() const Q_DECL_OVERRIDE;
+    virtual QWindow* window() const Q_DECL_OVERRIDE { return 0; }
+    virtual void update() Q_DECL_OVERRIDE { }
+    virtual void updateCursor(const QCursor &) Q_DECL_OVERRIDE { }
+    virtual void resize(int width, int height) Q_DECL_OVERRIDE;
+    virtual void move(const QPoint &) Q_DECL_OVERRIDE { }
+    virtual void inputMethodStateChanged(bool) Q_DECL_OVERRIDE { }
+    virtual void setTooltip(const QString &) Q_DECL_OVERRIDE { }
+
+private:
+    RenderWidgetHostViewQtDelegateClient *m_client;
+    QSize m_viewportSize;
+    bool m_isVisible;
+    bool m_hasKeyboardFocus;
+};
+
+#endif // RENDER_WIDGET_HOST_VIEW_QT_DELEGATE_HEADLESS_H
@@ -43,6 +43,19 @@
 
 #include "renderer/qt_render_view_observer.h"
 
+#include "base/bind.h"
+#include "base/message_loop/message_loop.h"
+#include "content/public/renderer/render_thread.h"
+
+void ContentRendererClientQt::RenderThreadStarted()
+{
+    // Blink and V8 are otherwise initialized with the first RenderView. Do it as soon as the
+    // thread runs instead, spare processes launched ahead of time are then ready to navigate.
+    content::RenderThread *renderThread = content::RenderThread::Get();
+    base::MessageLoop::current()->PostTask(FROM_HERE,
+        base::Bind(&content::RenderThread::EnsureWebKitInitialized, base::Unretained(renderThread)));
+}
+
 void ContentRendererClientQt::RenderViewCreated(content::RenderView* render_view)
 {
     // RenderViewObserver destroys itself with its RenderView.
@@ -45,6 +45,7 @@
 
 class ContentRendererClientQt : public content::ContentRendererClient {
 public:
+    virtual void RenderThreadStarted() Q_DECL_OVERRIDE;
     virtual void RenderViewCreated(content::RenderView *render_view) Q_DECL_OVERRIDE;
 
     // Update this when we want to allow overriding error pages.
@@ -43,31 +43,208 @@
 
 #include "common/qt_messages.h"
 
+#include "base/bind.h"
+#include "base/message_loop/message_loop.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/third_party/icu/icu_utf.h"
 #include "content/public/renderer/render_view.h"
 #include "third_party/WebKit/public/web/WebDocument.h"
 #include "third_party/WebKit/public/web/WebElement.h"
 #include "third_party/WebKit/public/web/WebFrame.h"
 #include "third_party/WebKit/public/web/WebView.h"
 
+#include <algorithm>
+
+// Upper bound of the text carried by one IPC message, in UTF-16 code units.
+static const size_t kMaxChunkLength = 256 * 1024;
+// Bounds the time spent walking the DOM in one task.
+static const int kMaxTextNodesPerChunk = 4096;
+// After restarting this many times because of DOM changes, the rest of the walk is done in a single task.
+static const int kMaxTextNodesWalkRestarts = 3;
+
+static bool isTextExcluded(const blink::WebNode &node)
+{
+    if (!node.isElementNode())
+        return false;
+    const blink::WebElement element = node.toConst<blink::WebElement>();
+    return element.hasHTMLTagName("script") || element.hasHTMLTagName("style") || element.hasHTMLTagName("noscript");
+}
+
+static std::string pathToString(const std::vector<int> &path)
+{
+    std::string result;
+    for (size_t i = 0; i < path.size(); ++i) {
+        if (i)
+            result += '/';
+        result += base::IntToString(path[i]);
+    }
+    return result;
+}
+
+// Moves to the next node in document order, skipping the children of |node| if asked to.
+// Returns a null node once the whole tree below the document was visited.
+// The DOM can't change within a task, |ancestors| is only checked against it before resuming a walk.
+static blink::WebNode nextNode(const blink::WebNode &node, std::vector<int> *path, std::vector<blink::WebNode> *ancestors, bool skipChildren)
+{
+    if (!skipChildren) {
+        blink::WebNode child = node.firstChild();
+        if (!child.isNull()) {
+            path->push_back(0);
+            ancestors->push_back(node);
+            return child;
+        }
+    }
+    blink::WebNode current = node;
+    while (!path->empty()) {
+        blink::WebNode sibling = current.nextSibling();
+        if (!sibling.isNull()) {
+            ++path->back();
+            return sibling;
+        }
+        current = ancestors->back();
+        path->pop_back();
+        ancestors->pop_back();
+    }
+    return blink::WebNode();
+}
+
+// Scripts may have inserted, removed or moved nodes since the previous chunk, or the document may have been replaced.
+// The walk can only resume if its node is still at the same path below the same ancestors.
+static bool isWalkPositionValid(const blink::WebNode &document, const blink::WebNode &node, const std::vector<int> &path, const std::vector<blink::WebNode> &ancestors)
+{
+    if (path.empty())
+        return node == document;
+    if (ancestors.front() != document)
+        return false;
+    blink::WebNode child = node;
+    for (size_t depth = path.size(); depth > 0; --depth) {
+        const blink::WebNode &parent = ancestors[depth - 1];
+        if (child.parentNode() != parent)
+            return false;
+        int index = 0;
+        for (blink::WebNode sibling = child.previousSibling(); !sibling.isNull(); sibling = sibling.previousSibling())
+            ++index;
+        if (index != path[depth - 1])
+            return false;
+        child = parent;
+    }
+    return true;
+}
+
 QtRenderViewObserver::QtRenderViewObserver(content::RenderView* render_view)
     : content::RenderViewObserver(render_view)
+    , m_weakFactory(this)
 {
 }
 
 void QtRenderViewObserver::onFetchDocumentMarkup(quint64 requestId)
 {
-    Send(new QtRenderViewObserverHost_DidFetchDocumentMarkup(
-        routing_id(),
-        requestId,
-        render_view()->GetWebView()->mainFrame()->document().createMarkup()));
+    PendingDocument document;
+    document.type = PendingDocument::Markup;
+    document.text = render_view()->GetWebView()->mainFrame()->document().createMarkup();
+    startDocumentExtraction(requestId, document);
 }
 
 void QtRenderViewObserver::onFetchDocumentInnerText(quint64 requestId)
 {
-    Send(new QtRenderViewObserverHost_DidFetchDocumentInnerText(
-        routing_id(),
-        requestId,
-        render_view()->GetWebView()->mainFrame()->document().documentElement().innerText()));
+    PendingDocument document;
+    document.type = PendingDocument::InnerText;
+    document.text = render_view()->GetWebView()->mainFrame()->document().documentElement().innerText();
+    startDocumentExtraction(requestId, document);
+}
+
+void QtRenderViewObserver::onFetchDocumentTextNodes(quint64 requestId)
+{
+    PendingDocument document;
+    document.type = PendingDocument::TextNodes;
+    // Start from the document, its path is empty.
+    document.node = render_view()->GetWebView()->mainFrame()->document();
+    startDocumentExtraction(requestId, document);
+}
+
+void QtRenderViewObserver::startDocumentExtraction(quint64 requestId, const PendingDocument &document)
+{
+    PendingDocument &pending = m_pendingDocuments[requestId];
+    pending = document;
+    pending.position = 0;
+    pending.restarts = 0;
+    sendNextDocumentChunk(requestId);
+}
+
+void QtRenderViewObserver::sendNextDocumentChunk(quint64 requestId)
+{
+    std::map<quint64, PendingDocument>::iterator it = m_pendingDocuments.find(requestId);
+    if (it == m_pendingDocuments.end())
+        return;
+
+    bool done = it->second.type == PendingDocument::TextNodes
+        ? sendNextTextNodesChunk(requestId, &it->second)
+        : sendNextTextChunk(requestId, &it->second);
+    if (done) {
+        m_pendingDocuments.erase(it);
+        return;
+    }
+    // Let the main thread handle other work before producing the next chunk.
+    base::MessageLoop::current()->PostTask(FROM_HERE,
+        base::Bind(&QtRenderViewObserver::sendNextDocumentChunk, m_weakFactory.GetWeakPtr(), requestId));
+}
+
+bool QtRenderViewObserver::sendNextTextChunk(quint64 requestId, PendingDocument *document)
+{
+    size_t length = std::min(kMaxChunkLength, document->text.size() - document->position);
+    // Keep surrogate pairs in one chunk, streamed chunks reach the client on their own.
+    if (length > 1 && CBU16_IS_LEAD(document->text[document->position + length - 1]))
+        --length;
+    const base::string16 chunk = document->text.substr(document->position, length);
+    document->position += length;
+    const bool done = document->position == document->text.size();
+    if (document->type == PendingDocument::Markup)
+        Send(new QtRenderViewObserverHost_DidFetchDocumentMarkup(routing_id(), requestId, chunk, done));
+    else
+        Send(new QtRenderViewObserverHost_DidFetchDocumentInnerText(routing_id(), requestId, chunk, done));
+    return done;
+}
+
+bool QtRenderViewObserver::sendNextTextNodesChunk(quint64 requestId, PendingDocument *document)
+{
+    const blink::WebDocument mainDocument = render_view()->GetWebView()->mainFrame()->document();
+    bool restarted = false;
+    if (!isWalkPositionValid(mainDocument, document->node, document->path, document->ancestors)) {
+        // The chunks already sent no longer match the document, the browser drops them.
+        document->node = mainDocument;
+        document->path.clear();
+        document->ancestors.clear();
+        ++document->restarts;
+        restarted = true;
+    }
+    // Nothing can change the DOM while this task runs, a document changing all the time is sent as it is now.
+    const bool walkToEnd = document->restarts >= kMaxTextNodesWalkRestarts;
+
+    bool done;
+    do {
+        base::string16 chunk;
+        std::vector<int> offsets;
+        std::vector<std::string> paths;
+        int visitedTextNodes = 0;
+        while (!document->node.isNull() && visitedTextNodes < kMaxTextNodesPerChunk && chunk.size() < kMaxChunkLength) {
+            const bool skipChildren = isTextExcluded(document->node);
+            if (document->node.isTextNode()) {
+                const base::string16 text = document->node.nodeValue();
+                if (!text.empty()) {
+                    offsets.push_back(static_cast<int>(chunk.size()));
+                    paths.push_back(pathToString(document->path));
+                    chunk.append(text);
+                }
+                ++visitedTextNodes;
+            }
+            document->node = nextNode(document->node, &document->path, &document->ancestors, skipChildren);
+        }
+
+        done = document->node.isNull();
+        Send(new QtRenderViewObserverHost_DidFetchDocumentTextNodes(routing_id(), requestId, chunk, offsets, paths, restarted, done));
+        restarted = false;
+    } while (walkToEnd && !done);
+    return done;
 }
 
 bool QtRenderViewObserver::OnMessageReceived(const IPC::Message& message)
@@ -76,6 +253,7 @@ bool QtRenderViewObserver::OnMessageReceived(const IPC::Message& message)
     IPC_BEGIN_MESSAGE_MAP(QtRenderViewObserver, message)
         IPC_MESSAGE_HANDLER(QtRenderViewObserver_FetchDocumentMarkup, onFetchDocumentMarkup)
         IPC_MESSAGE_HANDLER(QtRenderViewObserver_FetchDocumentInnerText, onFetchDocumentInnerText)
+        IPC_MESSAGE_HANDLER(QtRenderViewObserver_FetchDocumentTextNodes, onFetchDocumentTextNodes)
         IPC_MESSAGE_UNHANDLED(handled = false)
     IPC_END_MESSAGE_MAP()
     return handled;
@@ -39,19 +39,48 @@
 **
 ****************************************************************************/
 
+#include "base/memory/weak_ptr.h"
+#include "base/strings/string16.h"
 #include "content/public/renderer/render_view_observer.h"
+#include "third_party/WebKit/public/web/WebNode.h"
 
 #include <QtGlobal>
 
+#include <map>
+#include <vector>
+
 class QtRenderViewObserver : public content::RenderViewObserver {
 public:
     QtRenderViewObserver(content::RenderView* render_view);
 
 private:
+    // Extractions are done over several tasks, sending one bounded chunk of the document in each.
+    struct PendingDocument {
+        enum Type { Markup, InnerText, TextNodes };
+        Type type;
+        // Markup and InnerText are serialized by Blink in one go, then sent piece by piece.
+        base::string16 text;
+        size_t position;
+        // TextNodes walks the DOM, in document order, from |node| whose child index path is |path|
+        // and whose ancestors are |ancestors|, starting with the document.
+        blink::WebNode node;
+        std::vector<int> path;
+        std::vector<blink::WebNode> ancestors;
+        int restarts;
+    };
+
     void onFetchDocumentMarkup(quint64 requestId);
     void onFetchDocumentInnerText(quint64 requestId);
+    void onFetchDocumentTextNodes(quint64 requestId);
+    void startDocumentExtraction(quint64 requestId, const PendingDocument &document);
+    void sendNextDocumentChunk(quint64 requestId);
+    bool sendNextTextChunk(quint64 requestId, PendingDocument *document);
+    bool sendNextTextNodesChunk(quint64 requestId, PendingDocument *document);
 
     virtual bool OnMessageReceived(const IPC::Message& message) Q_DECL_OVERRIDE;
 
+    std::map<quint64, PendingDocument> m_pendingDocuments;
+    base::WeakPtrFactory<QtRenderViewObserver> m_weakFactory;
+
     DISALLOW_COPY_AND_ASSIGN(QtRenderViewObserver);
 };
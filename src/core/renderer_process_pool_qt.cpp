@@ -0,0 +1,180 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "renderer_process_pool_qt.h"
+
+#include "base/bind.h"
+#include "base/message_loop/message_loop.h"
+#include "content/public/browser/browser_context.h"
+#include "content/public/browser/notification_service.h"
+#include "content/public/browser/notification_types.h"
+#include "content/public/browser/render_process_host.h"
+#include "content/public/browser/site_instance.h"
+
+RendererProcessPoolQt::RendererProcessPoolQt(content::BrowserContext *browserContext, int size)
+    : m_browserContext(browserContext)
+    , m_size(0)
+    , m_fillScheduled(false)
+    , m_weakFactory(this)
+{
+    m_registrar.Add(this, content::NOTIFICATION_RENDERER_PROCESS_CREATED, content::NotificationService::AllBrowserContextsAndSources());
+    m_registrar.Add(this, content::NOTIFICATION_RENDERER_PROCESS_TERMINATED, content::NotificationService::AllBrowserContextsAndSources());
+    m_registrar.Add(this, content::NOTIFICATION_RENDERER_PROCESS_CLOSED, content::NotificationService::AllBrowserContextsAndSources());
+    setSize(size);
+}
+
+RendererProcessPoolQt::~RendererProcessPoolQt()
+{
+    while (!m_spares.empty()) {
+        scoped_refptr<content::SiteInstance> spare = m_spares.back();
+        m_spares.pop_back();
+        releaseSpare(spare);
+    }
+}
+
+void RendererProcessPoolQt::setSize(int size)
+{
+    m_size = qMax(0, size);
+    while (m_spares.size() > static_cast<size_t>(m_size)) {
+        // Out of the pool before its process goes, Observe would otherwise replace it.
+        scoped_refptr<content::SiteInstance> spare = m_spares.back();
+        m_spares.pop_back();
+        releaseSpare(spare);
+    }
+    scheduleFill();
+}
+
+scoped_refptr<content::SiteInstance> RendererProcessPoolQt::takeSpareSiteInstance()
+{
+    if (m_spares.empty())
+        return scoped_refptr<content::SiteInstance>();
+    scoped_refptr<content::SiteInstance> siteInstance = m_spares.front();
+    m_spares.pop_front();
+    scheduleFill();
+    return siteInstance;
+}
+
+bool RendererProcessPoolQt::isSpareProcess(int processId) const
+{
+    return m_spareProcessIds.count(processId);
+}
+
+base::TimeDelta RendererProcessPoolQt::processLaunchTime(int processId) const
+{
+    std::map<int, base::TimeDelta>::const_iterator it = m_launchTimes.find(processId);
+    return it != m_launchTimes.end() ? it->second : base::TimeDelta();
+}
+
+void RendererProcessPoolQt::processLaunchStarted(content::RenderProcessHost *host)
+{
+    m_launchStartTimes[host->GetID()] = base::TimeTicks::Now();
+}
+
+void RendererProcessPoolQt::Observe(int type, const content::NotificationSource &source, const content::NotificationDetails &)
+{
+    content::RenderProcessHost *host = content::Source<content::RenderProcessHost>(source).ptr();
+    if (host->GetBrowserContext() != m_browserContext)
+        return;
+    const int processId = host->GetID();
+
+    if (type == content::NOTIFICATION_RENDERER_PROCESS_CREATED) {
+        std::map<int, base::TimeTicks>::iterator it = m_launchStartTimes.find(processId);
+        if (it != m_launchStartTimes.end()) {
+            m_launchTimes[processId] = base::TimeTicks::Now() - it->second;
+            m_launchStartTimes.erase(it);
+        }
+        return;
+    }
+
+    // The process is gone, forget about it and replace it if it was still waiting in the pool.
+    m_launchStartTimes.erase(processId);
+    m_launchTimes.erase(processId);
+    m_spareProcessIds.erase(processId);
+    for (std::deque<scoped_refptr<content::SiteInstance> >::iterator it = m_spares.begin(); it != m_spares.end(); ++it) {
+        if ((*it)->HasProcess() && (*it)->GetProcess() == host) {
+            m_spares.erase(it);
+            scheduleFill();
+            break;
+        }
+    }
+}
+
+void RendererProcessPoolQt::scheduleFill()
+{
+    if (m_fillScheduled || m_spares.size() >= static_cast<size_t>(m_size))
+        return;
+    // Launching is asynchronous, but creating the process host still takes a while, don't do it in the caller's stack.
+    m_fillScheduled = true;
+    base::MessageLoop::current()->PostTask(FROM_HERE, base::Bind(&RendererProcessPoolQt::fill, m_weakFactory.GetWeakPtr()));
+}
+
+void RendererProcessPoolQt::fill()
+{
+    m_fillScheduled = false;
+    // One process per task, to stay out of the way of the UI.
+    if (m_spares.size() >= static_cast<size_t>(m_size))
+        return;
+
+    scoped_refptr<content::SiteInstance> siteInstance = content::SiteInstance::Create(m_browserContext);
+    content::RenderProcessHost *host = siteInstance->GetProcess();
+    // With too many processes GetProcess hands out an existing one, which would not be spare.
+    // The site instance only shares that process, dropping it leaves the process alone.
+    if (m_spareProcessIds.count(host->GetID()) || host->HasConnection()) {
+        qWarning("Renderer process limit reached, keeping %d of %d spare renderer processes.", int(m_spares.size()), m_size);
+        return;
+    }
+    m_spareProcessIds.insert(host->GetID());
+    if (!host->Init()) {
+        m_spareProcessIds.erase(host->GetID());
+        return;
+    }
+    m_spares.push_back(siteInstance);
+    scheduleFill();
+}
+
+void RendererProcessPoolQt::releaseSpare(const scoped_refptr<content::SiteInstance> &siteInstance)
+{
+    // Nothing else uses the process of a spare, let it go right away.
+    if (siteInstance->HasProcess()) {
+        m_spareProcessIds.erase(siteInstance->GetProcess()->GetID());
+        siteInstance->GetProcess()->Cleanup();
+    }
+}
@@ -0,0 +1,105 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef RENDERER_PROCESS_POOL_QT_H
+#define RENDERER_PROCESS_POOL_QT_H
+
+#include "base/memory/ref_counted.h"
+#include "base/memory/weak_ptr.h"
+#include "base/time/time.h"
+#include "content/public/browser/notification_observer.h"
+#include "content/public/browser/notification_registrar.h"
+
+#include <QtGlobal>
+
+#include <deque>
+#include <map>
+#include <set>
+
+namespace content {
+class BrowserContext;
+class RenderProcessHost;
+class SiteInstance;
+}
+
+// Keeps spare renderer processes launched ahead of need, so that new WebContents don't
+// wait for a process launch and Blink initialization before their first navigation.
+// Also measures how long each renderer process of the browser context took to launch.
+class RendererProcessPoolQt : public content::NotificationObserver {
+public:
+    RendererProcessPoolQt(content::BrowserContext *browserContext, int size);
+    virtual ~RendererProcessPoolQt();
+
+    void setSize(int size);
+    int size() const { return m_size; }
+
+    // Returns a SiteInstance without a site whose process was launched from the pool,
+    // or null if there is no spare left. The pool is refilled from the message loop.
+    scoped_refptr<content::SiteInstance> takeSpareSiteInstance();
+
+    bool isSpareProcess(int processId) const;
+    // From the launch request to the process being ready to receive messages, zero until then.
+    base::TimeDelta processLaunchTime(int processId) const;
+
+    // Called for any renderer process of the browser context when it starts launching.
+    void processLaunchStarted(content::RenderProcessHost *host);
+
+    virtual void Observe(int type, const content::NotificationSource &source, const content::NotificationDetails &details) Q_DECL_OVERRIDE;
+
+private:
+    void scheduleFill();
+    void fill();
+    void releaseSpare(const scoped_refptr<content::SiteInstance> &siteInstance);
+
+    content::BrowserContext *m_browserContext;
+    int m_size;
+    bool m_fillScheduled;
+    std::deque<scoped_refptr<content::SiteInstance> > m_spares;
+    std::set<int> m_spareProcessIds;
+    std::map<int, base::TimeTicks> m_launchStartTimes;
+    std::map<int, base::TimeDelta> m_launchTimes;
+    content::NotificationRegistrar m_registrar;
+    base::WeakPtrFactory<RendererProcessPoolQt> m_weakFactory;
+
+    DISALLOW_COPY_AND_ASSIGN(RendererProcessPoolQt);
+};
+
+#endif // RENDERER_PROCESS_POOL_QT_H
@@ -139,9 +139,11 @@ StreamVideoNode::StreamVideoNode(QSGTexture *texture)
 void StreamVideoNode::setRect(const QRectF &rect)
 {
     QSGGeometry::updateTexturedRectGeometry(geometry(), rect, QRectF(0, 0, 1, 1));
+    markDirty(QSGNode::DirtyGeometry);
 }
 
 void StreamVideoNode::setTextureMatrix(const QMatrix4x4 &matrix)
 {
     m_material->m_texMatrix = matrix;
+    markDirty(QSGNode::DirtyMaterial);
 }
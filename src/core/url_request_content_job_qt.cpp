@@ -0,0 +1,286 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "url_request_content_job_qt.h"
+
+#include "type_conversion.h"
+
+#include "base/rand_util.h"
+#include "content/public/browser/navigation_controller.h"
+#include "content/public/browser/navigation_entry.h"
+#include "content/public/browser/resource_request_info.h"
+#include "content/public/browser/web_contents.h"
+#include "net/base/io_buffer.h"
+#include "net/base/net_errors.h"
+#include "net/http/http_util.h"
+
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QPair>
+#include <QSet>
+
+using namespace net;
+
+namespace {
+
+// Long enough not to be guessed, content ids never leave the browser process anyway.
+const int kContentIdBytes = 16;
+
+struct ContentEntry {
+    QByteArray data;
+    std::string mimeType;
+    std::string charset;
+    GURL url;
+    // Only used as a key, never dereferenced outside of the UI thread.
+    const content::WebContents *owner;
+};
+
+typedef QPair<int, int> RenderViewId;
+
+// Content is registered from the UI thread and served from the IO thread.
+struct ContentRegistry {
+    QMutex mutex;
+    QHash<QByteArray, ContentEntry> entries;
+    // The render views of the WebContents owning content, requests are matched to their WebContents through them.
+    QHash<RenderViewId, const content::WebContents *> renderViews;
+    // The content the next main frame navigation of a WebContents is started for.
+    QHash<const content::WebContents *, QByteArray> expectedContent;
+};
+
+Q_GLOBAL_STATIC(ContentRegistry, contentRegistry)
+
+} // namespace
+
+const char URLRequestContentJobQt::kNavigationEntryKey[] = "qt_content_id";
+
+QByteArray URLRequestContentJobQt::registerContent(content::WebContents *owner, const GURL &url, const QByteArray &data, const QString &mimeType)
+{
+    ContentEntry entry;
+    entry.data = data;
+    entry.url = url;
+    entry.owner = owner;
+    // Use the same defaults as data: URLs.
+    bool hadCharset = false;
+    HttpUtil::ParseContentType(mimeType.toStdString(), &entry.mimeType, &entry.charset, &hadCharset, 0);
+    if (entry.mimeType.empty()) {
+        entry.mimeType = "text/plain";
+        if (entry.charset.empty())
+            entry.charset = "US-ASCII";
+    }
+
+    QByteArray contentId(kContentIdBytes, Qt::Uninitialized);
+    base::RandBytes(contentId.data(), contentId.size());
+    contentId = contentId.toHex();
+
+    ContentRegistry *registry = contentRegistry();
+    QMutexLocker locker(&registry->mutex);
+    registry->entries.insert(contentId, entry);
+    return contentId;
+}
+
+void URLRequestContentJobQt::unregisterContent(const QByteArray &contentId)
+{
+    ContentRegistry *registry = contentRegistry();
+    QMutexLocker locker(&registry->mutex);
+    registry->entries.remove(contentId);
+}
+
+bool URLRequestContentJobQt::isContentRegistered(const QByteArray &contentId)
+{
+    ContentRegistry *registry = contentRegistry();
+    QMutexLocker locker(&registry->mutex);
+    return registry->entries.contains(contentId);
+}
+
+void URLRequestContentJobQt::expectContent(const QByteArray &contentId)
+{
+    ContentRegistry *registry = contentRegistry();
+    QMutexLocker locker(&registry->mutex);
+    QHash<QByteArray, ContentEntry>::const_iterator it = registry->entries.constFind(contentId);
+    if (it != registry->entries.constEnd())
+        registry->expectedContent.insert(it->owner, contentId);
+}
+
+void URLRequestContentJobQt::addRenderView(content::WebContents *owner, int renderProcessId, int renderViewId)
+{
+    ContentRegistry *registry = contentRegistry();
+    QMutexLocker locker(&registry->mutex);
+    registry->renderViews.insert(qMakePair(renderProcessId, renderViewId), owner);
+}
+
+void URLRequestContentJobQt::removeRenderView(int renderProcessId, int renderViewId)
+{
+    ContentRegistry *registry = contentRegistry();
+    QMutexLocker locker(&registry->mutex);
+    registry->renderViews.remove(qMakePair(renderProcessId, renderViewId));
+}
+
+void URLRequestContentJobQt::releaseUnreachableContent(content::WebContents *owner)
+{
+    // The pending entry still counts, its navigation might not have reached the IO thread yet.
+    QSet<QByteArray> reachableIds;
+    const content::NavigationController &controller = owner->GetController();
+    const int entryCount = controller.GetEntryCount();
+    for (int i = -1; i < entryCount; ++i) {
+        const content::NavigationEntry *entry = i < 0 ? controller.GetPendingEntry() : controller.GetEntryAtIndex(i);
+        base::string16 contentId;
+        if (entry && entry->GetExtraData(kNavigationEntryKey, &contentId))
+            reachableIds.insert(toQt(contentId).toLatin1());
+    }
+
+    ContentRegistry *registry = contentRegistry();
+    QMutexLocker locker(&registry->mutex);
+    QHash<QByteArray, ContentEntry>::iterator it = registry->entries.begin();
+    while (it != registry->entries.end()) {
+        if (it->owner == owner && !reachableIds.contains(it.key()))
+            it = registry->entries.erase(it);
+        else
+            ++it;
+    }
+}
+
+void URLRequestContentJobQt::releaseOwner(content::WebContents *owner)
+{
+    ContentRegistry *registry = contentRegistry();
+    QMutexLocker locker(&registry->mutex);
+    QHash<QByteArray, ContentEntry>::iterator it = registry->entries.begin();
+    while (it != registry->entries.end()) {
+        if (it->owner == owner)
+            it = registry->entries.erase(it);
+        else
+            ++it;
+    }
+    QHash<RenderViewId, const content::WebContents *>::iterator view = registry->renderViews.begin();
+    while (view != registry->renderViews.end()) {
+        if (view.value() == owner)
+            view = registry->renderViews.erase(view);
+        else
+            ++view;
+    }
+    registry->expectedContent.remove(owner);
+}
+
+URLRequestContentJobQt *URLRequestContentJobQt::maybeCreate(URLRequest *request, NetworkDelegate *networkDelegate)
+{
+    // Only the main frame of a render view can be navigated to registered content, decided by the browser.
+    const content::ResourceRequestInfo *info = content::ResourceRequestInfo::ForRequest(request);
+    if (!info || info->GetResourceType() != ResourceType::MAIN_FRAME || request->method() != "GET")
+        return 0;
+    int renderProcessId;
+    int renderViewId;
+    if (!info->GetAssociatedRenderView(&renderProcessId, &renderViewId))
+        return 0;
+
+    ContentRegistry *registry = contentRegistry();
+    QMutexLocker locker(&registry->mutex);
+    const content::WebContents *owner = registry->renderViews.value(qMakePair(renderProcessId, renderViewId));
+    if (!owner)
+        return 0;
+    // Whichever main frame navigation comes first consumes the expectation, a later one
+    // started by the page itself can't get at the content.
+    QByteArray contentId = registry->expectedContent.take(owner);
+    if (contentId.isEmpty())
+        return 0;
+    QHash<QByteArray, ContentEntry>::const_iterator it = registry->entries.constFind(contentId);
+    if (it == registry->entries.constEnd() || it->url != request->url())
+        return 0;
+    return new URLRequestContentJobQt(request, networkDelegate, it->data, it->mimeType, it->charset);
+}
+
+URLRequestContentJobQt::URLRequestContentJobQt(URLRequest *request, NetworkDelegate *networkDelegate, const QByteArray &data,
+                                               const std::string &mimeType, const std::string &charset)
+    : URLRequestJob(request, networkDelegate)
+    , m_data(data)
+    , m_position(0)
+    , m_mimeType(mimeType)
+    , m_charset(charset)
+    , m_weakFactory(this)
+{
+}
+
+URLRequestContentJobQt::~URLRequestContentJobQt()
+{
+}
+
+void URLRequestContentJobQt::Start()
+{
+    base::MessageLoop::current()->PostTask(FROM_HERE, base::Bind(&URLRequestContentJobQt::startAsync, m_weakFactory.GetWeakPtr()));
+}
+
+void URLRequestContentJobQt::Kill()
+{
+    m_weakFactory.InvalidateWeakPtrs();
+
+    URLRequestJob::Kill();
+}
+
+bool URLRequestContentJobQt::GetMimeType(std::string *mimeType) const
+{
+    *mimeType = m_mimeType;
+    return true;
+}
+
+bool URLRequestContentJobQt::GetCharset(std::string *charset)
+{
+    if (m_charset.empty())
+        return false;
+    *charset = m_charset;
+    return true;
+}
+
+bool URLRequestContentJobQt::ReadRawData(IOBuffer *buf, int bufSize, int *bytesRead)
+{
+    DCHECK(bytesRead);
+    // The only copy of the data, from the registered buffer to the request's.
+    int remainingBytes = m_data.size() - m_position;
+    if (bufSize > remainingBytes)
+        bufSize = remainingBytes;
+    memcpy(buf->data(), m_data.constData() + m_position, bufSize);
+    m_position += bufSize;
+    *bytesRead = bufSize;
+    return true;
+}
+
+void URLRequestContentJobQt::startAsync()
+{
+    NotifyHeadersComplete();
+}
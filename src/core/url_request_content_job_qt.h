@@ -0,0 +1,109 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef URL_REQUEST_CONTENT_JOB_QT_H_
+#define URL_REQUEST_CONTENT_JOB_QT_H_
+
+#include "net/url_request/url_request.h"
+#include "net/url_request/url_request_job.h"
+
+#include <QtCore/qcompilerdetection.h> // Needed for Q_DECL_OVERRIDE
+#include <QByteArray>
+#include <QString>
+
+namespace content {
+class WebContents;
+}
+
+// A request job that serves the data given to WebContentsAdapter::setContent from memory,
+// so that it doesn't have to be encoded into a data: URL and carried through the navigation.
+//
+// Registered content belongs to a WebContents and its URL. It is only served to the main frame
+// navigation the browser started for it with expectContent(), in one of the render views of that
+// WebContents, nothing the page sends can select it.
+class URLRequestContentJobQt : public net::URLRequestJob {
+
+public:
+    // Navigation entries loading registered content keep its id as extra data under this key.
+    static const char kNavigationEntryKey[];
+
+    // Can be called from any thread, the data is shared and not copied.
+    // Returns an unguessable id for the content, which stays in the browser process.
+    static QByteArray registerContent(content::WebContents *owner, const GURL &url, const QByteArray &data, const QString &mimeType);
+    static void unregisterContent(const QByteArray &contentId);
+    static bool isContentRegistered(const QByteArray &contentId);
+    // The next main frame request of the owner of the content gets it, provided it is for the content's URL.
+    static void expectContent(const QByteArray &contentId);
+
+    // Must be called on the UI thread.
+    static void addRenderView(content::WebContents *owner, int renderProcessId, int renderViewId);
+    static void removeRenderView(int renderProcessId, int renderViewId);
+    // Unregisters the content of |owner| that none of its navigation entries can load again.
+    static void releaseUnreachableContent(content::WebContents *owner);
+    static void releaseOwner(content::WebContents *owner);
+
+    // Returns 0 if the request isn't the navigation expecting registered content.
+    static URLRequestContentJobQt *maybeCreate(net::URLRequest *request, net::NetworkDelegate *networkDelegate);
+
+    virtual void Start() Q_DECL_OVERRIDE;
+    virtual void Kill() Q_DECL_OVERRIDE;
+    virtual bool ReadRawData(net::IOBuffer *buf, int bufSize, int *bytesRead) Q_DECL_OVERRIDE;
+    virtual bool GetMimeType(std::string *mimeType) const Q_DECL_OVERRIDE;
+    virtual bool GetCharset(std::string *charset) Q_DECL_OVERRIDE;
+
+protected:
+    virtual ~URLRequestContentJobQt();
+    void startAsync();
+
+private:
+    URLRequestContentJobQt(net::URLRequest *request, net::NetworkDelegate *networkDelegate, const QByteArray &data,
+                           const std::string &mimeType, const std::string &charset);
+
+    QByteArray m_data;
+    int m_position;
+    std::string m_mimeType;
+    std::string m_charset;
+    base::WeakPtrFactory<URLRequestContentJobQt> m_weakFactory;
+
+    DISALLOW_COPY_AND_ASSIGN(URLRequestContentJobQt);
+};
+
+#endif // URL_REQUEST_CONTENT_JOB_QT_H_
@@ -49,6 +49,7 @@
 #include "content/public/browser/cookie_store_factory.h"
 #include "net/base/cache_type.h"
 #include "net/cert/cert_verifier.h"
+#include "net/cookies/cookie_monster.h"
 #include "net/dns/host_resolver.h"
 #include "net/dns/mapped_host_resolver.h"
 #include "net/http/http_auth_handler_factory.h"
@@ -64,18 +65,27 @@
 #include "net/url_request/data_protocol_handler.h"
 #include "net/url_request/file_protocol_handler.h"
 #include "net/url_request/ftp_protocol_handler.h"
+#include "net/url_request/protocol_intercept_job_factory.h"
+#include "net/url_request/url_request_job_factory_impl.h"
 #include "net/ftp/ftp_network_layer.h"
 
+#include "content_protocol_interceptor_qt.h"
 #include "network_delegate_qt.h"
 #include "qrc_protocol_handler_qt.h"
 
 static const char kQrcSchemeQt[] = "qrc";
+// Expired host cache entries are still used while being refreshed, up to this long after their expiration.
+static const int kHostCacheMaxStalenessHours = 6;
 
 using content::BrowserThread;
 
-URLRequestContextGetterQt::URLRequestContextGetterQt(const base::FilePath &basePath, content::ProtocolHandlerMap *protocolHandlers)
+URLRequestContextGetterQt::URLRequestContextGetterQt(const base::FilePath &basePath, content::ProtocolHandlerMap *protocolHandlers,
+                                                     BrowserContextAdapter::HttpCacheType httpCacheType, int httpCacheMaxSize, bool memoryOnly)
     : m_ignoreCertificateErrors(false)
     , m_basePath(basePath)
+    , m_httpCacheType(httpCacheType)
+    , m_httpCacheMaxSize(httpCacheMaxSize)
+    , m_memoryOnly(memoryOnly)
 {
     std::swap(m_protocolHandlers, *protocolHandlers);
 
@@ -93,13 +103,18 @@ net::URLRequestContext *URLRequestContextGetterQt::GetURLRequestContext()
     if (!m_urlRequestContext) {
 
         m_urlRequestContext.reset(new net::URLRequestContext());
-        m_networkDelegate.reset(new NetworkDelegateQt);
+        m_networkDelegate.reset(new NetworkDelegateQt(this));
 
         m_urlRequestContext->set_network_delegate(m_networkDelegate.get());
 
-        base::FilePath cookiesPath = m_basePath.Append(FILE_PATH_LITERAL("Cookies"));
-        scoped_refptr<net::CookieStore> cookieStore = content::CreatePersistentCookieStore(cookiesPath, true, NULL, NULL, scoped_ptr<content::CookieCryptoDelegate>());
-        cookieStore->GetCookieMonster()->SetPersistSessionCookies(true);
+        scoped_refptr<net::CookieStore> cookieStore;
+        if (m_memoryOnly) {
+            cookieStore = new net::CookieMonster(NULL, NULL);
+        } else {
+            base::FilePath cookiesPath = m_basePath.Append(FILE_PATH_LITERAL("Cookies"));
+            cookieStore = content::CreatePersistentCookieStore(cookiesPath, true, NULL, NULL, scoped_ptr<content::CookieCryptoDelegate>());
+            cookieStore->GetCookieMonster()->SetPersistSessionCookies(true);
+        }
 
         m_storage.reset(new net::URLRequestContextStorage(m_urlRequestContext.get()));
         m_storage->set_cookie_store(cookieStore.get());
@@ -109,8 +124,14 @@ net::URLRequestContext *URLRequestContextGetterQt::GetURLRequestContext()
         m_storage->set_http_user_agent_settings(
             new net::StaticHttpUserAgentSettings("en-us,en", base::EmptyString()));
 
+        net::HostResolver::Options hostResolverOptions;
+        hostResolverOptions.max_cache_staleness = base::TimeDelta::FromHours(kHostCacheMaxStalenessHours);
         scoped_ptr<net::HostResolver> host_resolver(
-            net::HostResolver::CreateDefaultResolver(NULL));
+            net::HostResolver::CreateSystemResolver(hostResolverOptions, NULL));
+        if (!m_memoryOnly && host_resolver->GetHostCache()) {
+            m_hostCachePersister.reset(new HostCachePersisterQt(host_resolver->GetHostCache(), m_basePath.Append(FILE_PATH_LITERAL("HostCache")),
+                                                                BrowserThread::GetMessageLoopProxyForThread(BrowserThread::FILE).get()));
+        }
 
         m_storage->set_cert_verifier(net::CertVerifier::CreateDefault());
 
@@ -123,16 +144,6 @@ net::URLRequestContext *URLRequestContextGetterQt::GetURLRequestContext()
             net::HttpAuthHandlerFactory::CreateDefault(host_resolver.get()));
         m_storage->set_http_server_properties(scoped_ptr<net::HttpServerProperties>(new net::HttpServerPropertiesImpl));
 
-        base::FilePath cache_path = m_basePath.Append(FILE_PATH_LITERAL("Cache"));
-        net::HttpCache::DefaultBackend* main_backend =
-            new net::HttpCache::DefaultBackend(
-                net::DISK_CACHE,
-                net::CACHE_BACKEND_DEFAULT,
-                cache_path,
-                0,
-                BrowserThread::GetMessageLoopProxyForThread(
-                    BrowserThread::CACHE));
-
         net::HttpNetworkSession::Params network_session_params;
         network_session_params.transport_security_state =
             m_urlRequestContext->transport_security_state();
@@ -159,24 +170,28 @@ net::URLRequestContext *URLRequestContextGetterQt::GetURLRequestContext()
             m_urlRequestContext->host_resolver();
 
         net::HttpCache* main_cache = new net::HttpCache(
-            network_session_params, main_backend);
+            network_session_params, createHttpCacheBackendFactory());
         m_storage->set_http_transaction_factory(main_cache);
 
 
-        m_jobFactory.reset(new net::URLRequestJobFactoryImpl());
+        scoped_ptr<net::URLRequestJobFactoryImpl> jobFactory(new net::URLRequestJobFactoryImpl());
 
         // Chromium has a few protocol handlers ready for us, only pick blob: and throw away the rest.
         content::ProtocolHandlerMap::iterator it = m_protocolHandlers.find(chrome::kBlobScheme);
         Q_ASSERT(it != m_protocolHandlers.end());
-        m_jobFactory->SetProtocolHandler(it->first, it->second.release());
+        jobFactory->SetProtocolHandler(it->first, it->second.release());
         m_protocolHandlers.clear();
 
-        m_jobFactory->SetProtocolHandler(chrome::kDataScheme, new net::DataProtocolHandler());
-        m_jobFactory->SetProtocolHandler(chrome::kFileScheme, new net::FileProtocolHandler(
+        jobFactory->SetProtocolHandler(chrome::kDataScheme, new net::DataProtocolHandler());
+        jobFactory->SetProtocolHandler(chrome::kFileScheme, new net::FileProtocolHandler(
             content::BrowserThread::GetBlockingPool()->GetTaskRunnerWithShutdownBehavior(base::SequencedWorkerPool::SKIP_ON_SHUTDOWN)));
-        m_jobFactory->SetProtocolHandler(kQrcSchemeQt, new QrcProtocolHandlerQt());
-        m_jobFactory->SetProtocolHandler(content::kFtpScheme, new net::FtpProtocolHandler(
+        jobFactory->SetProtocolHandler(kQrcSchemeQt, new QrcProtocolHandlerQt());
+        jobFactory->SetProtocolHandler(content::kFtpScheme, new net::FtpProtocolHandler(
             new net::FtpNetworkLayer(m_urlRequestContext->host_resolver())));
+
+        // Content given to WebContentsAdapter::setContent is served in place of the base URL it was loaded with.
+        m_jobFactory.reset(new net::ProtocolInterceptJobFactory(jobFactory.PassAs<net::URLRequestJobFactory>(),
+            scoped_ptr<net::URLRequestJobFactory::ProtocolHandler>(new ContentProtocolInterceptorQt())));
         m_urlRequestContext->set_job_factory(m_jobFactory.get());
     }
 
@@ -188,3 +203,42 @@ scoped_refptr<base::SingleThreadTaskRunner> URLRequestContextGetterQt::GetNetwor
 {
     return content::BrowserThread::GetMessageLoopProxyForThread(content::BrowserThread::IO);
 }
+
+net::HttpCache::BackendFactory *URLRequestContextGetterQt::createHttpCacheBackendFactory() const
+{
+    if (m_httpCacheType == BrowserContextAdapter::MemoryHttpCache)
+        return net::HttpCache::DefaultBackend::InMemory(m_httpCacheMaxSize);
+
+    net::BackendType backendType = net::CACHE_BACKEND_DEFAULT;
+    if (m_httpCacheType == BrowserContextAdapter::BlockfileHttpCache)
+        backendType = net::CACHE_BACKEND_BLOCKFILE;
+    else if (m_httpCacheType == BrowserContextAdapter::SimpleHttpCache)
+        backendType = net::CACHE_BACKEND_SIMPLE;
+
+    return new net::HttpCache::DefaultBackend(net::DISK_CACHE, backendType, m_basePath.Append(FILE_PATH_LITERAL("Cache")),
+                                              m_httpCacheMaxSize, BrowserThread::GetMessageLoopProxyForThread(BrowserThread::CACHE));
+}
+
+HttpCacheStatistics URLRequestContextGetterQt::httpCacheStatistics() const
+{
+    base::AutoLock lock(m_statisticsLock);
+    return m_statistics;
+}
+
+void URLRequestContextGetterQt::recordHttpCacheLookup(bool hit)
+{
+    base::AutoLock lock(m_statisticsLock);
+    if (hit)
+        ++m_statistics.hitCount;
+    else
+        ++m_statistics.missCount;
+}
+
+void URLRequestContextGetterQt::recordHttpCacheBytesRead(bool cached, int bytes)
+{
+    base::AutoLock lock(m_statisticsLock);
+    if (cached)
+        m_statistics.cachedBytes += bytes;
+    else
+        m_statistics.networkBytes += bytes;
+}
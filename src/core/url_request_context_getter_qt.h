@@ -46,10 +46,15 @@
 #include "base/files/file_path.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/single_thread_task_runner.h"
+#include "base/synchronization/lock.h"
 #include "content/public/browser/content_browser_client.h"
 #include "content/public/common/url_constants.h"
+#include "net/http/http_cache.h"
 #include "net/url_request/url_request_context_storage.h"
-#include "net/url_request/url_request_job_factory_impl.h"
+#include "net/url_request/url_request_job_factory.h"
+
+#include "browser_context_adapter.h"
+#include "host_cache_persister_qt.h"
 
 #include "qglobal.h"
 
@@ -62,23 +67,39 @@ class ProxyConfigService;
 
 class URLRequestContextGetterQt : public net::URLRequestContextGetter {
 public:
-    explicit URLRequestContextGetterQt(const base::FilePath &, content::ProtocolHandlerMap *protocolHandlers);
+    URLRequestContextGetterQt(const base::FilePath &, content::ProtocolHandlerMap *protocolHandlers,
+                              BrowserContextAdapter::HttpCacheType httpCacheType, int httpCacheMaxSize, bool memoryOnly);
 
     virtual net::URLRequestContext *GetURLRequestContext() Q_DECL_OVERRIDE;
     virtual scoped_refptr<base::SingleThreadTaskRunner> GetNetworkTaskRunner() const Q_DECL_OVERRIDE;
 
+    // The statistics are recorded on the IO thread and can be read from any thread.
+    HttpCacheStatistics httpCacheStatistics() const;
+    void recordHttpCacheLookup(bool hit);
+    void recordHttpCacheBytesRead(bool cached, int bytes);
+
 private:
     virtual ~URLRequestContextGetterQt() {}
 
+    net::HttpCache::BackendFactory *createHttpCacheBackendFactory() const;
+
     bool m_ignoreCertificateErrors;
     base::FilePath m_basePath;
+    BrowserContextAdapter::HttpCacheType m_httpCacheType;
+    int m_httpCacheMaxSize;
+    bool m_memoryOnly;
+
+    mutable base::Lock m_statisticsLock;
+    HttpCacheStatistics m_statistics;
     content::ProtocolHandlerMap m_protocolHandlers;
 
     scoped_ptr<net::ProxyConfigService> m_proxyConfigService;
     scoped_ptr<net::URLRequestContext> m_urlRequestContext;
     scoped_ptr<net::NetworkDelegate> m_networkDelegate;
     scoped_ptr<net::URLRequestContextStorage> m_storage;
-    scoped_ptr<net::URLRequestJobFactoryImpl> m_jobFactory;
+    scoped_ptr<net::URLRequestJobFactory> m_jobFactory;
+    // Declared after |m_storage| so that it goes before the host resolver owning the cache.
+    scoped_ptr<HostCachePersisterQt> m_hostCachePersister;
 };
 
 #endif // URL_REQUEST_CONTEXT_GETTER_QT_H
@@ -43,27 +43,47 @@
 
 #include "type_conversion.h"
 
+#include "base/strings/string_number_conversions.h"
 #include "net/base/net_errors.h"
 #include "net/base/io_buffer.h"
+#include "net/http/http_request_headers.h"
+#include "net/http/http_response_headers.h"
+#include "net/http/http_response_info.h"
+#include "net/http/http_util.h"
+#include "third_party/zlib/zlib.h"
 
-#include <QUrl>
 #include <QFileInfo>
+#include <QHash>
 #include <QMimeDatabase>
 #include <QMimeType>
+#include <QUrl>
+#include <QtEndian>
 
 using namespace net;
 
+// Looking up a mime type can involve reading the content, resources never change so do it once per path.
+// Jobs only run on the IO thread.
+typedef QHash<QString, std::string> MimeTypeCache;
+Q_GLOBAL_STATIC(MimeTypeCache, mimeTypeCache)
+
+// rcc compresses resources with qCompress, which prefixes the zlib stream with the inflated size.
+static const int kCompressedSizeHeaderLength = 4;
+static const int kSkipBufferSize = 32 * 1024;
+
 URLRequestQrcJobQt::URLRequestQrcJobQt(URLRequest *request, NetworkDelegate *networkDelegate)
     : URLRequestJob(request, networkDelegate)
+    , m_data(0)
+    , m_position(0)
     , m_remainingBytes(0)
+    , m_inflateStream(0)
+    , m_rangeNotSatisfiable(false)
     , m_weakFactory(this)
 {
 }
 
 URLRequestQrcJobQt::~URLRequestQrcJobQt()
 {
-    if (m_file.isOpen())
-        m_file.close();
+    closeResource();
 }
 
 void URLRequestQrcJobQt::Start()
@@ -73,8 +93,7 @@ void URLRequestQrcJobQt::Start()
 
 void URLRequestQrcJobQt::Kill()
 {
-    if (m_file.isOpen())
-        m_file.close();
+    closeResource();
     m_weakFactory.InvalidateWeakPtrs();
 
     URLRequestJob::Kill();
@@ -90,6 +109,34 @@ bool URLRequestQrcJobQt::GetMimeType(std::string *mimeType) const
     return false;
 }
 
+void URLRequestQrcJobQt::SetExtraRequestHeaders(const HttpRequestHeaders &headers)
+{
+    std::string rangeHeader;
+    if (!headers.GetHeader(HttpRequestHeaders::kRange, &rangeHeader))
+        return;
+    std::vector<HttpByteRange> ranges;
+    if (!HttpUtil::ParseRangeHeader(rangeHeader, &ranges))
+        return;
+    // Like for file URLs, multiple ranges would need a multipart response and aren't supported.
+    if (ranges.size() == 1)
+        m_byteRange = ranges[0];
+    else
+        m_rangeNotSatisfiable = true;
+}
+
+void URLRequestQrcJobQt::GetResponseInfo(HttpResponseInfo *info)
+{
+    if (m_responseInfo)
+        *info = *m_responseInfo;
+}
+
+int URLRequestQrcJobQt::GetResponseCode() const
+{
+    if (!m_responseInfo)
+        return -1;
+    return m_responseInfo->headers->response_code();
+}
+
 bool URLRequestQrcJobQt::ReadRawData(IOBuffer *buf, int bufSize, int *bytesRead)
 {
     DCHECK(bytesRead);
@@ -101,9 +148,15 @@ bool URLRequestQrcJobQt::ReadRawData(IOBuffer *buf, int bufSize, int *bytesRead)
     }
     if (m_remainingBytes < bufSize)
         bufSize = static_cast<int>(m_remainingBytes);
-    qint64 rv = m_file.read(buf->data(), bufSize);
+
+    int rv = bufSize;
+    if (m_inflateStream)
+        rv = inflateTo(buf->data(), bufSize);
+    else
+        memcpy(buf->data(), m_data + m_position, bufSize);
     if (rv >= 0) {
-        *bytesRead = static_cast<int>(rv);
+        *bytesRead = rv;
+        m_position += rv;
         m_remainingBytes -= rv;
         DCHECK_GE(m_remainingBytes, 0);
         return true;
@@ -117,18 +170,126 @@ void URLRequestQrcJobQt::startGetHead()
 {
     // Get qrc file path.
     QString qrcFilePath = ':' + toQt(request_->url()).path(QUrl::RemovePath | QUrl::RemoveQuery);
-    m_file.setFileName(qrcFilePath);
-    QFileInfo qrcFileInfo(m_file);
+    m_resource.setFileName(qrcFilePath);
+    if (!m_resource.isValid() || !m_resource.data()) {
+        NotifyStartError(URLRequestStatus(URLRequestStatus::FAILED, ERR_INVALID_URL));
+        return;
+    }
+
     // Get qrc file mime type.
-    QMimeDatabase mimeDatabase;
-    QMimeType mimeType = mimeDatabase.mimeTypeForFile(qrcFileInfo);
-    m_mimeType = mimeType.name().toStdString();
-    // Open file
-    if (m_file.open(QIODevice::ReadOnly)) {
-        m_remainingBytes = m_file.size();
-        // Notify that the headers are complete
-        NotifyHeadersComplete();
+    MimeTypeCache *mimeTypes = mimeTypeCache();
+    MimeTypeCache::const_iterator it = mimeTypes->constFind(qrcFilePath);
+    if (it == mimeTypes->constEnd()) {
+        QMimeDatabase mimeDatabase;
+        QMimeType mimeType = mimeDatabase.mimeTypeForFile(QFileInfo(qrcFilePath));
+        it = mimeTypes->insert(qrcFilePath, mimeType.name().toStdString());
+    }
+    m_mimeType = it.value();
+
+    m_data = reinterpret_cast<const char *>(m_resource.data());
+    qint64 size = m_resource.size();
+    if (m_resource.isCompressed()) {
+        if (size < kCompressedSizeHeaderLength || !startInflating()) {
+            NotifyStartError(URLRequestStatus(URLRequestStatus::FAILED, ERR_FAILED));
+            return;
+        }
+        size = qFromBigEndian<quint32>(reinterpret_cast<const uchar *>(m_data));
+    }
+
+    const bool hasByteRange = m_byteRange.IsValid();
+    if (m_rangeNotSatisfiable || !m_byteRange.ComputeBounds(size)) {
+        closeResource();
+        headersCompleted(HTTP_REQUESTED_RANGE_NOT_SATISFIABLE, size);
+        return;
+    }
+    m_remainingBytes = m_byteRange.last_byte_position() - m_byteRange.first_byte_position() + 1;
+    DCHECK_GE(m_remainingBytes, 0);
+
+    if (!m_inflateStream)
+        m_position = m_byteRange.first_byte_position();
+    else {
+        // There is no way to seek in a deflate stream, inflate up to the start of the range.
+        scoped_ptr<char[]> skipBuffer(new char[kSkipBufferSize]);
+        while (m_position < m_byteRange.first_byte_position()) {
+            int rv = inflateTo(skipBuffer.get(), static_cast<int>(qMin<qint64>(kSkipBufferSize, m_byteRange.first_byte_position() - m_position)));
+            if (rv <= 0) {
+                NotifyStartError(URLRequestStatus(URLRequestStatus::FAILED, ERR_FAILED));
+                return;
+            }
+            m_position += rv;
+        }
+    }
+
+    headersCompleted(hasByteRange ? HTTP_PARTIAL_CONTENT : HTTP_OK, size);
+}
+
+bool URLRequestQrcJobQt::startInflating()
+{
+    DCHECK(!m_inflateStream);
+    m_inflateStream = new z_stream;
+    memset(m_inflateStream, 0, sizeof(z_stream));
+    m_inflateStream->next_in = reinterpret_cast<Bytef *>(const_cast<char *>(m_data + kCompressedSizeHeaderLength));
+    m_inflateStream->avail_in = static_cast<uInt>(m_resource.size() - kCompressedSizeHeaderLength);
+    if (inflateInit(m_inflateStream) != Z_OK) {
+        delete m_inflateStream;
+        m_inflateStream = 0;
+        return false;
+    }
+    return true;
+}
+
+int URLRequestQrcJobQt::inflateTo(char *buffer, int size)
+{
+    // The whole compressed stream is available, so inflate only stops once the buffer is full or the stream ended.
+    m_inflateStream->next_out = reinterpret_cast<Bytef *>(buffer);
+    m_inflateStream->avail_out = static_cast<uInt>(size);
+    while (m_inflateStream->avail_out) {
+        int result = inflate(m_inflateStream, Z_NO_FLUSH);
+        if (result == Z_STREAM_END)
+            break;
+        if (result != Z_OK)
+            return -1;
+    }
+    return size - static_cast<int>(m_inflateStream->avail_out);
+}
+
+// Answers like an HTTP server would, so range requests get a 206 or 416 status with a Content-Range header.
+void URLRequestQrcJobQt::headersCompleted(HttpStatusCode statusCode, qint64 size)
+{
+    std::string status("HTTP/1.1 ");
+    status.append(base::IntToString(statusCode));
+    status.append(" ");
+    status.append(GetHttpReasonPhrase(statusCode));
+    status.append("\0\0", 2);
+    HttpResponseHeaders *headers = new HttpResponseHeaders(status);
+
+    if (statusCode == HTTP_REQUESTED_RANGE_NOT_SATISFIABLE) {
+        headers->AddHeader("Content-Range: bytes */" + base::Int64ToString(size));
     } else {
-        NotifyStartError(URLRequestStatus(URLRequestStatus::FAILED, ERR_INVALID_URL));
+        headers->AddHeader(std::string(HttpRequestHeaders::kContentLength) + ": " + base::Int64ToString(m_remainingBytes));
+        if (!m_mimeType.empty())
+            headers->AddHeader(std::string(HttpRequestHeaders::kContentType) + ": " + m_mimeType);
+        if (statusCode == HTTP_PARTIAL_CONTENT) {
+            headers->AddHeader("Content-Range: bytes " + base::Int64ToString(m_byteRange.first_byte_position())
+                               + "-" + base::Int64ToString(m_byteRange.last_byte_position())
+                               + "/" + base::Int64ToString(size));
+        }
+    }
+
+    m_responseInfo.reset(new HttpResponseInfo);
+    m_responseInfo->headers = headers;
+    set_expected_content_size(m_remainingBytes);
+
+    NotifyHeadersComplete();
+}
+
+void URLRequestQrcJobQt::closeResource()
+{
+    if (m_inflateStream) {
+        inflateEnd(m_inflateStream);
+        delete m_inflateStream;
+        m_inflateStream = 0;
     }
+    m_data = 0;
+    m_remainingBytes = 0;
 }
@@ -42,13 +42,19 @@
 #ifndef URL_REQUEST_QRC_JOB_QT_H_
 #define URL_REQUEST_QRC_JOB_QT_H_
 
+#include "net/http/http_byte_range.h"
+#include "net/http/http_status_code.h"
 #include "net/url_request/url_request.h"
 #include "net/url_request/url_request_job.h"
 
 #include <QtCore/qcompilerdetection.h> // Needed for Q_DECL_OVERRIDE
-#include <QFile>
+#include <QResource>
 
-// A request job that handles reading qrc file URLs
+typedef struct z_stream_s z_stream;
+
+// A request job that handles reading qrc file URLs.
+// Resources are read straight from the memory they were compiled or mapped to,
+// compressed ones are inflated progressively as the request reads them.
 class URLRequestQrcJobQt : public net::URLRequestJob {
 
 public:
@@ -57,15 +63,29 @@ public:
     virtual void Kill() Q_DECL_OVERRIDE;
     virtual bool ReadRawData(net::IOBuffer *buf, int bufSize, int *bytesRead) Q_DECL_OVERRIDE;
     virtual bool GetMimeType(std::string *mimeType) const Q_DECL_OVERRIDE;
+    virtual void SetExtraRequestHeaders(const net::HttpRequestHeaders &headers) Q_DECL_OVERRIDE;
+    virtual void GetResponseInfo(net::HttpResponseInfo *info) Q_DECL_OVERRIDE;
+    virtual int GetResponseCode() const Q_DECL_OVERRIDE;
 
 protected:
     virtual ~URLRequestQrcJobQt();
-    // Get file mime type and try open file on a background thread.
+    // Get the resource's mime type and locate its data.
     void startGetHead();
 
 private:
+    bool startInflating();
+    int inflateTo(char *buffer, int size);
+    void closeResource();
+    void headersCompleted(net::HttpStatusCode statusCode, qint64 size);
+
+    QResource m_resource;
+    const char *m_data;
+    qint64 m_position;
     qint64 m_remainingBytes;
-    QFile m_file;
+    z_stream *m_inflateStream;
+    net::HttpByteRange m_byteRange;
+    bool m_rangeNotSatisfiable;
+    scoped_ptr<net::HttpResponseInfo> m_responseInfo;
     std::string m_mimeType;
     base::WeakPtrFactory<URLRequestQrcJobQt> m_weakFactory;
 
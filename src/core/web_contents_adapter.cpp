@@ -50,18 +50,24 @@
 #include "javascript_dialog_manager_qt.h"
 #include "media_capture_devices_dispatcher.h"
 #include "qt_render_view_observer_host.h"
+#include "render_widget_host_view_qt.h"
 #include "type_conversion.h"
+#include "url_request_content_job_qt.h"
 #include "web_contents_adapter_client.h"
 #include "web_contents_delegate_qt.h"
 #include "web_contents_view_qt.h"
 #include "web_engine_context.h"
 
+#include "base/rand_util.h"
 #include "base/values.h"
 #include "content/browser/renderer_host/render_view_host_impl.h"
 #include "content/browser/web_contents/web_contents_impl.h"
+#include "content/public/browser/browser_thread.h"
 #include "content/public/browser/child_process_security_policy.h"
 #include "content/public/browser/navigation_entry.h"
+#include "content/public/browser/render_process_host.h"
 #include "content/public/browser/render_view_host.h"
+#include "content/public/browser/site_instance.h"
 #include "content/public/common/page_state.h"
 #include "content/public/common/page_zoom.h"
 #include "content/public/common/renderer_preferences.h"
@@ -71,6 +77,7 @@
 
 #include <QDir>
 #include <QGuiApplication>
+#include <QImage>
 #include <QStringList>
 #include <QStyleHints>
 #include <QVariant>
@@ -78,6 +85,8 @@
 static const int kTestWindowWidth = 800;
 static const int kTestWindowHeight = 600;
 static const int kHistoryStreamVersion = 3;
+// Below this size, setContent keeps encoding the data into a data: URL, which also survives session history navigations.
+static const int kSetContentDataUrlLimit = 256 * 1024;
 
 static QVariant fromJSValue(const base::Value *result)
 {
@@ -161,6 +170,49 @@ static void callbackOnEvaluateJS(WebContentsAdapterClient *adapterClient, quint6
     adapterClient->didRunJavaScript(requestId, fromJSValue(result));
 }
 
+static void callbackOnGrabImage(WebContentsAdapterClient *adapterClient, quint64 requestId, const QImage &image)
+{
+    adapterClient->didGrabImage(requestId, image);
+}
+
+static void expectRegisteredContent(content::WebContents *webContents, const QByteArray &contentId)
+{
+    // A WebContents not created by the adapter might have its render view already.
+    content::RenderViewHost *rvh = webContents->GetRenderViewHost();
+    URLRequestContentJobQt::addRenderView(webContents, rvh->GetProcess()->GetID(), rvh->GetRoutingID());
+    URLRequestContentJobQt::expectContent(contentId);
+}
+
+static void loadRegisteredContent(content::WebContents *webContents, const QByteArray &contentId, const GURL &url, content::PageTransition transition)
+{
+    expectRegisteredContent(webContents, contentId);
+
+    content::NavigationController::LoadURLParams params(url);
+    params.transition_type = transition;
+    params.can_load_local_resources = true;
+    webContents->GetController().LoadURLWithParams(params);
+    if (content::NavigationEntry *entry = webContents->GetController().GetPendingEntry())
+        entry->SetExtraData(URLRequestContentJobQt::kNavigationEntryKey, toString16(QString::fromLatin1(contentId)));
+}
+
+// Returns whether |entry| loads content registered by setContent that is still available.
+static bool registeredContentId(const content::NavigationEntry *entry, QByteArray *contentId)
+{
+    base::string16 contentIdString;
+    if (!entry || !entry->GetExtraData(URLRequestContentJobQt::kNavigationEntryKey, &contentIdString))
+        return false;
+    *contentId = toQt(contentIdString).toLatin1();
+    return URLRequestContentJobQt::isContentRegistered(*contentId);
+}
+
+// History navigations reuse the entry, its content has to be expected again or the base URL would be fetched.
+static void expectHistoryContent(content::WebContents *webContents, const content::NavigationEntry *entry)
+{
+    QByteArray contentId;
+    if (registeredContentId(entry, &contentId))
+        expectRegisteredContent(webContents, contentId);
+}
+
 static QStringList listRecursively(const QDir& dir) {
     QStringList ret;
     QFileInfoList infoList(dir.entryInfoList(QDir::Dirs | QDir::Files | QDir::NoDotAndDotDot |QDir::Hidden));
@@ -174,10 +226,12 @@ static QStringList listRecursively(const QDir& dir) {
     return ret;
 }
 
-static content::WebContents *createBlankWebContents(WebContentsAdapterClient *adapterClient)
+static content::WebContents *createBlankWebContents(WebContentsAdapterClient *adapterClient, BrowserContextAdapter *browserContextAdapter)
 {
-    content::BrowserContext* browserContext = ContentBrowserClientQt::Get()->browser_context();
-    content::WebContents::CreateParams create_params(browserContext, NULL);
+    BrowserContextQt* browserContext = browserContextAdapter->browserContext();
+    // Start with a renderer process that is already running if there is one to spare.
+    scoped_refptr<content::SiteInstance> siteInstance = browserContext->rendererProcessPool()->takeSpareSiteInstance();
+    content::WebContents::CreateParams create_params(browserContext, siteInstance.get());
     create_params.routing_id = MSG_ROUTING_NONE;
     create_params.initial_size = gfx::Size(kTestWindowWidth, kTestWindowHeight);
     create_params.context = reinterpret_cast<gfx::NativeView>(adapterClient);
@@ -221,7 +275,7 @@ static void serializeNavigationHistory(const content::NavigationController &cont
     }
 }
 
-void deserializeNavigationHistory(QDataStream &input, int *currentIndex, std::vector<content::NavigationEntry*> *entries)
+void deserializeNavigationHistory(QDataStream &input, int *currentIndex, std::vector<content::NavigationEntry*> *entries, content::BrowserContext *browserContext)
 {
     int version;
     input >> version;
@@ -277,7 +331,7 @@ void deserializeNavigationHistory(QDataStream &input, int *currentIndex, std::ve
             false,
             // The extra headers are not sync'ed across sessions.
             std::string(),
-            ContentBrowserClientQt::Get()->browser_context());
+            browserContext);
 
         entry->SetTitle(toString16(title));
         entry->SetPageState(content::PageState::CreateFromEncodedData(std::string(pageState.data(), pageState.size())));
@@ -299,27 +353,29 @@ public:
     scoped_ptr<WebContentsDelegateQt> webContentsDelegate;
     scoped_ptr<QtRenderViewObserverHost> renderViewObserverHost;
     WebContentsAdapterClient *adapterClient;
+    BrowserContextAdapter *browserContextAdapter;
     quint64 lastRequestId;
 };
 
 WebContentsAdapterPrivate::WebContentsAdapterPrivate()
     // This has to be the first thing we create, and the last we destroy.
     : engineContext(WebEngineContext::current())
+    , browserContextAdapter(BrowserContextAdapter::defaultContext())
     , lastRequestId(0)
 {
 }
 
-QExplicitlySharedDataPointer<WebContentsAdapter> WebContentsAdapter::createFromSerializedNavigationHistory(QDataStream &input, WebContentsAdapterClient *adapterClient)
+QExplicitlySharedDataPointer<WebContentsAdapter> WebContentsAdapter::createFromSerializedNavigationHistory(QDataStream &input, WebContentsAdapterClient *adapterClient, BrowserContextAdapter *browserContextAdapter)
 {
     int currentIndex;
     std::vector<content::NavigationEntry*> entries;
-    deserializeNavigationHistory(input, &currentIndex, &entries);
+    deserializeNavigationHistory(input, &currentIndex, &entries, browserContextAdapter->browserContext());
 
     if (currentIndex == -1)
         return QExplicitlySharedDataPointer<WebContentsAdapter>();
 
     // Unlike WebCore, Chromium only supports Restoring to a new WebContents instance.
-    content::WebContents* newWebContents = createBlankWebContents(adapterClient);
+    content::WebContents* newWebContents = createBlankWebContents(adapterClient, browserContextAdapter);
     content::NavigationController &controller = newWebContents->GetController();
     controller.Restore(currentIndex, content::NavigationController::RESTORE_LAST_SESSION_EXITED_CLEANLY, &entries);
 
@@ -344,8 +400,18 @@ WebContentsAdapter::WebContentsAdapter(content::WebContents *webContents)
     d->webContents.reset(webContents);
 }
 
+WebContentsAdapter::WebContentsAdapter(BrowserContextAdapter *browserContextAdapter)
+    : d_ptr(new WebContentsAdapterPrivate)
+{
+    Q_D(WebContentsAdapter);
+    d->browserContextAdapter = browserContextAdapter;
+}
+
 WebContentsAdapter::~WebContentsAdapter()
 {
+    Q_D(WebContentsAdapter);
+    if (d->webContents)
+        URLRequestContentJobQt::releaseOwner(d->webContents.get());
 }
 
 void WebContentsAdapter::initialize(WebContentsAdapterClient *adapterClient)
@@ -355,7 +421,7 @@ void WebContentsAdapter::initialize(WebContentsAdapterClient *adapterClient)
 
     // Create our own if a WebContents wasn't provided at construction.
     if (!d->webContents)
-        d->webContents.reset(createBlankWebContents(adapterClient));
+        d->webContents.reset(createBlankWebContents(adapterClient, d->browserContextAdapter));
 
     content::RendererPreferences* rendererPrefs = d->webContents->GetMutableRendererPrefs();
     rendererPrefs->use_custom_colors = true;
@@ -418,12 +484,21 @@ void WebContentsAdapter::stop()
         controller.RemoveEntryAtIndex(index);
 
     d->webContents->Stop();
+    URLRequestContentJobQt::releaseUnreachableContent(d->webContents.get());
     d->webContents->GetView()->Focus();
 }
 
 void WebContentsAdapter::reload()
 {
     Q_D(WebContentsAdapter);
+    // A plain reload would fetch the base URL, registered content has to be expected by a new navigation.
+    content::NavigationEntry *entry = d->webContents->GetController().GetActiveEntry();
+    QByteArray contentId;
+    if (registeredContentId(entry, &contentId)) {
+        loadRegisteredContent(d->webContents.get(), contentId, entry->GetURL(), content::PAGE_TRANSITION_RELOAD);
+        d->webContents->GetView()->Focus();
+        return;
+    }
     d->webContents->GetController().Reload(/*checkRepost = */false);
     d->webContents->GetView()->Focus();
 }
@@ -440,6 +515,22 @@ void WebContentsAdapter::load(const QUrl &url)
 void WebContentsAdapter::setContent(const QByteArray &data, const QString &mimeType, const QUrl &baseUrl)
 {
     Q_D(WebContentsAdapter);
+    // Large content is served from memory in place of its base URL, which needs a URL going through the network stack.
+    // Without a base URL, it gets a URL of its own that can't resolve, and as unique an origin as a data: URL.
+    if (data.size() >= kSetContentDataUrlLimit && (baseUrl.isEmpty() || (baseUrl.isValid() && !baseUrl.isRelative()
+            && baseUrl.scheme() != QLatin1String("about") && baseUrl.scheme() != QLatin1String("data")))) {
+        const GURL url = baseUrl.isEmpty()
+                ? GURL("http://" + QString::number(base::RandUint64(), 16).toStdString() + ".content.qt.invalid/")
+                : toGurl(baseUrl);
+        QByteArray contentId = URLRequestContentJobQt::registerContent(d->webContents.get(), url, data, mimeType);
+        loadRegisteredContent(d->webContents.get(), contentId, url, content::PAGE_TRANSITION_TYPED);
+        // Show the same URL as the data: URL path does.
+        content::NavigationEntry *entry = d->webContents->GetController().GetPendingEntry();
+        if (baseUrl.isEmpty() && entry)
+            entry->SetVirtualURL(GURL(content::kAboutBlankURL));
+        return;
+    }
+
     QByteArray encodedData = data.toPercentEncoding();
     std::string urlString("data:");
     urlString.append(mimeType.toStdString());
@@ -528,6 +619,7 @@ void WebContentsAdapter::selectAll()
 void WebContentsAdapter::navigateToIndex(int offset)
 {
     Q_D(WebContentsAdapter);
+    expectHistoryContent(d->webContents.get(), d->webContents->GetController().GetEntryAtIndex(offset));
     d->webContents->GetController().GoToIndex(offset);
     d->webContents->GetView()->Focus();
 }
@@ -535,6 +627,7 @@ void WebContentsAdapter::navigateToIndex(int offset)
 void WebContentsAdapter::navigateToOffset(int offset)
 {
     Q_D(WebContentsAdapter);
+    expectHistoryContent(d->webContents.get(), d->webContents->GetController().GetEntryAtOffset(offset));
     d->webContents->GetController().GoToOffset(offset);
     d->webContents->GetView()->Focus();
 }
@@ -604,6 +697,44 @@ qreal WebContentsAdapter::currentZoomFactor() const
     return static_cast<qreal>(content::ZoomLevelToZoomFactor(d->webContents->GetZoomLevel()));
 }
 
+void WebContentsAdapter::setSoftwareCompositingEnabled(bool enabled)
+{
+    Q_D(WebContentsAdapter);
+    content::RendererPreferences* rendererPrefs = d->webContents->GetMutableRendererPrefs();
+    if (rendererPrefs->use_software_compositing == enabled)
+        return;
+    // Headless views can only keep software frames.
+    if (!enabled && headlessViewportSize().isValid())
+        return;
+    // The RenderWidgetHostViewQt switches its delegate once it receives frames of the other kind.
+    rendererPrefs->use_software_compositing = enabled;
+    d->webContents->GetRenderViewHost()->SyncRendererPrefs();
+}
+
+bool WebContentsAdapter::softwareCompositingEnabled() const
+{
+    Q_D(const WebContentsAdapter);
+    return d->webContents->GetMutableRendererPrefs()->use_software_compositing;
+}
+
+void WebContentsAdapter::setHeadlessViewportSize(const QSize &size)
+{
+    Q_D(WebContentsAdapter);
+    if (!size.isValid())
+        return;
+    // Software frames stay in shared memory until grabbed, which keeps offscreen pages from holding any GPU memory.
+    setSoftwareCompositingEnabled(true);
+    WebContentsViewQt::from(d->webContents->GetView())->setHeadlessViewportSize(size);
+    if (RenderWidgetHostViewQt *rwhv = static_cast<RenderWidgetHostViewQt *>(d->webContents->GetRenderWidgetHostView()))
+        rwhv->setHeadless(size);
+}
+
+QSize WebContentsAdapter::headlessViewportSize() const
+{
+    Q_D(const WebContentsAdapter);
+    return WebContentsViewQt::from(d->webContents->GetView())->headlessViewportSize();
+}
+
 void WebContentsAdapter::enableInspector(bool enable)
 {
     ContentBrowserClientQt::Get()->enableInspector(enable);
@@ -629,17 +760,24 @@ quint64 WebContentsAdapter::runJavaScriptCallbackResult(const QString &javaScrip
     return d->lastRequestId;
 }
 
-quint64 WebContentsAdapter::fetchDocumentMarkup()
+quint64 WebContentsAdapter::fetchDocumentMarkup(bool streamed)
 {
     Q_D(WebContentsAdapter);
-    d->renderViewObserverHost->fetchDocumentMarkup(++d->lastRequestId);
+    d->renderViewObserverHost->fetchDocumentMarkup(++d->lastRequestId, streamed);
     return d->lastRequestId;
 }
 
-quint64 WebContentsAdapter::fetchDocumentInnerText()
+quint64 WebContentsAdapter::fetchDocumentInnerText(bool streamed)
 {
     Q_D(WebContentsAdapter);
-    d->renderViewObserverHost->fetchDocumentInnerText(++d->lastRequestId);
+    d->renderViewObserverHost->fetchDocumentInnerText(++d->lastRequestId, streamed);
+    return d->lastRequestId;
+}
+
+quint64 WebContentsAdapter::fetchDocumentTextNodes()
+{
+    Q_D(WebContentsAdapter);
+    d->renderViewObserverHost->fetchDocumentTextNodes(++d->lastRequestId);
     return d->lastRequestId;
 }
 
@@ -659,6 +797,17 @@ quint64 WebContentsAdapter::findText(const QString &subString, bool caseSensitiv
     return shrunkRequestId;
 }
 
+quint64 WebContentsAdapter::grabToImage(const QRect &rect, qreal scale)
+{
+    Q_D(WebContentsAdapter);
+    base::Callback<void(const QImage &)> callback = base::Bind(&callbackOnGrabImage, d->adapterClient, ++d->lastRequestId);
+    if (RenderWidgetHostViewQt *rwhv = static_cast<RenderWidgetHostViewQt *>(d->webContents->GetRenderWidgetHostView()))
+        rwhv->grabToImage(rect, scale, callback);
+    else
+        content::BrowserThread::PostTask(content::BrowserThread::UI, FROM_HERE, base::Bind(callback, QImage()));
+    return d->lastRequestId;
+}
+
 void WebContentsAdapter::stopFinding()
 {
     Q_D(WebContentsAdapter);
@@ -705,3 +854,31 @@ void WebContentsAdapter::filesSelectedInChooser(const QStringList &fileList, Web
         files = listRecursively(QDir(fileList.first()));
     rvh->FilesSelectedInChooser(toVector<ui::SelectedFileInfo>(files), static_cast<content::FileChooserParams::Mode>(mode));
 }
+
+QVariantMap WebContentsAdapter::frameStatistics() const
+{
+    Q_D(const WebContentsAdapter);
+    if (RenderWidgetHostViewQt *rwhv = static_cast<RenderWidgetHostViewQt *>(d->webContents->GetRenderWidgetHostView()))
+        return rwhv->frameStatistics()->toVariantMap();
+    return QVariantMap();
+}
+
+QVariantMap WebContentsAdapter::startupStatistics() const
+{
+    Q_D(const WebContentsAdapter);
+    QVariantMap result;
+    content::RenderProcessHost *host = d->webContents->GetRenderProcessHost();
+    RendererProcessPoolQt *pool = static_cast<BrowserContextQt*>(d->webContents->GetBrowserContext())->rendererProcessPool();
+    result.insert(QStringLiteral("spareProcess"), pool->isSpareProcess(host->GetID()));
+    // Times are left out until they are known.
+    const base::TimeDelta launchTime = pool->processLaunchTime(host->GetID());
+    if (launchTime != base::TimeDelta())
+        result.insert(QStringLiteral("processLaunch"), launchTime.InMillisecondsF());
+    const base::TimeDelta firstCommit = d->webContentsDelegate->timeToFirstCommit();
+    if (firstCommit != base::TimeDelta())
+        result.insert(QStringLiteral("firstCommit"), firstCommit.InMillisecondsF());
+    const base::TimeDelta firstPaint = d->webContentsDelegate->timeToFirstPaint();
+    if (firstPaint != base::TimeDelta())
+        result.insert(QStringLiteral("firstPaint"), firstPaint.InMillisecondsF());
+    return result;
+}
@@ -48,17 +48,21 @@
 #include <QSharedData>
 #include <QString>
 #include <QUrl>
+#include <QVariantMap>
 
 namespace content {
 class WebContents;
 }
+class BrowserContextAdapter;
 class WebContentsAdapterPrivate;
 
 class QWEBENGINE_EXPORT WebContentsAdapter : public QSharedData {
 public:
-    static QExplicitlySharedDataPointer<WebContentsAdapter> createFromSerializedNavigationHistory(QDataStream &input, WebContentsAdapterClient *adapterClient);
+    static QExplicitlySharedDataPointer<WebContentsAdapter> createFromSerializedNavigationHistory(QDataStream &input, WebContentsAdapterClient *adapterClient, BrowserContextAdapter *browserContextAdapter);
     // Takes ownership of the WebContents.
     WebContentsAdapter(content::WebContents *webContents = 0);
+    // The WebContents is created in |browserContextAdapter| by initialize().
+    explicit WebContentsAdapter(BrowserContextAdapter *browserContextAdapter);
     ~WebContentsAdapter();
     void initialize(WebContentsAdapterClient *adapterClient);
     void reattachRWHV();
@@ -95,13 +99,23 @@ public:
     void serializeNavigationHistory(QDataStream &output);
     void setZoomFactor(qreal);
     qreal currentZoomFactor() const;
+    // Takes effect the next time the renderer creates its compositor output surface.
+    void setSoftwareCompositingEnabled(bool);
+    bool softwareCompositingEnabled() const;
+    // Renders offscreen from now on, without any window nor GL context. Implies software compositing.
+    void setHeadlessViewportSize(const QSize &);
+    QSize headlessViewportSize() const;
     void enableInspector(bool);
     void filesSelectedInChooser(const QStringList &fileList, WebContentsAdapterClient::FileChooserMode);
     void runJavaScript(const QString &javaScript);
     quint64 runJavaScriptCallbackResult(const QString &javaScript);
-    quint64 fetchDocumentMarkup();
-    quint64 fetchDocumentInnerText();
+    // Streamed fetches report chunks through didFetchDocumentChunk instead of one result at the end.
+    quint64 fetchDocumentMarkup(bool streamed = false);
+    quint64 fetchDocumentInnerText(bool streamed = false);
+    quint64 fetchDocumentTextNodes();
     quint64 findText(const QString &subString, bool caseSensitively, bool findBackward);
+    // A null rect grabs the whole viewport.
+    quint64 grabToImage(const QRect &rect, qreal scale);
     void stopFinding();
 
     void wasShown();
@@ -110,6 +124,12 @@ public:
 
     void dpiScaleChanged();
 
+    // See FrameStatistics::toVariantMap for the layout.
+    QVariantMap frameStatistics() const;
+    // Process launch time of the current renderer, whether it came from the spare pool,
+    // and milliseconds from the first navigation request to its commit and first paint.
+    QVariantMap startupStatistics() const;
+
 private:
     Q_DISABLE_COPY(WebContentsAdapter);
     Q_DECLARE_PRIVATE(WebContentsAdapter);
@@ -50,6 +50,7 @@
 #include <QStringList>
 #include <QUrl>
 
+QT_FORWARD_DECLARE_CLASS(QImage)
 QT_FORWARD_DECLARE_CLASS(QVariant)
 
 class JavaScriptDialogController;
@@ -127,6 +128,8 @@ public:
 
     virtual RenderWidgetHostViewQtDelegate* CreateRenderWidgetHostViewQtDelegate(RenderWidgetHostViewQtDelegateClient *client) = 0;
     virtual RenderWidgetHostViewQtDelegate* CreateRenderWidgetHostViewQtDelegateForPopup(RenderWidgetHostViewQtDelegateClient *client) = 0;
+    // Can return 0 if the client doesn't support software compositing.
+    virtual RenderWidgetHostViewQtDelegate* CreateRenderWidgetHostViewQtDelegateForSoftwareCompositing(RenderWidgetHostViewQtDelegateClient *client) = 0;
     virtual void titleChanged(const QString&) = 0;
     virtual void urlChanged(const QUrl&) = 0;
     virtual void iconChanged(const QUrl&) = 0;
@@ -150,7 +153,12 @@ public:
     virtual void didRunJavaScript(quint64 requestId, const QVariant& result) = 0;
     virtual void didFetchDocumentMarkup(quint64 requestId, const QString& result) = 0;
     virtual void didFetchDocumentInnerText(quint64 requestId, const QString& result) = 0;
+    // Delivers streamed markup or text, |last| is set on the final chunk.
+    virtual void didFetchDocumentChunk(quint64 requestId, const QString& chunk, bool last) = 0;
+    // |result| is a map of the concatenated "text" with the "offsets" and child index "paths" of its text nodes.
+    virtual void didFetchDocumentTextNodes(quint64 requestId, const QVariant& result) = 0;
     virtual void didFindText(quint64 requestId, int matchCount) = 0;
+    virtual void didGrabImage(quint64 requestId, const QImage &image) = 0;
     virtual void passOnFocus(bool reverse) = 0;
     virtual void javaScriptConsoleMessage(JavaScriptConsoleMessageLevel level, const QString& message, int lineNumber, const QString& sourceID) = 0;
     virtual void authenticationRequired(const QUrl &requestUrl, const QString &realm, bool isProxy, const QString &challengingHost, QString *outUser, QString *outPassword) = 0;
@@ -47,6 +47,7 @@
 
 #include "media_capture_devices_dispatcher.h"
 #include "type_conversion.h"
+#include "url_request_content_job_qt.h"
 #include "web_contents_adapter.h"
 #include "web_contents_adapter_client.h"
 #include "web_engine_context.h"
@@ -54,6 +55,7 @@
 #include "content/public/browser/favicon_status.h"
 #include "content/public/browser/invalidate_type.h"
 #include "content/public/browser/navigation_entry.h"
+#include "content/public/browser/render_process_host.h"
 #include "content/public/browser/render_view_host.h"
 #include "content/public/browser/web_contents.h"
 #include "content/public/common/favicon_url.h"
@@ -145,6 +147,9 @@ void WebContentsDelegateQt::DidCommitProvisionalLoadForFrame(int64 frame_id, con
     // Make sure that we don't set the findNext WebFindOptions on a new frame.
     m_lastSearchedString = QString();
 
+    if (is_main_frame && !m_firstNavigationTime.is_null() && m_firstCommitTime.is_null())
+        m_firstCommitTime = base::TimeTicks::Now();
+
     // This is currently used for canGoBack/Forward values, which is flattened across frames. For other purposes we might have to pass is_main_frame.
     m_viewClient->loadCommitted();
 }
@@ -251,3 +256,47 @@ void WebContentsDelegateQt::UpdateTargetURL(content::WebContents *source, int32
     Q_UNUSED(page_id)
     m_viewClient->didUpdateTargetURL(toQt(url));
 }
+
+void WebContentsDelegateQt::DidStartNavigationToPendingEntry(const GURL &, content::NavigationController::ReloadType)
+{
+    if (m_firstNavigationTime.is_null())
+        m_firstNavigationTime = base::TimeTicks::Now();
+}
+
+void WebContentsDelegateQt::DidFirstVisuallyNonEmptyPaint(int32)
+{
+    // Paints of the initial empty document don't count.
+    if (!m_firstCommitTime.is_null() && m_firstPaintTime.is_null())
+        m_firstPaintTime = base::TimeTicks::Now();
+}
+
+void WebContentsDelegateQt::RenderViewCreated(content::RenderViewHost *render_view_host)
+{
+    // Requests for content given to setContent are matched to this WebContents through its render views.
+    URLRequestContentJobQt::addRenderView(web_contents(), render_view_host->GetProcess()->GetID(), render_view_host->GetRoutingID());
+}
+
+void WebContentsDelegateQt::RenderViewDeleted(content::RenderViewHost *render_view_host)
+{
+    URLRequestContentJobQt::removeRenderView(render_view_host->GetProcess()->GetID(), render_view_host->GetRoutingID());
+}
+
+void WebContentsDelegateQt::NavigationEntryCommitted(const content::LoadCommittedDetails &)
+{
+    // Commits replace and prune navigation entries, drop the content only they could reload.
+    URLRequestContentJobQt::releaseUnreachableContent(web_contents());
+}
+
+base::TimeDelta WebContentsDelegateQt::timeToFirstCommit() const
+{
+    if (m_firstCommitTime.is_null())
+        return base::TimeDelta();
+    return m_firstCommitTime - m_firstNavigationTime;
+}
+
+base::TimeDelta WebContentsDelegateQt::timeToFirstPaint() const
+{
+    if (m_firstPaintTime.is_null())
+        return base::TimeDelta();
+    return m_firstPaintTime - m_firstNavigationTime;
+}
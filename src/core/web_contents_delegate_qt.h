@@ -42,6 +42,8 @@
 #ifndef WEB_CONTENTS_DELEGATE_QT_H
 #define WEB_CONTENTS_DELEGATE_QT_H
 
+#include "base/time/time.h"
+#include "content/public/browser/navigation_controller.h"
 #include "content/public/browser/web_contents_delegate.h"
 #include "content/public/browser/web_contents_observer.h"
 
@@ -84,10 +86,22 @@ public:
     virtual void FindReply(content::WebContents *source, int request_id, int number_of_matches, const gfx::Rect& selection_rect, int active_match_ordinal, bool final_update) Q_DECL_OVERRIDE;
     virtual void RequestMediaAccessPermission(content::WebContents* web_contents, const content::MediaStreamRequest& request, const content::MediaResponseCallback& callback) Q_DECL_OVERRIDE;
     virtual void UpdateTargetURL(content::WebContents *source, int32 page_id, const GURL &url) Q_DECL_OVERRIDE;
+    virtual void DidStartNavigationToPendingEntry(const GURL &url, content::NavigationController::ReloadType reload_type) Q_DECL_OVERRIDE;
+    virtual void DidFirstVisuallyNonEmptyPaint(int32 page_id) Q_DECL_OVERRIDE;
+    virtual void RenderViewCreated(content::RenderViewHost *render_view_host) Q_DECL_OVERRIDE;
+    virtual void RenderViewDeleted(content::RenderViewHost *render_view_host) Q_DECL_OVERRIDE;
+    virtual void NavigationEntryCommitted(const content::LoadCommittedDetails &load_details) Q_DECL_OVERRIDE;
+
+    // Measured from the first navigation, zero until it happened.
+    base::TimeDelta timeToFirstCommit() const;
+    base::TimeDelta timeToFirstPaint() const;
 
 private:
     WebContentsAdapterClient *m_viewClient;
     QString m_lastSearchedString;
+    base::TimeTicks m_firstNavigationTime;
+    base::TimeTicks m_firstCommitTime;
+    base::TimeTicks m_firstPaintTime;
 };
 
 #endif // WEB_CONTENTS_DELEGATE_QT_H
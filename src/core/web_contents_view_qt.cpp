@@ -63,8 +63,12 @@ content::RenderWidgetHostView* WebContentsViewQt::CreateViewForWidget(content::R
 {
     RenderWidgetHostViewQt *view = new RenderWidgetHostViewQt(render_widget_host);
 
-    Q_ASSERT(m_factoryClient);
-    view->setDelegate(m_factoryClient->CreateRenderWidgetHostViewQtDelegate(view));
+    if (m_headlessViewportSize.isValid())
+        view->setHeadless(m_headlessViewportSize);
+    else {
+        Q_ASSERT(m_factoryClient);
+        view->setDelegate(m_factoryClient->CreateRenderWidgetHostViewQtDelegate(view));
+    }
     if (m_client)
         view->setAdapterClient(m_client);
     // Tell the RWHV delegate to attach itself to the native view container.
@@ -99,6 +103,10 @@ gfx::NativeView WebContentsViewQt::GetNativeView() const
 
 void WebContentsViewQt::GetContainerBounds(gfx::Rect* out) const
 {
+    if (m_headlessViewportSize.isValid()) {
+        *out = gfx::Rect(m_headlessViewportSize.width(), m_headlessViewportSize.height());
+        return;
+    }
     const QRectF r(m_client->viewportRect());
     *out = gfx::Rect(r.x(), r.y(), r.width(), r.height());
 }
@@ -69,6 +69,10 @@ public:
     void initialize(WebContentsAdapterClient* client);
     WebContentsAdapterClient *client() { return m_client; }
 
+    // Views created from now on render offscreen, with the given viewport size.
+    void setHeadlessViewportSize(const QSize &size) { m_headlessViewportSize = size; }
+    QSize headlessViewportSize() const { return m_headlessViewportSize; }
+
     virtual content::RenderWidgetHostView *CreateViewForWidget(content::RenderWidgetHost* render_widget_host) Q_DECL_OVERRIDE;
 
     virtual void CreateView(const gfx::Size& initial_size, gfx::NativeView context) Q_DECL_OVERRIDE;
@@ -129,6 +133,7 @@ private:
     content::WebContents *m_webContents;
     WebContentsAdapterClient *m_client;
     WebContentsAdapterClient *m_factoryClient;
+    QSize m_headlessViewportSize;
 };
 
 #endif // WEB_CONTENTS_VIEW_QT_H
@@ -42,9 +42,58 @@
 
 #include <QtQuick/qsgtexture.h>
 
+// These values are magic numbers that are used in the transformation from YUV
+// to RGB color values. The limited range ones are scaled up to [0, 255].
+static void colorConversion(YUVVideoMaterial::ColorSpace colorSpace, YUVVideoMaterial::ColorRange colorRange,
+                            QMatrix3x3 *yuvMatrix, QVector3D *yuvAdjust)
+{
+    // http://www.fourcc.org/fccyvrgb.php
+    static const float yuv_to_rgb_rec601[9] = {
+        1.164f, 0.0f, 1.596f,
+        1.164f, -.391f, -.813f,
+        1.164f, 2.018f, 0.0f,
+    };
+    // JPEG's JFIF variant of Rec. 601 uses the full range.
+    static const float yuv_to_rgb_rec601_full[9] = {
+        1.0f, 0.0f, 1.402f,
+        1.0f, -.344f, -.714f,
+        1.0f, 1.772f, 0.0f,
+    };
+    // ITU-R BT.709, used by HD video.
+    static const float yuv_to_rgb_rec709[9] = {
+        1.164f, 0.0f, 1.793f,
+        1.164f, -.213f, -.533f,
+        1.164f, 2.112f, 0.0f,
+    };
+    static const float yuv_to_rgb_rec709_full[9] = {
+        1.0f, 0.0f, 1.575f,
+        1.0f, -.187f, -.468f,
+        1.0f, 1.856f, 0.0f,
+    };
+
+    const bool fullRange = colorRange == YUVVideoMaterial::FullRange;
+    if (colorSpace == YUVVideoMaterial::BT709)
+        *yuvMatrix = QMatrix3x3(fullRange ? yuv_to_rgb_rec709_full : yuv_to_rgb_rec709);
+    else
+        *yuvMatrix = QMatrix3x3(fullRange ? yuv_to_rgb_rec601_full : yuv_to_rgb_rec601);
+
+    // These values map to 16, 128, and 128 respectively, and are computed
+    // as a fraction over 256 (e.g. 16 / 256 = 0.0625).
+    // They are used in the YUV to RGBA conversion formula:
+    //   Y - 16   : Gives 16 values of head and footroom for overshooting
+    //   U - 128  : Turns unsigned U into signed U [-128,127]
+    //   V - 128  : Turns unsigned V into signed V [-128,127]
+    // The full range has no head and footroom.
+    *yuvAdjust = QVector3D(fullRange ? 0.0f : -0.0625f, -0.5f, -0.5f);
+}
+
 class YUVVideoMaterialShader : public QSGMaterialShader
 {
 public:
+    YUVVideoMaterialShader(bool biPlanar)
+        : m_biPlanar(biPlanar)
+    { }
+
     virtual void updateState(const RenderState &state, QSGMaterial *newMaterial, QSGMaterial *oldMaterial) Q_DECL_OVERRIDE;
 
     virtual char const *const *attributeNames() const Q_DECL_OVERRIDE {
@@ -90,20 +139,37 @@ protected:
         "  lowp vec3 rgb = yuv_matrix * yuv;\n"
         "  gl_FragColor = vec4(rgb, 1.0) * alpha;\n"
         "}";
-        return shader;
+        // The interleaved chroma plane is a GL_LUMINANCE_ALPHA texture to stay
+        // compatible with OpenGL ES 2, U ends up in .r and V in .a.
+        static const char *biPlanarShader =
+        "varying mediump vec2 v_texCoord;\n"
+        "uniform sampler2D y_texture;\n"
+        "uniform sampler2D uv_texture;\n"
+        "uniform lowp float alpha;\n"
+        "uniform lowp vec3 yuv_adj;\n"
+        "uniform lowp mat3 yuv_matrix;\n"
+        "void main() {\n"
+        "  lowp float y_raw = texture2D(y_texture, v_texCoord).x;\n"
+        "  lowp vec2 uv_unsigned = texture2D(uv_texture, v_texCoord).xw;\n"
+        "  lowp vec3 yuv = vec3(y_raw, uv_unsigned) + yuv_adj;\n"
+        "  lowp vec3 rgb = yuv_matrix * yuv;\n"
+        "  gl_FragColor = vec4(rgb, 1.0) * alpha;\n"
+        "}";
+        return m_biPlanar ? biPlanarShader : shader;
     }
 
     virtual void initialize() Q_DECL_OVERRIDE {
         m_id_matrix = program()->uniformLocation("matrix");
         m_id_texScale = program()->uniformLocation("texScale");
         m_id_yTexture = program()->uniformLocation("y_texture");
-        m_id_uTexture = program()->uniformLocation("u_texture");
-        m_id_vTexture = program()->uniformLocation("v_texture");
+        m_id_uTexture = program()->uniformLocation(m_biPlanar ? "uv_texture" : "u_texture");
+        m_id_vTexture = m_biPlanar ? -1 : program()->uniformLocation("v_texture");
         m_id_yuvMatrix = program()->uniformLocation("yuv_matrix");
         m_id_yuvAdjust = program()->uniformLocation("yuv_adj");
         m_id_opacity = program()->uniformLocation("alpha");
     }
 
+    bool m_biPlanar;
     int m_id_matrix;
     int m_id_texScale;
     int m_id_yTexture;
@@ -116,6 +182,11 @@ protected:
 
 class YUVAVideoMaterialShader : public YUVVideoMaterialShader
 {
+public:
+    YUVAVideoMaterialShader()
+        : YUVVideoMaterialShader(false)
+    { }
+
     virtual void updateState(const RenderState &state, QSGMaterial *newMaterial, QSGMaterial *oldMaterial) Q_DECL_OVERRIDE;
 
 protected:
@@ -155,41 +226,36 @@ protected:
 
 void YUVVideoMaterialShader::updateState(const RenderState &state, QSGMaterial *newMaterial, QSGMaterial *oldMaterial)
 {
-    Q_UNUSED(oldMaterial);
-
     YUVVideoMaterial *mat = static_cast<YUVVideoMaterial *>(newMaterial);
-    program()->setUniformValue(m_id_yTexture, 0);
-    program()->setUniformValue(m_id_uTexture, 1);
-    program()->setUniformValue(m_id_vTexture, 2);
+    // The program keeps its uniforms while it stays in use, oldMaterial is only set
+    // if the previous material was drawn with this same program.
+    YUVVideoMaterial *old = static_cast<YUVVideoMaterial *>(oldMaterial);
+    if (!old) {
+        program()->setUniformValue(m_id_yTexture, 0);
+        program()->setUniformValue(m_id_uTexture, 1);
+        if (!m_biPlanar)
+            program()->setUniformValue(m_id_vTexture, 2);
+    }
 
     glActiveTexture(GL_TEXTURE1);
     mat->m_uTexture->bind();
-    glActiveTexture(GL_TEXTURE2);
-    mat->m_vTexture->bind();
+    if (!m_biPlanar) {
+        glActiveTexture(GL_TEXTURE2);
+        mat->m_vTexture->bind();
+    }
     glActiveTexture(GL_TEXTURE0); // Finish with 0 as default texture unit
     mat->m_yTexture->bind();
 
-    program()->setUniformValue(m_id_texScale, mat->m_texScale);
-
-    // These values are magic numbers that are used in the transformation from YUV
-    // to RGB color values.  They are taken from the following webpage:
-    // http://www.fourcc.org/fccyvrgb.php
-    const float yuv_to_rgb[9] = {
-        1.164f, 0.0f, 1.596f,
-        1.164f, -.391f, -.813f,
-        1.164f, 2.018f, 0.0f,
-    };
-    const QMatrix3x3 yuvMatrix(yuv_to_rgb);
+    if (!old || old->m_texScale != mat->m_texScale)
+        program()->setUniformValue(m_id_texScale, mat->m_texScale);
 
-    // These values map to 16, 128, and 128 respectively, and are computed
-    // as a fraction over 256 (e.g. 16 / 256 = 0.0625).
-    // They are used in the YUV to RGBA conversion formula:
-    //   Y - 16   : Gives 16 values of head and footroom for overshooting
-    //   U - 128  : Turns unsigned U into signed U [-128,127]
-    //   V - 128  : Turns unsigned V into signed V [-128,127]
-    const QVector3D yuvAdjust(-0.0625f, -0.5f, -0.5f);
-    program()->setUniformValue(m_id_yuvMatrix, yuvMatrix);
-    program()->setUniformValue(m_id_yuvAdjust, yuvAdjust);
+    if (!old || old->m_colorSpace != mat->m_colorSpace || old->m_colorRange != mat->m_colorRange) {
+        QMatrix3x3 yuvMatrix;
+        QVector3D yuvAdjust;
+        colorConversion(mat->m_colorSpace, mat->m_colorRange, &yuvMatrix, &yuvAdjust);
+        program()->setUniformValue(m_id_yuvMatrix, yuvMatrix);
+        program()->setUniformValue(m_id_yuvAdjust, yuvAdjust);
+    }
 
     if (state.isOpacityDirty())
         program()->setUniformValue(m_id_opacity, state.opacity());
@@ -203,7 +269,8 @@ void YUVAVideoMaterialShader::updateState(const RenderState &state, QSGMaterial
     YUVVideoMaterialShader::updateState(state, newMaterial, oldMaterial);
 
     YUVAVideoMaterial *mat = static_cast<YUVAVideoMaterial *>(newMaterial);
-    program()->setUniformValue(m_id_aTexture, 3);
+    if (!oldMaterial)
+        program()->setUniformValue(m_id_aTexture, 3);
 
     glActiveTexture(GL_TEXTURE3);
     mat->m_aTexture->bind();
@@ -213,17 +280,20 @@ void YUVAVideoMaterialShader::updateState(const RenderState &state, QSGMaterial
 }
 
 
-YUVVideoMaterial::YUVVideoMaterial(QSGTexture *yTexture, QSGTexture *uTexture, QSGTexture *vTexture, const QSizeF &texScale)
+YUVVideoMaterial::YUVVideoMaterial(QSGTexture *yTexture, QSGTexture *uTexture, QSGTexture *vTexture, const QSizeF &texScale,
+                                   ColorSpace colorSpace, ColorRange colorRange)
     : m_yTexture(yTexture)
     , m_uTexture(uTexture)
     , m_vTexture(vTexture)
     , m_texScale(texScale)
+    , m_colorSpace(colorSpace)
+    , m_colorRange(colorRange)
 {
 }
 
 QSGMaterialShader *YUVVideoMaterial::createShader() const
 {
-    return new YUVVideoMaterialShader;
+    return new YUVVideoMaterialShader(isBiPlanar());
 }
 
 int YUVVideoMaterial::compare(const QSGMaterial *other) const
@@ -233,13 +303,19 @@ int YUVVideoMaterial::compare(const QSGMaterial *other) const
         return diff;
     if (int diff = m_uTexture->textureId() - m->m_uTexture->textureId())
         return diff;
-    return m_vTexture->textureId() - m->m_vTexture->textureId();
+    if (int diff = (m_vTexture ? m_vTexture->textureId() : 0) - (m->m_vTexture ? m->m_vTexture->textureId() : 0))
+        return diff;
+    if (int diff = m_colorSpace - m->m_colorSpace)
+        return diff;
+    return m_colorRange - m->m_colorRange;
 }
 
-YUVAVideoMaterial::YUVAVideoMaterial(QSGTexture *yTexture, QSGTexture *uTexture, QSGTexture *vTexture, QSGTexture *aTexture, const QSizeF &texScale)
-    : YUVVideoMaterial(yTexture, uTexture, vTexture, texScale)
+YUVAVideoMaterial::YUVAVideoMaterial(QSGTexture *yTexture, QSGTexture *uTexture, QSGTexture *vTexture, QSGTexture *aTexture, const QSizeF &texScale,
+                                     ColorSpace colorSpace, ColorRange colorRange)
+    : YUVVideoMaterial(yTexture, uTexture, vTexture, texScale, colorSpace, colorRange)
     , m_aTexture(aTexture)
 {
+    Q_ASSERT(vTexture);
     setFlag(Blending, aTexture);
 }
 
@@ -256,15 +332,16 @@ int YUVAVideoMaterial::compare(const QSGMaterial *other) const
     return (m_aTexture ? m_aTexture->textureId() : 0) - (m->m_aTexture ? m->m_aTexture->textureId() : 0);
 }
 
-YUVVideoNode::YUVVideoNode(QSGTexture *yTexture, QSGTexture *uTexture, QSGTexture *vTexture, QSGTexture *aTexture, const QSizeF &texScale)
+YUVVideoNode::YUVVideoNode(QSGTexture *yTexture, QSGTexture *uTexture, QSGTexture *vTexture, QSGTexture *aTexture, const QSizeF &texScale,
+                           YUVVideoMaterial::ColorSpace colorSpace, YUVVideoMaterial::ColorRange colorRange)
     : m_geometry(QSGGeometry::defaultAttributes_TexturedPoint2D(), 4)
 {
     setGeometry(&m_geometry);
     setFlag(QSGNode::OwnsMaterial);
     if (aTexture)
-        m_material = new YUVAVideoMaterial(yTexture, uTexture, vTexture, aTexture, texScale);
+        m_material = new YUVAVideoMaterial(yTexture, uTexture, vTexture, aTexture, texScale, colorSpace, colorRange);
     else
-        m_material = new YUVVideoMaterial(yTexture, uTexture, vTexture, texScale);
+        m_material = new YUVVideoMaterial(yTexture, uTexture, vTexture, texScale, colorSpace, colorRange);
     setMaterial(m_material);
 }
 
@@ -55,26 +55,47 @@ QT_END_NAMESPACE
 class YUVVideoMaterial : public QSGMaterial
 {
 public:
-    YUVVideoMaterial(QSGTexture *yTexture, QSGTexture *uTexture, QSGTexture *vTexture, const QSizeF &texScale);
+    enum ColorSpace {
+        BT601,
+        BT709
+    };
+    enum ColorRange {
+        LimitedRange, // Studio swing, Y in [16, 235] and UV in [16, 240].
+        FullRange
+    };
 
+    // Planar frames use one texture per plane. NV12 frames pass their interleaved
+    // chroma plane as a luminance-alpha uTexture and a null vTexture.
+    YUVVideoMaterial(QSGTexture *yTexture, QSGTexture *uTexture, QSGTexture *vTexture, const QSizeF &texScale,
+                     ColorSpace colorSpace = BT601, ColorRange colorRange = LimitedRange);
+
+    // The scene graph links one program per material type and render context, the color space
+    // and range are uniforms so that only the plane layout needs its own type.
     virtual QSGMaterialType *type() const Q_DECL_OVERRIDE {
-        static QSGMaterialType theType;
-        return &theType;
+        static QSGMaterialType planarType;
+        static QSGMaterialType biPlanarType;
+        return isBiPlanar() ? &biPlanarType : &planarType;
     }
 
     virtual QSGMaterialShader *createShader() const Q_DECL_OVERRIDE;
     virtual int compare(const QSGMaterial *other) const Q_DECL_OVERRIDE;
 
+    bool isBiPlanar() const { return !m_vTexture; }
+
     QSGTexture *m_yTexture;
     QSGTexture *m_uTexture;
     QSGTexture *m_vTexture;
     QSizeF m_texScale;
+    ColorSpace m_colorSpace;
+    ColorRange m_colorRange;
 };
 
+// Only planar, there is no two-plane layout with alpha.
 class YUVAVideoMaterial : public YUVVideoMaterial
 {
 public:
-    YUVAVideoMaterial(QSGTexture *yTexture, QSGTexture *uTexture, QSGTexture *vTexture, QSGTexture *aTexture, const QSizeF &texScale);
+    YUVAVideoMaterial(QSGTexture *yTexture, QSGTexture *uTexture, QSGTexture *vTexture, QSGTexture *aTexture, const QSizeF &texScale,
+                      ColorSpace colorSpace = BT601, ColorRange colorRange = LimitedRange);
 
     virtual QSGMaterialType *type() const Q_DECL_OVERRIDE{
         static QSGMaterialType theType;
@@ -90,7 +111,9 @@ public:
 class YUVVideoNode : public QSGGeometryNode
 {
 public:
-    YUVVideoNode(QSGTexture *yTexture, QSGTexture *uTexture, QSGTexture *vTexture, QSGTexture *aTexture, const QSizeF &texScale);
+    YUVVideoNode(QSGTexture *yTexture, QSGTexture *uTexture, QSGTexture *vTexture, QSGTexture *aTexture, const QSizeF &texScale,
+                 YUVVideoMaterial::ColorSpace colorSpace = YUVVideoMaterial::BT601,
+                 YUVVideoMaterial::ColorRange colorRange = YUVVideoMaterial::LimitedRange);
     void setRect(const QRectF &rect);
 
 private:
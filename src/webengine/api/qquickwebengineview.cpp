@@ -561,6 +561,16 @@ QQuickWebEngineHistory *QQuickWebEngineViewExperimental::navigationHistory() con
     return d_ptr->m_history.data();
 }
 
+QVariantMap QQuickWebEngineViewExperimental::frameStatistics() const
+{
+    return d_ptr->adapter->frameStatistics();
+}
+
+QVariantMap QQuickWebEngineViewExperimental::startupStatistics() const
+{
+    return d_ptr->adapter->startupStatistics();
+}
+
 void QQuickWebEngineViewExperimental::grantFeaturePermission(const QUrl &securityOrigin, QQuickWebEngineViewExperimental::Feature feature, bool granted)
 {
     if (!granted && feature >= MediaAudioDevices && feature <= MediaAudioVideoDevices) {
@@ -48,6 +48,7 @@
 #include <QScopedPointer>
 #include <QSharedData>
 #include <QString>
+#include <QVariantMap>
 #include <QtCore/qcompilerdetection.h>
 #include <QtQuick/private/qquickitem_p.h>
 
@@ -103,6 +104,8 @@ public:
     void setExtraContextMenuEntriesComponent(QQmlComponent *);
     QQmlComponent *extraContextMenuEntriesComponent() const;
     QQuickWebEngineHistory *navigationHistory() const;
+    Q_INVOKABLE QVariantMap frameStatistics() const;
+    Q_INVOKABLE QVariantMap startupStatistics() const;
 
 public Q_SLOTS:
     void goBackTo(int index);
@@ -139,6 +142,8 @@ public:
 
     virtual RenderWidgetHostViewQtDelegate* CreateRenderWidgetHostViewQtDelegate(RenderWidgetHostViewQtDelegateClient *client) Q_DECL_OVERRIDE;
     virtual RenderWidgetHostViewQtDelegate* CreateRenderWidgetHostViewQtDelegateForPopup(RenderWidgetHostViewQtDelegateClient *client) Q_DECL_OVERRIDE;
+    // The scene graph always composites our frames on the GPU.
+    virtual RenderWidgetHostViewQtDelegate* CreateRenderWidgetHostViewQtDelegateForSoftwareCompositing(RenderWidgetHostViewQtDelegateClient *) Q_DECL_OVERRIDE { return 0; }
     virtual void titleChanged(const QString&) Q_DECL_OVERRIDE;
     virtual void urlChanged(const QUrl&) Q_DECL_OVERRIDE;
     virtual void iconChanged(const QUrl&) Q_DECL_OVERRIDE;
@@ -162,7 +167,10 @@ public:
     virtual void didRunJavaScript(quint64, const QVariant&) Q_DECL_OVERRIDE;
     virtual void didFetchDocumentMarkup(quint64, const QString&) Q_DECL_OVERRIDE { }
     virtual void didFetchDocumentInnerText(quint64, const QString&) Q_DECL_OVERRIDE { }
+    virtual void didFetchDocumentChunk(quint64, const QString&, bool) Q_DECL_OVERRIDE { }
+    virtual void didFetchDocumentTextNodes(quint64, const QVariant&) Q_DECL_OVERRIDE { }
     virtual void didFindText(quint64, int) Q_DECL_OVERRIDE { }
+    virtual void didGrabImage(quint64, const QImage&) Q_DECL_OVERRIDE { }
     virtual void passOnFocus(bool reverse) Q_DECL_OVERRIDE;
     virtual void javaScriptConsoleMessage(JavaScriptConsoleMessageLevel level, const QString& message, int lineNumber, const QString& sourceID) Q_DECL_OVERRIDE;
     virtual void authenticationRequired(const QUrl&, const QString&, bool, const QString&, QString*, QString*) Q_DECL_OVERRIDE { }
@@ -216,10 +216,21 @@ void RenderWidgetHostViewQtDelegateQuick::geometryChanged(const QRectF &newGeome
 void RenderWidgetHostViewQtDelegateQuick::itemChange(ItemChange change, const ItemChangeData &value)
 {
     QQuickItem::itemChange(change, value);
+    if (change == QQuickItem::ItemSceneChange) {
+        disconnect(m_frameSwappedConnection);
+        // frameSwapped is emitted on the render thread, report it from there without waiting for the GUI thread.
+        if (value.window)
+            m_frameSwappedConnection = connect(value.window, &QQuickWindow::frameSwapped, this, &RenderWidgetHostViewQtDelegateQuick::onFrameSwapped, Qt::DirectConnection);
+    }
     if (m_initialized  && change == QQuickItem::ItemSceneChange)
         m_client->windowChanged();
 }
 
+void RenderWidgetHostViewQtDelegateQuick::onFrameSwapped()
+{
+    m_client->notifyFrameSwapped();
+}
+
 QSGNode *RenderWidgetHostViewQtDelegateQuick::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *)
 {
     return m_client->updatePaintNode(oldNode, QQuickWindowPrivate::get(QQuickItem::window())->context);
@@ -85,9 +85,13 @@ protected:
     virtual void itemChange(ItemChange change, const ItemChangeData &value) Q_DECL_OVERRIDE;
     virtual QSGNode *updatePaintNode(QSGNode *, UpdatePaintNodeData *) Q_DECL_OVERRIDE;
 
+private Q_SLOTS:
+    void onFrameSwapped();
+
 private:
     RenderWidgetHostViewQtDelegateClient *m_client;
     bool m_isPopup;
     bool m_initialized;
+    QMetaObject::Connection m_frameSwappedConnection;
 };
 #endif
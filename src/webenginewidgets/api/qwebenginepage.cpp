@@ -26,8 +26,10 @@
 #include "javascript_dialog_controller.h"
 #include "qwebenginehistory.h"
 #include "qwebenginehistory_p.h"
+#include "qwebengineprofile_p.h"
 #include "qwebengineview.h"
 #include "qwebengineview_p.h"
+#include "render_widget_host_view_qt_delegate_softwarewidget.h"
 #include "render_widget_host_view_qt_delegate_widget.h"
 #include "web_contents_adapter.h"
 
@@ -36,6 +38,7 @@
 #include <QClipboard>
 #include <QFileDialog>
 #include <QIcon>
+#include <QImage>
 #include <QInputDialog>
 #include <QLayout>
 #include <QMenu>
@@ -76,6 +79,9 @@ CallbackDirectory::~CallbackDirectory()
         case CallbackSharedDataPointer::Bool:
             (*sharedPtr.boolCallback)(false);
             break;
+        case CallbackSharedDataPointer::Image:
+            (*sharedPtr.imageCallback)(QImage());
+            break;
         default:
             Q_UNREACHABLE();
         }
@@ -97,6 +103,11 @@ void CallbackDirectory::registerCallback(quint64 requestId, const QExplicitlySha
     m_callbackMap.insert(requestId, CallbackSharedDataPointer(callback.data()));
 }
 
+void CallbackDirectory::registerCallback(quint64 requestId, const QExplicitlySharedDataPointer<ImageCallback> &callback)
+{
+    m_callbackMap.insert(requestId, CallbackSharedDataPointer(callback.data()));
+}
+
 void CallbackDirectory::invoke(quint64 requestId, const QVariant &result)
 {
     CallbackSharedDataPointer sharedPtr = m_callbackMap.take(requestId);
@@ -124,6 +135,27 @@ void CallbackDirectory::invoke(quint64 requestId, bool result)
     }
 }
 
+void CallbackDirectory::invoke(quint64 requestId, const QImage &result)
+{
+    CallbackSharedDataPointer sharedPtr = m_callbackMap.take(requestId);
+    if (sharedPtr) {
+        Q_ASSERT(sharedPtr.type == CallbackSharedDataPointer::Image);
+        (*sharedPtr.imageCallback)(result);
+    }
+}
+
+void CallbackDirectory::invokeChunk(quint64 requestId, const QString &chunk, bool last)
+{
+    CallbackSharedDataPointer sharedPtr = last ? m_callbackMap.take(requestId) : m_callbackMap.value(requestId);
+    if (sharedPtr) {
+        Q_ASSERT(sharedPtr.type == CallbackSharedDataPointer::String);
+        if (!last || !chunk.isEmpty())
+            (*sharedPtr.stringCallback)(chunk);
+        if (last)
+            (*sharedPtr.stringCallback)(QString());
+    }
+}
+
 void CallbackDirectory::CallbackSharedDataPointer::doRef()
 {
     switch (type) {
@@ -138,6 +170,9 @@ void CallbackDirectory::CallbackSharedDataPointer::doRef()
     case Bool:
         boolCallback->ref.ref();
         break;
+    case Image:
+        imageCallback->ref.ref();
+        break;
     }
 }
 
@@ -158,12 +193,17 @@ void CallbackDirectory::CallbackSharedDataPointer::doDeref()
         if (!boolCallback->ref.deref())
             delete boolCallback;
         break;
+    case Image:
+        if (!imageCallback->ref.deref())
+            delete imageCallback;
+        break;
     }
 }
 
-QWebEnginePagePrivate::QWebEnginePagePrivate()
+QWebEnginePagePrivate::QWebEnginePagePrivate(QWebEngineProfile *profile)
     : QObjectPrivate(QObjectPrivateVersion)
-    , adapter(new WebContentsAdapter)
+    , profile(profile)
+    , adapter(new WebContentsAdapter(profile->d_func()->browserContext))
     , history(new QWebEngineHistory(new QWebEngineHistoryPrivate(this)))
     , view(0)
 {
@@ -181,6 +221,11 @@ RenderWidgetHostViewQtDelegate *QWebEnginePagePrivate::CreateRenderWidgetHostVie
     return new RenderWidgetHostViewQtDelegateWidget(client);
 }
 
+RenderWidgetHostViewQtDelegate *QWebEnginePagePrivate::CreateRenderWidgetHostViewQtDelegateForSoftwareCompositing(RenderWidgetHostViewQtDelegateClient *client)
+{
+    return new RenderWidgetHostViewQtDelegateSoftwareWidget(client);
+}
+
 void QWebEnginePagePrivate::titleChanged(const QString &title)
 {
     Q_Q(QWebEnginePage);
@@ -270,6 +315,8 @@ void QWebEnginePagePrivate::adoptNewWindow(WebContentsAdapter *newWebContents, W
     // Overwrite the new page's WebContents with ours.
     if (newPage && newPage->d_func() != this) {
         newPage->d_func()->adapter = newWebContents;
+        // Chromium opens new windows in the context of their opener.
+        newPage->d_func()->profile = profile;
         newWebContents->initialize(newPage->d_func());
         if (!initialGeometry.isEmpty())
             emit newPage->geometryChangeRequested(initialGeometry);
@@ -297,11 +344,26 @@ void QWebEnginePagePrivate::didFetchDocumentInnerText(quint64 requestId, const Q
     m_callbacks.invoke(requestId, result);
 }
 
+void QWebEnginePagePrivate::didFetchDocumentChunk(quint64 requestId, const QString& chunk, bool last)
+{
+    m_callbacks.invokeChunk(requestId, chunk, last);
+}
+
+void QWebEnginePagePrivate::didFetchDocumentTextNodes(quint64 requestId, const QVariant& result)
+{
+    m_callbacks.invoke(requestId, result);
+}
+
 void QWebEnginePagePrivate::didFindText(quint64 requestId, int matchCount)
 {
     m_callbacks.invoke(requestId, matchCount > 0);
 }
 
+void QWebEnginePagePrivate::didGrabImage(quint64 requestId, const QImage &image)
+{
+    m_callbacks.invoke(requestId, image);
+}
+
 void QWebEnginePagePrivate::authenticationRequired(const QUrl &requestUrl, const QString &realm, bool isProxy, const QString &challengingHost, QString *outUser, QString *outPassword)
 {
     Q_Q(QWebEnginePage);
@@ -389,7 +451,7 @@ void QWebEnginePagePrivate::_q_webActionTriggered(bool checked)
 
 void QWebEnginePagePrivate::recreateFromSerializedHistory(QDataStream &input)
 {
-    QExplicitlySharedDataPointer<WebContentsAdapter> newWebContents = WebContentsAdapter::createFromSerializedNavigationHistory(input, this);
+    QExplicitlySharedDataPointer<WebContentsAdapter> newWebContents = WebContentsAdapter::createFromSerializedNavigationHistory(input, this, profile->d_func()->browserContext);
     if (newWebContents) {
         adapter = newWebContents.data();
         adapter->initialize(this);
@@ -401,6 +463,15 @@ QWebEnginePage::QWebEnginePage(QObject* parent)
 {
 }
 
+/*!
+    Constructs an empty web engine page with the parent \a parent that uses the
+    cookies, caches and storage of \a profile. The profile must outlive the page.
+*/
+QWebEnginePage::QWebEnginePage(QWebEngineProfile *profile, QObject* parent)
+    : QObject(*new QWebEnginePagePrivate(profile), parent)
+{
+}
+
 QWebEnginePage::~QWebEnginePage()
 {
     Q_D(QWebEnginePage);
@@ -413,6 +484,15 @@ QWebEngineHistory *QWebEnginePage::history() const
     return d->history;
 }
 
+/*!
+    Returns the profile the page was created with, or the default profile.
+*/
+QWebEngineProfile *QWebEnginePage::profile() const
+{
+    Q_D(const QWebEnginePage);
+    return d->profile;
+}
+
 void QWebEnginePage::setView(QWidget *view)
 {
     QWebEngineViewPrivate::bind(qobject_cast<QWebEngineView*>(view), this);
@@ -761,6 +841,56 @@ void QWebEnginePage::toPlainText(const QWebEngineCallback<const QString &> &resu
     d->m_callbacks.registerCallback(requestId, resultCallback.d);
 }
 
+/*!
+    Asynchronously retrieves the HTML of the page in chunks and passes each chunk
+    to \a chunkCallback, in document order, as soon as it is available.
+
+    A null string marks the end of the document. If the renderer goes away before
+    the document is complete, \a chunkCallback only receives the null string.
+
+    \sa toHtml()
+*/
+void QWebEnginePage::toHtmlChunked(const QWebEngineCallback<const QString &> &chunkCallback) const
+{
+    Q_D(const QWebEnginePage);
+    quint64 requestId = d->adapter->fetchDocumentMarkup(/*streamed*/ true);
+    d->m_callbacks.registerCallback(requestId, chunkCallback.d);
+}
+
+/*!
+    Asynchronously retrieves the text of the page in chunks and passes each chunk
+    to \a chunkCallback, in document order, as soon as it is available.
+
+    A null string marks the end of the text. If the renderer goes away before
+    the text is complete, \a chunkCallback only receives the null string.
+
+    \sa toPlainText()
+*/
+void QWebEnginePage::toPlainTextChunked(const QWebEngineCallback<const QString &> &chunkCallback) const
+{
+    Q_D(const QWebEnginePage);
+    quint64 requestId = d->adapter->fetchDocumentInnerText(/*streamed*/ true);
+    d->m_callbacks.registerCallback(requestId, chunkCallback.d);
+}
+
+/*!
+    Asynchronously retrieves the text nodes of the page and passes them to
+    \a resultCallback as a QVariantMap.
+
+    The map holds the concatenated text of all text nodes under the key \c text.
+    For each text node, \c offsets holds the position where its text starts and
+    \c paths holds the child index path from the document to the node.
+
+    If the renderer goes away before all text nodes are retrieved,
+    \a resultCallback receives an invalid QVariant.
+*/
+void QWebEnginePage::toStructuredText(const QWebEngineCallback<const QVariant &> &resultCallback) const
+{
+    Q_D(const QWebEnginePage);
+    quint64 requestId = d->adapter->fetchDocumentTextNodes();
+    d->m_callbacks.registerCallback(requestId, resultCallback.d);
+}
+
 void QWebEnginePage::setHtml(const QString &html, const QUrl &baseUrl)
 {
     setContent(html.toUtf8(), QStringLiteral("text/html;charset=UTF-8"), baseUrl);
@@ -809,6 +939,37 @@ void QWebEnginePage::setZoomFactor(qreal factor)
     d->adapter->setZoomFactor(factor);
 }
 
+bool QWebEnginePage::softwareCompositingEnabled() const
+{
+    Q_D(const QWebEnginePage);
+    return d->adapter->softwareCompositingEnabled();
+}
+
+void QWebEnginePage::setSoftwareCompositingEnabled(bool enabled)
+{
+    Q_D(QWebEnginePage);
+    d->adapter->setSoftwareCompositingEnabled(enabled);
+}
+
+QSize QWebEnginePage::headlessViewportSize() const
+{
+    Q_D(const QWebEnginePage);
+    return d->adapter->headlessViewportSize();
+}
+
+void QWebEnginePage::setHeadlessViewportSize(const QSize &size)
+{
+    Q_D(QWebEnginePage);
+    d->adapter->setHeadlessViewportSize(size);
+}
+
+void QWebEnginePage::grabToImage(const QWebEngineCallback<const QImage &> &resultCallback, const QRect &rect, qreal scale)
+{
+    Q_D(QWebEnginePage);
+    quint64 requestId = d->adapter->grabToImage(rect, scale);
+    d->m_callbacks.registerCallback(requestId, resultCallback.d);
+}
+
 void QWebEnginePage::runJavaScript(const QString &scriptSource)
 {
     Q_D(QWebEnginePage);
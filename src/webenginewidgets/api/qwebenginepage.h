@@ -31,10 +31,12 @@
 #include <QtWidgets/qwidget.h>
 
 QT_BEGIN_NAMESPACE
+class QImage;
 class QMenu;
 class QWebEngineHistory;
 class QWebEnginePage;
 class QWebEnginePagePrivate;
+class QWebEngineProfile;
 
 namespace QtWebEnginePrivate {
 
@@ -139,8 +141,10 @@ public:
     };
 
     explicit QWebEnginePage(QObject *parent = 0);
+    explicit QWebEnginePage(QWebEngineProfile *profile, QObject *parent = 0);
     ~QWebEnginePage();
     QWebEngineHistory *history() const;
+    QWebEngineProfile *profile() const;
 
     void setView(QWidget *view);
     QWidget *view() const;
@@ -166,6 +170,9 @@ public:
 
     void toHtml(const QWebEngineCallback<const QString &> &resultCallback) const;
     void toPlainText(const QWebEngineCallback<const QString &> &resultCallback) const;
+    void toHtmlChunked(const QWebEngineCallback<const QString &> &chunkCallback) const;
+    void toPlainTextChunked(const QWebEngineCallback<const QString &> &chunkCallback) const;
+    void toStructuredText(const QWebEngineCallback<const QVariant &> &resultCallback) const;
 
     QString title() const;
     void setUrl(const QUrl &url);
@@ -175,6 +182,13 @@ public:
     qreal zoomFactor() const;
     void setZoomFactor(qreal factor);
 
+    bool softwareCompositingEnabled() const;
+    void setSoftwareCompositingEnabled(bool enabled);
+
+    QSize headlessViewportSize() const;
+    void setHeadlessViewportSize(const QSize &size);
+    void grabToImage(const QWebEngineCallback<const QImage &> &resultCallback, const QRect &rect = QRect(), qreal scale = 1.0);
+
     void runJavaScript(const QString& scriptSource);
     void runJavaScript(const QString& scriptSource, const QWebEngineCallback<const QVariant &> &resultCallback);
 
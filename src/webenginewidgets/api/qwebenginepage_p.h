@@ -43,6 +43,7 @@
 #define QWEBENGINEPAGE_P_H
 
 #include "qwebenginepage.h"
+#include "qwebengineprofile.h"
 
 #include "web_contents_adapter_client.h"
 #include <QtCore/private/qobject_p.h>
@@ -62,14 +63,19 @@ public:
     typedef QtWebEnginePrivate::QWebEngineCallbackPrivateBase<const QVariant&> VariantCallback;
     typedef QtWebEnginePrivate::QWebEngineCallbackPrivateBase<const QString&> StringCallback;
     typedef QtWebEnginePrivate::QWebEngineCallbackPrivateBase<bool> BoolCallback;
+    typedef QtWebEnginePrivate::QWebEngineCallbackPrivateBase<const QImage&> ImageCallback;
 
     ~CallbackDirectory();
     void registerCallback(quint64 requestId, const QExplicitlySharedDataPointer<VariantCallback> &callback);
     void registerCallback(quint64 requestId, const QExplicitlySharedDataPointer<StringCallback> &callback);
     void registerCallback(quint64 requestId, const QExplicitlySharedDataPointer<BoolCallback> &callback);
+    void registerCallback(quint64 requestId, const QExplicitlySharedDataPointer<ImageCallback> &callback);
     void invoke(quint64 requestId, const QVariant &result);
     void invoke(quint64 requestId, const QString &result);
     void invoke(quint64 requestId, bool result);
+    void invoke(quint64 requestId, const QImage &result);
+    // Keeps the callback registered until the last chunk, which is followed by a null string.
+    void invokeChunk(quint64 requestId, const QString &chunk, bool last);
 
 private:
     struct CallbackSharedDataPointer {
@@ -77,17 +83,20 @@ private:
             None,
             Variant,
             String,
-            Bool
+            Bool,
+            Image
         } type;
         union {
             VariantCallback *variantCallback;
             StringCallback *stringCallback;
             BoolCallback *boolCallback;
+            ImageCallback *imageCallback;
         };
         CallbackSharedDataPointer() : type(None) { }
         CallbackSharedDataPointer(VariantCallback *callback) : type(Variant), variantCallback(callback) { callback->ref.ref(); }
         CallbackSharedDataPointer(StringCallback *callback) : type(String), stringCallback(callback) { callback->ref.ref(); }
         CallbackSharedDataPointer(BoolCallback *callback) : type(Bool), boolCallback(callback) { callback->ref.ref(); }
+        CallbackSharedDataPointer(ImageCallback *callback) : type(Image), imageCallback(callback) { callback->ref.ref(); }
         CallbackSharedDataPointer(const CallbackSharedDataPointer &other) : type(other.type), variantCallback(other.variantCallback) { doRef(); }
         ~CallbackSharedDataPointer() { doDeref(); }
         operator bool () const { return type != None; }
@@ -105,11 +114,12 @@ class QWebEnginePagePrivate : public QObjectPrivate, public WebContentsAdapterCl
 public:
     Q_DECLARE_PUBLIC(QWebEnginePage)
 
-    QWebEnginePagePrivate();
+    QWebEnginePagePrivate(QWebEngineProfile *profile = QWebEngineProfile::defaultProfile());
     ~QWebEnginePagePrivate();
 
     virtual RenderWidgetHostViewQtDelegate* CreateRenderWidgetHostViewQtDelegate(RenderWidgetHostViewQtDelegateClient *client) Q_DECL_OVERRIDE;
     virtual RenderWidgetHostViewQtDelegate* CreateRenderWidgetHostViewQtDelegateForPopup(RenderWidgetHostViewQtDelegateClient *client) Q_DECL_OVERRIDE { return CreateRenderWidgetHostViewQtDelegate(client); }
+    virtual RenderWidgetHostViewQtDelegate* CreateRenderWidgetHostViewQtDelegateForSoftwareCompositing(RenderWidgetHostViewQtDelegateClient *client) Q_DECL_OVERRIDE;
     virtual void titleChanged(const QString&) Q_DECL_OVERRIDE;
     virtual void urlChanged(const QUrl&) Q_DECL_OVERRIDE;
     virtual void iconChanged(const QUrl&) Q_DECL_OVERRIDE;
@@ -133,7 +143,10 @@ public:
     virtual void didRunJavaScript(quint64 requestId, const QVariant& result) Q_DECL_OVERRIDE;
     virtual void didFetchDocumentMarkup(quint64 requestId, const QString& result) Q_DECL_OVERRIDE;
     virtual void didFetchDocumentInnerText(quint64 requestId, const QString& result) Q_DECL_OVERRIDE;
+    virtual void didFetchDocumentChunk(quint64 requestId, const QString& chunk, bool last) Q_DECL_OVERRIDE;
+    virtual void didFetchDocumentTextNodes(quint64 requestId, const QVariant& result) Q_DECL_OVERRIDE;
     virtual void didFindText(quint64 requestId, int matchCount) Q_DECL_OVERRIDE;
+    virtual void didGrabImage(quint64 requestId, const QImage &image) Q_DECL_OVERRIDE;
     virtual void passOnFocus(bool reverse) Q_DECL_OVERRIDE { Q_UNUSED(reverse); };
     virtual void javaScriptConsoleMessage(JavaScriptConsoleMessageLevel level, const QString& message, int lineNumber, const QString& sourceID) Q_DECL_OVERRIDE;
     virtual void authenticationRequired(const QUrl &requestUrl, const QString &realm, bool isProxy, const QString &challengingHost, QString *outUser, QString *outPassword) Q_DECL_OVERRIDE;
@@ -146,6 +159,7 @@ public:
     WebContentsAdapter *webContents() { return adapter.data(); }
     void recreateFromSerializedHistory(QDataStream &input);
 
+    QWebEngineProfile *profile;
     QExplicitlySharedDataPointer<WebContentsAdapter> adapter;
     QWebEngineHistory *history;
     QWebEngineView *view;
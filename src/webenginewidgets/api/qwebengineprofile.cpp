@@ -0,0 +1,235 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qwebengineprofile.h"
+#include "qwebengineprofile_p.h"
+
+#include "browser_context_adapter.h"
+
+QT_BEGIN_NAMESPACE
+
+Q_STATIC_ASSERT(int(QWebEngineProfile::DefaultHttpCache) == int(BrowserContextAdapter::DefaultHttpCache));
+Q_STATIC_ASSERT(int(QWebEngineProfile::BlockfileHttpCache) == int(BrowserContextAdapter::BlockfileHttpCache));
+Q_STATIC_ASSERT(int(QWebEngineProfile::SimpleHttpCache) == int(BrowserContextAdapter::SimpleHttpCache));
+Q_STATIC_ASSERT(int(QWebEngineProfile::MemoryHttpCache) == int(BrowserContextAdapter::MemoryHttpCache));
+
+QWebEngineProfilePrivate::QWebEngineProfilePrivate(BrowserContextAdapter *browserContext)
+    : browserContext(browserContext)
+{
+}
+
+/*!
+    \class QWebEngineProfile
+    \brief The QWebEngineProfile class provides the network and storage settings shared by web engine pages.
+
+    The HTTP cache settings are read when the profile handles its first request,
+    later changes have no effect.
+*/
+
+/*!
+    \enum QWebEngineProfile::HttpCacheType
+
+    This enum describes the HTTP cache backend of a profile:
+
+    \value DefaultHttpCache The default disk cache backend of the platform.
+    \value BlockfileHttpCache The block file disk cache backend.
+    \value SimpleHttpCache The simple disk cache backend, with one file per entry.
+    \value MemoryHttpCache An in-memory cache that is discarded with the profile.
+*/
+
+/*!
+    Constructs an off-the-record profile that keeps its cookies, caches and storage
+    in memory. The profile must outlive the pages that use it.
+
+    \sa defaultProfile()
+*/
+QWebEngineProfile::QWebEngineProfile()
+    : d_ptr(new QWebEngineProfilePrivate(new BrowserContextAdapter(/*offTheRecord*/ true)))
+{
+    d_ptr->ownedBrowserContext.reset(d_ptr->browserContext);
+}
+
+QWebEngineProfile::QWebEngineProfile(QWebEngineProfilePrivate *d)
+    : d_ptr(d)
+{
+}
+
+QWebEngineProfile::~QWebEngineProfile()
+{
+}
+
+/*!
+    Returns the profile used by pages created without one, which stores its data on disk.
+*/
+QWebEngineProfile *QWebEngineProfile::defaultProfile()
+{
+    static QWebEngineProfile *profile = new QWebEngineProfile(new QWebEngineProfilePrivate(BrowserContextAdapter::defaultContext()));
+    return profile;
+}
+
+/*!
+    Returns whether the profile keeps all its data in memory.
+*/
+bool QWebEngineProfile::isOffTheRecord() const
+{
+    Q_D(const QWebEngineProfile);
+    return d->browserContext->isOffTheRecord();
+}
+
+/*!
+    Returns the HTTP cache backend of the profile, which is always MemoryHttpCache
+    for memory only profiles.
+
+    \sa setHttpCacheType(), isMemoryOnly()
+*/
+QWebEngineProfile::HttpCacheType QWebEngineProfile::httpCacheType() const
+{
+    Q_D(const QWebEngineProfile);
+    return static_cast<HttpCacheType>(d->browserContext->httpCacheType());
+}
+
+/*!
+    Sets the HTTP cache backend of the profile to \a type.
+*/
+void QWebEngineProfile::setHttpCacheType(HttpCacheType type)
+{
+    Q_D(QWebEngineProfile);
+    d->browserContext->setHttpCacheType(static_cast<BrowserContextAdapter::HttpCacheType>(type));
+}
+
+/*!
+    Returns the maximum size of the HTTP cache in bytes, 0 lets the backend
+    pick a size.
+
+    \sa setHttpCacheMaximumSize()
+*/
+int QWebEngineProfile::httpCacheMaximumSize() const
+{
+    Q_D(const QWebEngineProfile);
+    return d->browserContext->httpCacheMaxSize();
+}
+
+/*!
+    Sets the maximum size of the HTTP cache to \a maxSize bytes. Negative sizes
+    are treated as 0.
+*/
+void QWebEngineProfile::setHttpCacheMaximumSize(int maxSize)
+{
+    Q_D(QWebEngineProfile);
+    d->browserContext->setHttpCacheMaxSize(maxSize);
+}
+
+/*!
+    Returns whether the profile keeps its HTTP cache in memory instead of on disk.
+
+    \sa setMemoryOnly()
+*/
+bool QWebEngineProfile::isMemoryOnly() const
+{
+    Q_D(const QWebEngineProfile);
+    return d->browserContext->isMemoryOnly();
+}
+
+/*!
+    Keeps the HTTP cache in memory if \a memoryOnly is true, regardless of
+    httpCacheType().
+*/
+void QWebEngineProfile::setMemoryOnly(bool memoryOnly)
+{
+    Q_D(QWebEngineProfile);
+    d->browserContext->setMemoryOnly(memoryOnly);
+}
+
+/*!
+    Returns the number of requests the HTTP cache answered from a stored entry.
+    Only HTTP and HTTPS requests go through the cache.
+
+    \sa httpCacheMissCount()
+*/
+qint64 QWebEngineProfile::httpCacheHitCount() const
+{
+    Q_D(const QWebEngineProfile);
+    return d->browserContext->httpCacheStatistics().hitCount;
+}
+
+/*!
+    Returns the number of requests the HTTP cache had to send to the network.
+
+    \sa httpCacheHitCount()
+*/
+qint64 QWebEngineProfile::httpCacheMissCount() const
+{
+    Q_D(const QWebEngineProfile);
+    return d->browserContext->httpCacheStatistics().missCount;
+}
+
+/*!
+    Returns the number of response body bytes read from the HTTP cache.
+*/
+qint64 QWebEngineProfile::httpCacheBytesFromCache() const
+{
+    Q_D(const QWebEngineProfile);
+    return d->browserContext->httpCacheStatistics().cachedBytes;
+}
+
+/*!
+    Returns the number of response body bytes read from the network by requests
+    that went through the HTTP cache.
+*/
+qint64 QWebEngineProfile::httpCacheBytesFromNetwork() const
+{
+    Q_D(const QWebEngineProfile);
+    return d->browserContext->httpCacheStatistics().networkBytes;
+}
+
+int QWebEngineProfile::spareRendererProcessCount() const
+{
+    Q_D(const QWebEngineProfile);
+    return d->browserContext->spareRendererProcessCount();
+}
+
+void QWebEngineProfile::setSpareRendererProcessCount(int count)
+{
+    Q_D(QWebEngineProfile);
+    d->browserContext->setSpareRendererProcessCount(count);
+}
+
+QT_END_NAMESPACE
@@ -223,6 +223,26 @@ void QWebEngineView::setZoomFactor(qreal factor)
     page()->setZoomFactor(factor);
 }
 
+bool QWebEngineView::softwareCompositingEnabled() const
+{
+    return page()->softwareCompositingEnabled();
+}
+
+void QWebEngineView::setSoftwareCompositingEnabled(bool enabled)
+{
+    page()->setSoftwareCompositingEnabled(enabled);
+}
+
+QVariantMap QWebEngineView::frameStatistics() const
+{
+    return page()->d_func()->adapter->frameStatistics();
+}
+
+QVariantMap QWebEngineView::startupStatistics() const
+{
+    return page()->d_func()->adapter->startupStatistics();
+}
+
 bool QWebEngineView::event(QEvent *ev)
 {
     Q_D(QWebEngineView);
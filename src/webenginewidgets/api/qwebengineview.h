@@ -22,6 +22,7 @@
 #ifndef QWEBENGINEVIEW_H
 #define QWEBENGINEVIEW_H
 
+#include <QtCore/qvariant.h>
 #include <QtGui/qpainter.h>
 #include <QtNetwork/qnetworkaccessmanager.h>
 #include <QtWidgets/qwidget.h>
@@ -71,6 +72,12 @@ public:
     qreal zoomFactor() const;
     void setZoomFactor(qreal factor);
 
+    bool softwareCompositingEnabled() const;
+    void setSoftwareCompositingEnabled(bool enabled);
+
+    QVariantMap frameStatistics() const;
+    QVariantMap startupStatistics() const;
+
     void findText(const QString &subString, QWebEnginePage::FindFlags options = 0, const QWebEngineCallback<bool> &resultCallback = QWebEngineCallback<bool>());
 
     virtual QSize sizeHint() const { return QSize(800, 600); }
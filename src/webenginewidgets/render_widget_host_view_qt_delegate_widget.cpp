@@ -41,94 +41,18 @@
 
 #include "render_widget_host_view_qt_delegate_widget.h"
 
-#include "qwebenginepage_p.h"
-#include "qwebengineview.h"
-#include <QLayout>
 #include <QSGNode>
 #include <private/qsgadaptationlayer_p.h>
 #include <private/qsgcontext_p.h>
 #include <private/qsgrenderer_p.h>
 #include <private/qwidget_p.h>
 
-static const int MaxTooltipLength = 1024;
-
 RenderWidgetHostViewQtDelegateWidget::RenderWidgetHostViewQtDelegateWidget(RenderWidgetHostViewQtDelegateClient *client, QWidget *parent)
-    : QOpenGLWidget(parent)
-    , m_client(client)
+    : RenderWidgetHostViewQtDelegateWidgetBase<QOpenGLWidget>(client, parent)
     , rootNode(new QSGRootNode)
     , sgContext(QSGContext::createDefaultContext())
     , sgRenderContext(new QSGRenderContext(sgContext.data()))
-    , m_isPopup(false)
-{
-    setFocusPolicy(Qt::ClickFocus);
-    setMouseTracking(true);
-    setAttribute(Qt::WA_AcceptTouchEvents);
-    setAttribute(Qt::WA_OpaquePaintEvent);
-    setAttribute(Qt::WA_AlwaysShowToolTips);
-}
-
-void RenderWidgetHostViewQtDelegateWidget::initAsChild(WebContentsAdapterClient* container)
-{
-    QWebEnginePagePrivate *pagePrivate = static_cast<QWebEnginePagePrivate *>(container);
-    if (pagePrivate->view) {
-        pagePrivate->view->layout()->addWidget(this);
-        QOpenGLWidget::show();
-    } else
-        setParent(0);
-}
-
-void RenderWidgetHostViewQtDelegateWidget::initAsPopup(const QRect& screenRect)
-{
-    m_isPopup = true;
-    // The keyboard events are supposed to go to the parent RenderHostView
-    // so the WebUI popups should never have focus. Besides, if the parent view
-    // loses focus, WebKit will cause its associated popups (including this one)
-    // to be destroyed.
-    setAttribute(Qt::WA_ShowWithoutActivating);
-    setFocusPolicy(Qt::NoFocus);
-    setWindowFlags(Qt::ToolTip | Qt::FramelessWindowHint | Qt::WindowDoesNotAcceptFocus);
-
-    setGeometry(screenRect);
-    show();
-}
-
-QRectF RenderWidgetHostViewQtDelegateWidget::screenRect() const
-{
-    return QRectF(x(), y(), width(), height());
-}
-
-void RenderWidgetHostViewQtDelegateWidget::setKeyboardFocus()
-{
-    setFocus();
-}
-
-bool RenderWidgetHostViewQtDelegateWidget::hasKeyboardFocus()
-{
-    return hasFocus();
-}
-
-void RenderWidgetHostViewQtDelegateWidget::show()
-{
-    // Check if we're attached to a QWebEngineView, we don't
-    // want to show anything else than popups as top-level.
-    if (parent() || m_isPopup)
-        QOpenGLWidget::show();
-}
-
-void RenderWidgetHostViewQtDelegateWidget::hide()
-{
-    QOpenGLWidget::hide();
-}
-
-bool RenderWidgetHostViewQtDelegateWidget::isVisible() const
-{
-    return QOpenGLWidget::isVisible();
-}
-
-QWindow* RenderWidgetHostViewQtDelegateWidget::window() const
 {
-    const QWidget* root = QOpenGLWidget::window();
-    return root ? root->windowHandle() : 0;
 }
 
 void RenderWidgetHostViewQtDelegateWidget::update()
@@ -136,71 +60,6 @@ void RenderWidgetHostViewQtDelegateWidget::update()
     updateGL();
 }
 
-void RenderWidgetHostViewQtDelegateWidget::updateCursor(const QCursor &cursor)
-{
-    QOpenGLWidget::setCursor(cursor);
-}
-
-void RenderWidgetHostViewQtDelegateWidget::resize(int width, int height)
-{
-    QOpenGLWidget::resize(width, height);
-}
-
-void RenderWidgetHostViewQtDelegateWidget::move(const QPoint &screenPos)
-{
-    Q_ASSERT(m_isPopup);
-    QOpenGLWidget::move(screenPos);
-}
-
-void RenderWidgetHostViewQtDelegateWidget::inputMethodStateChanged(bool editorVisible)
-{
-    if (qApp->inputMethod()->isVisible() == editorVisible)
-        return;
-
-    QOpenGLWidget::setAttribute(Qt::WA_InputMethodEnabled, editorVisible);
-    qApp->inputMethod()->update(Qt::ImQueryInput | Qt::ImEnabled | Qt::ImHints);
-    qApp->inputMethod()->setVisible(editorVisible);
-}
-
-void RenderWidgetHostViewQtDelegateWidget::setTooltip(const QString &tooltip)
-{
-    QString wrappedTip;
-    if (!tooltip.isEmpty())
-         wrappedTip = QStringLiteral("<p>") % tooltip.toHtmlEscaped().left(MaxTooltipLength) % QStringLiteral("</p>");
-    setToolTip(wrappedTip);
-}
-
-QVariant RenderWidgetHostViewQtDelegateWidget::inputMethodQuery(Qt::InputMethodQuery query) const
-{
-    return m_client->inputMethodQuery(query);
-}
-
-void RenderWidgetHostViewQtDelegateWidget::resizeEvent(QResizeEvent *resizeEvent)
-{
-    QOpenGLWidget::resizeEvent(resizeEvent);
-    m_client->notifyResize();
-}
-
-bool RenderWidgetHostViewQtDelegateWidget::event(QEvent *event)
-{
-    bool handled = false;
-    if (event->type() == QEvent::MouseButtonDblClick) {
-        // QWidget keeps the Qt4 behavior where the DblClick event would replace the Press event.
-        // QtQuick is different by sending both the Press and DblClick events for the second press
-        // where we can simply ignore the DblClick event.
-        QMouseEvent *dblClick = static_cast<QMouseEvent *>(event);
-        QMouseEvent press(QEvent::MouseButtonPress, dblClick->localPos(), dblClick->windowPos(), dblClick->screenPos(),
-            dblClick->button(), dblClick->buttons(), dblClick->modifiers());
-        press.setTimestamp(dblClick->timestamp());
-        handled = m_client->forwardEvent(&press);
-    } else
-        handled = m_client->forwardEvent(event);
-
-    if (!handled)
-        return QOpenGLWidget::event(event);
-    return true;
-}
-
 void RenderWidgetHostViewQtDelegateWidget::initializeGL()
 {
     sgRenderContext->initialize(QOpenGLContext::currentContext());
@@ -230,4 +89,6 @@ void RenderWidgetHostViewQtDelegateWidget::paintGL()
     sgRenderer->setClearColor(Qt::white);
 
     sgRenderContext->renderNextFrame(sgRenderer.data(), defaultFramebufferObject());
+    // QOpenGLWidget composes our framebuffer with the rest of the window right after this.
+    m_client->notifyFrameSwapped();
 }
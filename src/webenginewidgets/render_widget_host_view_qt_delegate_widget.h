@@ -42,8 +42,7 @@
 #ifndef RENDER_WIDGET_HOST_VIEW_QT_DELEGATE_WIDGET_H
 #define RENDER_WIDGET_HOST_VIEW_QT_DELEGATE_WIDGET_H
 
-#include "render_widget_host_view_qt_delegate.h"
-#include "web_contents_adapter_client.h"
+#include "render_widget_host_view_qt_delegate_widgetbase.h"
 
 #include <private/qopenglwidget_p.h>
 
@@ -52,46 +51,25 @@ class QSGContext;
 class QSGRenderContext;
 class QSGRenderer;
 class QSGRootNode;
-class QWindow;
 QT_END_NAMESPACE
 
-class RenderWidgetHostViewQtDelegateWidget : public QOpenGLWidget, public RenderWidgetHostViewQtDelegate
+class RenderWidgetHostViewQtDelegateWidget : public RenderWidgetHostViewQtDelegateWidgetBase<QOpenGLWidget>
 {
 public:
     RenderWidgetHostViewQtDelegateWidget(RenderWidgetHostViewQtDelegateClient *client, QWidget *parent = 0);
 
-    virtual void initAsChild(WebContentsAdapterClient* container) Q_DECL_OVERRIDE;
-    virtual void initAsPopup(const QRect&) Q_DECL_OVERRIDE;
-    virtual QRectF screenRect() const Q_DECL_OVERRIDE;
-    virtual void setKeyboardFocus() Q_DECL_OVERRIDE;
-    virtual bool hasKeyboardFocus() Q_DECL_OVERRIDE;
-    virtual void show() Q_DECL_OVERRIDE;
-    virtual void hide() Q_DECL_OVERRIDE;
-    virtual bool isVisible() const Q_DECL_OVERRIDE;
-    virtual QWindow* window() const Q_DECL_OVERRIDE;
     virtual void update() Q_DECL_OVERRIDE;
-    virtual void updateCursor(const QCursor &) Q_DECL_OVERRIDE;
-    virtual void resize(int width, int height) Q_DECL_OVERRIDE;
-    virtual void move(const QPoint &screenPos) Q_DECL_OVERRIDE;
-    virtual void inputMethodStateChanged(bool editorVisible) Q_DECL_OVERRIDE;
-    virtual void setTooltip(const QString &tooltip) Q_DECL_OVERRIDE;
 
 protected:
-    bool event(QEvent *event);
-    void resizeEvent(QResizeEvent *resizeEvent);
     void initializeGL() Q_DECL_OVERRIDE;
     void paintGL() Q_DECL_OVERRIDE;
 
-    QVariant inputMethodQuery(Qt::InputMethodQuery query) const;
-
 private:
-    RenderWidgetHostViewQtDelegateClient *m_client;
     // Put the root node first to make sure it gets destroyed after the SG renderer.
     QScopedPointer<QSGRootNode> rootNode;
     QScopedPointer<QSGContext> sgContext;
     QScopedPointer<QSGRenderContext> sgRenderContext;
     QScopedPointer<QSGRenderer> sgRenderer;
-    bool m_isPopup;
 };
 
 #endif
@@ -0,0 +1,212 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtWebEngine module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+
+#ifndef RENDER_WIDGET_HOST_VIEW_QT_DELEGATE_WIDGETBASE_H
+#define RENDER_WIDGET_HOST_VIEW_QT_DELEGATE_WIDGETBASE_H
+
+#include "render_widget_host_view_qt_delegate.h"
+#include "web_contents_adapter_client.h"
+
+#include "qwebenginepage_p.h"
+#include "qwebengineview.h"
+#include <QGuiApplication>
+#include <QLayout>
+#include <QMouseEvent>
+#include <QWidget>
+
+QT_BEGIN_NAMESPACE
+class QWindow;
+QT_END_NAMESPACE
+
+// Event, geometry and input method handling shared by the widget delegates, which only differ in how they paint.
+// WidgetBase is the QWidget subclass the delegate paints with.
+template<typename WidgetBase>
+class RenderWidgetHostViewQtDelegateWidgetBase : public WidgetBase, public RenderWidgetHostViewQtDelegate
+{
+public:
+    RenderWidgetHostViewQtDelegateWidgetBase(RenderWidgetHostViewQtDelegateClient *client, QWidget *parent)
+        : WidgetBase(parent)
+        , m_client(client)
+        , m_isPopup(false)
+    {
+        WidgetBase::setFocusPolicy(Qt::ClickFocus);
+        WidgetBase::setMouseTracking(true);
+        WidgetBase::setAttribute(Qt::WA_AcceptTouchEvents);
+        // The paint path covers the whole damaged area.
+        WidgetBase::setAttribute(Qt::WA_OpaquePaintEvent);
+        WidgetBase::setAttribute(Qt::WA_AlwaysShowToolTips);
+    }
+
+    virtual void initAsChild(WebContentsAdapterClient* container) Q_DECL_OVERRIDE
+    {
+        QWebEnginePagePrivate *pagePrivate = static_cast<QWebEnginePagePrivate *>(container);
+        if (pagePrivate->view) {
+            pagePrivate->view->layout()->addWidget(this);
+            WidgetBase::show();
+        } else
+            WidgetBase::setParent(0);
+    }
+
+    virtual void initAsPopup(const QRect& screenRect) Q_DECL_OVERRIDE
+    {
+        m_isPopup = true;
+        // The keyboard events are supposed to go to the parent RenderHostView
+        // so the WebUI popups should never have focus. Besides, if the parent view
+        // loses focus, WebKit will cause its associated popups (including this one)
+        // to be destroyed.
+        WidgetBase::setAttribute(Qt::WA_ShowWithoutActivating);
+        WidgetBase::setFocusPolicy(Qt::NoFocus);
+        WidgetBase::setWindowFlags(Qt::ToolTip | Qt::FramelessWindowHint | Qt::WindowDoesNotAcceptFocus);
+
+        WidgetBase::setGeometry(screenRect);
+        show();
+    }
+
+    virtual QRectF screenRect() const Q_DECL_OVERRIDE
+    {
+        return QRectF(WidgetBase::x(), WidgetBase::y(), WidgetBase::width(), WidgetBase::height());
+    }
+
+    virtual void setKeyboardFocus() Q_DECL_OVERRIDE
+    {
+        WidgetBase::setFocus();
+    }
+
+    virtual bool hasKeyboardFocus() Q_DECL_OVERRIDE
+    {
+        return WidgetBase::hasFocus();
+    }
+
+    virtual void show() Q_DECL_OVERRIDE
+    {
+        // Check if we're attached to a QWebEngineView, we don't
+        // want to show anything else than popups as top-level.
+        if (WidgetBase::parent() || m_isPopup)
+            WidgetBase::show();
+    }
+
+    virtual void hide() Q_DECL_OVERRIDE
+    {
+        WidgetBase::hide();
+    }
+
+    virtual bool isVisible() const Q_DECL_OVERRIDE
+    {
+        return WidgetBase::isVisible();
+    }
+
+    virtual QWindow* window() const Q_DECL_OVERRIDE
+    {
+        const QWidget* root = WidgetBase::window();
+        return root ? root->windowHandle() : 0;
+    }
+
+    virtual void updateCursor(const QCursor &cursor) Q_DECL_OVERRIDE
+    {
+        WidgetBase::setCursor(cursor);
+    }
+
+    virtual void resize(int width, int height) Q_DECL_OVERRIDE
+    {
+        WidgetBase::resize(width, height);
+    }
+
+    virtual void move(const QPoint &screenPos) Q_DECL_OVERRIDE
+    {
+        Q_ASSERT(m_isPopup);
+        WidgetBase::move(screenPos);
+    }
+
+    virtual void inputMethodStateChanged(bool editorVisible) Q_DECL_OVERRIDE
+    {
+        if (qApp->inputMethod()->isVisible() == editorVisible)
+            return;
+
+        WidgetBase::setAttribute(Qt::WA_InputMethodEnabled, editorVisible);
+        qApp->inputMethod()->update(Qt::ImQueryInput | Qt::ImEnabled | Qt::ImHints);
+        qApp->inputMethod()->setVisible(editorVisible);
+    }
+
+    virtual void setTooltip(const QString &tooltip) Q_DECL_OVERRIDE
+    {
+        static const int MaxTooltipLength = 1024;
+        QString wrappedTip;
+        if (!tooltip.isEmpty())
+             wrappedTip = QStringLiteral("<p>") % tooltip.toHtmlEscaped().left(MaxTooltipLength) % QStringLiteral("</p>");
+        WidgetBase::setToolTip(wrappedTip);
+    }
+
+protected:
+    bool event(QEvent *event)
+    {
+        bool handled = false;
+        if (event->type() == QEvent::MouseButtonDblClick) {
+            // QWidget keeps the Qt4 behavior where the DblClick event would replace the Press event.
+            // QtQuick is different by sending both the Press and DblClick events for the second press
+            // where we can simply ignore the DblClick event.
+            QMouseEvent *dblClick = static_cast<QMouseEvent *>(event);
+            QMouseEvent press(QEvent::MouseButtonPress, dblClick->localPos(), dblClick->windowPos(), dblClick->screenPos(),
+                dblClick->button(), dblClick->buttons(), dblClick->modifiers());
+            press.setTimestamp(dblClick->timestamp());
+            handled = m_client->forwardEvent(&press);
+        } else
+            handled = m_client->forwardEvent(event);
+
+        if (!handled)
+            return WidgetBase::event(event);
+        return true;
+    }
+
+    void resizeEvent(QResizeEvent *resizeEvent)
+    {
+        WidgetBase::resizeEvent(resizeEvent);
+        m_client->notifyResize();
+    }
+
+    QVariant inputMethodQuery(Qt::InputMethodQuery query) const
+    {
+        return m_client->inputMethodQuery(query);
+    }
+
+    RenderWidgetHostViewQtDelegateClient *m_client;
+    bool m_isPopup;
+};
+
+#endif
@@ -14,15 +14,21 @@ SOURCES = \
         api/qtwebenginewidgetsglobal.cpp \
         api/qwebenginehistory.cpp \
         api/qwebenginepage.cpp \
+        api/qwebengineprofile.cpp \
         api/qwebengineview.cpp\
+        render_widget_host_view_qt_delegate_softwarewidget.cpp \
         render_widget_host_view_qt_delegate_widget.cpp
 
 HEADERS = \
         api/qtwebenginewidgetsglobal.h \
         api/qwebenginehistory.h \
         api/qwebenginepage.h \
+        api/qwebengineprofile.h \
+        api/qwebengineprofile_p.h \
         api/qwebengineview.h \
         api/qwebengineview_p.h \
-        render_widget_host_view_qt_delegate_widget.h
+        render_widget_host_view_qt_delegate_softwarewidget.h \
+        render_widget_host_view_qt_delegate_widget.h \
+        render_widget_host_view_qt_delegate_widgetbase.h
 
 load(qt_module)
@@ -61,10 +61,15 @@ private Q_SLOTS:
     void javaScriptWindowObjectClearedOnEvaluate();
     void asyncAndDelete();
     void earlyToHtml();
+    void toPlainTextChunked();
+    void toStructuredText();
+    void toStructuredTextWhileMutating();
     void setHtml();
     void setHtmlWithImageResource();
     void setHtmlWithStylesheetResource();
     void setHtmlWithBaseURL();
+    void setHtmlLargeWithBaseURL();
+    void setHtmlLargeWithoutBaseURL();
     void setHtmlWithJSAlert();
     void ipv6HostEncoding();
     void metaData();
@@ -432,6 +437,82 @@ void tst_QWebEngineFrame::earlyToHtml()
     QCOMPARE(toHtmlSync(m_view->page()), html);
 }
 
+struct ChunkCollector {
+    QString *text;
+    int *chunks;
+    bool *done;
+    void operator()(const QString &chunk) {
+        if (chunk.isNull()) {
+            *done = true;
+            return;
+        }
+        text->append(chunk);
+        ++*chunks;
+    }
+};
+
+void tst_QWebEngineFrame::toPlainTextChunked()
+{
+    // Spans several chunks.
+    const QString text(600 * 1024, QLatin1Char('a'));
+    QSignalSpy spy(m_page, SIGNAL(loadFinished(bool)));
+    m_page->setHtml(QStringLiteral("<html><body><p>") + text + QStringLiteral("</p></body></html>"), QUrl("http://foobar.baz/"));
+    QVERIFY(spy.wait());
+
+    QString result;
+    int chunks = 0;
+    bool done = false;
+    ChunkCollector collector = { &result, &chunks, &done };
+    m_page->toPlainTextChunked(collector);
+    QTRY_VERIFY(done);
+    QVERIFY(chunks > 1);
+    QCOMPARE(result, text);
+}
+
+void tst_QWebEngineFrame::toStructuredText()
+{
+    QSignalSpy spy(m_page, SIGNAL(loadFinished(bool)));
+    m_page->setHtml("<html><head><script>var a;</script></head><body><p>hello</p><p>world</p></body></html>");
+    QVERIFY(spy.wait());
+
+    CallbackSpy<QVariant> callback;
+    m_page->toStructuredText(callback.ref());
+    const QVariantMap result = callback.waitForResult().toMap();
+    QCOMPARE(result.value("text").toString(), QString("helloworld"));
+    QCOMPARE(result.value("offsets").toList(), QVariantList() << 0 << 5);
+    QCOMPARE(result.value("paths").toStringList(), QStringList() << "0/1/0/0" << "0/1/1/0");
+}
+
+void tst_QWebEngineFrame::toStructuredTextWhileMutating()
+{
+    // Enough text nodes for several chunks, while the page keeps removing nodes between the tasks sending them.
+    QSignalSpy spy(m_page, SIGNAL(loadFinished(bool)));
+    m_page->setHtml("<html><body><script>"
+                    "for (var i = 0; i < 20000; ++i) {"
+                    "    var p = document.createElement('p');"
+                    "    p.appendChild(document.createTextNode('x'));"
+                    "    document.body.appendChild(p);"
+                    "}"
+                    "var removals = 0;"
+                    "(function removeFirst() {"
+                    "    document.body.removeChild(document.body.firstChild);"
+                    "    if (++removals < 200)"
+                    "        setTimeout(removeFirst, 0);"
+                    "})();"
+                    "</script></body></html>");
+    QVERIFY(spy.wait());
+
+    CallbackSpy<QVariant> callback;
+    m_page->toStructuredText(callback.ref());
+    const QVariantMap result = callback.waitForResult().toMap();
+    const QStringList paths = result.value("paths").toStringList();
+    // Chunks taken before a change would repeat the paths of shifted nodes.
+    QVERIFY(!paths.isEmpty());
+    QCOMPARE(result.value("offsets").toList().size(), paths.size());
+    QCOMPARE(result.value("text").toString().size(), paths.size());
+    QCOMPARE(paths.toSet().size(), paths.size());
+}
+
 void tst_QWebEngineFrame::setHtml()
 {
     QString html("<html><head></head><body><p>hello world</p></body></html>");
@@ -555,6 +636,58 @@ protected:
     }
 };
 
+void tst_QWebEngineFrame::setHtmlLargeWithBaseURL()
+{
+    // Big enough not to be encoded into a data: URL.
+    const QString text(512 * 1024, QLatin1Char('a'));
+    const QString html = QStringLiteral("<html><body><p>") + text + QStringLiteral("</p></body></html>");
+    const QUrl baseUrl("http://foobar.baz/");
+
+    QSignalSpy spy(m_page, SIGNAL(loadFinished(bool)));
+    m_page->setHtml(html, baseUrl);
+    QVERIFY(spy.wait());
+    QVERIFY(spy.takeFirst().first().toBool());
+    QCOMPARE(m_page->url(), baseUrl);
+    QCOMPARE(baseUrlSync(m_page), baseUrl);
+    QCOMPARE(evaluateJavaScriptSync(m_page, "document.body.textContent.length").toInt(), text.size());
+
+    // The content has to be served again, not fetched from the base URL.
+    m_page->triggerAction(QWebEnginePage::Reload);
+    QVERIFY(spy.wait());
+    QVERIFY(spy.takeFirst().first().toBool());
+    QCOMPARE(evaluateJavaScriptSync(m_page, "document.body.textContent.length").toInt(), text.size());
+
+    // The content belongs to the page it was set on, another page loading the base URL doesn't get it.
+    QWebEnginePage otherPage;
+    QSignalSpy otherSpy(&otherPage, SIGNAL(loadFinished(bool)));
+    otherPage.load(baseUrl);
+    QVERIFY(otherSpy.wait());
+    QVERIFY(evaluateJavaScriptSync(&otherPage, "document.body ? document.body.textContent.length : 0").toInt() != text.size());
+}
+
+void tst_QWebEngineFrame::setHtmlLargeWithoutBaseURL()
+{
+    const QString text(512 * 1024, QLatin1Char('a'));
+    const QString html = QStringLiteral("<html><body><p>") + text + QStringLiteral("</p></body></html>");
+
+    QSignalSpy spy(m_page, SIGNAL(loadFinished(bool)));
+    m_page->setHtml(html);
+    QVERIFY(spy.wait());
+    QVERIFY(spy.takeFirst().first().toBool());
+    QCOMPARE(m_page->url(), QUrl("about:blank"));
+    QCOMPARE(evaluateJavaScriptSync(m_page, "document.body.textContent.length").toInt(), text.size());
+
+    m_page->setHtml("<html><body>other</body></html>");
+    QVERIFY(spy.wait());
+    QVERIFY(spy.takeFirst().first().toBool());
+
+    // Going back has to serve the content again too.
+    m_page->triggerAction(QWebEnginePage::Back);
+    QVERIFY(spy.wait());
+    QVERIFY(spy.takeFirst().first().toBool());
+    QCOMPARE(evaluateJavaScriptSync(m_page, "document.body.textContent.length").toInt(), text.size());
+}
+
 void tst_QWebEngineFrame::setHtmlWithJSAlert()
 {
     QString html("<html><head></head><body><script>alert('foo');</script><p>hello world</p></body></html>");
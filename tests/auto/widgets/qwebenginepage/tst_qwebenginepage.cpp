@@ -187,6 +187,8 @@ private Q_SLOTS:
     void openWindowDefaultSize();
     void cssMediaTypeGlobalSetting();
     void cssMediaTypePageSetting();
+    void qrcRangeRequests_data();
+    void qrcRangeRequests();
 
 #ifdef Q_OS_MAC
     void macCopyUnicodeToClipboard();
@@ -3744,5 +3746,52 @@ void tst_QWebEnginePage::cssMediaTypePageSetting()
 #endif
 }
 
+void tst_QWebEnginePage::qrcRangeRequests_data()
+{
+    QTest::addColumn<QString>("url");
+    QTest::addColumn<QString>("range");
+    QTest::addColumn<int>("status");
+    QTest::addColumn<QString>("contentRange");
+    QTest::addColumn<QString>("body");
+
+    // range.txt holds "0123456789" ten times over, range_compressed.txt is the same file stored compressed.
+    const QString content = QString("0123456789").repeated(100);
+    const QStringList urls = QStringList() << "qrc:///resources/range.txt" << "qrc:///resources/range_compressed.txt";
+    foreach (const QString &url, urls) {
+        const QString name = url.section('/', -1);
+        QTest::newRow(qPrintable(name + " whole")) << url << QString() << 200 << QString() << content;
+        QTest::newRow(qPrintable(name + " first bytes")) << url << "bytes=0-9" << 206 << "bytes 0-9/1000" << "0123456789";
+        QTest::newRow(qPrintable(name + " middle")) << url << "bytes=512-515" << 206 << "bytes 512-515/1000" << "2345";
+        QTest::newRow(qPrintable(name + " past the end")) << url << "bytes=995-1100" << 206 << "bytes 995-999/1000" << "56789";
+        QTest::newRow(qPrintable(name + " suffix")) << url << "bytes=-3" << 206 << "bytes 997-999/1000" << "789";
+        QTest::newRow(qPrintable(name + " unsatisfiable")) << url << "bytes=1000-" << 416 << "bytes */1000" << QString();
+        QTest::newRow(qPrintable(name + " multiple")) << url << "bytes=0-1,5-6" << 416 << "bytes */1000" << QString();
+    }
+}
+
+void tst_QWebEnginePage::qrcRangeRequests()
+{
+    QFETCH(QString, url);
+    QFETCH(QString, range);
+    QFETCH(int, status);
+    QFETCH(QString, contentRange);
+    QFETCH(QString, body);
+
+    // Requests from a qrc page to qrc resources are same-origin.
+    QSignalSpy loadSpy(m_view, SIGNAL(loadFinished(bool)));
+    m_view->load(QUrl("qrc:///resources/range.txt"));
+    QTRY_COMPARE(loadSpy.count(), 1);
+
+    QString script = QString("var xhr = new XMLHttpRequest(); xhr.open('GET', '%1', false);").arg(url);
+    if (!range.isEmpty())
+        script += QString("xhr.setRequestHeader('Range', '%1');").arg(range);
+    script += "xhr.send(); [xhr.status, xhr.getResponseHeader('Content-Range') || '', xhr.responseText]";
+    const QVariantList result = evaluateJavaScriptSync(m_view->page(), script).toList();
+    QCOMPARE(result.size(), 3);
+    QCOMPARE(result.at(0).toInt(), status);
+    QCOMPARE(result.at(1).toString(), contentRange);
+    QCOMPARE(result.at(2).toString(), body);
+}
+
 QTEST_MAIN(tst_QWebEnginePage)
 #include "tst_qwebenginepage.moc"
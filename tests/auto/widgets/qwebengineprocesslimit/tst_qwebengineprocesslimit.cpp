@@ -0,0 +1,101 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+
+#include <QtTest/QtTest>
+
+#include "../util.h"
+#include "qwebengineprofile.h"
+#include "qwebengineview.h"
+
+#include <QApplication>
+
+// Runs with a renderer process limit of one, which the first page reaches.
+class tst_QWebEngineProcessLimit : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void spareRendererProcessAtLimit();
+};
+
+void tst_QWebEngineProcessLimit::initTestCase()
+{
+    QWebEngineWidgets::initialize();
+}
+
+void tst_QWebEngineProcessLimit::spareRendererProcessAtLimit()
+{
+    QWebEngineView first;
+    first.setHtml("<html><body>first</body></html>");
+    QVERIFY(waitForSignal(&first, SIGNAL(loadFinished(bool))));
+
+    // The pool can only get the process of the first page, which must not become a spare.
+    QTest::ignoreMessage(QtWarningMsg, "Renderer process limit reached, keeping 0 of 1 spare renderer processes.");
+    QWebEngineProfile *profile = QWebEngineProfile::defaultProfile();
+    profile->setSpareRendererProcessCount(1);
+
+    QWebEngineView second;
+    second.setHtml("<html><body>second</body></html>");
+    QVERIFY(waitForSignal(&second, SIGNAL(loadFinished(bool))));
+    QVERIFY(!second.startupStatistics().value("spareProcess").toBool());
+    QCOMPARE(toPlainTextSync(first.page()), QStringLiteral("first"));
+    QCOMPARE(toPlainTextSync(second.page()), QStringLiteral("second"));
+
+    profile->setSpareRendererProcessCount(0);
+}
+
+int main(int argc, char *argv[])
+{
+    // Chromium picks its switches from the application arguments, the test library must not see this one.
+    QVector<char *> arguments;
+    for (int i = 0; i < argc; ++i)
+        arguments.append(argv[i]);
+    char processLimit[] = "--renderer-process-limit=1";
+    arguments.append(processLimit);
+    int argumentCount = arguments.size();
+    arguments.append(0);
+
+    QApplication app(argumentCount, arguments.data());
+    tst_QWebEngineProcessLimit test;
+    return QTest::qExec(&test, argc, argv);
+}
+
+#include "tst_qwebengineprocesslimit.moc"
@@ -0,0 +1,241 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+
+#include "../util.h"
+#include "qwebenginepage.h"
+#include "qwebengineprofile.h"
+#include "qwebengineview.h"
+
+#include <QTcpServer>
+#include <QTcpSocket>
+
+// Serves an HTML page at / and a cacheable text resource at /cached.txt, one request per connection.
+class TestHttpServer : public QTcpServer
+{
+    Q_OBJECT
+
+public:
+    TestHttpServer()
+    {
+        connect(this, SIGNAL(newConnection()), this, SLOT(onNewConnection()));
+    }
+
+    QUrl url(const QString &path) const
+    {
+        return QUrl(QString("http://127.0.0.1:%1%2").arg(serverPort()).arg(path));
+    }
+
+private Q_SLOTS:
+    void onNewConnection()
+    {
+        while (QTcpSocket *socket = nextPendingConnection()) {
+            connect(socket, SIGNAL(readyRead()), this, SLOT(onReadyRead()));
+            connect(socket, SIGNAL(disconnected()), socket, SLOT(deleteLater()));
+        }
+    }
+
+    void onReadyRead()
+    {
+        QTcpSocket *socket = static_cast<QTcpSocket *>(sender());
+        QByteArray request = socket->property("request").toByteArray() + socket->readAll();
+        socket->setProperty("request", request);
+        if (!request.contains("\r\n\r\n"))
+            return;
+
+        const QByteArray path = request.split(' ').value(1);
+        QByteArray status = "200 OK";
+        QByteArray headers;
+        QByteArray body;
+        if (path == "/") {
+            headers = "Content-Type: text/html\r\nCache-Control: no-store\r\n";
+            body = "<html><body>served</body></html>";
+        } else if (path == "/cached.txt") {
+            headers = "Content-Type: text/plain\r\nCache-Control: max-age=3600\r\n";
+            body = "cached";
+        } else {
+            status = "404 Not Found";
+        }
+        socket->write("HTTP/1.1 " + status + "\r\n" + headers
+                      + "Content-Length: " + QByteArray::number(body.size()) + "\r\n"
+                      + "Connection: close\r\n\r\n" + body);
+        socket->disconnectFromHost();
+    }
+};
+
+class tst_QWebEngineProfile : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void httpCacheSettings();
+    void httpCacheStatistics();
+    void spareRendererProcess();
+    void offTheRecord();
+};
+
+void tst_QWebEngineProfile::initTestCase()
+{
+    QWebEngineWidgets::initialize();
+
+    // The cache settings are read by the first request, before any page is created.
+    QWebEngineProfile *profile = QWebEngineProfile::defaultProfile();
+    QCOMPARE(profile->httpCacheType(), QWebEngineProfile::DefaultHttpCache);
+    QCOMPARE(profile->httpCacheMaximumSize(), 0);
+    QVERIFY(!profile->isMemoryOnly());
+
+    profile->setHttpCacheType(QWebEngineProfile::SimpleHttpCache);
+    profile->setHttpCacheMaximumSize(4 * 1024 * 1024);
+    profile->setMemoryOnly(true);
+}
+
+void tst_QWebEngineProfile::httpCacheSettings()
+{
+    QWebEngineProfile *profile = QWebEngineProfile::defaultProfile();
+    QCOMPARE(profile->httpCacheMaximumSize(), 4 * 1024 * 1024);
+    QVERIFY(profile->isMemoryOnly());
+    // Memory only overrides the cache type.
+    QCOMPARE(profile->httpCacheType(), QWebEngineProfile::MemoryHttpCache);
+
+    profile->setHttpCacheMaximumSize(-1);
+    QCOMPARE(profile->httpCacheMaximumSize(), 0);
+    profile->setHttpCacheMaximumSize(4 * 1024 * 1024);
+}
+
+void tst_QWebEngineProfile::httpCacheStatistics()
+{
+    QWebEngineProfile *profile = QWebEngineProfile::defaultProfile();
+    QWebEnginePage page;
+    QSignalSpy spy(&page, SIGNAL(loadFinished(bool)));
+    page.setHtml("<html><body>foo</body></html>");
+    QVERIFY(spy.wait());
+
+    // Only HTTP(S) requests go through the cache.
+    QCOMPARE(profile->httpCacheHitCount(), qint64(0));
+    QCOMPARE(profile->httpCacheMissCount(), qint64(0));
+    QCOMPARE(profile->httpCacheBytesFromCache(), qint64(0));
+    QCOMPARE(profile->httpCacheBytesFromNetwork(), qint64(0));
+
+    TestHttpServer server;
+    QVERIFY(server.listen(QHostAddress::LocalHost));
+    page.load(server.url("/"));
+    QVERIFY(spy.wait());
+    QVERIFY(spy.last().first().toBool());
+
+    // Synchronous requests skip the renderer's memory cache, so both of them reach the HTTP cache.
+    const QString fetch = QString("var xhr = new XMLHttpRequest(); xhr.open('GET', '%1', false); xhr.send(); xhr.responseText")
+            .arg(server.url("/cached.txt").toString());
+    const qint64 hitCount = profile->httpCacheHitCount();
+    const qint64 missCount = profile->httpCacheMissCount();
+    const qint64 bytesFromNetwork = profile->httpCacheBytesFromNetwork();
+
+    QCOMPARE(evaluateJavaScriptSync(&page, fetch).toString(), QStringLiteral("cached"));
+    QTRY_COMPARE(profile->httpCacheMissCount(), missCount + 1);
+    QCOMPARE(profile->httpCacheHitCount(), hitCount);
+    QTRY_VERIFY(profile->httpCacheBytesFromNetwork() > bytesFromNetwork);
+    const qint64 bytesFromCache = profile->httpCacheBytesFromCache();
+
+    QCOMPARE(evaluateJavaScriptSync(&page, fetch).toString(), QStringLiteral("cached"));
+    QTRY_COMPARE(profile->httpCacheHitCount(), hitCount + 1);
+    QCOMPARE(profile->httpCacheMissCount(), missCount + 1);
+    QTRY_VERIFY(profile->httpCacheBytesFromCache() > bytesFromCache);
+}
+
+void tst_QWebEngineProfile::spareRendererProcess()
+{
+    QWebEngineProfile *profile = QWebEngineProfile::defaultProfile();
+    QCOMPARE(profile->spareRendererProcessCount(), 0);
+    profile->setSpareRendererProcessCount(1);
+
+    // The pool is filled from the event loop, after this view took its process.
+    QWebEngineView first;
+    first.setHtml("<html><body>first</body></html>");
+    QVERIFY(waitForSignal(&first, SIGNAL(loadFinished(bool))));
+
+    QWebEngineView view;
+    view.setHtml("<html><body>second</body></html>");
+    QVERIFY(waitForSignal(&view, SIGNAL(loadFinished(bool))));
+    view.show();
+    QTest::qWaitForWindowExposed(&view);
+
+    QVariantMap statistics = view.startupStatistics();
+    QVERIFY(statistics.value("spareProcess").toBool());
+    QVERIFY(statistics.value("processLaunch").toDouble() > 0);
+    QVERIFY(statistics.value("firstCommit").toDouble() > 0);
+    QTRY_VERIFY(view.startupStatistics().contains("firstPaint"));
+    QVERIFY(view.startupStatistics().value("firstPaint").toDouble() >= statistics.value("firstCommit").toDouble());
+
+    profile->setSpareRendererProcessCount(0);
+}
+
+void tst_QWebEngineProfile::offTheRecord()
+{
+    QVERIFY(!QWebEngineProfile::defaultProfile()->isOffTheRecord());
+
+    QWebEngineProfile first;
+    QWebEngineProfile second;
+    QVERIFY(first.isOffTheRecord());
+    QVERIFY(first.isMemoryOnly());
+    QCOMPARE(first.httpCacheType(), QWebEngineProfile::MemoryHttpCache);
+
+    const QUrl baseUrl(QStringLiteral("http://qt.example/"));
+    QWebEnginePage firstPage(&first);
+    QWebEnginePage secondPage(&second);
+    QCOMPARE(firstPage.profile(), &first);
+    QCOMPARE(QWebEnginePage().profile(), QWebEngineProfile::defaultProfile());
+
+    firstPage.setHtml("<html><body>first</body></html>", baseUrl);
+    QVERIFY(waitForSignal(&firstPage, SIGNAL(loadFinished(bool))));
+    secondPage.setHtml("<html><body>second</body></html>", baseUrl);
+    QVERIFY(waitForSignal(&secondPage, SIGNAL(loadFinished(bool))));
+
+    // Contexts don't share cookies or storage, even for the same origin.
+    evaluateJavaScriptSync(&firstPage, "document.cookie = 'profile=first'; localStorage.setItem('profile', 'first');");
+    QCOMPARE(evaluateJavaScriptSync(&firstPage, "document.cookie").toString(), QStringLiteral("profile=first"));
+    QCOMPARE(evaluateJavaScriptSync(&firstPage, "localStorage.getItem('profile')").toString(), QStringLiteral("first"));
+    QCOMPARE(evaluateJavaScriptSync(&secondPage, "document.cookie").toString(), QString());
+    QVERIFY(evaluateJavaScriptSync(&secondPage, "localStorage.getItem('profile')").isNull());
+}
+
+QTEST_MAIN(tst_QWebEngineProfile)
+#include "tst_qwebengineprofile.moc"
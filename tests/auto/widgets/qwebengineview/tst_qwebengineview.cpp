@@ -27,6 +27,7 @@
 #include <qwebenginepage.h>
 #include <qnetworkrequest.h>
 #include <qdiriterator.h>
+#include <qtouchdevice.h>
 
 #define VERIFY_INPUTMETHOD_HINTS(actual, expect) \
     QVERIFY(actual == expect);
@@ -48,6 +49,15 @@ private Q_SLOTS:
 
     void reusePage_data();
     void reusePage();
+    void frameStatistics();
+    void overdrawStatistics();
+    void sceneGraphNodeReuse();
+    void softwareCompositing_data();
+    void softwareCompositing();
+    void headlessGrabToImage();
+    void coalescedMouseMoves();
+    void coalescedWheelEvents();
+    void coalescedTouchMoves();
     void microFocusCoordinates();
     void focusInputTypes();
     void horizontalScrollbarTest();
@@ -173,6 +183,225 @@ void tst_QWebEngineView::reusePage()
     QDir::setCurrent(QApplication::applicationDirPath());
 }
 
+void tst_QWebEngineView::frameStatistics()
+{
+    QWebEngineView view;
+    view.setHtml("<html><body style='background: green'></body></html>");
+    QVERIFY(waitForSignal(&view, SIGNAL(loadFinished(bool))));
+    view.show();
+    QTest::qWaitForWindowExposed(&view);
+
+    QTRY_VERIFY(view.frameStatistics().value("framesSwapped").toULongLong() > 0);
+    QVariantMap statistics = view.frameStatistics();
+    QVERIFY(statistics.value("framesCommitted").toULongLong() >= statistics.value("framesSwapped").toULongLong());
+    QVariantMap commitToSwap = statistics.value("commitToSwap").toMap();
+    QVERIFY(commitToSwap.value("count").toInt() > 0);
+    QCOMPARE(commitToSwap.value("histogram").toList().size(), statistics.value("histogramBucketBounds").toList().size() + 1);
+    QVERIFY(commitToSwap.value("min").toDouble() <= commitToSwap.value("p50").toDouble());
+    QVERIFY(commitToSwap.value("p50").toDouble() <= commitToSwap.value("max").toDouble());
+    QVERIFY(statistics.contains("mailboxWait"));
+    QVERIFY(statistics.contains("inputLatency"));
+}
+
+void tst_QWebEngineView::overdrawStatistics()
+{
+    QWebEngineView view;
+    view.resize(800, 600);
+    // An opaque layer covering the page hides the composited layers below it.
+    view.setHtml("<html><body style='margin: 0'>"
+                 "<div style='position: absolute; width: 400px; height: 400px; background: red; transform: translateZ(0)'></div>"
+                 "<div style='position: absolute; width: 800px; height: 600px; background: green; transform: translateZ(0)'></div>"
+                 "</body></html>");
+    QVERIFY(waitForSignal(&view, SIGNAL(loadFinished(bool))));
+    view.show();
+    QTest::qWaitForWindowExposed(&view);
+
+    QTRY_VERIFY(view.frameStatistics().contains("overdraw"));
+    QVariantMap overdraw = view.frameStatistics().value("overdraw").toMap();
+    QVERIFY(overdraw.value("afterCulling").toDouble() > 0);
+    QVERIFY(overdraw.value("afterCulling").toDouble() <= overdraw.value("beforeCulling").toDouble());
+}
+
+void tst_QWebEngineView::sceneGraphNodeReuse()
+{
+    QWebEngineView view;
+    view.resize(800, 600);
+    // Only the transform of the animated layer changes, its quads and their textures stay the same between frames.
+    view.setHtml("<html><head><style>"
+                 "@keyframes slide { from { transform: translateX(0); } to { transform: translateX(200px); } }"
+                 "div { width: 300px; height: 300px; background: green; animation: slide 1s linear infinite; }"
+                 "</style></head><body><div></div></body></html>");
+    QVERIFY(waitForSignal(&view, SIGNAL(loadFinished(bool))));
+    view.show();
+    QTest::qWaitForWindowExposed(&view);
+
+    QTRY_VERIFY(view.frameStatistics().value("framesCommitted").toULongLong() > 1);
+    const QVariantMap firstNodes = view.frameStatistics().value("sceneGraphNodes").toMap();
+    QVERIFY(firstNodes.value("created").toULongLong() > 0);
+
+    QTRY_VERIFY(view.frameStatistics().value("sceneGraphNodes").toMap().value("reused").toULongLong() > firstNodes.value("reused").toULongLong());
+    const QVariantMap nodes = view.frameStatistics().value("sceneGraphNodes").toMap();
+    // Nodes are only deleted after having been created.
+    QVERIFY(nodes.value("deleted").toULongLong() <= nodes.value("created").toULongLong());
+}
+
+void tst_QWebEngineView::softwareCompositing_data()
+{
+    QTest::addColumn<bool>("softwareCompositing");
+    QTest::newRow("gl") << false;
+    QTest::newRow("software") << true;
+}
+
+void tst_QWebEngineView::softwareCompositing()
+{
+    QFETCH(bool, softwareCompositing);
+    QWebEngineView view;
+    view.resize(800, 600);
+    view.setSoftwareCompositingEnabled(softwareCompositing);
+    QCOMPARE(view.softwareCompositingEnabled(), softwareCompositing);
+    view.setHtml("<html><head><style>"
+                 "@keyframes spin { from { transform: rotate(0deg); } to { transform: rotate(360deg); } }"
+                 "div { width: 300px; height: 300px; background: green; animation: spin 1s linear infinite; }"
+                 "</style></head><body><div></div></body></html>");
+    QVERIFY(waitForSignal(&view, SIGNAL(loadFinished(bool))));
+    view.show();
+    QTest::qWaitForWindowExposed(&view);
+    QTRY_VERIFY(view.frameStatistics().value("framesSwapped").toULongLong() > 0);
+
+    // The animation keeps presenting new frames in both modes.
+    const qulonglong framesSwapped = view.frameStatistics().value("framesSwapped").toULongLong();
+    QTRY_VERIFY(view.frameStatistics().value("framesSwapped").toULongLong() > framesSwapped);
+}
+
+void tst_QWebEngineView::headlessGrabToImage()
+{
+    QWebEnginePage page;
+    page.setHeadlessViewportSize(QSize(400, 300));
+    QCOMPARE(page.headlessViewportSize(), QSize(400, 300));
+    QVERIFY(page.softwareCompositingEnabled());
+    page.setHtml("<html><body style='margin: 0; background: green'>"
+                 "<div style='width: 100px; height: 100px; background: blue'></div></body></html>");
+    QVERIFY(waitForSignal(&page, SIGNAL(loadFinished(bool))));
+
+    // The first frames can still be blank, wait until the page got composited.
+    QTRY_COMPARE(QColor(grabToImageSync(&page).pixel(50, 50)), QColor(Qt::blue));
+    QImage full = grabToImageSync(&page);
+    QCOMPARE(full.size(), QSize(400, 300));
+    QCOMPARE(QColor(full.pixel(200, 200)), QColor(Qt::green));
+
+    // Only the requested region is read back, then scaled.
+    QImage region = grabToImageSync(&page, QRect(100, 100, 200, 100), 0.5);
+    QCOMPARE(region.size(), QSize(100, 50));
+    QCOMPARE(QColor(region.pixel(50, 25)), QColor(Qt::green));
+}
+
+// Logs the input events the page receives, in order.
+static const char inputLogHtml[] =
+    "<html><body style='margin: 0'><script>"
+    "var log = []; var wheelDeltas = [];"
+    "document.addEventListener('mousemove', function(e) { log.push('mousemove ' + e.clientX + ',' + e.clientY); });"
+    "document.addEventListener('mousedown', function(e) { log.push('mousedown'); });"
+    "document.addEventListener('mouseup', function(e) { log.push('mouseup'); });"
+    "document.addEventListener('wheel', function(e) { log.push('wheel'); wheelDeltas.push(e.deltaY); e.preventDefault(); });"
+    "document.addEventListener('touchstart', function(e) { log.push('touchstart ' + e.touches[0].clientX + ',' + e.touches[0].clientY); e.preventDefault(); });"
+    "document.addEventListener('touchmove', function(e) { log.push('touchmove ' + e.touches[0].clientX + ',' + e.touches[0].clientY); e.preventDefault(); });"
+    "document.addEventListener('touchend', function(e) { log.push('touchend'); e.preventDefault(); });"
+    "</script></body></html>";
+
+// The render widget is the only child widget of the view.
+static QWidget *loadInputLog(QWebEngineView *view)
+{
+    view->resize(400, 300);
+    view->setHtml(QString::fromLatin1(inputLogHtml));
+    if (!waitForSignal(view, SIGNAL(loadFinished(bool))))
+        return 0;
+    view->show();
+    QTest::qWaitForWindowExposed(view);
+    evaluateJavaScriptSync(view->page(), "log = []; wheelDeltas = [];");
+    return view->findChild<QWidget *>();
+}
+
+static QString inputLog(QWebEnginePage *page)
+{
+    return evaluateJavaScriptSync(page, "log.join('; ')").toString();
+}
+
+static void sendMouseEvent(QWidget *widget, QEvent::Type type, const QPointF &pos, Qt::MouseButton button, Qt::MouseButtons buttons)
+{
+    QMouseEvent event(type, pos, button, buttons, Qt::NoModifier);
+    QCoreApplication::sendEvent(widget, &event);
+}
+
+static void sendTouchEvent(QWidget *widget, QTouchDevice *device, QEvent::Type type, Qt::TouchPointState state, const QPointF &pos)
+{
+    QTouchEvent::TouchPoint point(0);
+    point.setState(state);
+    point.setPos(pos);
+    point.setScreenPos(widget->mapToGlobal(pos.toPoint()));
+    QList<QTouchEvent::TouchPoint> points;
+    points.append(point);
+    QTouchEvent event(type, device, Qt::NoModifier, state, points);
+    QCoreApplication::sendEvent(widget, &event);
+}
+
+// Events sent without returning to the event loop all arrive within the same frame.
+void tst_QWebEngineView::coalescedMouseMoves()
+{
+    QWebEngineView view;
+    QWidget *renderWidget = loadInputLog(&view);
+    QVERIFY(renderWidget);
+
+    for (int i = 1; i <= 10; ++i)
+        sendMouseEvent(renderWidget, QEvent::MouseMove, QPointF(10 * i, 5 * i), Qt::NoButton, Qt::NoButton);
+    // The press flushes the pending move first so the page sees them in order.
+    sendMouseEvent(renderWidget, QEvent::MouseButtonPress, QPointF(100, 50), Qt::LeftButton, Qt::LeftButton);
+    sendMouseEvent(renderWidget, QEvent::MouseButtonRelease, QPointF(100, 50), Qt::LeftButton, Qt::NoButton);
+
+    QTRY_COMPARE(inputLog(view.page()), QString("mousemove 100,50; mousedown; mouseup"));
+}
+
+void tst_QWebEngineView::coalescedWheelEvents()
+{
+    QWebEngineView view;
+    QWidget *renderWidget = loadInputLog(&view);
+    QVERIFY(renderWidget);
+
+    QWheelEvent wheel(QPointF(50, 50), -120, Qt::NoButton, Qt::NoModifier);
+    QCoreApplication::sendEvent(renderWidget, &wheel);
+    QTRY_COMPARE(inputLog(view.page()), QString("wheel"));
+    const double singleDelta = evaluateJavaScriptSync(view.page(), "wheelDeltas[0]").toDouble();
+    QVERIFY(singleDelta != 0);
+    evaluateJavaScriptSync(view.page(), "log = []; wheelDeltas = [];");
+
+    for (int i = 0; i < 5; ++i) {
+        QWheelEvent event(QPointF(50, 50), -120, Qt::NoButton, Qt::NoModifier);
+        QCoreApplication::sendEvent(renderWidget, &event);
+    }
+    sendMouseEvent(renderWidget, QEvent::MouseButtonPress, QPointF(50, 50), Qt::LeftButton, Qt::LeftButton);
+    sendMouseEvent(renderWidget, QEvent::MouseButtonRelease, QPointF(50, 50), Qt::LeftButton, Qt::NoButton);
+
+    // The deltas of the coalesced events add up.
+    QTRY_COMPARE(inputLog(view.page()), QString("wheel; mousedown; mouseup"));
+    QCOMPARE(evaluateJavaScriptSync(view.page(), "wheelDeltas[0]").toDouble(), 5 * singleDelta);
+}
+
+void tst_QWebEngineView::coalescedTouchMoves()
+{
+    QWebEngineView view;
+    QWidget *renderWidget = loadInputLog(&view);
+    QVERIFY(renderWidget);
+
+    QTouchDevice device;
+    device.setType(QTouchDevice::TouchScreen);
+    sendTouchEvent(renderWidget, &device, QEvent::TouchBegin, Qt::TouchPointPressed, QPointF(10, 10));
+    for (int i = 2; i <= 10; ++i)
+        sendTouchEvent(renderWidget, &device, QEvent::TouchUpdate, Qt::TouchPointMoved, QPointF(10 * i, 5 * i));
+    // The release flushes the pending move first.
+    sendTouchEvent(renderWidget, &device, QEvent::TouchEnd, Qt::TouchPointReleased, QPointF(100, 50));
+
+    QTRY_COMPARE(inputLog(view.page()), QString("touchstart 10,10; touchmove 100,50; touchend"));
+}
+
 // Class used in crashTests
 class WebViewCrashTest : public QObject {
     Q_OBJECT
@@ -23,6 +23,7 @@
 #endif
 
 #include <QEventLoop>
+#include <QImage>
 #include <QSignalSpy>
 #include <QTimer>
 #include <qwebenginepage.h>
@@ -149,6 +150,13 @@ static inline bool findTextSync(QWebEnginePage *page, const QString &subString)
     return spy.waitForResult();
 }
 
+static inline QImage grabToImageSync(QWebEnginePage *page, const QRect &rect = QRect(), qreal scale = 1.0)
+{
+    CallbackSpy<QImage> spy;
+    page->grabToImage(spy.ref(), rect, scale);
+    return spy.waitForResult();
+}
+
 static inline QVariant evaluateJavaScriptSync(QWebEnginePage *page, const QString &script)
 {
     CallbackSpy<QVariant> spy;
@@ -8,4 +8,6 @@ SUBDIRS += \
     qwebenginehistoryinterface \
     qwebengineview \
     qwebenginehistory \
+    qwebengineprofile \
+    qwebengineprocesslimit \
     qwebengineinspector \
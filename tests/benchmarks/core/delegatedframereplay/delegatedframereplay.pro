@@ -0,0 +1,12 @@
+TEMPLATE = app
+TARGET = tst_bench_delegatedframereplay
+
+# DelegatedFrameNode needs Chromium, go through the replayer exported by the core library.
+CORE_SOURCE_DIR = $$PWD/../../../../src/core
+INCLUDEPATH += $$CORE_SOURCE_DIR
+
+SOURCES += tst_bench_delegatedframereplay.cpp
+
+QT += testlib gui
+QT_PRIVATE += webenginecore
+macx: CONFIG -= app_bundle
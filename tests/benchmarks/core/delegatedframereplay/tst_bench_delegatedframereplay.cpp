@@ -0,0 +1,125 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "delegated_frame_replayer.h"
+
+#include <QtTest/QtTest>
+#include <QOffscreenSurface>
+#include <QOpenGLContext>
+
+// Replays a recording made by running any QtWebEngine application with QTWEBENGINE_RECORD_FRAMES
+// set to an existing directory. Point QTWEBENGINE_FRAME_RECORDING to one of the files written there.
+class tst_bench_DelegatedFrameReplay : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+    void replay_data();
+    void replay();
+
+private:
+    QOffscreenSurface m_surface;
+    QOpenGLContext m_context;
+    QScopedPointer<DelegatedFrameReplayer> m_replayer;
+};
+
+enum Phase {
+    Commit,
+    Preprocess,
+    Render
+};
+
+void tst_bench_DelegatedFrameReplay::initTestCase()
+{
+    const QString recording = QString::fromLocal8Bit(qgetenv("QTWEBENGINE_FRAME_RECORDING"));
+    if (recording.isEmpty())
+        QSKIP("QTWEBENGINE_FRAME_RECORDING isn't set.");
+    m_surface.create();
+    if (!m_context.create() || !m_context.makeCurrent(&m_surface))
+        QSKIP("No OpenGL context available.");
+    m_replayer.reset(new DelegatedFrameReplayer);
+    QVERIFY2(m_replayer->load(recording), qPrintable(recording));
+}
+
+void tst_bench_DelegatedFrameReplay::cleanupTestCase()
+{
+    m_replayer.reset();
+    m_context.doneCurrent();
+}
+
+void tst_bench_DelegatedFrameReplay::replay_data()
+{
+    QTest::addColumn<int>("phase");
+
+    QTest::newRow("commit") << int(Commit);
+    QTest::newRow("preprocess") << int(Preprocess);
+    QTest::newRow("render") << int(Render);
+}
+
+void tst_bench_DelegatedFrameReplay::replay()
+{
+    QFETCH(int, phase);
+
+    // Warm up the shader and FBO caches with a first pass over the recording.
+    m_replayer->reset();
+    for (int i = 0; i < m_replayer->frameCount(); ++i)
+        m_replayer->replayNextFrame();
+    m_replayer->reset();
+
+    DelegatedFrameReplayer::FrameTimings total;
+    for (int i = 0; i < m_replayer->frameCount(); ++i) {
+        const DelegatedFrameReplayer::FrameTimings timings = m_replayer->replayNextFrame();
+        total.commit += timings.commit;
+        total.preprocess += timings.preprocess;
+        total.render += timings.render;
+    }
+    QCOMPARE(glGetError(), GLenum(GL_NO_ERROR));
+
+    const int frames = m_replayer->frameCount();
+    const qint64 measured = phase == Commit ? total.commit : phase == Preprocess ? total.preprocess : total.render;
+    QTest::setBenchmarkResult(measured / frames, QTest::WalltimeNanoseconds);
+}
+
+QTEST_MAIN(tst_bench_DelegatedFrameReplay)
+
+#include "tst_bench_delegatedframereplay.moc"
@@ -0,0 +1,203 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "yuv_video_node.h"
+
+#include <QtTest/QtTest>
+#include <QOffscreenSurface>
+#include <QOpenGLContext>
+#include <QOpenGLFramebufferObject>
+#include <QOpenGLFunctions>
+#include <QtQuick/qsgtexture.h>
+
+// A 4K frame, converted into an FBO of the same size.
+static const QSize frameSize(3840, 2160);
+
+class PlaneTexture : public QSGTexture
+{
+public:
+    PlaneTexture(GLenum format, const QSize &size)
+        : m_format(format)
+        , m_size(size)
+    {
+        const int bytesPerPixel = format == GL_LUMINANCE_ALPHA ? 2 : 1;
+        QByteArray data(size.width() * size.height() * bytesPerPixel, Qt::Uninitialized);
+        for (int i = 0; i < data.size(); ++i)
+            data[i] = char(i * 7);
+
+        glGenTextures(1, &m_id);
+        glBindTexture(GL_TEXTURE_2D, m_id);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glTexImage2D(GL_TEXTURE_2D, 0, format, size.width(), size.height(), 0, format, GL_UNSIGNED_BYTE, data.constData());
+    }
+    ~PlaneTexture() { glDeleteTextures(1, &m_id); }
+
+    virtual int textureId() const Q_DECL_OVERRIDE { return m_id; }
+    virtual QSize textureSize() const Q_DECL_OVERRIDE { return m_size; }
+    virtual bool hasAlphaChannel() const Q_DECL_OVERRIDE { return m_format == GL_LUMINANCE_ALPHA; }
+    virtual bool hasMipmaps() const Q_DECL_OVERRIDE { return false; }
+    virtual void bind() Q_DECL_OVERRIDE { glBindTexture(GL_TEXTURE_2D, m_id); }
+
+private:
+    GLuint m_id;
+    GLenum m_format;
+    QSize m_size;
+};
+
+// compile() and initialize() are otherwise only called by the scene graph renderer.
+class MaterialShaderAccess : public QSGMaterialShader
+{
+public:
+    static void prepare(QSGMaterialShader *shader)
+    {
+        (shader->*&MaterialShaderAccess::compile)();
+        (shader->*&MaterialShaderAccess::initialize)();
+    }
+};
+
+class tst_bench_YUVVideoMaterial : public QObject, protected QOpenGLFunctions
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+    void convert_data();
+    void convert();
+
+private:
+    QOffscreenSurface m_surface;
+    QOpenGLContext m_context;
+    QScopedPointer<QOpenGLFramebufferObject> m_fbo;
+};
+
+void tst_bench_YUVVideoMaterial::initTestCase()
+{
+    m_surface.create();
+    if (!m_context.create() || !m_context.makeCurrent(&m_surface))
+        QSKIP("No OpenGL context available.");
+    initializeOpenGLFunctions();
+    m_fbo.reset(new QOpenGLFramebufferObject(frameSize));
+    QVERIFY(m_fbo->bind());
+    glViewport(0, 0, frameSize.width(), frameSize.height());
+}
+
+void tst_bench_YUVVideoMaterial::cleanupTestCase()
+{
+    m_fbo.reset();
+    m_context.doneCurrent();
+}
+
+void tst_bench_YUVVideoMaterial::convert_data()
+{
+    QTest::addColumn<bool>("biPlanar");
+    QTest::addColumn<bool>("withAlpha");
+    QTest::addColumn<int>("colorSpace");
+    QTest::addColumn<int>("colorRange");
+
+    QTest::newRow("I420 BT.601") << false << false << int(YUVVideoMaterial::BT601) << int(YUVVideoMaterial::LimitedRange);
+    QTest::newRow("I420 BT.601 full range") << false << false << int(YUVVideoMaterial::BT601) << int(YUVVideoMaterial::FullRange);
+    QTest::newRow("I420 BT.709") << false << false << int(YUVVideoMaterial::BT709) << int(YUVVideoMaterial::LimitedRange);
+    QTest::newRow("NV12 BT.709") << true << false << int(YUVVideoMaterial::BT709) << int(YUVVideoMaterial::LimitedRange);
+    QTest::newRow("YV12A BT.601") << false << true << int(YUVVideoMaterial::BT601) << int(YUVVideoMaterial::LimitedRange);
+}
+
+void tst_bench_YUVVideoMaterial::convert()
+{
+    QFETCH(bool, biPlanar);
+    QFETCH(bool, withAlpha);
+    QFETCH(int, colorSpace);
+    QFETCH(int, colorRange);
+
+    const QSize chromaSize = frameSize / 2;
+    PlaneTexture yTexture(GL_LUMINANCE, frameSize);
+    QScopedPointer<PlaneTexture> uTexture(new PlaneTexture(biPlanar ? GL_LUMINANCE_ALPHA : GL_LUMINANCE, chromaSize));
+    QScopedPointer<PlaneTexture> vTexture(biPlanar ? 0 : new PlaneTexture(GL_LUMINANCE, chromaSize));
+    QScopedPointer<PlaneTexture> aTexture(withAlpha ? new PlaneTexture(GL_LUMINANCE, frameSize) : 0);
+
+    QScopedPointer<YUVVideoMaterial> material;
+    if (withAlpha)
+        material.reset(new YUVAVideoMaterial(&yTexture, uTexture.data(), vTexture.data(), aTexture.data(), QSizeF(1, 1),
+                                             YUVVideoMaterial::ColorSpace(colorSpace), YUVVideoMaterial::ColorRange(colorRange)));
+    else
+        material.reset(new YUVVideoMaterial(&yTexture, uTexture.data(), vTexture.data(), QSizeF(1, 1),
+                                            YUVVideoMaterial::ColorSpace(colorSpace), YUVVideoMaterial::ColorRange(colorRange)));
+
+    QScopedPointer<QSGMaterialShader> shader(material->createShader());
+    MaterialShaderAccess::prepare(shader.data());
+    QVERIFY(shader->program()->isLinked());
+    shader->program()->bind();
+    // Nothing is dirty in this state, the vertices are already in normalized device coordinates.
+    const QSGMaterialShader::RenderState state = QSGMaterialShader::RenderState();
+    shader->program()->setUniformValue("matrix", QMatrix4x4());
+    shader->program()->setUniformValue("alpha", GLfloat(1));
+
+    static const GLfloat vertices[] = { -1, -1, 1, -1, -1, 1, 1, 1 };
+    static const GLfloat texCoords[] = { 0, 0, 1, 0, 0, 1, 1, 1 };
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 0, vertices);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 0, texCoords);
+    glEnableVertexAttribArray(0);
+    glEnableVertexAttribArray(1);
+
+    // The first frame sets up the program, the following ones only rebind their planes like consecutive video frames.
+    shader->updateState(state, material.data(), 0);
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    glFinish();
+
+    QBENCHMARK {
+        shader->updateState(state, material.data(), material.data());
+        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+        glFinish();
+    }
+    QCOMPARE(glGetError(), GLenum(GL_NO_ERROR));
+
+    glDisableVertexAttribArray(0);
+    glDisableVertexAttribArray(1);
+    shader->program()->release();
+}
+
+QTEST_MAIN(tst_bench_YUVVideoMaterial)
+
+#include "tst_bench_yuvvideomaterial.moc"
@@ -0,0 +1,13 @@
+TEMPLATE = app
+TARGET = tst_bench_yuvvideomaterial
+
+# The material only depends on Qt Quick, build it from the core sources directly.
+CORE_SOURCE_DIR = $$PWD/../../../../src/core
+INCLUDEPATH += $$CORE_SOURCE_DIR
+
+SOURCES += tst_bench_yuvvideomaterial.cpp \
+    $$CORE_SOURCE_DIR/yuv_video_node.cpp
+HEADERS += $$CORE_SOURCE_DIR/yuv_video_node.h
+
+QT += testlib quick
+macx: CONFIG -= app_bundle
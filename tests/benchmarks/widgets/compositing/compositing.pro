@@ -0,0 +1,10 @@
+TEMPLATE = app
+TARGET = tst_bench_compositing
+
+# Reuse the signal helpers of the widgets autotests.
+INCLUDEPATH += $$PWD/../../../auto/widgets
+
+SOURCES += tst_bench_compositing.cpp
+
+QT += testlib webenginewidgets widgets
+macx: CONFIG -= app_bundle
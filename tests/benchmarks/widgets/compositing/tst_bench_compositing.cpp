@@ -0,0 +1,86 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <qwebengineview.h>
+#include "util.h"
+
+class tst_bench_Compositing : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void animationFrames_data();
+    void animationFrames();
+};
+
+void tst_bench_Compositing::animationFrames_data()
+{
+    QTest::addColumn<bool>("softwareCompositing");
+    QTest::newRow("gl") << false;
+    QTest::newRow("software") << true;
+}
+
+// Measures the time needed to present a fixed number of animation frames.
+void tst_bench_Compositing::animationFrames()
+{
+    QFETCH(bool, softwareCompositing);
+    QWebEngineView view;
+    view.resize(800, 600);
+    view.setSoftwareCompositingEnabled(softwareCompositing);
+    view.setHtml("<html><head><style>"
+                 "@keyframes spin { from { transform: rotate(0deg); } to { transform: rotate(360deg); } }"
+                 "div { width: 300px; height: 300px; background: green; animation: spin 1s linear infinite; }"
+                 "</style></head><body><div></div></body></html>");
+    QVERIFY(waitForSignal(&view, SIGNAL(loadFinished(bool))));
+    view.show();
+    QTest::qWaitForWindowExposed(&view);
+    QTRY_VERIFY(view.frameStatistics().value("framesSwapped").toULongLong() > 0);
+
+    QBENCHMARK {
+        const qulonglong target = view.frameStatistics().value("framesSwapped").toULongLong() + 60;
+        QTRY_VERIFY_WITH_TIMEOUT(view.frameStatistics().value("framesSwapped").toULongLong() >= target, 10000);
+    }
+}
+
+QTEST_MAIN(tst_bench_Compositing)
+
+#include "tst_bench_compositing.moc"